@@ -21,6 +21,7 @@
 %rename(KMeans) CKMeans;
 %rename(KMeansBase) CKMeansBase;
 %rename(KMeansMiniBatch) CKMeansMiniBatch;
+%rename(StreamingKMeansMiniBatch) CStreamingKMeansMiniBatch;
 %rename(GMM) CGMM;
 
 /* Include Class Headers to make them visible from within the target language */
@@ -29,5 +30,6 @@
 %include <shogun/clustering/KMeansBase.h> 
 %include <shogun/clustering/KMeans.h>
 %include <shogun/clustering/KMeansMiniBatch.h>
+%include <shogun/clustering/StreamingKMeansMiniBatch.h>
 %include <shogun/clustering/Hierarchical.h>
 %include <shogun/clustering/GMM.h>
@@ -3,6 +3,7 @@
 #include <shogun/clustering/KMeansBase.h>    
 #include <shogun/clustering/KMeans.h>
 #include <shogun/clustering/KMeansMiniBatch.h>    
+#include <shogun/clustering/StreamingKMeansMiniBatch.h>
 #include <shogun/clustering/Hierarchical.h>
 #include <shogun/clustering/GMM.h>
 %}
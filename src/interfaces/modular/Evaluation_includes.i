@@ -12,6 +12,7 @@
  #include <shogun/evaluation/MeanSquaredLogError.h>
  #include <shogun/evaluation/ROCEvaluation.h>
  #include <shogun/evaluation/PRCEvaluation.h>
+ #include <shogun/evaluation/ScoreHistogram.h>
  #include <shogun/evaluation/MachineEvaluation.h>
  #include <shogun/evaluation/CrossValidation.h>
  #include <shogun/evaluation/DifferentiableFunction.h>
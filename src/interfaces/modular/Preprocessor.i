@@ -23,6 +23,7 @@
 %rename(DimensionReductionPreprocessor) CDimensionReductionPreprocessor;
 %rename(PCA) CPCA;
 %rename(KernelPCA) CKernelPCA;
+%rename(Nystrom) CNystrom;
 %rename(FisherLda) CFisherLDA;
 
 %rename(SortUlongString) CSortUlongString;
@@ -37,6 +38,8 @@
 %newobject shogun::CFeatureSelection::remove_feats;
 
 %newobject shogun::CKernelPCA::apply_to_string_features;
+%newobject shogun::CNystrom::apply_to_features;
+%newobject shogun::CNystrom::get_landmarks;
 
 /* Include Class Headers to make them visible from within the target language */
 %include <shogun/lib/Compressor.h>
@@ -141,6 +144,7 @@ namespace shogun
 
 %include <shogun/preprocessor/PCA.h>
 %include <shogun/preprocessor/KernelPCA.h>
+%include <shogun/preprocessor/Nystrom.h>
 %include <shogun/preprocessor/FisherLDA.h>
 
 %include <shogun/preprocessor/SortUlongString.h>
@@ -3703,10 +3703,10 @@ bool TParameter::copy_stype(EStructType stype, EPrimitiveType ptype,
 						" freeing memory.\n",
 						source_ptr->num_feat_entries, target_ptr->num_feat_entries);
 
-				/* if string have different lengths, free data and make equal */
-				SG_FREE(target_ptr->features);
-				target_ptr->features=NULL;
-				target_ptr->num_feat_entries=0;
+				/* if string have different lengths, free data and make equal.
+				 * The target may point into the entries of a sparse matrix,
+				 * so it is released via its reference count */
+				*target_ptr=SGSparseVector<char>();
 			}
 
 			if (!target_ptr->features)
@@ -3717,8 +3717,9 @@ bool TParameter::copy_stype(EStructType stype, EPrimitiveType ptype,
 
 				SG_SDEBUG("target sparse data NULL, allocating %d bytes.\n",
 						num_bytes);
-				target_ptr->features=(SGSparseVectorEntry<char>*)SG_MALLOC(char, num_bytes);
-				target_ptr->num_feat_entries=source_ptr->num_feat_entries;
+				*target_ptr=SGSparseVector<char>(
+						(SGSparseVectorEntry<char>*)SG_MALLOC(char, num_bytes),
+						source_ptr->num_feat_entries);
 			}
 
 			SG_SDEBUG("Copying sparse vectors\n");
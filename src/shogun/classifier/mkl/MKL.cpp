@@ -1575,6 +1575,25 @@ void CMKL::compute_sum_beta(float64_t* sumw)
 	ASSERT(nweights==num_kernels)
 	ASSERT(old_beta)
 
+	if (use_subkernel_quadratic_forms())
+	{
+		SGVector<int32_t> sv_idx(nsv);
+		SGVector<float64_t> sv_alpha(nsv);
+		for (int32_t i=0; i<nsv; i++)
+		{
+			sv_idx[i]=svm->get_support_vector(i);
+			sv_alpha[i]=svm->get_alpha(i);
+		}
+
+		SGVector<float64_t> q=((CCombinedKernel*) kernel)->
+			compute_subkernel_quadratic_forms(sv_idx, sv_alpha);
+		for (int32_t n=0; n<num_kernels; n++)
+			sumw[n]=0.5*q[n];
+
+		mkl_iterations++;
+		return;
+	}
+
 	for (int32_t i=0; i<num_kernels; i++)
 	{
 		beta.vector[i]=0;
@@ -1606,6 +1625,27 @@ void CMKL::compute_sum_beta(float64_t* sumw)
 }
 
 
+bool CMKL::use_subkernel_quadratic_forms()
+{
+	if (!kernel || kernel->get_kernel_type()!=K_COMBINED)
+		return false;
+
+	CCombinedKernel* combined=(CCombinedKernel*) kernel;
+	if (combined->get_num_subkernels()!=combined->get_num_kernels())
+		return false;
+
+	if (!combined->has_symmetric_subkernels())
+		return false;
+
+	/* subkernel values are taken as they are, which is only what the
+	 * combined kernel computes if it does not normalize on its own */
+	CKernelNormalizer* normalizer=combined->get_normalizer();
+	bool identity=!strcmp(normalizer->get_name(), "IdentityKernelNormalizer");
+	SG_UNREF(normalizer);
+
+	return identity;
+}
+
 // assumes that all constraints are satisfied
 float64_t CMKL::compute_mkl_dual_objective()
 {
@@ -1620,18 +1660,37 @@ float64_t CMKL::compute_mkl_dual_objective()
 
 	if (m_labels && kernel && kernel->get_kernel_type() == K_COMBINED)
 	{
+		SGVector<float64_t> q;
+		if (use_subkernel_quadratic_forms())
+		{
+			SGVector<int32_t> sv_idx(n);
+			SGVector<float64_t> sv_alpha(n);
+			for (int32_t i=0; i<n; i++)
+			{
+				sv_idx[i]=get_support_vector(i);
+				sv_alpha[i]=get_alpha(i);
+			}
+			q=((CCombinedKernel*) kernel)->compute_subkernel_quadratic_forms(
+				sv_idx, sv_alpha);
+		}
+
 		for (index_t k_idx=0; k_idx<((CCombinedKernel*) kernel)->get_num_kernels(); k_idx++)
 		{
 			CKernel* kn = ((CCombinedKernel*) kernel)->get_kernel(k_idx);
 			float64_t sum=0;
-			for (int32_t i=0; i<n; i++)
+			if (q.vector)
+				sum=q[k_idx];
+			else
 			{
-				int32_t ii=get_support_vector(i);
-
-				for (int32_t j=0; j<n; j++)
+				for (int32_t i=0; i<n; i++)
 				{
-					int32_t jj=get_support_vector(j);
-					sum+=get_alpha(i)*get_alpha(j)*kn->kernel(ii,jj);
+					int32_t ii=get_support_vector(i);
+
+					for (int32_t j=0; j<n; j++)
+					{
+						int32_t jj=get_support_vector(j);
+						sum+=get_alpha(i)*get_alpha(j)*kn->kernel(ii,jj);
+					}
 				}
 			}
 
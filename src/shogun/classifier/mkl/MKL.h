@@ -246,6 +246,14 @@ class CMKL : public CSVM
 		 */
 		virtual void compute_sum_beta(float64_t* sumw);
 
+		/** whether the per kernel terms of the objective can be computed
+		 * with CCombinedKernel::compute_subkernel_quadratic_forms(), i.e.
+		 * in parallel and using the subkernel cache of the combined kernel
+		 *
+		 * @return if the kernel is a suitable combined kernel
+		 */
+		bool use_subkernel_quadratic_forms();
+
 		/** @return object name */
 		virtual const char* get_name() const { return "MKL"; }
 
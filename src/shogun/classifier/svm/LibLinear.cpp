@@ -18,9 +18,32 @@
 #include <shogun/optimization/liblinear/tron.h>
 #include <shogun/features/DotFeatures.h>
 #include <shogun/labels/BinaryLabels.h>
+#include <shogun/base/Parallel.h>
+
+// minimal number of samples per thread of a parallel dual coordinate
+// descent sweep
+#define DUAL_CD_MIN_BLOCK_SIZE 1024
+// minimal number of features per thread of a parallel L1 regularized
+// coordinate descent sweep
+#define PRIMAL_CD_MIN_BLOCK_SIZE 8
 
 using namespace shogun;
 
+// move the coordinates a parallel sweep marked as shrunk behind the active
+// ones, returns the new number of active coordinates
+static int32_t remove_shrunk(int *index, bool *shrunk, int32_t active_size)
+{
+	int32_t num_active=0;
+	for (int32_t s=0; s<active_size; s++)
+	{
+		if (shrunk[index[s]])
+			shrunk[index[s]]=false;
+		else
+			CMath::swap(index[s], index[num_active++]);
+	}
+	return num_active;
+}
+
 CLibLinear::CLibLinear()
 : CLinearMachine()
 {
@@ -56,6 +79,7 @@ void CLibLinear::init()
 	C2=1;
 	set_max_iterations();
 	epsilon=1e-5;
+	parallel_coordinate_descent=false;
 	/** Prevent default bias computation*/
 	set_compute_bias(false);
 
@@ -67,6 +91,8 @@ void CLibLinear::init()
 	SG_ADD(&max_iterations, "max_iterations", "Max number of iterations.",
 			MS_NOT_AVAILABLE);
 	SG_ADD(&m_linear_term, "linear_term", "Linear Term", MS_NOT_AVAILABLE);
+	SG_ADD(&parallel_coordinate_descent, "parallel_coordinate_descent",
+			"Whether coordinate descent uses several threads.", MS_NOT_AVAILABLE);
 	SG_ADD((machine_int_t*) &liblinear_solver_type, "liblinear_solver_type",
 			"Type of LibLinear solver.", MS_NOT_AVAILABLE);
 }
@@ -75,6 +101,15 @@ CLibLinear::~CLibLinear()
 {
 }
 
+int32_t CLibLinear::get_num_cd_blocks(int32_t num_coordinates, int32_t min_block_size)
+{
+	if (!parallel_coordinate_descent)
+		return 1;
+
+	return CMath::max(1, CMath::min(parallel->get_num_threads(),
+		num_coordinates/min_block_size));
+}
+
 bool CLibLinear::train_machine(CFeatures* data)
 {
 	CSignal::clear_cancel();
@@ -254,21 +289,88 @@ bool CLibLinear::train_machine(CFeatures* data)
 #define GETI(i) (y[i]+1)
 // To support weights for instances, use GETI(i) (i)
 
+bool CLibLinear::update_l2r_l1l2_svc_coordinate(
+	const liblinear_problem *prob, int32_t i, const int32_t *y, double *alpha,
+	const double *QD, const double *diag, const double *upper_bound,
+	double PGmax_old, double PGmin_old, double &PGmax_new, double &PGmin_new,
+	bool atomic)
+{
+	int n = prob->n;
+	if (prob->use_bias)
+		n--;
+
+	int32_t yi = y[i];
+	double G = prob->x->dense_dot(i, w.vector, n);
+	if (prob->use_bias)
+		G+=w.vector[n];
+
+	if (m_linear_term.vector)
+		G = G*yi + m_linear_term.vector[i];
+	else
+		G = G*yi-1;
+
+	double C = upper_bound[GETI(i)];
+	G += alpha[i]*diag[GETI(i)];
+
+	double PG = 0;
+	if (alpha[i] == 0)
+	{
+		if (G > PGmax_old)
+			return false;
+		else if (G < 0)
+			PG = G;
+	}
+	else if (alpha[i] == C)
+	{
+		if (G < PGmin_old)
+			return false;
+		else if (G > 0)
+			PG = G;
+	}
+	else
+		PG = G;
+
+	PGmax_new = CMath::max(PGmax_new, PG);
+	PGmin_new = CMath::min(PGmin_new, PG);
+
+	if(fabs(PG) > 1.0e-12)
+	{
+		double alpha_old = alpha[i];
+		alpha[i] = CMath::min(CMath::max(alpha[i] - G/QD[i], 0.0), C);
+		double d = (alpha[i] - alpha_old)*yi;
+
+		prob->x->add_to_dense_vec(d, i, w.vector, n);
+
+		if (prob->use_bias)
+		{
+			if (atomic)
+			{
+				#pragma omp atomic
+				w.vector[n]+=d;
+			}
+			else
+				w.vector[n]+=d;
+		}
+	}
+
+	return true;
+}
+
 void CLibLinear::solve_l2r_l1l2_svc(
 			const liblinear_problem *prob, double eps, double Cp, double Cn, LIBLINEAR_SOLVER_TYPE st)
 {
 	int l = prob->l;
 	int w_size = prob->n;
 	int i, s, iter = 0;
-	double C, d, G;
 	double *QD = SG_MALLOC(double, l);
 	int *index = SG_MALLOC(int, l);
 	double *alpha = SG_MALLOC(double, l);
 	int32_t *y = SG_MALLOC(int32_t, l);
+	bool *shrunk = SG_MALLOC(bool, l);
 	int active_size = l;
+	bool w_stale = false;
 
 	// PG: projected gradient, for shrinking and stopping
-	double PG;
 	double PGmax_old = CMath::INFTY;
 	double PGmin_old = -CMath::INFTY;
 	double PGmax_new, PGmin_new;
@@ -307,6 +409,7 @@ void CLibLinear::solve_l2r_l1l2_svc(
 
 		QD[i] += prob->x->dot(i, prob->x,i);
 		index[i] = i;
+		shrunk[i] = false;
 	}
 
 
@@ -325,64 +428,50 @@ void CLibLinear::solve_l2r_l1l2_svc(
 			CMath::swap(index[i], index[j]);
 		}
 
-		for (s=0;s<active_size;s++)
+		int32_t num_blocks=get_num_cd_blocks(active_size, DUAL_CD_MIN_BLOCK_SIZE);
+		if (num_blocks>1)
 		{
-			i = index[s];
-			int32_t yi = y[i];
-
-			G = prob->x->dense_dot(i, w.vector, n);
-			if (prob->use_bias)
-				G+=w.vector[n];
-
-			if (m_linear_term.vector)
-				G = G*yi + m_linear_term.vector[i];
-			else
-				G = G*yi-1;
-
-			C = upper_bound[GETI(i)];
-			G += alpha[i]*diag[GETI(i)];
-
-			PG = 0;
-			if (alpha[i] == 0)
+			// the threads read and update w without locking, so updates of w
+			// may get lost and w is recomputed from alpha before stopping
+			SGVector<float64_t> PGmax_block(num_blocks);
+			SGVector<float64_t> PGmin_block(num_blocks);
+			PGmax_block.set_const(-CMath::INFTY);
+			PGmin_block.set_const(CMath::INFTY);
+
+			#pragma omp parallel for num_threads(num_blocks)
+			for (int32_t block=0; block<num_blocks; block++)
 			{
-				if (G > PGmax_old)
+				int32_t first=(int64_t) block*active_size/num_blocks;
+				int32_t last=(int64_t) (block+1)*active_size/num_blocks;
+				for (int32_t t=first; t<last; t++)
 				{
-					active_size--;
-					CMath::swap(index[s], index[active_size]);
-					s--;
-					continue;
+					shrunk[index[t]]=!update_l2r_l1l2_svc_coordinate(prob,
+						index[t], y, alpha, QD, diag, upper_bound, PGmax_old,
+						PGmin_old, PGmax_block[block], PGmin_block[block], true);
 				}
-				else if (G < 0)
-					PG = G;
 			}
-			else if (alpha[i] == C)
+
+			for (int32_t block=0; block<num_blocks; block++)
+			{
+				PGmax_new=CMath::max(PGmax_new, PGmax_block[block]);
+				PGmin_new=CMath::min(PGmin_new, PGmin_block[block]);
+			}
+
+			active_size=remove_shrunk(index, shrunk, active_size);
+			w_stale=true;
+		}
+		else
+		{
+			for (s=0;s<active_size;s++)
 			{
-				if (G < PGmin_old)
+				if (!update_l2r_l1l2_svc_coordinate(prob, index[s], y, alpha,
+					QD, diag, upper_bound, PGmax_old, PGmin_old, PGmax_new,
+					PGmin_new, false))
 				{
 					active_size--;
 					CMath::swap(index[s], index[active_size]);
 					s--;
-					continue;
 				}
-				else if (G > 0)
-					PG = G;
-			}
-			else
-				PG = G;
-
-			PGmax_new = CMath::max(PGmax_new, PG);
-			PGmin_new = CMath::min(PGmin_new, PG);
-
-			if(fabs(PG) > 1.0e-12)
-			{
-				double alpha_old = alpha[i];
-				alpha[i] = CMath::min(CMath::max(alpha[i] - G/QD[i], 0.0), C);
-				d = (alpha[i] - alpha_old)*yi;
-
-				prob->x->add_to_dense_vec(d, i, w.vector, n);
-
-				if (prob->use_bias)
-					w.vector[n]+=d;
 			}
 		}
 
@@ -392,6 +481,12 @@ void CLibLinear::solve_l2r_l1l2_svc(
 
 		if(gap <= eps)
 		{
+			if (w_stale)
+			{
+				recompute_w(prob, alpha, y);
+				w_stale=false;
+			}
+
 			if(active_size == l)
 				break;
 			else
@@ -410,6 +505,9 @@ void CLibLinear::solve_l2r_l1l2_svc(
 			PGmin_old = -CMath::INFTY;
 	}
 
+	if (w_stale)
+		recompute_w(prob, alpha, y);
+
 	SG_DONE()
 	SG_INFO("optimization finished, #iter = %d\n",iter)
 	if (iter >= max_iterations)
@@ -436,9 +534,30 @@ void CLibLinear::solve_l2r_l1l2_svc(
 	SG_FREE(QD);
 	SG_FREE(alpha);
 	SG_FREE(y);
+	SG_FREE(shrunk);
 	SG_FREE(index);
 }
 
+void CLibLinear::recompute_w(
+	const liblinear_problem *prob, const double *alpha, const int32_t *y)
+{
+	int n = prob->n;
+	if (prob->use_bias)
+		n--;
+
+	memset(w.vector, 0, sizeof(float64_t)*prob->n);
+	for (int32_t i=0; i<prob->l; i++)
+	{
+		if (alpha[i] == 0)
+			continue;
+
+		double d = alpha[i]*y[i];
+		prob->x->add_to_dense_vec(d, i, w.vector, n);
+		if (prob->use_bias)
+			w.vector[n]+=d;
+	}
+}
+
 // A coordinate descent algorithm for
 // L1-regularized L2-loss support vector classification
 //
@@ -454,6 +573,174 @@ void CLibLinear::solve_l2r_l1l2_svc(
 #define GETI(i) (y[i]+1)
 // To support weights for instances, use GETI(i) (i)
 
+bool CLibLinear::update_l1r_l2_svc_coordinate(
+	const liblinear_problem *prob_col, int32_t j, const int32_t *y,
+	const double *C, const double *xj_sq, double *b, double Gmax_old,
+	double &Gmax_new, bool &linesearch_failed, bool atomic)
+{
+	int l = prob_col->l;
+	int max_num_linesearch = 20;
+	double sigma = 0.01;
+
+	CDotFeatures* x = prob_col->x;
+	void* iterator;
+	int32_t ind;
+	float64_t val;
+
+	int n = prob_col->n;
+	if (prob_col->use_bias)
+		n--;
+
+	double G_loss = 0;
+	double H = 0;
+
+	if (use_bias && j==n)
+	{
+		for (ind=0; ind<l; ind++)
+		{
+			if(b[ind] > 0)
+			{
+				double tmp = C[GETI(ind)]*y[ind];
+				G_loss -= tmp*b[ind];
+				H += tmp*y[ind];
+			}
+		}
+	}
+	else
+	{
+		iterator=x->get_feature_iterator(j);
+		while (x->get_next_feature(ind, val, iterator))
+		{
+			if(b[ind] > 0)
+			{
+				double tmp = C[GETI(ind)]*val*y[ind];
+				G_loss -= tmp*b[ind];
+				H += tmp*val*y[ind];
+			}
+		}
+		x->free_feature_iterator(iterator);
+	}
+
+	G_loss *= 2;
+
+	double G = G_loss;
+	H *= 2;
+	H = CMath::max(H, 1e-12);
+
+	double Gp = G+1;
+	double Gn = G-1;
+	double violation = 0;
+	if(w.vector[j] == 0)
+	{
+		if(Gp < 0)
+			violation = -Gp;
+		else if(Gn > 0)
+			violation = Gn;
+		else if(Gp>Gmax_old/l && Gn<-Gmax_old/l)
+			return false;
+	}
+	else if(w.vector[j] > 0)
+		violation = fabs(Gp);
+	else
+		violation = fabs(Gn);
+
+	Gmax_new = CMath::max(Gmax_new, violation);
+
+	// obtain Newton direction d
+	double d;
+	if(Gp <= H*w.vector[j])
+		d = -Gp/H;
+	else if(Gn >= H*w.vector[j])
+		d = -Gn/H;
+	else
+		d = -w.vector[j];
+
+	if(fabs(d) < 1.0e-12)
+		return true;
+
+	// search the step on the residuals b as they are, b is changed only
+	// once the step is accepted
+	double delta = fabs(w.vector[j]+d)-fabs(w.vector[j]) + G*d;
+	int num_linesearch;
+	for(num_linesearch=0; num_linesearch < max_num_linesearch; num_linesearch++)
+	{
+		double cond = fabs(w.vector[j]+d)-fabs(w.vector[j]) - sigma*delta;
+
+		double appxcond = xj_sq[j]*d*d + G_loss*d + cond;
+		if(appxcond <= 0)
+			break;
+
+		double loss_old = 0;
+		double loss_new = 0;
+		if (use_bias && j==n)
+		{
+			for (ind=0; ind<l; ind++)
+			{
+				if(b[ind] > 0)
+					loss_old += C[GETI(ind)]*b[ind]*b[ind];
+				double b_new = b[ind] - d*y[ind];
+				if(b_new > 0)
+					loss_new += C[GETI(ind)]*b_new*b_new;
+			}
+		}
+		else
+		{
+			iterator=x->get_feature_iterator(j);
+			while (x->get_next_feature(ind, val, iterator))
+			{
+				if(b[ind] > 0)
+					loss_old += C[GETI(ind)]*b[ind]*b[ind];
+				double b_new = b[ind] - d*val*y[ind];
+				if(b_new > 0)
+					loss_new += C[GETI(ind)]*b_new*b_new;
+			}
+			x->free_feature_iterator(iterator);
+		}
+
+		if(cond + loss_new - loss_old <= 0)
+			break;
+
+		d *= 0.5;
+		delta *= 0.5;
+	}
+
+	w.vector[j] += d;
+
+	if (use_bias && j==n)
+	{
+		for (ind=0; ind<l; ind++)
+		{
+			if (atomic)
+			{
+				#pragma omp atomic
+				b[ind] -= d*y[ind];
+			}
+			else
+				b[ind] -= d*y[ind];
+		}
+	}
+	else
+	{
+		iterator=x->get_feature_iterator(j);
+		while (x->get_next_feature(ind, val, iterator))
+		{
+			if (atomic)
+			{
+				#pragma omp atomic
+				b[ind] -= d*val*y[ind];
+			}
+			else
+				b[ind] -= d*val*y[ind];
+		}
+		x->free_feature_iterator(iterator);
+	}
+
+	if(num_linesearch >= max_num_linesearch)
+		linesearch_failed = true;
+
+	return true;
+}
+
 void CLibLinear::solve_l1r_l2_svc(
 	liblinear_problem *prob_col, double eps, double Cp, double Cn)
 {
@@ -461,21 +748,16 @@ void CLibLinear::solve_l1r_l2_svc(
 	int w_size = prob_col->n;
 	int j, s, iter = 0;
 	int active_size = w_size;
-	int max_num_linesearch = 20;
 
-	double sigma = 0.01;
-	double d, G_loss, G, H;
 	double Gmax_old = CMath::INFTY;
 	double Gmax_new;
 	double Gmax_init=0;
-	double d_old, d_diff;
-	double loss_old=0, loss_new;
-	double appxcond, cond;
 
 	int *index = SG_MALLOC(int, w_size);
 	int32_t *y = SG_MALLOC(int32_t, l);
 	double *b = SG_MALLOC(double, l); // b = 1-ywTx
 	double *xj_sq = SG_MALLOC(double, w_size);
+	bool *shrunk = SG_MALLOC(bool, w_size);
 
 	CDotFeatures* x = (CDotFeatures*) prob_col->x;
 	void* iterator;
@@ -501,6 +783,7 @@ void CLibLinear::solve_l1r_l2_svc(
 	{
 		w.vector[j] = 0;
 		index[j] = j;
+		shrunk[j] = false;
 		xj_sq[j] = 0;
 
 		if (use_bias && j==n)
@@ -532,204 +815,75 @@ void CLibLinear::solve_l1r_l2_svc(
 			CMath::swap(index[i], index[j]);
 		}
 
-		for(s=0; s<active_size; s++)
+		int32_t num_blocks=get_num_cd_blocks(active_size, PRIMAL_CD_MIN_BLOCK_SIZE);
+		bool failed=false;
+		if (num_blocks>1)
 		{
-			j = index[s];
-			G_loss = 0;
-			H = 0;
-
-			if (use_bias && j==n)
+			// the threads update disjoint features, each one searches its
+			// step on the residuals b as they are and adds its change to b
+			// atomically once the step is accepted
+			SGVector<float64_t> Gmax_block(num_blocks);
+			SGVector<bool> failed_block(num_blocks);
+			Gmax_block.zero();
+			failed_block.set_const(false);
+
+			#pragma omp parallel for num_threads(num_blocks)
+			for (int32_t block=0; block<num_blocks; block++)
 			{
-				for (ind=0; ind<l; ind++)
+				int32_t first=(int64_t) block*active_size/num_blocks;
+				int32_t last=(int64_t) (block+1)*active_size/num_blocks;
+				for (int32_t t=first; t<last; t++)
 				{
-					if(b[ind] > 0)
-					{
-						double tmp = C[GETI(ind)]*y[ind];
-						G_loss -= tmp*b[ind];
-						H += tmp*y[ind];
-					}
+					shrunk[index[t]]=!update_l1r_l2_svc_coordinate(prob_col,
+						index[t], y, C, xj_sq, b, Gmax_old, Gmax_block[block],
+						failed_block[block], true);
 				}
 			}
-			else
-			{
-				iterator=x->get_feature_iterator(j);
 
-				while (x->get_next_feature(ind, val, iterator))
-				{
-					if(b[ind] > 0)
-					{
-						double tmp = C[GETI(ind)]*val*y[ind];
-						G_loss -= tmp*b[ind];
-						H += tmp*val*y[ind];
-					}
-				}
-				x->free_feature_iterator(iterator);
+			for (int32_t block=0; block<num_blocks; block++)
+			{
+				Gmax_new=CMath::max(Gmax_new, Gmax_block[block]);
+				failed|=failed_block[block];
 			}
 
-			G_loss *= 2;
-
-			G = G_loss;
-			H *= 2;
-			H = CMath::max(H, 1e-12);
-
-			double Gp = G+1;
-			double Gn = G-1;
-			double violation = 0;
-			if(w.vector[j] == 0)
+			active_size=remove_shrunk(index, shrunk, active_size);
+		}
+		else
+		{
+			for(s=0; s<active_size; s++)
 			{
-				if(Gp < 0)
-					violation = -Gp;
-				else if(Gn > 0)
-					violation = Gn;
-				else if(Gp>Gmax_old/l && Gn<-Gmax_old/l)
+				if (!update_l1r_l2_svc_coordinate(prob_col, index[s], y, C,
+					xj_sq, b, Gmax_old, Gmax_new, failed, false))
 				{
 					active_size--;
 					CMath::swap(index[s], index[active_size]);
 					s--;
-					continue;
 				}
 			}
-			else if(w.vector[j] > 0)
-				violation = fabs(Gp);
-			else
-				violation = fabs(Gn);
-
-			Gmax_new = CMath::max(Gmax_new, violation);
-
-			// obtain Newton direction d
-			if(Gp <= H*w.vector[j])
-				d = -Gp/H;
-			else if(Gn >= H*w.vector[j])
-				d = -Gn/H;
-			else
-				d = -w.vector[j];
+		}
 
-			if(fabs(d) < 1.0e-12)
-				continue;
+		// recompute b[] if line search takes too many steps
+		if (failed)
+		{
+			SG_INFO("#")
+			for(int i=0; i<l; i++)
+				b[i] = 1;
 
-			double delta = fabs(w.vector[j]+d)-fabs(w.vector[j]) + G*d;
-			d_old = 0;
-			int num_linesearch;
-			for(num_linesearch=0; num_linesearch < max_num_linesearch; num_linesearch++)
+			for(int i=0; i<n; i++)
 			{
-				d_diff = d_old - d;
-				cond = fabs(w.vector[j]+d)-fabs(w.vector[j]) - sigma*delta;
-
-				appxcond = xj_sq[j]*d*d + G_loss*d + cond;
-				if(appxcond <= 0)
-				{
-					if (use_bias && j==n)
-					{
-						for (ind=0; ind<l; ind++)
-							b[ind] += d_diff*y[ind];
-						break;
-					}
-					else
-					{
-						iterator=x->get_feature_iterator(j);
-						while (x->get_next_feature(ind, val, iterator))
-							b[ind] += d_diff*val*y[ind];
-
-						x->free_feature_iterator(iterator);
-						break;
-					}
-				}
-
-				if(num_linesearch == 0)
-				{
-					loss_old = 0;
-					loss_new = 0;
-
-					if (use_bias && j==n)
-					{
-						for (ind=0; ind<l; ind++)
-						{
-							if(b[ind] > 0)
-								loss_old += C[GETI(ind)]*b[ind]*b[ind];
-							double b_new = b[ind] + d_diff*y[ind];
-							b[ind] = b_new;
-							if(b_new > 0)
-								loss_new += C[GETI(ind)]*b_new*b_new;
-						}
-					}
-					else
-					{
-						iterator=x->get_feature_iterator(j);
-						while (x->get_next_feature(ind, val, iterator))
-						{
-							if(b[ind] > 0)
-								loss_old += C[GETI(ind)]*b[ind]*b[ind];
-							double b_new = b[ind] + d_diff*val*y[ind];
-							b[ind] = b_new;
-							if(b_new > 0)
-								loss_new += C[GETI(ind)]*b_new*b_new;
-						}
-						x->free_feature_iterator(iterator);
-					}
-				}
-				else
-				{
-					loss_new = 0;
-					if (use_bias && j==n)
-					{
-						for (ind=0; ind<l; ind++)
-						{
-							double b_new = b[ind] + d_diff*y[ind];
-							b[ind] = b_new;
-							if(b_new > 0)
-								loss_new += C[GETI(ind)]*b_new*b_new;
-						}
-					}
-					else
-					{
-						iterator=x->get_feature_iterator(j);
-						while (x->get_next_feature(ind, val, iterator))
-						{
-							double b_new = b[ind] + d_diff*val*y[ind];
-							b[ind] = b_new;
-							if(b_new > 0)
-								loss_new += C[GETI(ind)]*b_new*b_new;
-						}
-						x->free_feature_iterator(iterator);
-					}
-				}
+				if(w.vector[i]==0)
+					continue;
 
-				cond = cond + loss_new - loss_old;
-				if(cond <= 0)
-					break;
-				else
-				{
-					d_old = d;
-					d *= 0.5;
-					delta *= 0.5;
-				}
+				iterator=x->get_feature_iterator(i);
+				while (x->get_next_feature(ind, val, iterator))
+					b[ind] -= w.vector[i]*val*y[ind];
+				x->free_feature_iterator(iterator);
 			}
 
-			w.vector[j] += d;
-
-			// recompute b[] if line search takes too many steps
-			if(num_linesearch >= max_num_linesearch)
+			if (use_bias && w.vector[n])
 			{
-				SG_INFO("#")
-				for(int i=0; i<l; i++)
-					b[i] = 1;
-
-				for(int i=0; i<n; i++)
-				{
-					if(w.vector[i]==0)
-						continue;
-
-					iterator=x->get_feature_iterator(i);
-					while (x->get_next_feature(ind, val, iterator))
-						b[ind] -= w.vector[i]*val*y[ind];
-					x->free_feature_iterator(iterator);
-				}
-
-				if (use_bias && w.vector[n])
-				{
-					for (ind=0; ind<l; ind++)
-						b[ind] -= w.vector[n]*y[ind];
-				}
+				for (ind=0; ind<l; ind++)
+					b[ind] -= w.vector[n]*y[ind];
 			}
 		}
 
@@ -783,6 +937,7 @@ void CLibLinear::solve_l1r_l2_svc(
 	SG_FREE(y);
 	SG_FREE(b);
 	SG_FREE(xj_sq);
+	SG_FREE(shrunk);
 }
 
 // A coordinate descent algorithm for
@@ -800,6 +955,179 @@ void CLibLinear::solve_l1r_l2_svc(
 #define GETI(i) (y[i]+1)
 // To support weights for instances, use GETI(i) (i)
 
+bool CLibLinear::update_l1r_lr_coordinate(
+	const liblinear_problem *prob_col, int32_t j, const int32_t *y,
+	const double *C, double x_min, const double *xj_max, const double *C_sum,
+	const double *xjneg_sum, const double *xjpos_sum, double *exp_wTx,
+	double Gmax_old, double &Gmax_new, bool &linesearch_failed, bool atomic)
+{
+	int l = prob_col->l;
+	int max_num_linesearch = 20;
+	double sigma = 0.01;
+
+	CDotFeatures* x = prob_col->x;
+	void* iterator;
+	int ind;
+	double val;
+
+	int n = prob_col->n;
+	if (prob_col->use_bias)
+		n--;
+
+	double sum1 = 0;
+	double sum2 = 0;
+	double H = 0;
+
+	if (use_bias && j==n)
+	{
+		for (ind=0; ind<l; ind++)
+		{
+			double exp_wTxind = exp_wTx[ind];
+			double tmp1 = 1.0/(1+exp_wTxind);
+			double tmp2 = C[GETI(ind)]*tmp1;
+			double tmp3 = tmp2*exp_wTxind;
+			sum2 += tmp2;
+			sum1 += tmp3;
+			H += tmp1*tmp3;
+		}
+	}
+	else
+	{
+		iterator=x->get_feature_iterator(j);
+		while (x->get_next_feature(ind, val, iterator))
+		{
+			double exp_wTxind = exp_wTx[ind];
+			double tmp1 = val/(1+exp_wTxind);
+			double tmp2 = C[GETI(ind)]*tmp1;
+			double tmp3 = tmp2*exp_wTxind;
+			sum2 += tmp2;
+			sum1 += tmp3;
+			H += tmp1*tmp3;
+		}
+		x->free_feature_iterator(iterator);
+	}
+
+	double G = -sum2 + xjneg_sum[j];
+
+	double Gp = G+1;
+	double Gn = G-1;
+	double violation = 0;
+	if(w.vector[j] == 0)
+	{
+		if(Gp < 0)
+			violation = -Gp;
+		else if(Gn > 0)
+			violation = Gn;
+		else if(Gp>Gmax_old/l && Gn<-Gmax_old/l)
+			return false;
+	}
+	else if(w.vector[j] > 0)
+		violation = fabs(Gp);
+	else
+		violation = fabs(Gn);
+
+	Gmax_new = CMath::max(Gmax_new, violation);
+
+	// obtain Newton direction d
+	double d;
+	if(Gp <= H*w.vector[j])
+		d = -Gp/H;
+	else if(Gn >= H*w.vector[j])
+		d = -Gn/H;
+	else
+		d = -w.vector[j];
+
+	if(fabs(d) < 1.0e-12)
+		return true;
+
+	d = CMath::min(CMath::max(d,-10.0),10.0);
+
+	// search the step on exp_wTx as it is, exp_wTx is changed only once
+	// the step is accepted
+	double delta = fabs(w.vector[j]+d)-fabs(w.vector[j]) + G*d;
+	int num_linesearch;
+	for(num_linesearch=0; num_linesearch < max_num_linesearch; num_linesearch++)
+	{
+		double cond = fabs(w.vector[j]+d)-fabs(w.vector[j]) - sigma*delta;
+
+		if(x_min >= 0)
+		{
+			double tmp = exp(d*xj_max[j]);
+			double appxcond1 = log(1+sum1*(tmp-1)/xj_max[j]/C_sum[j])*C_sum[j] + cond - d*xjpos_sum[j];
+			double appxcond2 = log(1+sum2*(1/tmp-1)/xj_max[j]/C_sum[j])*C_sum[j] + cond + d*xjneg_sum[j];
+			if(CMath::min(appxcond1,appxcond2) <= 0)
+				break;
+		}
+
+		cond += d*xjneg_sum[j];
+
+		if (use_bias && j==n)
+		{
+			double exp_dx = exp(d);
+			for (ind=0; ind<l; ind++)
+			{
+				double exp_wTxind = exp_wTx[ind]*exp_dx;
+				cond += C[GETI(ind)]*log((1+exp_wTxind)/(exp_dx+exp_wTxind));
+			}
+		}
+		else
+		{
+			iterator=x->get_feature_iterator(j);
+			while (x->get_next_feature(ind, val, iterator))
+			{
+				double exp_dx = exp(d*val);
+				double exp_wTxind = exp_wTx[ind]*exp_dx;
+				cond += C[GETI(ind)]*log((1+exp_wTxind)/(exp_dx+exp_wTxind));
+			}
+			x->free_feature_iterator(iterator);
+		}
+
+		if(cond <= 0)
+			break;
+
+		d *= 0.5;
+		delta *= 0.5;
+	}
+
+	w.vector[j] += d;
+
+	if (use_bias && j==n)
+	{
+		double exp_dx = exp(d);
+		for (ind=0; ind<l; ind++)
+		{
+			if (atomic)
+			{
+				#pragma omp atomic
+				exp_wTx[ind] *= exp_dx;
+			}
+			else
+				exp_wTx[ind] *= exp_dx;
+		}
+	}
+	else
+	{
+		iterator=x->get_feature_iterator(j);
+		while (x->get_next_feature(ind, val, iterator))
+		{
+			double exp_dx = exp(d*val);
+			if (atomic)
+			{
+				#pragma omp atomic
+				exp_wTx[ind] *= exp_dx;
+			}
+			else
+				exp_wTx[ind] *= exp_dx;
+		}
+		x->free_feature_iterator(iterator);
+	}
+
+	if(num_linesearch >= max_num_linesearch)
+		linesearch_failed = true;
+
+	return true;
+}
+
 void CLibLinear::solve_l1r_lr(
 	const liblinear_problem *prob_col, double eps,
 	double Cp, double Cn)
@@ -808,26 +1136,20 @@ void CLibLinear::solve_l1r_lr(
 	int w_size = prob_col->n;
 	int j, s, iter = 0;
 	int active_size = w_size;
-	int max_num_linesearch = 20;
 
 	double x_min = 0;
-	double sigma = 0.01;
-	double d, G, H;
 	double Gmax_old = CMath::INFTY;
 	double Gmax_new;
 	double Gmax_init=0;
-	double sum1, appxcond1;
-	double sum2, appxcond2;
-	double cond;
 
 	int *index = SG_MALLOC(int, w_size);
 	int32_t *y = SG_MALLOC(int32_t, l);
 	double *exp_wTx = SG_MALLOC(double, l);
-	double *exp_wTx_new = SG_MALLOC(double, l);
 	double *xj_max = SG_MALLOC(double, w_size);
 	double *C_sum = SG_MALLOC(double, w_size);
 	double *xjneg_sum = SG_MALLOC(double, w_size);
 	double *xjpos_sum = SG_MALLOC(double, w_size);
+	bool *shrunk = SG_MALLOC(bool, w_size);
 
 	CDotFeatures* x = prob_col->x;
 	void* iterator;
@@ -852,6 +1174,7 @@ void CLibLinear::solve_l1r_lr(
 	{
 		w.vector[j] = 0;
 		index[j] = j;
+		shrunk[j] = false;
 		xj_max[j] = 0;
 		C_sum[j] = 0;
 		xjneg_sum[j] = 0;
@@ -901,199 +1224,82 @@ void CLibLinear::solve_l1r_lr(
 			CMath::swap(index[i], index[j]);
 		}
 
-		for(s=0; s<active_size; s++)
+		int32_t num_blocks=get_num_cd_blocks(active_size, PRIMAL_CD_MIN_BLOCK_SIZE);
+		bool failed=false;
+		if (num_blocks>1)
 		{
-			j = index[s];
-			sum1 = 0;
-			sum2 = 0;
-			H = 0;
-
-			if (use_bias && j==n)
+			// the threads update disjoint features, each one searches its
+			// step on exp_wTx as it is and applies its change to exp_wTx
+			// atomically once the step is accepted
+			SGVector<float64_t> Gmax_block(num_blocks);
+			SGVector<bool> failed_block(num_blocks);
+			Gmax_block.zero();
+			failed_block.set_const(false);
+
+			#pragma omp parallel for num_threads(num_blocks)
+			for (int32_t block=0; block<num_blocks; block++)
 			{
-				for (ind=0; ind<l; ind++)
+				int32_t first=(int64_t) block*active_size/num_blocks;
+				int32_t last=(int64_t) (block+1)*active_size/num_blocks;
+				for (int32_t t=first; t<last; t++)
 				{
-					double exp_wTxind = exp_wTx[ind];
-					double tmp1 = 1.0/(1+exp_wTxind);
-					double tmp2 = C[GETI(ind)]*tmp1;
-					double tmp3 = tmp2*exp_wTxind;
-					sum2 += tmp2;
-					sum1 += tmp3;
-					H += tmp1*tmp3;
+					shrunk[index[t]]=!update_l1r_lr_coordinate(prob_col,
+						index[t], y, C, x_min, xj_max, C_sum, xjneg_sum,
+						xjpos_sum, exp_wTx, Gmax_old, Gmax_block[block],
+						failed_block[block], true);
 				}
 			}
-			else
+
+			for (int32_t block=0; block<num_blocks; block++)
 			{
-				iterator=x->get_feature_iterator(j);
-				while (x->get_next_feature(ind, val, iterator))
-				{
-					double exp_wTxind = exp_wTx[ind];
-					double tmp1 = val/(1+exp_wTxind);
-					double tmp2 = C[GETI(ind)]*tmp1;
-					double tmp3 = tmp2*exp_wTxind;
-					sum2 += tmp2;
-					sum1 += tmp3;
-					H += tmp1*tmp3;
-				}
-				x->free_feature_iterator(iterator);
+				Gmax_new=CMath::max(Gmax_new, Gmax_block[block]);
+				failed|=failed_block[block];
 			}
 
-			G = -sum2 + xjneg_sum[j];
-
-			double Gp = G+1;
-			double Gn = G-1;
-			double violation = 0;
-			if(w.vector[j] == 0)
+			active_size=remove_shrunk(index, shrunk, active_size);
+		}
+		else
+		{
+			for(s=0; s<active_size; s++)
 			{
-				if(Gp < 0)
-					violation = -Gp;
-				else if(Gn > 0)
-					violation = Gn;
-				else if(Gp>Gmax_old/l && Gn<-Gmax_old/l)
+				if (!update_l1r_lr_coordinate(prob_col, index[s], y, C, x_min,
+					xj_max, C_sum, xjneg_sum, xjpos_sum, exp_wTx, Gmax_old,
+					Gmax_new, failed, false))
 				{
 					active_size--;
 					CMath::swap(index[s], index[active_size]);
 					s--;
-					continue;
 				}
 			}
-			else if(w.vector[j] > 0)
-				violation = fabs(Gp);
-			else
-				violation = fabs(Gn);
-
-			Gmax_new = CMath::max(Gmax_new, violation);
-
-			// obtain Newton direction d
-			if(Gp <= H*w.vector[j])
-				d = -Gp/H;
-			else if(Gn >= H*w.vector[j])
-				d = -Gn/H;
-			else
-				d = -w.vector[j];
-
-			if(fabs(d) < 1.0e-12)
-				continue;
+		}
 
-			d = CMath::min(CMath::max(d,-10.0),10.0);
+		// recompute exp_wTx[] if line search takes too many steps
+		if (failed)
+		{
+			SG_INFO("#")
+			for(int i=0; i<l; i++)
+				exp_wTx[i] = 0;
 
-			double delta = fabs(w.vector[j]+d)-fabs(w.vector[j]) + G*d;
-			int num_linesearch;
-			for(num_linesearch=0; num_linesearch < max_num_linesearch; num_linesearch++)
+			for(int i=0; i<w_size; i++)
 			{
-				cond = fabs(w.vector[j]+d)-fabs(w.vector[j]) - sigma*delta;
+				if(w.vector[i]==0) continue;
 
-				if(x_min >= 0)
-				{
-					double tmp = exp(d*xj_max[j]);
-					appxcond1 = log(1+sum1*(tmp-1)/xj_max[j]/C_sum[j])*C_sum[j] + cond - d*xjpos_sum[j];
-					appxcond2 = log(1+sum2*(1/tmp-1)/xj_max[j]/C_sum[j])*C_sum[j] + cond + d*xjneg_sum[j];
-					if(CMath::min(appxcond1,appxcond2) <= 0)
-					{
-						if (use_bias && j==n)
-						{
-							for (ind=0; ind<l; ind++)
-								exp_wTx[ind] *= exp(d);
-						}
-
-						else
-						{
-							iterator=x->get_feature_iterator(j);
-							while (x->get_next_feature(ind, val, iterator))
-								exp_wTx[ind] *= exp(d*val);
-							x->free_feature_iterator(iterator);
-						}
-						break;
-					}
-				}
-
-				cond += d*xjneg_sum[j];
-
-				int i = 0;
-
-				if (use_bias && j==n)
+				if (use_bias && i==n)
 				{
 					for (ind=0; ind<l; ind++)
-					{
-						double exp_dx = exp(d);
-						exp_wTx_new[i] = exp_wTx[ind]*exp_dx;
-						cond += C[GETI(ind)]*log((1+exp_wTx_new[i])/(exp_dx+exp_wTx_new[i]));
-						i++;
-					}
+						exp_wTx[ind] += w.vector[i];
 				}
 				else
 				{
-
-					iterator=x->get_feature_iterator(j);
+					iterator=x->get_feature_iterator(i);
 					while (x->get_next_feature(ind, val, iterator))
-					{
-						double exp_dx = exp(d*val);
-						exp_wTx_new[i] = exp_wTx[ind]*exp_dx;
-						cond += C[GETI(ind)]*log((1+exp_wTx_new[i])/(exp_dx+exp_wTx_new[i]));
-						i++;
-					}
+						exp_wTx[ind] += w.vector[i]*val;
 					x->free_feature_iterator(iterator);
 				}
-
-				if(cond <= 0)
-				{
-					i = 0;
-					if (use_bias && j==n)
-					{
-						for (ind=0; ind<l; ind++)
-						{
-							exp_wTx[ind] = exp_wTx_new[i];
-							i++;
-						}
-					}
-					else
-					{
-						iterator=x->get_feature_iterator(j);
-						while (x->get_next_feature(ind, val, iterator))
-						{
-							exp_wTx[ind] = exp_wTx_new[i];
-							i++;
-						}
-						x->free_feature_iterator(iterator);
-					}
-					break;
-				}
-				else
-				{
-					d *= 0.5;
-					delta *= 0.5;
-				}
 			}
 
-			w.vector[j] += d;
-
-			// recompute exp_wTx[] if line search takes too many steps
-			if(num_linesearch >= max_num_linesearch)
-			{
-				SG_INFO("#")
-				for(int i=0; i<l; i++)
-					exp_wTx[i] = 0;
-
-				for(int i=0; i<w_size; i++)
-				{
-					if(w.vector[i]==0) continue;
-
-					if (use_bias && i==n)
-					{
-						for (ind=0; ind<l; ind++)
-							exp_wTx[ind] += w.vector[i];
-					}
-					else
-					{
-						iterator=x->get_feature_iterator(i);
-						while (x->get_next_feature(ind, val, iterator))
-							exp_wTx[ind] += w.vector[i]*val;
-						x->free_feature_iterator(iterator);
-					}
-				}
-
-				for(int i=0; i<l; i++)
-					exp_wTx[i] = exp(exp_wTx[i]);
-			}
+			for(int i=0; i<l; i++)
+				exp_wTx[i] = exp(exp_wTx[i]);
 		}
 
 		if(iter == 0)
@@ -1143,11 +1349,11 @@ void CLibLinear::solve_l1r_lr(
 	SG_FREE(index);
 	SG_FREE(y);
 	SG_FREE(exp_wTx);
-	SG_FREE(exp_wTx_new);
 	SG_FREE(xj_max);
 	SG_FREE(C_sum);
 	SG_FREE(xjneg_sum);
 	SG_FREE(xjpos_sum);
+	SG_FREE(shrunk);
 }
 
 // A coordinate descent algorithm for
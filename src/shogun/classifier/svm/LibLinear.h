@@ -56,7 +56,22 @@ namespace shogun
  *
  * See the ::LIBLINEAR_SOLVER_TYPE enum for types of solvers.
  *
+ * The coordinate descent solvers L2R_L2LOSS_SVC_DUAL, L2R_L1LOSS_SVC_DUAL,
+ * L1R_L2LOSS_SVC and L1R_LR can use several threads, see
+ * set_parallel_coordinate_descent(). The dual solvers then update the
+ * coordinates asynchronously without locking w [2], the L1 regularized
+ * solvers update blocks of features in parallel and add the changes to the
+ * shared per-sample state atomically [3]. Both give slightly different (and
+ * not reproducible) results than the serial solvers but stop with the same
+ * convergence checks.
+ *
  * [1] http://www.csie.ntu.edu.tw/~cjlin/liblinear/
+ *
+ * [2] Hsieh, C.-J., Yu, H.-F. and Dhillon, I. S. (2015). PASSCoDe: Parallel
+ * ASynchronous Stochastic dual Co-ordinate Descent. ICML.
+ *
+ * [3] Bradley, J. K., Kyrola, A., Bickson, D. and Guestrin, C. (2011).
+ * Parallel Coordinate Descent for L1-Regularized Loss Minimization. ICML.
  * */
 class CLibLinear : public CLinearMachine
 {
@@ -166,6 +181,22 @@ class CLibLinear : public CLinearMachine
 			max_iterations=max_iter;
 		}
 
+		/** set whether the coordinate descent solvers use several threads
+		 * (as many as parallel->get_num_threads())
+		 *
+		 * @param parallel_cd whether to use parallel coordinate descent
+		 */
+		inline void set_parallel_coordinate_descent(bool parallel_cd)
+		{
+			parallel_coordinate_descent=parallel_cd;
+		}
+
+		/** @return whether the coordinate descent solvers use several threads */
+		inline bool get_parallel_coordinate_descent()
+		{
+			return parallel_coordinate_descent;
+		}
+
 		/** set the linear term for qp */
 		void set_linear_term(const SGVector<float64_t> linear_term);
 
@@ -198,6 +229,52 @@ class CLibLinear : public CLinearMachine
 		void solve_l1r_lr(const liblinear_problem *prob_col, double eps, double Cp, double Cn);
 		void solve_l2r_lr_dual(const liblinear_problem *prob, double eps, double Cp, double Cn);
 
+		/** update coordinate i of the dual coordinate descent of
+		 * solve_l2r_l1l2_svc, the bias part of w is updated atomically if
+		 * atomic is set
+		 *
+		 * @return false if the coordinate shall be shrunk
+		 */
+		bool update_l2r_l1l2_svc_coordinate(
+			const liblinear_problem *prob, int32_t i, const int32_t *y, double *alpha,
+			const double *QD, const double *diag, const double *upper_bound,
+			double PGmax_old, double PGmin_old, double &PGmax_new, double &PGmin_new,
+			bool atomic);
+
+		/** update feature j of the coordinate descent of solve_l1r_l2_svc,
+		 * the residuals b are updated atomically if atomic is set and
+		 * linesearch_failed is set if the line search did not converge
+		 *
+		 * @return false if the coordinate shall be shrunk
+		 */
+		bool update_l1r_l2_svc_coordinate(
+			const liblinear_problem *prob_col, int32_t j, const int32_t *y,
+			const double *C, const double *xj_sq, double *b, double Gmax_old,
+			double &Gmax_new, bool &linesearch_failed, bool atomic);
+
+		/** update feature j of the coordinate descent of solve_l1r_lr,
+		 * exp_wTx is updated atomically if atomic is set and
+		 * linesearch_failed is set if the line search did not converge
+		 *
+		 * @return false if the coordinate shall be shrunk
+		 */
+		bool update_l1r_lr_coordinate(
+			const liblinear_problem *prob_col, int32_t j, const int32_t *y,
+			const double *C, double x_min, const double *xj_max, const double *C_sum,
+			const double *xjneg_sum, const double *xjpos_sum, double *exp_wTx,
+			double Gmax_old, double &Gmax_new, bool &linesearch_failed, bool atomic);
+
+		/** set w to sum_i alpha_i y_i x_i (and the bias to sum_i alpha_i
+		 * y_i), after parallel sweeps of the dual solvers lost updates of w
+		 */
+		void recompute_w(const liblinear_problem *prob, const double *alpha, const int32_t *y);
+
+		/** @param num_coordinates number of coordinates of a sweep
+		 * @param min_block_size minimal number of coordinates per thread
+		 * @return number of threads a coordinate descent sweep uses
+		 */
+		int32_t get_num_cd_blocks(int32_t num_coordinates, int32_t min_block_size);
+
 
 	protected:
 		/** C1 */
@@ -210,6 +287,8 @@ class CLibLinear : public CLinearMachine
 		float64_t epsilon;
 		/** maximum number of iterations */
 		int32_t max_iterations;
+		/** whether coordinate descent uses several threads */
+		bool parallel_coordinate_descent;
 
 		/** precomputed linear term */
 		SGVector<float64_t> m_linear_term;
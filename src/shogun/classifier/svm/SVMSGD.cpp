@@ -116,37 +116,75 @@ bool CSVMSGD::train_machine(CFeatures* data)
 	if ((loss_type == L_LOGLOSS) || (loss_type == L_LOGLOSSMARGIN))
 		is_log_loss = true;
 
-	for(int32_t e=0; e<epochs && (!CSignal::cancel_computations()); e++)
+	int32_t num_threads=CMath::min(parallel->get_num_threads(), num_vec);
+	if (parallel_mode==PSGD_SERIAL || num_threads<2)
 	{
-		count = skip;
-		for (int32_t i=0; i<num_vec; i++)
+		for(int32_t e=0; e<epochs && (!CSignal::cancel_computations()); e++)
 		{
-			float64_t eta = 1.0 / (lambda * t);
-			float64_t y = ((CBinaryLabels*) m_labels)->get_label(i);
-			float64_t z = y * (features->dense_dot(i, w.vector, w.vlen) + bias);
+			count = skip;
+			t=sgd_range(w.vector, &bias, 0, num_vec, t, 1, lambda, is_log_loss, count);
+		}
+	}
+	else
+	{
+		SG_INFO("Training with %d threads\n", num_threads)
+
+		// private weights of the threads in PSGD_AVERAGED mode
+		SGMatrix<float64_t> thread_w;
+		SGVector<float64_t> thread_bias;
+		if (parallel_mode==PSGD_AVERAGED)
+		{
+			thread_w=SGMatrix<float64_t>(w.vlen, num_threads);
+			thread_bias=SGVector<float64_t>(num_threads);
+		}
+
+		for(int32_t e=0; e<epochs && (!CSignal::cancel_computations()); e++)
+		{
+			if (parallel_mode==PSGD_AVERAGED)
+			{
+				for (int32_t k=0; k<num_threads; k++)
+				{
+					memcpy(thread_w.get_column_vector(k), w.vector, w.vlen*sizeof(float64_t));
+					thread_bias[k]=bias;
+				}
+			}
 
-			if (z < 1 || is_log_loss)
+			/* thread k does every num_threads-th step of a serial epoch, so the
+			 * learning rates of all steps are the same as in serial mode */
+#pragma omp parallel for num_threads(num_threads)
+			for (int32_t k=0; k<num_threads; k++)
 			{
-				float64_t etd = -eta * loss->first_derivative(z,1);
-				features->add_to_dense_vec(etd * y / wscale, i, w.vector, w.vlen);
+				int32_t first=int64_t(num_vec)*k/num_threads;
+				int32_t last=int64_t(num_vec)*(k+1)/num_threads;
+				int32_t skip_count=skip;
 
-				if (use_bias)
+				if (parallel_mode==PSGD_AVERAGED)
 				{
-					if (use_regularized_bias)
-						bias *= 1 - eta * lambda * bscale;
-					bias += etd * y * bscale;
+					sgd_range(thread_w.get_column_vector(k), &thread_bias[k], first,
+							last, t+k, num_threads, lambda, is_log_loss, skip_count);
+				}
+				else
+				{
+					// Hogwild!, w and bias are shared without locks
+					sgd_range(w.vector, &bias, first, last, t+k, num_threads,
+							lambda, is_log_loss, skip_count);
 				}
 			}
 
-			if (--count <= 0)
+			if (parallel_mode==PSGD_AVERAGED)
 			{
-				float64_t r = 1 - eta * lambda * skip;
-				if (r < 0.8)
-					r = pow(1 - eta * lambda, skip);
-				SGVector<float64_t>::scale_vector(r, w.vector, w.vlen);
-				count = skip;
+				w.zero();
+				bias=0;
+				for (int32_t k=0; k<num_threads; k++)
+				{
+					float64_t weight=float64_t(int64_t(num_vec)*(k+1)/num_threads-
+							int64_t(num_vec)*k/num_threads)/num_vec;
+					SGVector<float64_t>::vec1_plus_scalar_times_vec2(w.vector,
+							weight, thread_w.get_column_vector(k), w.vlen);
+					bias+=weight*thread_bias[k];
+				}
 			}
-			t++;
+			t+=num_vec;
 		}
 	}
 
@@ -156,6 +194,45 @@ bool CSVMSGD::train_machine(CFeatures* data)
 	return true;
 }
 
+float64_t CSVMSGD::sgd_range(float64_t* w_vec, float64_t* b, int32_t first,
+		int32_t last, float64_t t_first, int32_t t_stride, float64_t lambda,
+		bool is_log_loss, int32_t& skip_count)
+{
+	int32_t w_len=w.vlen;
+	float64_t t_cur=t_first;
+	for (int32_t i=first; i<last; i++)
+	{
+		float64_t eta = 1.0 / (lambda * t_cur);
+		float64_t y = ((CBinaryLabels*) m_labels)->get_label(i);
+		float64_t z = y * (features->dense_dot(i, w_vec, w_len) + *b);
+
+		if (z < 1 || is_log_loss)
+		{
+			float64_t etd = -eta * loss->first_derivative(z,1);
+			features->add_to_dense_vec(etd * y / wscale, i, w_vec, w_len);
+
+			if (use_bias)
+			{
+				if (use_regularized_bias)
+					*b *= 1 - eta * lambda * bscale;
+				*b += etd * y * bscale;
+			}
+		}
+
+		if (--skip_count <= 0)
+		{
+			float64_t r = 1 - eta * lambda * skip;
+			if (r < 0.8)
+				r = pow(1 - eta * lambda, skip);
+			SGVector<float64_t>::scale_vector(r, w_vec, w_len);
+			skip_count = skip;
+		}
+		t_cur+=t_stride;
+	}
+
+	return t_cur;
+}
+
 void CSVMSGD::calibrate()
 {
 	ASSERT(features)
@@ -208,6 +285,7 @@ void CSVMSGD::init()
 	use_bias=true;
 
 	use_regularized_bias=false;
+	parallel_mode=PSGD_SERIAL;
 
 	loss=new CHingeLoss();
 	SG_REF(loss);
@@ -221,4 +299,5 @@ void CSVMSGD::init()
     m_parameters->add(&count, "count",  "count");
     m_parameters->add(&use_bias, "use_bias",  "Indicates if bias is used.");
     m_parameters->add(&use_regularized_bias, "use_regularized_bias",  "Indicates if bias is regularized.");
+    m_parameters->add((machine_int_t*) &parallel_mode, "parallel_mode",  "How training is parallelized.");
 }
@@ -29,6 +29,7 @@
 #include <shogun/features/DotFeatures.h>
 #include <shogun/labels/Labels.h>
 #include <shogun/loss/LossFunction.h>
+#include <shogun/optimization/SGDMinimizer.h>
 
 namespace shogun
 {
@@ -123,6 +124,21 @@ class CSVMSGD : public CLinearMachine
 		 */
 		inline bool get_regularized_bias_enabled() { return use_regularized_bias; }
 
+		/** set how training is parallelized. PSGD_HOGWILD and PSGD_AVERAGED
+		 * split the training vectors between parallel->get_num_threads()
+		 * threads, see EParallelSGDMode. With one thread, training is serial
+		 * in every mode
+		 *
+		 * @param mode parallel mode, PSGD_SERIAL by default
+		 */
+		inline void set_parallel_mode(EParallelSGDMode mode) { parallel_mode=mode; }
+
+		/** get parallel mode
+		 *
+		 * @return parallel mode
+		 */
+		inline EParallelSGDMode get_parallel_mode() { return parallel_mode; }
+
 		/** Set the loss function to use
 		 *
 		 * @param loss_func object derived from CLossFunction
@@ -142,6 +158,23 @@ class CSVMSGD : public CLinearMachine
 		/** calibrate */
 		void calibrate();
 
+		/** do SGD steps on a range of training vectors
+		 *
+		 * @param w_vec weight vector to update
+		 * @param b bias to update
+		 * @param first first training vector
+		 * @param last training vector after the last one
+		 * @param t_first t of the first step
+		 * @param t_stride increment of t between steps
+		 * @param lambda regularization parameter
+		 * @param is_log_loss whether every vector causes an update
+		 * @param skip_count steps until the next weight decay, updated
+		 * @return t after the last step
+		 */
+		float64_t sgd_range(float64_t* w_vec, float64_t* b, int32_t first, int32_t last,
+				float64_t t_first, int32_t t_stride, float64_t lambda,
+				bool is_log_loss, int32_t& skip_count);
+
 		/** train classifier
 		 *
 		 * @param data training data (parameter can be avoided if distance or
@@ -168,6 +201,9 @@ class CSVMSGD : public CLinearMachine
 		bool use_bias;
 		bool use_regularized_bias;
 
+		/** parallel mode */
+		EParallelSGDMode parallel_mode;
+
 		CLossFunction* loss;
 };
 }
@@ -19,11 +19,51 @@
 #include <shogun/mathematics/lapack.h>
 #include <shogun/labels/MulticlassLabels.h>
 #include <shogun/multiclass/KNN.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/base/Parallel.h>
+#include <shogun/mathematics/eigen3.h>
 
 #include <vector>
 
 using namespace shogun;
 using namespace std;
+using namespace Eigen;
+
+/* number of vectors processed at once when computing log densities */
+#define GMM_BLOCK_SIZE 1024
+
+/* log-sum-exp over the components of every vector. Writes the log
+ * posteriors to log_post (may alias log_pxy) and the log marginals to
+ * log_px, returns the log likelihood of all vectors.
+ */
+static float64_t normalize_log_densities(float64_t* log_pxy, float64_t* log_post,
+		float64_t* log_px, int32_t num_comp, int32_t num_vectors)
+{
+#pragma omp parallel for
+	for (int32_t i=0; i<num_vectors; i++)
+	{
+		Map<VectorXd> lpxy(log_pxy+int64_t(i)*num_comp, num_comp);
+		Map<VectorXd> lpost(log_post+int64_t(i)*num_comp, num_comp);
+		float64_t max_lpxy=lpxy.maxCoeff();
+
+		if (max_lpxy==-CMath::INFTY)
+		{
+			log_px[i]=max_lpxy;
+			lpost.fill(-CMath::log(num_comp));
+			continue;
+		}
+
+		log_px[i]=max_lpxy+CMath::log((lpxy.array()-max_lpxy).exp().sum());
+		lpost=lpxy.array()-log_px[i];
+	}
+
+	/* sum serially so that the result does not depend on the threads */
+	float64_t log_likelihood=0;
+	for (int32_t i=0; i<num_vectors; i++)
+		log_likelihood+=log_px[i];
+
+	return log_likelihood;
+}
 
 CGMM::CGMM() : CDistribution(), m_components(),	m_coefficients()
 {
@@ -154,44 +194,31 @@ float64_t CGMM::train_em(float64_t min_cov, int32_t max_iter, float64_t min_chan
 	int32_t iter=0;
 	float64_t log_likelihood_prev=0;
 	float64_t log_likelihood_cur=0;
-	float64_t* logPxy=SG_MALLOC(float64_t, num_vectors*m_components.size());
+	int32_t num_comp=int32_t(m_components.size());
+	SGMatrix<float64_t> data=get_data_matrix();
 	float64_t* logPx=SG_MALLOC(float64_t, num_vectors);
-	//float64_t* logPost=SG_MALLOC(float64_t, num_vectors*m_components.vlen);
 
 	while (iter<max_iter)
 	{
 		log_likelihood_prev=log_likelihood_cur;
-		log_likelihood_cur=0;
 
-		for (int32_t i=0; i<num_vectors; i++)
-		{
-			logPx[i]=0;
-			SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(i);
-			for (int32_t j=0; j<int32_t(m_components.size()); j++)
-			{
-				logPxy[i*m_components.size()+j]=m_components[j]->compute_log_PDF(v)+CMath::log(m_coefficients[j]);
-				logPx[i]+=CMath::exp(logPxy[i*m_components.size()+j]);
-			}
+		/* posteriors are computed in place of the joint log densities */
+		compute_log_densities(data, alpha.matrix);
+		log_likelihood_cur=normalize_log_densities(alpha.matrix, alpha.matrix,
+				logPx, num_comp, num_vectors);
 
-			logPx[i]=CMath::log(logPx[i]);
-			log_likelihood_cur+=logPx[i];
-
-			for (int32_t j=0; j<int32_t(m_components.size()); j++)
-			{
-				//logPost[i*m_components.vlen+j]=logPxy[i*m_components.vlen+j]-logPx[i];
-				alpha.matrix[i*m_components.size()+j]=CMath::exp(logPxy[i*m_components.size()+j]-logPx[i]);
-			}
-		}
+#pragma omp parallel for
+		for (int64_t i=0; i<int64_t(num_vectors)*num_comp; i++)
+			alpha.matrix[i]=CMath::exp(alpha.matrix[i]);
 
 		if (iter>0 && log_likelihood_cur-log_likelihood_prev<min_change)
 			break;
 
-		max_likelihood(alpha, min_cov);
+		max_likelihood(alpha, min_cov, data);
 
 		iter++;
 	}
 
-	SG_FREE(logPxy);
 	SG_FREE(logPx);
 
 	return log_likelihood_cur;
@@ -209,6 +236,7 @@ float64_t CGMM::train_smem(int32_t max_iter, int32_t max_cand, float64_t min_cov
 	int32_t num_vectors=dotdata->get_num_vectors();
 
 	float64_t cur_likelihood=train_em(min_cov, max_em_iter, min_change);
+	SGMatrix<float64_t> data=get_data_matrix();
 
 	int32_t iter=0;
 	float64_t* logPxy=SG_MALLOC(float64_t, num_vectors*m_components.size());
@@ -227,21 +255,13 @@ float64_t CGMM::train_smem(int32_t max_iter, int32_t max_cand, float64_t min_cov
 		memset(logPostSum, 0, m_components.size()*sizeof(float64_t));
 		memset(logPostSum2, 0, m_components.size()*sizeof(float64_t));
 		memset(logPostSumSum, 0, (m_components.size()*(m_components.size()-1)/2)*sizeof(float64_t));
+		compute_log_densities(data, logPxy);
+		normalize_log_densities(logPxy, logPost, logPx, int32_t(m_components.size()), num_vectors);
+
 		for (int32_t i=0; i<num_vectors; i++)
 		{
-			logPx[i]=0;
-			SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(i);
 			for (int32_t j=0; j<int32_t(m_components.size()); j++)
 			{
-				logPxy[i*m_components.size()+j]=m_components[j]->compute_log_PDF(v)+CMath::log(m_coefficients[j]);
-				logPx[i]+=CMath::exp(logPxy[i*m_components.size()+j]);
-			}
-
-			logPx[i]=CMath::log(logPx[i]);
-
-			for (int32_t j=0; j<int32_t(m_components.size()); j++)
-			{
-				logPost[i*m_components.size()+j]=logPxy[i*m_components.size()+j]-logPx[i];
 				logPostSum[j]+=CMath::exp(logPost[i*m_components.size()+j]);
 				logPostSum2[j]+=CMath::exp(2*logPost[i*m_components.size()+j]);
 			}
@@ -345,15 +365,15 @@ void CGMM::partial_em(int32_t comp1, int32_t comp2, int32_t comp3, float64_t min
 	float64_t* init_logPx_fix=SG_MALLOC(float64_t, num_vectors);
 	float64_t* post_add=SG_MALLOC(float64_t, num_vectors);
 
+	compute_log_densities(get_data_matrix(), init_logPxy);
+
 	for (int32_t i=0; i<num_vectors; i++)
 	{
 		init_logPx[i]=0;
 		init_logPx_fix[i]=0;
 
-		SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(i);
 		for (int32_t j=0; j<int32_t(m_components.size()); j++)
 		{
-			init_logPxy[i*m_components.size()+j]=m_components[j]->compute_log_PDF(v)+CMath::log(m_coefficients[j]);
 			init_logPx[i]+=CMath::exp(init_logPxy[i*m_components.size()+j]);
 			if (j!=comp1 && j!=comp2 && j!=comp3)
 			{
@@ -518,78 +538,82 @@ void CGMM::partial_em(int32_t comp1, int32_t comp2, int32_t comp3, float64_t min
 
 void CGMM::max_likelihood(SGMatrix<float64_t> alpha, float64_t min_cov)
 {
-	CDotFeatures* dotdata=(CDotFeatures *) features;
-	int32_t num_dim=dotdata->get_dim_feature_space();
+	max_likelihood(alpha, min_cov, get_data_matrix());
+}
 
-	float64_t alpha_sum;
+void CGMM::max_likelihood(SGMatrix<float64_t> alpha, float64_t min_cov,
+		SGMatrix<float64_t> data)
+{
+	int32_t num_dim=data.num_rows;
+	int32_t num_vectors=data.num_cols;
+	int32_t num_comp=alpha.num_cols;
+	int32_t num_blocks=CMath::max(1, CMath::min(parallel->get_num_threads(), num_vectors));
+
+	Map<MatrixXd> x(data.matrix, num_dim, num_vectors);
+	/* posteriors of a vector are stored contiguously */
+	Map<MatrixXd> post(alpha.matrix, num_comp, num_vectors);
+
+	/* every block of vectors accumulates its own partial sums which are
+	 * added up in block order, so results do not depend on scheduling */
+	MatrixXd mean_partial(num_dim, num_blocks);
+	MatrixXd cov_partial;
 	float64_t alpha_sum_sum=0;
-	float64_t* mean_sum;
-	float64_t* cov_sum=NULL;
 
-	for (int32_t i=0; i<alpha.num_cols; i++)
+	for (int32_t i=0; i<num_comp; i++)
 	{
-		alpha_sum=0;
-		mean_sum=SG_MALLOC(float64_t, num_dim);
-		memset(mean_sum, 0, num_dim*sizeof(float64_t));
+		VectorXd weights=post.row(i).transpose();
+		float64_t alpha_sum=weights.sum();
 
-		for (int32_t j=0; j<alpha.num_rows; j++)
+#pragma omp parallel for
+		for (int32_t b=0; b<num_blocks; b++)
 		{
-			alpha_sum+=alpha.matrix[j*alpha.num_cols+i];
-			SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(j);
-			SGVector<float64_t>::add(mean_sum, alpha.matrix[j*alpha.num_cols+i], v.vector, 1, mean_sum, v.vlen);
+			int32_t start=int64_t(num_vectors)*b/num_blocks;
+			int32_t len=int64_t(num_vectors)*(b+1)/num_blocks-start;
+			mean_partial.col(b).noalias()=x.middleCols(start, len)*weights.segment(start, len);
 		}
 
-		for (int32_t j=0; j<num_dim; j++)
-			mean_sum[j]/=alpha_sum;
-
-		m_components[i]->set_mean(SGVector<float64_t>(mean_sum, num_dim));
+		SGVector<float64_t> mean(num_dim);
+		Map<VectorXd> map_mean(mean.vector, num_dim);
+		map_mean=mean_partial.rowwise().sum()/alpha_sum;
+		m_components[i]->set_mean(mean);
 
 		ECovType cov_type=m_components[i]->get_cov_type();
+		int32_t cov_len=cov_type==FULL ? num_dim*num_dim : (cov_type==DIAG ? num_dim : 1);
+		cov_partial.resize(cov_len, num_blocks);
 
-		if (cov_type==FULL)
-		{
-			cov_sum=SG_MALLOC(float64_t, num_dim*num_dim);
-			memset(cov_sum, 0, num_dim*num_dim*sizeof(float64_t));
-		}
-		else if(cov_type==DIAG)
-		{
-			cov_sum=SG_MALLOC(float64_t, num_dim);
-			memset(cov_sum, 0, num_dim*sizeof(float64_t));
-		}
-		else if(cov_type==SPHERICAL)
-		{
-			cov_sum=SG_MALLOC(float64_t, 1);
-			cov_sum[0]=0;
-		}
-
-		for (int32_t j=0; j<alpha.num_rows; j++)
+#pragma omp parallel for
+		for (int32_t b=0; b<num_blocks; b++)
 		{
-			SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(j);
-			SGVector<float64_t>::add(v.vector, 1, v.vector, -1, mean_sum, v.vlen);
+			int32_t start=int64_t(num_vectors)*b/num_blocks;
+			int32_t end=int64_t(num_vectors)*(b+1)/num_blocks;
+			cov_partial.col(b).setZero();
 
-			switch (cov_type)
+			for (int32_t j=start; j<end; j+=GMM_BLOCK_SIZE)
 			{
-				case FULL:
-					cblas_dger(CblasRowMajor, num_dim, num_dim, alpha.matrix[j*alpha.num_cols+i], v.vector, 1, v.vector,
-								 1, (double*) cov_sum, num_dim);
-
-					break;
-				case DIAG:
-					for (int32_t k=0; k<num_dim; k++)
-						cov_sum[k]+=v.vector[k]*v.vector[k]*alpha.matrix[j*alpha.num_cols+i];
+				int32_t len=CMath::min(GMM_BLOCK_SIZE, end-j);
+				MatrixXd centered=x.middleCols(j, len).colwise()-map_mean;
 
-					break;
-				case SPHERICAL:
-					float64_t temp=0;
-
-					for (int32_t k=0; k<num_dim; k++)
-						temp+=v.vector[k]*v.vector[k];
-
-					cov_sum[0]+=temp*alpha.matrix[j*alpha.num_cols+i];
-					break;
+				switch (cov_type)
+				{
+					case FULL:
+					{
+						Map<MatrixXd> cov(cov_partial.col(b).data(), num_dim, num_dim);
+						cov.noalias()+=(centered*weights.segment(j, len).asDiagonal())*centered.transpose();
+						break;
+					}
+					case DIAG:
+						cov_partial.col(b).noalias()+=centered.array().square().matrix()*weights.segment(j, len);
+						break;
+					case SPHERICAL:
+						cov_partial(0, b)+=centered.colwise().squaredNorm().dot(weights.segment(j, len));
+						break;
+				}
 			}
 		}
 
+		float64_t* cov_sum=SG_MALLOC(float64_t, cov_len);
+		Map<VectorXd>(cov_sum, cov_len)=cov_partial.rowwise().sum();
+
 		switch (cov_type)
 		{
 			case FULL:
@@ -628,10 +652,49 @@ void CGMM::max_likelihood(SGMatrix<float64_t> alpha, float64_t min_cov)
 		alpha_sum_sum+=alpha_sum;
 	}
 
-	for (int32_t i=0; i<alpha.num_cols; i++)
+	for (int32_t i=0; i<num_comp; i++)
 		m_coefficients.vector[i]/=alpha_sum_sum;
 }
 
+SGMatrix<float64_t> CGMM::get_data_matrix()
+{
+	if (features->get_feature_class()==C_DENSE && features->get_feature_type()==F_DREAL)
+	{
+		SGMatrix<float64_t> matrix=((CDenseFeatures<float64_t>*) features)->get_feature_matrix();
+		if (matrix.matrix)
+			return matrix;
+	}
+
+	CDotFeatures* dotdata=(CDotFeatures *) features;
+	int32_t num_vectors=dotdata->get_num_vectors();
+	int32_t num_dim=dotdata->get_dim_feature_space();
+	SGMatrix<float64_t> data(num_dim, num_vectors);
+
+	for (int32_t i=0; i<num_vectors; i++)
+	{
+		SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(i);
+		memcpy(data.get_column_vector(i), v.vector, sizeof(float64_t)*num_dim);
+	}
+
+	return data;
+}
+
+void CGMM::compute_log_densities(SGMatrix<float64_t> data, float64_t* log_pxy)
+{
+	int32_t num_vectors=data.num_cols;
+	int32_t num_comp=int32_t(m_components.size());
+
+	for (int32_t j=0; j<num_comp; j++)
+	{
+		SGVector<float64_t> log_pdf=m_components[j]->compute_log_PDF(data);
+		float64_t log_coef=CMath::log(m_coefficients[j]);
+
+#pragma omp parallel for
+		for (int32_t i=0; i<num_vectors; i++)
+			log_pxy[int64_t(i)*num_comp+j]=log_pdf[i]+log_coef;
+	}
+}
+
 int32_t CGMM::get_num_model_parameters()
 {
 	return 1;
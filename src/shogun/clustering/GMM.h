@@ -242,6 +242,29 @@ class CGMM : public CDistribution
 		void partial_em(int32_t comp1, int32_t comp2, int32_t comp3,
 				float64_t min_cov, int32_t max_em_iter, float64_t min_change);
 
+		/** @return features as dense matrix, a view on the feature matrix
+		 * of dense real-valued features
+		 */
+		SGMatrix<float64_t> get_data_matrix();
+
+		/** compute \f$\log(\pi_j p(x_i|j))\f$ for all components and
+		 * vectors, every component evaluates all vectors at once.
+		 *
+		 * @param data vectors (one per column)
+		 * @param log_pxy output, num_components values per vector stored
+		 * contiguously
+		 */
+		void compute_log_densities(SGMatrix<float64_t> data, float64_t* log_pxy);
+
+		/** maximum likelihood estimation on given data
+		 *
+		 * @param alpha point assignment
+		 * @param min_cov minimum covariance
+		 * @param data vectors (one per column)
+		 */
+		void max_likelihood(SGMatrix<float64_t> alpha, float64_t min_cov,
+				SGMatrix<float64_t> data);
+
 	protected:
 		/** Mixture components */
 		std::vector<CGaussian*> m_components;
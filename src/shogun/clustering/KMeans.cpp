@@ -19,20 +19,70 @@
 using namespace Eigen;
 using namespace shogun;
 
+/* KMM_AUTO uses Elkan's method only if its lower bounds, one per point and
+ * center, take at most this many bytes */
+#define KMEANS_ELKAN_MAX_BOUND_BYTES (64*1024*1024)
+
 
 namespace shogun
 {
 
 CKMeans::CKMeans():CKMeansBase()
 {
+	init_train_method();
 }
 
 CKMeans::CKMeans(int32_t k_i, CDistance* d_i, bool use_kmpp_i):CKMeansBase(k_i, d_i, use_kmpp_i)
 {
+	init_train_method();
 }
 
 CKMeans::CKMeans(int32_t k_i, CDistance* d_i, SGMatrix<float64_t> centers_i):CKMeansBase(k_i, d_i, centers_i)
 {
+	init_train_method();
+}
+
+void CKMeans::init_train_method()
+{
+	train_method=KMM_AUTO;
+	SG_ADD((machine_int_t*) &train_method, "train_method",
+		"Method used for the Lloyd iterations", MS_NOT_AVAILABLE);
+}
+
+void CKMeans::set_train_method(EKMeansMethod method)
+{
+	train_method=method;
+}
+
+EKMeansMethod CKMeans::get_train_method() const
+{
+	return train_method;
+}
+
+EKMeansMethod CKMeans::resolve_train_method() const
+{
+	/* bounds are only valid for a metric, and fixed centers move during
+	 * the assignment step */
+	bool metric=distance->get_distance_type()==D_EUCLIDEAN &&
+		!((CEuclideanDistance*) distance)->get_disable_sqrt();
+
+	if (fixed_centers || !metric)
+	{
+		if (train_method!=KMM_AUTO && train_method!=KMM_LLOYD)
+			SG_WARNING("Bound accelerated KMeans requires euclidean distance \
+and no fixed centers, using Lloyd iterations\n")
+		return KMM_LLOYD;
+	}
+
+	if (train_method==KMM_AUTO)
+	{
+		int64_t bound_bytes=int64_t(k)*distance->get_num_vec_lhs()*
+			sizeof(float64_t);
+		return k>20 && bound_bytes<=KMEANS_ELKAN_MAX_BOUND_BYTES ?
+			KMM_ELKAN : KMM_HAMERLY;
+	}
+
+	return train_method;
 }
 
 CKMeans::~CKMeans()
@@ -100,13 +150,15 @@ void CKMeans::Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
 			if (min_cluster!=cluster_assignments_i)
 			{
 				changed++;
-#pragma omp atomic
-				++weights_set[min_cluster];
-#pragma omp atomic
-				--weights_set[cluster_assignments_i];
 
+				/* weights are only maintained here when centers move
+				 * during assignment, which runs serially. Otherwise they
+				 * are recomputed by the update step. */
 				if(fixed_centers)
 				{
+					++weights_set[min_cluster];
+					--weights_set[cluster_assignments_i];
+
 					SGVector<float64_t>vec=lhs->get_feature_vector(i);
 					float64_t temp_min = 1.0 / weights_set[min_cluster];
 
@@ -150,30 +202,303 @@ void CKMeans::Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
 
 		/* Update Step : Calculate new means */
 		if (!fixed_centers)
+			update_centers(lhs, cluster_assignments, centers, weights_set);
+		if (iter%(max_iter/10) == 0)
+			SG_SINFO("Iteration[%d/%d]: Assignment of %i patterns changed.\n", iter, max_iter, changed)
+	}
+	distance->reset_precompute();
+	distance->replace_rhs(rhs_cache);
+	delete rhs_mus;
+	SG_UNREF(lhs);
+}
+
+/* closest and second closest center of point i, ties are resolved towards
+ * the lower center index as in the Lloyd iterations */
+static void closest_centers(CDistance* distance, int32_t i, int32_t num_centers,
+		int32_t& closest, float64_t& min_dist, float64_t& second_min_dist)
+{
+	closest=0;
+	min_dist=CMath::INFTY;
+	second_min_dist=CMath::INFTY;
+
+	for (int32_t j=0; j<num_centers; j++)
+	{
+		float64_t dist=distance->distance(i,j);
+		if (dist<min_dist)
 		{
-			/* mus=zeros(dim, num_centers) ; */
-			centers.zero();
-			Map<MatrixXd> map_centers(centers.matrix, centers.num_rows, centers.num_cols);
-			
+			second_min_dist=min_dist;
+			min_dist=dist;
+			closest=j;
+		}
+		else if (dist<second_min_dist)
+			second_min_dist=dist;
+	}
+}
+
+/* pairwise center distances and half the distance from every center to its
+ * closest other center */
+static void compute_center_distances(SGMatrix<float64_t> centers,
+		SGMatrix<float64_t> center_dists, SGVector<float64_t> separation)
+{
+	int32_t num_centers=centers.num_cols;
+	Map<MatrixXd> map_centers(centers.matrix, centers.num_rows, num_centers);
+
+#pragma omp parallel for
+	for (int32_t j=0; j<num_centers; j++)
+	{
+		center_dists(j,j)=0;
+		for (int32_t l=0; l<num_centers; l++)
+		{
+			if (l!=j)
+				center_dists(l,j)=(map_centers.col(j)-map_centers.col(l)).norm();
+		}
+	}
+
+	for (int32_t j=0; j<num_centers; j++)
+	{
+		float64_t min_dist=CMath::INFTY;
+		for (int32_t l=0; l<num_centers; l++)
+		{
+			if (l!=j)
+				min_dist=CMath::min(min_dist, center_dists(l,j));
+		}
+		separation[j]=0.5*min_dist;
+	}
+}
+
+/* distance every center moved */
+static void compute_center_shift(SGMatrix<float64_t> old_centers,
+		SGMatrix<float64_t> centers, SGVector<float64_t> shift)
+{
+	Map<MatrixXd> map_old(old_centers.matrix, old_centers.num_rows, old_centers.num_cols);
+	Map<MatrixXd> map_new(centers.matrix, centers.num_rows, centers.num_cols);
+
+	for (int32_t j=0; j<centers.num_cols; j++)
+		shift[j]=(map_new.col(j)-map_old.col(j)).norm();
+}
+
+void CKMeans::Hamerly_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
+{
+	CDenseFeatures<float64_t>* lhs=
+		CDenseFeatures<float64_t>::obtain_from_generic(distance->get_lhs());
+
+	int32_t lhs_size=lhs->get_num_vectors();
+	int32_t dim=lhs->get_num_features();
+
+	CDenseFeatures<float64_t>* rhs_mus=new CDenseFeatures<float64_t>(0);
+	CFeatures* rhs_cache=distance->replace_rhs(rhs_mus);
+
+	SGVector<int32_t> cluster_assignments(lhs_size);
+	/* upper bound on distance to assigned center */
+	SGVector<float64_t> upper(lhs_size);
+	/* lower bound on distance to any other center */
+	SGVector<float64_t> lower(lhs_size);
+	SGVector<int64_t> weights_set(num_centers);
+	SGMatrix<float64_t> center_dists(num_centers, num_centers);
+	SGVector<float64_t> separation(num_centers);
+	SGVector<float64_t> shift(num_centers);
+	SGMatrix<float64_t> old_centers(dim, num_centers);
+
+	distance->precompute_lhs();
+	rhs_mus->copy_feature_matrix(centers);
+	distance->precompute_rhs();
+
+#pragma omp parallel for
+	for (int32_t i=0; i<lhs_size; i++)
+	{
+		closest_centers(distance, i, num_centers, cluster_assignments[i],
+				upper[i], lower[i]);
+	}
+
+	int32_t changed=lhs_size;
+	int32_t iter;
+	for (iter=0; iter<max_iter; iter++)
+	{
+		if (iter==max_iter-1)
+			SG_SWARNING("KMeans clustering has reached maximum number of ( %d ) iterations without having converged. \
+				   	Terminating. \n", iter)
+
+		if (iter>0)
+		{
+			compute_center_distances(centers, center_dists, separation);
+			changed=0;
+
+#pragma omp parallel for reduction(+:changed)
 			for (int32_t i=0; i<lhs_size; i++)
 			{
-				int32_t cluster_i=cluster_assignments[i];
+				const int32_t cluster_assignments_i=cluster_assignments[i];
+				const float64_t bound=CMath::max(separation[cluster_assignments_i], lower[i]);
+				if (upper[i]<=bound)
+					continue;
+
+				/* tighten upper bound before falling back to all centers */
+				upper[i]=distance->distance(i, cluster_assignments_i);
+				if (upper[i]<=bound)
+					continue;
+
+				closest_centers(distance, i, num_centers, cluster_assignments[i],
+						upper[i], lower[i]);
+				if (cluster_assignments[i]!=cluster_assignments_i)
+					changed++;
+			}
+
+			if (changed==0)
+				break;
+		}
 
-				SGVector<float64_t>vec=lhs->get_feature_vector(i);
-				Map<VectorXd> map_vec(vec.vector, vec.size());
-				
-				map_centers.col(cluster_i) += map_vec;
+		/* Update Step : Calculate new means */
+		memcpy(old_centers.matrix, centers.matrix, sizeof(float64_t)*dim*num_centers);
+		update_centers(lhs, cluster_assignments, centers, weights_set);
+		compute_center_shift(old_centers, centers, shift);
 
-				lhs->free_feature_vector(vec, i);
+		int32_t max_shift_idx=CMath::arg_max(shift.vector, 1, num_centers);
+		float64_t second_max_shift=0;
+		for (int32_t j=0; j<num_centers; j++)
+		{
+			if (j!=max_shift_idx)
+				second_max_shift=CMath::max(second_max_shift, shift[j]);
+		}
+
+#pragma omp parallel for
+		for (int32_t i=0; i<lhs_size; i++)
+		{
+			const int32_t cluster_assignments_i=cluster_assignments[i];
+			upper[i]+=shift[cluster_assignments_i];
+			lower[i]-=cluster_assignments_i==max_shift_idx ?
+				second_max_shift : shift[max_shift_idx];
+		}
+
+		rhs_mus->copy_feature_matrix(centers);
+		distance->precompute_rhs();
+
+		if (iter%CMath::max(1, max_iter/10) == 0)
+			SG_SINFO("Iteration[%d/%d]: Assignment of %i patterns changed.\n", iter, max_iter, changed)
+	}
+	distance->reset_precompute();
+	distance->replace_rhs(rhs_cache);
+	delete rhs_mus;
+	SG_UNREF(lhs);
+}
+
+void CKMeans::Elkan_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
+{
+	CDenseFeatures<float64_t>* lhs=
+		CDenseFeatures<float64_t>::obtain_from_generic(distance->get_lhs());
+
+	int32_t lhs_size=lhs->get_num_vectors();
+	int32_t dim=lhs->get_num_features();
+
+	CDenseFeatures<float64_t>* rhs_mus=new CDenseFeatures<float64_t>(0);
+	CFeatures* rhs_cache=distance->replace_rhs(rhs_mus);
+
+	SGVector<int32_t> cluster_assignments(lhs_size);
+	/* upper bound on distance to assigned center */
+	SGVector<float64_t> upper(lhs_size);
+	/* lower bound on distance to every center, one column per point */
+	SGMatrix<float64_t> lower(num_centers, lhs_size);
+	SGVector<int64_t> weights_set(num_centers);
+	SGMatrix<float64_t> center_dists(num_centers, num_centers);
+	SGVector<float64_t> separation(num_centers);
+	SGVector<float64_t> shift(num_centers);
+	SGMatrix<float64_t> old_centers(dim, num_centers);
+
+	distance->precompute_lhs();
+	rhs_mus->copy_feature_matrix(centers);
+	distance->precompute_rhs();
+
+#pragma omp parallel for
+	for (int32_t i=0; i<lhs_size; i++)
+	{
+		int32_t min_cluster=0;
+		float64_t min_dist=CMath::INFTY;
+		for (int32_t j=0; j<num_centers; j++)
+		{
+			lower(j,i)=distance->distance(i,j);
+			if (lower(j,i)<min_dist)
+			{
+				min_dist=lower(j,i);
+				min_cluster=j;
 			}
-		
-			for (int32_t i=0; i<num_centers; i++)
+		}
+		cluster_assignments[i]=min_cluster;
+		upper[i]=min_dist;
+	}
+
+	int32_t changed=lhs_size;
+	int32_t iter;
+	for (iter=0; iter<max_iter; iter++)
+	{
+		if (iter==max_iter-1)
+			SG_SWARNING("KMeans clustering has reached maximum number of ( %d ) iterations without having converged. \
+				   	Terminating. \n", iter)
+
+		if (iter>0)
+		{
+			compute_center_distances(centers, center_dists, separation);
+			changed=0;
+
+#pragma omp parallel for reduction(+:changed)
+			for (int32_t i=0; i<lhs_size; i++)
 			{
-				if (weights_set[i]!=0)
-					map_centers.col(i)*=1.0/weights_set[i];
+				int32_t min_cluster=cluster_assignments[i];
+				if (upper[i]<=separation[min_cluster])
+					continue;
+
+				bool tight=false;
+				for (int32_t j=0; j<num_centers; j++)
+				{
+					if (j==min_cluster)
+						continue;
+
+					float64_t bound=CMath::max(lower(j,i), 0.5*center_dists(j,min_cluster));
+					if (upper[i]<=bound)
+						continue;
+
+					if (!tight)
+					{
+						upper[i]=distance->distance(i, min_cluster);
+						lower(min_cluster,i)=upper[i];
+						tight=true;
+						if (upper[i]<=bound)
+							continue;
+					}
+
+					lower(j,i)=distance->distance(i,j);
+					if (lower(j,i)<upper[i])
+					{
+						min_cluster=j;
+						upper[i]=lower(j,i);
+					}
+				}
+
+				if (min_cluster!=cluster_assignments[i])
+				{
+					cluster_assignments[i]=min_cluster;
+					changed++;
+				}
 			}
+
+			if (changed==0)
+				break;
 		}
-		if (iter%(max_iter/10) == 0)
+
+		/* Update Step : Calculate new means */
+		memcpy(old_centers.matrix, centers.matrix, sizeof(float64_t)*dim*num_centers);
+		update_centers(lhs, cluster_assignments, centers, weights_set);
+		compute_center_shift(old_centers, centers, shift);
+
+#pragma omp parallel for
+		for (int32_t i=0; i<lhs_size; i++)
+		{
+			upper[i]+=shift[cluster_assignments[i]];
+			for (int32_t j=0; j<num_centers; j++)
+				lower(j,i)=CMath::max(lower(j,i)-shift[j], 0.0);
+		}
+
+		rhs_mus->copy_feature_matrix(centers);
+		distance->precompute_rhs();
+
+		if (iter%CMath::max(1, max_iter/10) == 0)
 			SG_SINFO("Iteration[%d/%d]: Assignment of %i patterns changed.\n", iter, max_iter, changed)
 	}
 	distance->reset_precompute();
@@ -185,7 +510,18 @@ void CKMeans::Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers)
 bool CKMeans::train_machine(CFeatures* data)
 {
 	initialize_training(data);
-	Lloyd_KMeans(mus, k);
+
+	switch (resolve_train_method())
+	{
+		case KMM_HAMERLY:
+			Hamerly_KMeans(mus, k);
+			break;
+		case KMM_ELKAN:
+			Elkan_KMeans(mus, k);
+			break;
+		default:
+			Lloyd_KMeans(mus, k);
+	}
 	compute_cluster_variances();	
 	return true;
 }
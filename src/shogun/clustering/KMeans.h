@@ -23,6 +23,26 @@ namespace shogun
 {
 class CKMeansBase;
 
+/** Method used by CKMeans to run the Lloyd iterations */
+enum EKMeansMethod
+{
+	/** Elkan's method for more than 20 centers if its bounds take at
+	 * most 64MB, Hamerly's method otherwise. Falls back to KMM_LLOYD when
+	 * the bounds can not be used.
+	 */
+	KMM_AUTO = 0,
+	/** plain Lloyd iterations, all point to center distances are computed
+	 * in every iteration
+	 */
+	KMM_LLOYD = 10,
+	/** Hamerly's method, keeps one upper and one lower bound per point */
+	KMM_HAMERLY = 20,
+	/** Elkan's method, keeps one upper and one lower bound per point and
+	 * center (memory grows with the number of points times k)
+	 */
+	KMM_ELKAN = 30
+};
+
 /** @brief KMeans clustering,  partitions the data into k (a-priori specified) clusters.
  *
  * It minimizes
@@ -35,6 +55,17 @@ class CKMeansBase;
  *
  * Beware that this algorithm obtains only a <em>local</em> optimum.
  *
+ * With euclidean distance the iterations can use the triangle inequality to
+ * skip point to center distance computations that can not change an
+ * assignment (see EKMeansMethod). The accelerated methods produce the same
+ * clustering as plain Lloyd iterations.
+ *
+ * Hamerly, G. (2010). Making k-means even faster. SIAM International
+ * Conference on Data Mining, 130-140.
+ *
+ * Elkan, C. (2003). Using the triangle inequality to accelerate k-means.
+ * International Conference on Machine Learning, 147-153.
+ *
  * To use mini-batch based training was see CKMeansMiniBatch 
  *
  * cf. http://en.wikipedia.org/wiki/K-means_algorithm
@@ -69,6 +100,18 @@ class CKMeans : public CKMeansBase
 		/** @return object name */
 		virtual const char* get_name() const { return "KMeans"; }		
 
+		/** set method used for the Lloyd iterations
+		 *
+		 * @param method KMM_AUTO (default), KMM_LLOYD, KMM_HAMERLY or KMM_ELKAN
+		 */
+		void set_train_method(EKMeansMethod method);
+
+		/** get method used for the Lloyd iterations
+		 *
+		 * @return train method
+		 */
+		EKMeansMethod get_train_method() const;
+
 	private:
 
 		/** train k-means
@@ -84,6 +127,24 @@ class CKMeans : public CKMeansBase
 		/** Lloyd's KMeans training method
 		 */
 		void Lloyd_KMeans(SGMatrix<float64_t> centers, int32_t num_centers);
+
+		/** Hamerly's bound accelerated Lloyd iterations
+		 */
+		void Hamerly_KMeans(SGMatrix<float64_t> centers, int32_t num_centers);
+
+		/** Elkan's bound accelerated Lloyd iterations
+		 */
+		void Elkan_KMeans(SGMatrix<float64_t> centers, int32_t num_centers);
+
+		/** @return method resolved from train_method for current settings */
+		EKMeansMethod resolve_train_method() const;
+
+		void init_train_method();
+
+	protected:
+
+		/** Method used for the Lloyd iterations */
+		EKMeansMethod train_method;
 };
 }
 #endif
@@ -18,6 +18,8 @@
 #include <shogun/base/Parallel.h>
 #include <shogun/mathematics/eigen3.h>
 
+#include <vector>
+
 #ifdef HAVE_LINALG_LIB
 #include <shogun/mathematics/linalg/linalg.h>
 #endif
@@ -158,8 +160,10 @@ void CKMeansBase::initialize_training(CFeatures* data)
 	REQUIRE(lhs_size>0, "Lhs features should not be empty");
 	REQUIRE(dimensions>0, "Lhs features should have more than zero dimensions");
 
-	/* if kmeans++ to be used */
-	if (use_kmeanspp)
+	/* if kmeans|| or kmeans++ to be used */
+	if (use_kmeans_parallel)
+		mus_initial=kmeans_parallel();
+	else if (use_kmeanspp)
 	{
 #ifdef HAVE_LINALG_LIB
 		mus_initial=kmeanspp();
@@ -183,6 +187,57 @@ void CKMeansBase::initialize_training(CFeatures* data)
 	SG_UNREF(lhs);
 }
 
+void CKMeansBase::update_centers(CDenseFeatures<float64_t>* lhs,
+		SGVector<int32_t> cluster_assignments,
+		SGMatrix<float64_t> centers, SGVector<int64_t> weights_set)
+{
+	int32_t lhs_size=lhs->get_num_vectors();
+	int32_t dim=centers.num_rows;
+	int32_t num_centers=centers.num_cols;
+	int32_t num_blocks=CMath::max(1, CMath::min(parallel->get_num_threads(), lhs_size));
+
+	SGMatrix<float64_t> partial_sums(dim, num_centers*num_blocks);
+	SGMatrix<int64_t> partial_weights(num_centers, num_blocks);
+	partial_sums.zero();
+	partial_weights.zero();
+
+#pragma omp parallel for
+	for (int32_t b=0; b<num_blocks; b++)
+	{
+		Map<MatrixXd> sums(partial_sums.get_column_vector(b*num_centers), dim, num_centers);
+		int64_t* weights=partial_weights.get_column_vector(b);
+		int32_t start=int64_t(lhs_size)*b/num_blocks;
+		int32_t end=int64_t(lhs_size)*(b+1)/num_blocks;
+
+		for (int32_t i=start; i<end; i++)
+		{
+			int32_t cluster_i=cluster_assignments[i];
+			SGVector<float64_t> vec=lhs->get_feature_vector(i);
+			sums.col(cluster_i)+=Map<VectorXd>(vec.vector, vec.vlen);
+			weights[cluster_i]++;
+			lhs->free_feature_vector(vec, i);
+		}
+	}
+
+	/* reduce partials in block order, which keeps the result independent
+	 * of thread scheduling */
+	Map<MatrixXd> map_centers(centers.matrix, dim, num_centers);
+	map_centers.setZero();
+	weights_set.zero();
+	for (int32_t b=0; b<num_blocks; b++)
+	{
+		map_centers+=Map<MatrixXd>(partial_sums.get_column_vector(b*num_centers), dim, num_centers);
+		for (int32_t j=0; j<num_centers; j++)
+			weights_set[j]+=partial_weights(j, b);
+	}
+
+	for (int32_t j=0; j<num_centers; j++)
+	{
+		if (weights_set[j]!=0)
+			map_centers.col(j)*=1.0/weights_set[j];
+	}
+}
+
 bool CKMeansBase::load(FILE* srcfile)
 {
 	SG_SET_LOCALE_C;
@@ -207,6 +262,24 @@ bool CKMeansBase::get_use_kmeanspp() const
 	return use_kmeanspp;
 }
 
+void CKMeansBase::set_use_kmeans_parallel(bool kmpar)
+{
+	use_kmeans_parallel=kmpar;
+}
+
+bool CKMeansBase::get_use_kmeans_parallel() const
+{
+	return use_kmeans_parallel;
+}
+
+void CKMeansBase::set_kmeans_parallel_params(float64_t oversampling, int32_t rounds)
+{
+	REQUIRE(oversampling>0, "oversampling factor should be > 0");
+	REQUIRE(rounds>0, "number of rounds should be > 0");
+	kmeans_parallel_oversampling=oversampling;
+	kmeans_parallel_rounds=rounds;
+}
+
 void CKMeansBase::set_k(int32_t p_k)
 {
 	REQUIRE(p_k>0, "number of clusters should be > 0");
@@ -314,7 +387,6 @@ SGMatrix<float64_t> CKMeansBase::kmeanspp()
 		for(int32_t trial=0; trial<n_rands; trial++)
 		{
 			float64_t temp_sum=0.0;		
-			float64_t temp_dist=0.0;
 			SGVector<float64_t> temp_min_dist=SGVector<float64_t>(lhs_size);		
 			int32_t new_center=0;		
 			float64_t prob=CMath::random(0.0, 1.0);
@@ -334,7 +406,7 @@ SGMatrix<float64_t> CKMeansBase::kmeanspp()
 			shared(temp_min_dist)		
 			for(int32_t j=0; j<lhs_size; j++)
 			{
-				temp_dist=CMath::sq(distance->distance(j, new_center));
+				float64_t temp_dist=CMath::sq(distance->distance(j, new_center));
 				temp_min_dist[j]=CMath::min(temp_dist, min_dist[j]);
 			}
 
@@ -364,6 +436,205 @@ SGMatrix<float64_t> CKMeansBase::kmeanspp()
 	return centers;
 }
 
+/* index drawn with probability proportional to weights, which sum to sum */
+static int32_t sample_weighted(SGVector<float64_t> weights, float64_t sum)
+{
+	float64_t prob=CMath::random(0.0, 1.0)*sum;
+	float64_t temp_sum=0.0;
+	for (int32_t j=0; j<weights.vlen; j++)
+	{
+		temp_sum+=weights[j];
+		if (prob<=temp_sum && weights[j]>0)
+			return j;
+	}
+	/* rounding left prob above the total, take the last candidate */
+	for (int32_t j=weights.vlen-1; j>0; j--)
+	{
+		if (weights[j]>0)
+			return j;
+	}
+	return 0;
+}
+
+/* cluster weighted candidates into k centers with weighted KMeans++ seeding
+ * followed by weighted Lloyd iterations */
+static SGMatrix<float64_t> recluster_candidates(SGMatrix<float64_t> candidates,
+		SGVector<float64_t> weights, int32_t k, int32_t max_iter)
+{
+	int32_t dim=candidates.num_rows;
+	int32_t num_candidates=candidates.num_cols;
+	Map<MatrixXd> cand(candidates.matrix, dim, num_candidates);
+
+	SGMatrix<float64_t> centers(dim, k);
+	Map<MatrixXd> cent(centers.matrix, dim, k);
+
+	SGVector<float64_t> min_dist(num_candidates);
+	SGVector<float64_t> prob(num_candidates);
+	Map<VectorXd> map_weights(weights.vector, num_candidates);
+	Map<VectorXd> map_min_dist(min_dist.vector, num_candidates);
+	Map<VectorXd> map_prob(prob.vector, num_candidates);
+
+	cent.col(0)=cand.col(sample_weighted(weights, map_weights.sum()));
+	for (int32_t c=0; c<num_candidates; c++)
+		min_dist[c]=(cand.col(c)-cent.col(0)).squaredNorm();
+
+	for (int32_t i=1; i<k; i++)
+	{
+		map_prob=map_weights.cwiseProduct(map_min_dist);
+		float64_t sum=map_prob.sum();
+		int32_t chosen=sum>0 ? sample_weighted(prob, sum) :
+			sample_weighted(weights, map_weights.sum());
+		cent.col(i)=cand.col(chosen);
+
+#pragma omp parallel for
+		for (int32_t c=0; c<num_candidates; c++)
+			min_dist[c]=CMath::min(min_dist[c], (cand.col(c)-cent.col(i)).squaredNorm());
+	}
+
+	SGVector<int32_t> assignment(num_candidates);
+	assignment.set_const(-1);
+	for (int32_t iter=0; iter<max_iter; iter++)
+	{
+		int32_t changed=0;
+
+#pragma omp parallel for reduction(+:changed)
+		for (int32_t c=0; c<num_candidates; c++)
+		{
+			int32_t closest=0;
+			(cent.colwise()-cand.col(c)).colwise().squaredNorm().minCoeff(&closest);
+			if (closest!=assignment[c])
+			{
+				assignment[c]=closest;
+				changed++;
+			}
+		}
+
+		if (changed==0)
+			break;
+
+		/* weighted means, empty clusters keep their center */
+		MatrixXd sums=MatrixXd::Zero(dim, k);
+		VectorXd total=VectorXd::Zero(k);
+		for (int32_t c=0; c<num_candidates; c++)
+		{
+			sums.col(assignment[c])+=weights[c]*cand.col(c);
+			total[assignment[c]]+=weights[c];
+		}
+		for (int32_t j=0; j<k; j++)
+		{
+			if (total[j]>0)
+				cent.col(j)=sums.col(j)/total[j];
+		}
+	}
+
+	return centers;
+}
+
+SGMatrix<float64_t> CKMeansBase::kmeans_parallel()
+{
+	CDenseFeatures<float64_t>* lhs=(CDenseFeatures<float64_t>*)distance->get_lhs();
+	int32_t lhs_size=lhs->get_num_vectors();
+	const float64_t oversampling=kmeans_parallel_oversampling*k;
+
+	/* candidates are point indices. For every point the squared distance
+	 * to and index of its closest candidate are maintained */
+	std::vector<int32_t> candidates;
+	SGVector<bool> is_candidate(lhs_size);
+	SGVector<float64_t> min_dist(lhs_size);
+	SGVector<int32_t> closest(lhs_size);
+	SGVector<float64_t> uniform(lhs_size);
+	Map<VectorXd> map_min_dist(min_dist.vector, lhs_size);
+	is_candidate.set_const(false);
+
+	distance->precompute_lhs();
+	distance->precompute_rhs();
+
+	/* First candidate is chosen at random */
+	int32_t first=CMath::random((int32_t) 0, lhs_size-1);
+	candidates.push_back(first);
+	is_candidate[first]=true;
+#pragma omp parallel for
+	for (int32_t i=0; i<lhs_size; i++)
+	{
+		min_dist[i]=CMath::sq(distance->distance(i, first));
+		closest[i]=0;
+	}
+
+	for (int32_t round=0; round<kmeans_parallel_rounds; round++)
+	{
+		float64_t cost=map_min_dist.sum();
+		if (cost<=0)
+			break;
+
+		/* variates are drawn up front since the generator is shared */
+		for (int32_t i=0; i<lhs_size; i++)
+			uniform[i]=CMath::random(0.0, 1.0);
+
+		int32_t num_old=candidates.size();
+		for (int32_t i=0; i<lhs_size; i++)
+		{
+			if (!is_candidate[i] && uniform[i]<oversampling*min_dist[i]/cost)
+			{
+				candidates.push_back(i);
+				is_candidate[i]=true;
+			}
+		}
+		int32_t num_candidates=candidates.size();
+
+#pragma omp parallel for
+		for (int32_t i=0; i<lhs_size; i++)
+		{
+			for (int32_t c=num_old; c<num_candidates; c++)
+			{
+				float64_t dist=CMath::sq(distance->distance(i, candidates[c]));
+				if (dist<min_dist[i])
+				{
+					min_dist[i]=dist;
+					closest[i]=c;
+				}
+			}
+		}
+	}
+	distance->reset_precompute();
+
+	/* too few candidates, complete them with random points */
+	if ((int32_t) candidates.size()<k)
+	{
+		SGVector<int32_t> perm(lhs_size);
+		perm.range_fill();
+		CMath::permute(perm);
+		for (int32_t i=0; i<lhs_size && (int32_t) candidates.size()<k; i++)
+		{
+			if (!is_candidate[perm[i]])
+			{
+				candidates.push_back(perm[i]);
+				is_candidate[perm[i]]=true;
+			}
+		}
+	}
+
+	int32_t num_candidates=candidates.size();
+	SGMatrix<float64_t> candidate_matrix(dimensions, num_candidates);
+	for (int32_t c=0; c<num_candidates; c++)
+	{
+		SGVector<float64_t> vec=lhs->get_feature_vector(candidates[c]);
+		memcpy(candidate_matrix.get_column_vector(c), vec.vector, sizeof(float64_t)*dimensions);
+		lhs->free_feature_vector(vec, candidates[c]);
+	}
+	SG_UNREF(lhs);
+
+	if (num_candidates==k)
+		return candidate_matrix;
+
+	/* weight of a candidate is the number of points closest to it */
+	SGVector<float64_t> weights(num_candidates);
+	weights.zero();
+	for (int32_t i=0; i<lhs_size; i++)
+		weights[closest[i]]+=1.0;
+
+	return recluster_candidates(candidate_matrix, weights, k, max_iter);
+}
+
 void CKMeansBase::init()
 {
 	max_iter=10000;
@@ -371,9 +642,18 @@ void CKMeansBase::init()
 	dimensions=0;
 	fixed_centers=false;
 	use_kmeanspp=false;
+	use_kmeans_parallel=false;
+	kmeans_parallel_oversampling=2.0;
+	kmeans_parallel_rounds=5;
 	SG_ADD(&max_iter, "max_iter", "Maximum number of iterations", MS_AVAILABLE);
 	SG_ADD(&k, "k", "k, the number of clusters", MS_AVAILABLE);
 	SG_ADD(&dimensions, "dimensions", "Dimensions of data", MS_NOT_AVAILABLE);
 	SG_ADD(&R, "R", "Cluster radiuses", MS_NOT_AVAILABLE);
+	SG_ADD(&use_kmeans_parallel, "use_kmeans_parallel",
+		"Whether KMeans|| initialization is used", MS_NOT_AVAILABLE);
+	SG_ADD(&kmeans_parallel_oversampling, "kmeans_parallel_oversampling",
+		"KMeans|| candidates per round, times k", MS_AVAILABLE);
+	SG_ADD(&kmeans_parallel_rounds, "kmeans_parallel_rounds",
+		"Number of KMeans|| rounds", MS_AVAILABLE);
 }
 
@@ -97,6 +97,27 @@ class CKMeansBase : public CDistanceMachine
 		 */
 		bool get_use_kmeanspp() const;
 
+		/** set use_kmeans_parallel attribute. KMeans|| initialization takes
+		 * precedence over KMeans++ if both are set.
+		 *
+		 * @param kmpar Set true/false to use/not use KMeans|| initialization
+		 */
+		void set_use_kmeans_parallel(bool kmpar);
+
+		/** get use_kmeans_parallel attribute
+		 *
+		 * @return use_kmeans_parallel If KMeans|| initialization is used
+		 */
+		bool get_use_kmeans_parallel() const;
+
+		/** set parameters of KMeans|| initialization
+		 *
+		 * @param oversampling expected number of candidates sampled per
+		 * round, as a multiple of k (default 2)
+		 * @param rounds number of sampling rounds (default 5)
+		 */
+		void set_kmeans_parallel_params(float64_t oversampling, int32_t rounds);
+
 		/** set fixed centers
 		 *
 		 * @param fixed true if fixed cluster centers are intended
@@ -162,6 +183,20 @@ class CKMeansBase : public CDistanceMachine
 		* @return initial cluster centers: matrix (k columns, dim rows)
 		*/
 		SGMatrix<float64_t> kmeanspp();
+
+		/** KMeans|| (scalable KMeans++) algorithm to initialize cluster
+		 * centers. Candidates are oversampled in a few parallel passes over
+		 * the data, weighted by the number of points closest to them and
+		 * reclustered into k centers with weighted KMeans++ and Lloyd
+		 * iterations.
+		 *
+		 * Bahmani, B., Moseley, B., Vattani, A., Kumar, R., & Vassilvitskii, S.
+		 * (2012). Scalable k-means++. Proceedings of the VLDB Endowment, 5(7),
+		 * 622-633.
+		 *
+		 * @return initial cluster centers: matrix (k columns, dim rows)
+		 */
+		SGMatrix<float64_t> kmeans_parallel();
 		
 		void init();
 
@@ -173,6 +208,19 @@ class CKMeansBase : public CDistanceMachine
 
 		void compute_cluster_variances();
 
+		/** set centers to the means of their assigned points. Sums are
+		 * accumulated per thread on contiguous blocks of points and reduced
+		 * afterwards. Centers without points are set to zero.
+		 *
+		 * @param lhs training points
+		 * @param cluster_assignments center index of every point
+		 * @param centers centers to update
+		 * @param weights_set set to the number of points of every center
+		 */
+		void update_centers(CDenseFeatures<float64_t>* lhs,
+				SGVector<int32_t> cluster_assignments,
+				SGMatrix<float64_t> centers, SGVector<int64_t> weights_set);
+
 	protected:
 		/** Maximum number of iterations */
 		int32_t max_iter;
@@ -195,6 +243,15 @@ class CKMeansBase : public CDistanceMachine
 		/** Flag to check if kmeans++ has to be used */
 		bool use_kmeanspp;
 
+		/** Flag to check if kmeans|| has to be used */
+		bool use_kmeans_parallel;
+
+		/** Expected number of candidates per KMeans|| round, times k */
+		float64_t kmeans_parallel_oversampling;
+
+		/** Number of KMeans|| sampling rounds */
+		int32_t kmeans_parallel_rounds;
+
 		/** Cluster centers */
 		SGMatrix<float64_t> mus;
 
@@ -0,0 +1,298 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/clustering/StreamingKMeansMiniBatch.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/distance/Distance.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/io/CSVFile.h>
+#include <shogun/mathematics/eigen3.h>
+
+using namespace shogun;
+using namespace Eigen;
+
+CStreamingKMeansMiniBatch::CStreamingKMeansMiniBatch() : CKMeansMiniBatch()
+{
+	init();
+}
+
+CStreamingKMeansMiniBatch::CStreamingKMeansMiniBatch(int32_t k_i, CDistance* d_i,
+		bool use_kmpp_i) : CKMeansMiniBatch(k_i, d_i, use_kmpp_i)
+{
+	init();
+}
+
+CStreamingKMeansMiniBatch::CStreamingKMeansMiniBatch(int32_t k_i, CDistance* d_i,
+		SGMatrix<float64_t> centers_i) : CKMeansMiniBatch(k_i, d_i, false)
+{
+	init();
+	set_initial_centers(centers_i);
+}
+
+CStreamingKMeansMiniBatch::~CStreamingKMeansMiniBatch()
+{
+	SG_UNREF(streaming_features);
+	SG_FREE(checkpoint_filename);
+}
+
+void CStreamingKMeansMiniBatch::init()
+{
+	streaming_features=NULL;
+	min_learning_rate=0.0;
+	checkpoint_interval=0;
+	checkpoint_filename=NULL;
+
+	SG_ADD((CSGObject**) &streaming_features, "streaming_features",
+		"Streaming features to train on", MS_NOT_AVAILABLE);
+	SG_ADD(&min_learning_rate, "min_learning_rate",
+		"Minimum learning rate of the centers", MS_AVAILABLE);
+	SG_ADD(&center_counts, "center_counts",
+		"Number of vectors assigned to every center", MS_NOT_AVAILABLE);
+	SG_ADD(&initial_center_counts, "initial_center_counts",
+		"Number of vectors assigned to every center before training",
+		MS_NOT_AVAILABLE);
+	SG_ADD(&checkpoint_interval, "checkpoint_interval",
+		"Batches between checkpoints", MS_NOT_AVAILABLE);
+}
+
+void CStreamingKMeansMiniBatch::set_initial_centers(SGMatrix<float64_t> centers)
+{
+	REQUIRE(centers.num_cols==k,
+			"Expected %d initial cluster centers, got %d", k, centers.num_cols);
+	mus_initial=centers;
+}
+
+void CStreamingKMeansMiniBatch::set_streaming_features(
+		CStreamingDenseFeatures<float64_t>* features)
+{
+	SG_REF(features);
+	SG_UNREF(streaming_features);
+	streaming_features=features;
+}
+
+void CStreamingKMeansMiniBatch::set_min_learning_rate(float64_t rate)
+{
+	REQUIRE(rate>=0 && rate<=1, "Minimum learning rate (%f) should be in [0,1]\n", rate);
+	min_learning_rate=rate;
+}
+
+float64_t CStreamingKMeansMiniBatch::get_min_learning_rate() const
+{
+	return min_learning_rate;
+}
+
+void CStreamingKMeansMiniBatch::set_checkpoint(int32_t num_batches, const char* filename)
+{
+	REQUIRE(num_batches>=0, "Number of batches between checkpoints should be >= 0\n");
+	REQUIRE(num_batches==0 || filename, "No checkpoint file provided\n");
+
+	checkpoint_interval=num_batches;
+	SG_FREE(checkpoint_filename);
+	checkpoint_filename=filename ? get_strdup(filename) : NULL;
+}
+
+void CStreamingKMeansMiniBatch::load_checkpoint(const char* filename)
+{
+	REQUIRE(filename, "No checkpoint file provided\n");
+
+	CCSVFile* file=new CCSVFile(filename, 'r');
+	SG_REF(file);
+	SGMatrix<float64_t> checkpoint;
+	checkpoint.load(file);
+	SG_UNREF(file);
+
+	REQUIRE(checkpoint.num_cols==k && checkpoint.num_rows>1, "Expected a \
+checkpoint with %d centers, got a %dx%d matrix\n", k, checkpoint.num_rows,
+		checkpoint.num_cols);
+
+	int32_t dim=checkpoint.num_rows-1;
+	SGMatrix<float64_t> centers(dim, k);
+	SGVector<float64_t> counts(k);
+	for (int32_t j=0; j<k; j++)
+	{
+		memcpy(centers.get_column_vector(j), checkpoint.get_column_vector(j),
+			sizeof(float64_t)*dim);
+		counts[j]=checkpoint(dim, j);
+	}
+
+	set_initial_centers(centers);
+	set_center_counts(counts);
+}
+
+void CStreamingKMeansMiniBatch::set_center_counts(SGVector<float64_t> counts)
+{
+	REQUIRE(counts.vlen==k, "Expected %d center counts, got %d\n", k, counts.vlen);
+	for (int32_t j=0; j<k; j++)
+		REQUIRE(counts[j]>=0, "Center count %d (%f) should be >= 0\n", j, counts[j]);
+
+	initial_center_counts=counts;
+}
+
+SGVector<float64_t> CStreamingKMeansMiniBatch::get_center_counts() const
+{
+	return center_counts;
+}
+
+int32_t CStreamingKMeansMiniBatch::read_batch(SGMatrix<float64_t>& batch)
+{
+	int32_t num_read=0;
+	while (num_read<batch_size && streaming_features->get_next_example())
+	{
+		SGVector<float64_t> vec=streaming_features->get_vector();
+		if (!batch.matrix)
+			batch=SGMatrix<float64_t>(vec.vlen, batch_size);
+
+		REQUIRE(vec.vlen==batch.num_rows, "Streamed vector has %d dimensions, \
+expected %d\n", vec.vlen, batch.num_rows);
+		memcpy(batch.get_column_vector(num_read), vec.vector, sizeof(float64_t)*vec.vlen);
+		streaming_features->release_example();
+		num_read++;
+	}
+
+	return num_read;
+}
+
+void CStreamingKMeansMiniBatch::write_checkpoint()
+{
+	/* the counts below the centers, to resume from both */
+	SGMatrix<float64_t> checkpoint(mus.num_rows+1, mus.num_cols);
+	for (int32_t j=0; j<mus.num_cols; j++)
+	{
+		memcpy(checkpoint.get_column_vector(j), mus.get_column_vector(j),
+			sizeof(float64_t)*mus.num_rows);
+		checkpoint(mus.num_rows, j)=center_counts[j];
+	}
+
+	CCSVFile* file=new CCSVFile(checkpoint_filename, 'w');
+	SG_REF(file);
+	file->set_matrix(checkpoint.matrix, checkpoint.num_rows, checkpoint.num_cols);
+	file->close();
+	SG_UNREF(file);
+}
+
+bool CStreamingKMeansMiniBatch::train_machine(CFeatures* data)
+{
+	if (data)
+	{
+		REQUIRE(data->get_feature_class()==C_STREAMING_DENSE &&
+				data->get_feature_type()==F_DREAL,
+				"Features should be CStreamingDenseFeatures<float64_t>\n");
+		set_streaming_features((CStreamingDenseFeatures<float64_t>*) data);
+	}
+	REQUIRE(streaming_features, "No streaming features provided\n");
+	REQUIRE(batch_size>0,
+		"batch size not set to positive value. Current batch size %d \n", batch_size);
+
+	streaming_features->start_parser();
+
+	/* one buffer for all batches, features of a batch view its first columns */
+	SGMatrix<float64_t> batch;
+	int32_t num_read=read_batch(batch);
+	if (num_read==0)
+	{
+		streaming_features->end_parser();
+		SG_ERROR("No data in stream\n")
+		return false;
+	}
+	REQUIRE(mus_initial.matrix || num_read>=k, "First batch has %d vectors, \
+at least k=%d are needed to initialize centers\n", num_read, k);
+
+	CDenseFeatures<float64_t>* batch_features=new CDenseFeatures<float64_t>(
+			SGMatrix<float64_t>(batch.matrix, batch.num_rows, num_read, false));
+	SG_REF(batch_features);
+	initialize_training(batch_features);
+	REQUIRE(mus.num_rows==batch.num_rows, "Expected %d dimensional cluster \
+centers, got %d", batch.num_rows, mus.num_rows);
+
+	/* never update the user supplied initial centers in place */
+	mus=mus.clone();
+	CDenseFeatures<float64_t>* center_features=new CDenseFeatures<float64_t>(mus);
+	SG_REF(center_features);
+
+	if (initial_center_counts.vector)
+	{
+		REQUIRE(initial_center_counts.vlen==k, "Expected %d center counts, \
+got %d\n", k, initial_center_counts.vlen);
+		center_counts=initial_center_counts.clone();
+	}
+	else
+	{
+		center_counts=SGVector<float64_t>(k);
+		center_counts.zero();
+	}
+	SGVector<int32_t> assignments(batch_size);
+	SGMatrix<float64_t> batch_means(dimensions, k);
+	SGVector<int64_t> batch_counts(k);
+	Map<MatrixXd> map_mus(mus.matrix, dimensions, k);
+	Map<MatrixXd> map_batch_means(batch_means.matrix, dimensions, k);
+
+	int32_t num_batches=0;
+	while (num_read>0)
+	{
+		if (num_batches>0)
+		{
+			SG_UNREF(batch_features);
+			batch_features=new CDenseFeatures<float64_t>(
+				SGMatrix<float64_t>(batch.matrix, batch.num_rows, num_read, false));
+			SG_REF(batch_features);
+		}
+
+		distance->init(batch_features, center_features);
+		distance->precompute_lhs();
+		distance->precompute_rhs();
+
+#pragma omp parallel for
+		for (int32_t i=0; i<num_read; i++)
+		{
+			int32_t min_cluster=0;
+			float64_t min_dist=distance->distance(i,0);
+			for (int32_t j=1; j<k; j++)
+			{
+				float64_t dist=distance->distance(i,j);
+				if (dist<min_dist)
+				{
+					min_dist=dist;
+					min_cluster=j;
+				}
+			}
+			assignments[i]=min_cluster;
+		}
+		distance->reset_precompute();
+
+		SGVector<int32_t> batch_assignments(assignments.vector, num_read, false);
+		update_centers(batch_features, batch_assignments, batch_means, batch_counts);
+
+		for (int32_t j=0; j<k; j++)
+		{
+			if (batch_counts[j]==0)
+				continue;
+
+			center_counts[j]+=batch_counts[j];
+			float64_t eta=CMath::max(batch_counts[j]/center_counts[j], min_learning_rate);
+			map_mus.col(j)+=eta*(map_batch_means.col(j)-map_mus.col(j));
+		}
+
+		num_batches++;
+		if (checkpoint_interval>0 && num_batches%checkpoint_interval==0)
+			write_checkpoint();
+
+		if (minib_iter>0 && num_batches>=minib_iter)
+			break;
+
+		num_read=read_batch(batch);
+	}
+	streaming_features->end_parser();
+
+	/* do not leave the distance pointing into the batch buffer */
+	distance->init(center_features, center_features);
+	SG_UNREF(batch_features);
+	SG_UNREF(center_features);
+
+	SG_INFO("Processed %d batches\n", num_batches)
+	compute_cluster_variances();
+	return true;
+}
@@ -0,0 +1,166 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef _STREAMINGKMEANSMINIBATCH_H__
+#define _STREAMINGKMEANSMINIBATCH_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/common.h>
+#include <shogun/io/SGIO.h>
+#include <shogun/clustering/KMeansMiniBatch.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
+
+namespace shogun
+{
+class CKMeansMiniBatch;
+
+/** @brief Mini-batch KMeans over CStreamingDenseFeatures.
+ *
+ * Consumes the stream in batches of batch_size vectors so that the data never
+ * has to fit in memory. Vectors of a batch are assigned to their closest
+ * center in parallel. Every center keeps the number of vectors \f$v_c\f$ it
+ * was assigned so far and moves towards the mean \f$m_c\f$ of its \f$n_c\f$
+ * vectors in the batch with its own learning rate
+ *
+ * \f[
+ *  \mu_c \leftarrow (1-\eta_c)\mu_c + \eta_c m_c,\quad
+ *  \eta_c = \max(\frac{n_c}{v_c}, \eta_{min})
+ * \f]
+ *
+ * With \f$\eta_{min}=0\f$ (default) every center is the running mean of its
+ * vectors, as in CKMeansMiniBatch. A positive minimum learning rate lets the
+ * centers follow drifting streams.
+ *
+ * Centers are initialized from the first batch (randomly, with KMeans++ or
+ * KMeans||) unless initial centers are given. Centers and their counts
+ * \f$v_c\f$ can be written to a CSV file every few batches with
+ * set_checkpoint(), and load_checkpoint() resumes training from them on the
+ * rest of the stream. Training stops at the end of the stream or after
+ * set_mb_iter() batches.
+ *
+ * Sculley, D. (2010). Web-scale k-means clustering. Proceedings of the 19th
+ * International Conference on World Wide Web, 1177-1178.
+ */
+class CStreamingKMeansMiniBatch : public CKMeansMiniBatch
+{
+	public:
+		/** default constructor */
+		CStreamingKMeansMiniBatch();
+
+		/** constructor
+		 *
+		 * @param k parameter k
+		 * @param d distance
+		 * @param kmeanspp true for using KMeans++ on the first batch (default false)
+		 */
+		CStreamingKMeansMiniBatch(int32_t k, CDistance* d, bool kmeanspp=false);
+
+		/** constructor for supplying initial centers
+		 * @param k_i parameter k
+		 * @param d_i distance
+		 * @param centers_i initial centers
+		 */
+		CStreamingKMeansMiniBatch(int32_t k_i, CDistance* d_i, SGMatrix<float64_t> centers_i);
+
+		virtual ~CStreamingKMeansMiniBatch();
+
+		/** @return object name */
+		virtual const char* get_name() const { return "StreamingKMeansMiniBatch"; }
+
+		/** set the initial cluster centers, no features have to be known
+		 *
+		 * @param centers matrix with cluster centers (k colums, dim rows)
+		 */
+		virtual void set_initial_centers(SGMatrix<float64_t> centers);
+
+		/** set streaming features to train on
+		 *
+		 * @param features streaming dense real-valued features
+		 */
+		void set_streaming_features(CStreamingDenseFeatures<float64_t>* features);
+
+		/** set minimum learning rate of the centers
+		 *
+		 * @param rate minimum learning rate in [0,1] (default 0)
+		 */
+		void set_min_learning_rate(float64_t rate);
+
+		/** @return minimum learning rate of the centers */
+		float64_t get_min_learning_rate() const;
+
+		/** write centers and their counts to a CSV file every few batches.
+		 * The file is overwritten by each checkpoint. It holds a matrix with
+		 * one column per center, the center followed by its count.
+		 *
+		 * @param num_batches batches between checkpoints, 0 disables them
+		 * @param filename file to write centers to
+		 */
+		void set_checkpoint(int32_t num_batches, const char* filename);
+
+		/** set the centers and their counts from a checkpoint file written
+		 * during an earlier training, so that the next training resumes it
+		 *
+		 * @param filename checkpoint file
+		 */
+		void load_checkpoint(const char* filename);
+
+		/** set the number of vectors assigned to every center before the
+		 * next training, to resume one from its centers. Zero by default.
+		 *
+		 * @param counts number of vectors assigned to every center
+		 */
+		void set_center_counts(SGVector<float64_t> counts);
+
+		/** @return number of vectors assigned to every center so far */
+		SGVector<float64_t> get_center_counts() const;
+
+	protected:
+		/** train on the stream
+		 *
+		 * @param data CStreamingDenseFeatures<float64_t> (optional if set
+		 * before with set_streaming_features)
+		 *
+		 * @return whether training was successful
+		 */
+		virtual bool train_machine(CFeatures* data=NULL);
+
+		/** read up to batch.num_cols vectors from the stream into batch,
+		 * which is allocated once the dimension is known
+		 *
+		 * @param batch batch buffer
+		 * @return number of vectors read
+		 */
+		int32_t read_batch(SGMatrix<float64_t>& batch);
+
+		/** write centers and their counts to the checkpoint file */
+		void write_checkpoint();
+
+	private:
+		void init();
+
+	protected:
+		/** stream to train on */
+		CStreamingDenseFeatures<float64_t>* streaming_features;
+
+		/** minimum learning rate of the centers */
+		float64_t min_learning_rate;
+
+		/** number of vectors assigned to every center */
+		SGVector<float64_t> center_counts;
+
+		/** number of vectors assigned to every center before training */
+		SGVector<float64_t> initial_center_counts;
+
+		/** batches between checkpoints, 0 if disabled */
+		int32_t checkpoint_interval;
+
+		/** file centers are written to */
+		char* checkpoint_filename;
+};
+}
+#endif
@@ -22,6 +22,7 @@ CEmbeddingConverter::CEmbeddingConverter()
 	m_target_dim = 1;
 	m_distance = new CEuclideanDistance();
 	m_kernel = new CLinearKernel();
+	m_knn_method = KNNG_KD_TREE;
 
 	init();
 }
@@ -74,6 +75,16 @@ CKernel* CEmbeddingConverter::get_kernel() const
 	return m_kernel;
 }
 
+void CEmbeddingConverter::set_knn_method(EKNNGraphMethod method)
+{
+	m_knn_method = method;
+}
+
+EKNNGraphMethod CEmbeddingConverter::get_knn_method() const
+{
+	return m_knn_method;
+}
+
 void CEmbeddingConverter::init()
 {
 	SG_ADD(&m_target_dim, "target_dim",
@@ -82,5 +93,7 @@ void CEmbeddingConverter::init()
 	    "distance to be used for embedding", MS_AVAILABLE);
 	SG_ADD((CSGObject**)&m_kernel, "kernel", "kernel to be used for embedding",
 	    MS_AVAILABLE);
+	SG_ADD((machine_int_t*) &m_knn_method, "knn_method",
+	    "nearest neighbors search method", MS_NOT_AVAILABLE);
 }
 }
@@ -18,6 +18,7 @@
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/distance/Distance.h>
 #include <shogun/kernel/Kernel.h>
+#include <shogun/multiclass/tree/KNNGraphBuilder.h>
 
 namespace shogun
 {
@@ -83,6 +84,17 @@ public:
 	 */
 	CKernel* get_kernel() const;
 
+	/** setter for the method the nearest neighbors are found with by
+	 * converters based on a neighborhood graph
+	 * @param method nearest neighbors search method
+	 */
+	void set_knn_method(EKNNGraphMethod method);
+
+	/** getter for the nearest neighbors search method
+	 * @return nearest neighbors search method
+	 */
+	EKNNGraphMethod get_knn_method() const;
+
 	virtual const char* get_name() const { return "EmbeddingConverter"; };
 
 protected:
@@ -100,6 +112,9 @@ protected:
 
 	/** kernel to be used */
 	CKernel* m_kernel;
+
+	/** nearest neighbors search method */
+	EKNNGraphMethod m_knn_method;
 };
 }
 
@@ -34,6 +34,7 @@ CFeatures* CHessianLocallyLinearEmbedding::apply(CFeatures* features)
 	CKernel* kernel = new CLinearKernel((CDotFeatures*)features,(CDotFeatures*)features);
 	TAPKEE_PARAMETERS_FOR_SHOGUN parameters;
 	parameters.n_neighbors = m_k;
+	parameters.knn_method = m_knn_method;
 	parameters.eigenshift = m_nullspace_shift;
 	parameters.method = SHOGUN_HESSIAN_LOCALLY_LINEAR_EMBEDDING;
 	parameters.target_dimension = m_target_dim;
@@ -42,7 +42,16 @@ class CDistance;
  * - Compute embedding with the \f$t\f$ eigenvectors that correspond to the largest eigenvalues of the matrix \f$D\f$; normalize these vectors
  *   dividing each eigenvector by the square root of its corresponding eigenvalue. Form the final embedding with eigenvectors as rows and projected
  *   feature vectors as columns.
-
+ *
+ * The neighbourhood graph is undirected, i.e. vectors are also connected to
+ * the vectors they are neighbours of. In landmark mode (see set_landmark())
+ * shortest distances are only computed from the landmarks, in parallel one
+ * landmark per thread, and only a landmarks x vectors matrix is stored, so
+ * memory is linear in the number of vectors. Without landmarks the dense
+ * N x N matrix of shortest distances is stored, so only landmark mode
+ * scales to large numbers of vectors. Without ARPACK a Lanczos
+ * eigensolver computes the eigenvectors without a full eigendecomposition.
+ *
  * It is possible to apply preprocessor to specified distance using
  * apply_to_distance.
  *
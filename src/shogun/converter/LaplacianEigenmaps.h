@@ -29,7 +29,10 @@ class CDistance;
  * Science, 14, 585-591. MIT Press.
  * Retrieved from http://citeseerx.ist.psu.edu/viewdoc/download?doi=10.1.1.19.9400&rep=rep1&type=pdf
  *
- * Uses implementation from the Tapkee library.
+ * Uses implementation from the Tapkee library. Without ARPACK the
+ * generalized eigenproblem of the sparse laplacian is solved with a
+ * Lanczos method on the normalized laplacian, which only multiplies sparse
+ * matrices, so memory is linear in the number of vectors.
  *
  * To use this converter with static interfaces please refer it by
  * sg('create_converter','laplacian_eigenmaps',k,width);
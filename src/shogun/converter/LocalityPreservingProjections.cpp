@@ -34,6 +34,7 @@ CFeatures* CLocalityPreservingProjections::apply(CFeatures* features)
 	TAPKEE_PARAMETERS_FOR_SHOGUN parameters;
 	m_distance->init(features,features);
 	parameters.n_neighbors = m_k;
+	parameters.knn_method = m_knn_method;
 	parameters.gaussian_kernel_width = m_tau;
 	parameters.method = SHOGUN_LOCALITY_PRESERVING_PROJECTIONS;
 	parameters.target_dimension = m_target_dim;
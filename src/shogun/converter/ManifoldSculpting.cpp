@@ -85,6 +85,7 @@ CFeatures* CManifoldSculpting::apply(CFeatures* features)
 
 	TAPKEE_PARAMETERS_FOR_SHOGUN parameters;
 	parameters.n_neighbors = m_k;
+	parameters.knn_method = m_knn_method;
 	parameters.squishing_rate = m_squishing_rate;
 	parameters.max_iteration = m_max_iteration;
 	parameters.features = feats;
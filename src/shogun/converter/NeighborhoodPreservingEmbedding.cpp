@@ -35,6 +35,7 @@ CFeatures* CNeighborhoodPreservingEmbedding::apply(CFeatures* features)
 	CKernel* kernel = new CLinearKernel((CDotFeatures*)features,(CDotFeatures*)features);
 	TAPKEE_PARAMETERS_FOR_SHOGUN parameters;
 	parameters.n_neighbors = m_k;
+	parameters.knn_method = m_knn_method;
 	parameters.eigenshift = m_nullspace_shift;
 	parameters.method = SHOGUN_NEIGHBORHOOD_PRESERVING_EMBEDDING;
 	parameters.target_dimension = m_target_dim;
@@ -80,6 +80,31 @@ float64_t CEuclideanDistance::compute(int32_t idx_a, int32_t idx_b)
 	return CMath::sqrt(result);
 }
 
+void CEuclideanDistance::distance_subset(int32_t idx_a, const int32_t* idx_b,
+		int32_t num, float64_t* result)
+{
+	REQUIRE(lhs, "Left hand side feature cannot be NULL!\n");
+	REQUIRE(rhs, "Right hand side feature cannot be NULL!\n");
+
+	if (lhs->get_feature_class()!=rhs->get_feature_class())
+	{
+		for (int32_t i=0; i<num; i++)
+			result[i]=distance(idx_a, idx_b[i]);
+		return;
+	}
+
+	CDotFeatures* casted_lhs=static_cast<CDotFeatures*>(lhs);
+	casted_lhs->dot_subset(idx_a, static_cast<CDotFeatures*>(rhs), idx_b, num,
+		result);
+
+	for (int32_t i=0; i<num; i++)
+	{
+		result[i]=m_lhs_squared_norms[idx_a]+m_rhs_squared_norms[idx_b[i]]-2*result[i];
+		if (!disable_sqrt)
+			result[i]=CMath::sqrt(result[i]);
+	}
+}
+
 void CEuclideanDistance::precompute_lhs()
 {
 	REQUIRE(lhs, "Left hand side feature cannot be NULL!\n");
@@ -134,6 +134,18 @@ public:
 	 */
 	virtual float64_t distance_upper_bounded(int32_t idx_a, int32_t idx_b, float64_t upper_bound);
 
+	/** compute the distances between lhs feature vector a and the rhs
+	 *  feature vectors b[0], ..., b[num-1]. The dot products are computed
+	 *  at once, see CDotFeatures::dot_subset()
+	 *
+	 *  @param idx_a feature vector a at idx_a
+	 *  @param idx_b indices of rhs feature vectors
+	 *  @param num number of rhs feature vectors
+	 *  @param result distances (output, length num)
+	 */
+	void distance_subset(int32_t idx_a, const int32_t* idx_b, int32_t num,
+			float64_t* result);
+
 	/**
 	 * Precomputation of squared norms for features of right hand side
 	 * WARNING : Make sure to reset computations using reset_precompute()
@@ -40,13 +40,22 @@ SGVector<float64_t> CDistribution::get_log_likelihood()
 {
 	ASSERT(features)
 
-	int32_t num=features->get_num_vectors();
-	float64_t* vec=SG_MALLOC(float64_t, num);
+	return get_log_likelihood_examples(0, features->get_num_vectors());
+}
 
-	for (int32_t i=0; i<num; i++)
-		vec[i]=get_log_likelihood_example(i);
+SGVector<float64_t> CDistribution::get_log_likelihood_examples(
+	int32_t start, int32_t stop)
+{
+	ASSERT(features)
+	REQUIRE(start>=0 && start<=stop && stop<=features->get_num_vectors(),
+		"Invalid range of examples [%d, %d) for %d examples\n", start, stop,
+		features->get_num_vectors());
+
+	SGVector<float64_t> result(stop-start);
+	for (int32_t i=start; i<stop; i++)
+		result[i-start]=get_log_likelihood_example(i);
 
-	return SGVector<float64_t>(vec,num);
+	return result;
 }
 
 int32_t CDistribution::get_num_relevant_model_parameters()
@@ -115,6 +115,16 @@ class CDistribution : public CSGObject
 		 */
 		virtual SGVector<float64_t> get_log_likelihood();
 
+		/** compute log likelihood for a range of examples. Subclasses can
+		 * evaluate all examples at once instead of one at a time.
+		 *
+		 * @param start index of first example
+		 * @param stop index one past the last example
+		 * @return log likelihood vector of length stop-start
+		 */
+		virtual SGVector<float64_t> get_log_likelihood_examples(
+			int32_t start, int32_t stop);
+
 		/** get model parameter
 		 *
 		 * @param num_param which param
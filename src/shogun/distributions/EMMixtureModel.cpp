@@ -43,18 +43,25 @@ CEMMixtureModel::~CEMMixtureModel()
 
 float64_t CEMMixtureModel::expectation_step()
 {
+	// log of weighted likelihood of all data points, one component at a time
+	for (int32_t j=0;j<data.alpha.num_cols;j++)
+	{
+		CDistribution* jth_component=CDistribution::obtain_from_generic(data.components->get_element(j));
+		SGVector<float64_t> log_likelihood=jth_component->get_log_likelihood_examples(0,data.alpha.num_rows);
+		float64_t log_weight=CMath::log(data.weights[j]);
+		for (int32_t i=0;i<data.alpha.num_rows;i++)
+			data.alpha(i,j)=log_weight+log_likelihood[i];
+
+		SG_UNREF(jth_component);
+	}
+
 	float64_t log_likelihood=0;
+	SGVector<float64_t> alpha_ij(data.alpha.num_cols);
 	// for each data point
 	for (int32_t i=0;i<data.alpha.num_rows;i++)
 	{
-		SGVector<float64_t> alpha_ij(data.alpha.num_cols);
-		// for each component
 		for (int32_t j=0;j<data.alpha.num_cols;j++)
-		{
-			CDistribution* jth_component=CDistribution::obtain_from_generic(data.components->get_element(j));
-			alpha_ij[j]=CMath::log(data.weights[j])+jth_component->get_log_likelihood_example(i);
-			SG_UNREF(jth_component);
-		};
+			alpha_ij[j]=data.alpha(i,j);
 
 		float64_t normalize=CMath::log_sum_exp(alpha_ij);
 		log_likelihood+=normalize;
@@ -16,8 +16,14 @@
 #include <shogun/mathematics/Math.h>
 #include <shogun/base/Parameter.h>
 #include <shogun/mathematics/lapack.h>
+#include <shogun/mathematics/eigen3.h>
+#include <shogun/features/DenseFeatures.h>
 
 using namespace shogun;
+using namespace Eigen;
+
+/* number of points transformed at once in the batched log PDF */
+#define GAUSSIAN_BLOCK_SIZE 1024
 
 CGaussian::CGaussian() : CDistribution(), m_constant(0), m_d(), m_u(), m_mean(), m_cov_type(FULL)
 {
@@ -115,6 +121,32 @@ float64_t CGaussian::get_log_likelihood_example(int32_t num_example)
 	return answer;
 }
 
+SGVector<float64_t> CGaussian::get_log_likelihood_examples(int32_t start, int32_t stop)
+{
+	REQUIRE(features, "Features not set\n")
+	REQUIRE(start>=0 && start<=stop && stop<=features->get_num_vectors(),
+		"Invalid range of examples [%d, %d) for %d examples\n", start, stop,
+		features->get_num_vectors());
+
+	if (features->get_feature_class()==C_DENSE && features->get_feature_type()==F_DREAL)
+	{
+		SGMatrix<float64_t> matrix=((CDenseFeatures<float64_t>*) features)->get_feature_matrix();
+		return compute_log_PDF(SGMatrix<float64_t>(matrix.get_column_vector(start),
+				matrix.num_rows, stop-start, false));
+	}
+
+	ASSERT(features->has_property(FP_DOT))
+	CDotFeatures* dotdata=(CDotFeatures*) features;
+	SGMatrix<float64_t> points(dotdata->get_dim_feature_space(), stop-start);
+	for (int32_t i=start; i<stop; i++)
+	{
+		SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(i);
+		memcpy(points.get_column_vector(i-start), v.vector, sizeof(float64_t)*v.vlen);
+	}
+
+	return compute_log_PDF(points);
+}
+
 float64_t CGaussian::update_params_em(float64_t* alpha_k, int32_t len)
 {
 	CDotFeatures* dotdata=dynamic_cast<CDotFeatures *>(features);
@@ -258,6 +290,57 @@ float64_t CGaussian::compute_log_PDF(SGVector<float64_t> point)
 	return -0.5*answer;
 }
 
+SGVector<float64_t> CGaussian::compute_log_PDF(SGMatrix<float64_t> points)
+{
+	ASSERT(m_mean.vector && m_d.vector)
+	REQUIRE(points.num_rows==m_mean.vlen, "Dimension of points (%d) does not "
+		"match dimension of the Gaussian (%d)\n", points.num_rows, m_mean.vlen);
+
+	int32_t num_dim=m_mean.vlen;
+	int32_t num_points=points.num_cols;
+	SGVector<float64_t> result(num_points);
+
+	/* the Mahalanobis distance is ||W x - W mu||^2 with W=D^{-1/2}U for full
+	 * covariances (rows of U are the eigenvectors) and W=D^{-1/2} otherwise */
+	Map<VectorXd> mean(m_mean.vector, num_dim);
+	VectorXd scales(num_dim);
+	for (int32_t i=0; i<num_dim; i++)
+		scales[i]=1.0/CMath::sqrt(m_d.vector[m_cov_type==SPHERICAL ? 0 : i]);
+
+	MatrixXd whitening;
+	VectorXd whitened_mean;
+	if (m_cov_type==FULL)
+	{
+		Map<MatrixXd> u(m_u.matrix, num_dim, num_dim);
+		whitening=scales.asDiagonal()*u.transpose();
+		whitened_mean=whitening*mean;
+	}
+	else
+		whitened_mean=scales.cwiseProduct(mean);
+
+	int32_t num_blocks=(num_points+GAUSSIAN_BLOCK_SIZE-1)/GAUSSIAN_BLOCK_SIZE;
+
+#pragma omp parallel for
+	for (int32_t b=0; b<num_blocks; b++)
+	{
+		int32_t start=b*GAUSSIAN_BLOCK_SIZE;
+		int32_t len=CMath::min(GAUSSIAN_BLOCK_SIZE, num_points-start);
+		Map<MatrixXd> block(points.get_column_vector(start), num_dim, len);
+		MatrixXd whitened(num_dim, len);
+
+		if (m_cov_type==FULL)
+			whitened.noalias()=whitening*block;
+		else
+			whitened.noalias()=scales.asDiagonal()*block;
+
+		whitened.colwise()-=whitened_mean;
+		Map<VectorXd> block_result(result.vector+start, len);
+		block_result=-0.5*(whitened.colwise().squaredNorm().transpose().array()+m_constant);
+	}
+
+	return result;
+}
+
 SGVector<float64_t> CGaussian::get_mean()
 {
 	return m_mean;
@@ -102,6 +102,15 @@ class CGaussian : public CDistribution
 		 */
 		virtual float64_t get_log_likelihood_example(int32_t num_example);
 
+		/** compute log likelihood for a range of examples at once
+		 *
+		 * @param start index of first example
+		 * @param stop index one past the last example
+		 * @return log likelihood vector of length stop-start
+		 */
+		virtual SGVector<float64_t> get_log_likelihood_examples(
+			int32_t start, int32_t stop);
+
 		/** update parameters in the em maximization step for mixture model of which
 		 * this distribution is a part
 		 *
@@ -128,6 +137,16 @@ class CGaussian : public CDistribution
 		 */
 		virtual float64_t compute_log_PDF(SGVector<float64_t> point);
 
+		/** compute log PDF of many points at once. The transform whitening
+		 * the points is set up once, points are then transformed blockwise
+		 * in parallel.
+		 *
+		 * @param points points for which to compute the log PDF (one per
+		 * column)
+		 * @return computed log PDF of every point
+		 */
+		virtual SGVector<float64_t> compute_log_PDF(SGMatrix<float64_t> points);
+
 		/** get mean
 		 *
 		 * @return mean
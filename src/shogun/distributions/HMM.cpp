@@ -167,6 +167,7 @@ CHMM::CHMM()
 	arrayS = NULL;
 #endif
 #ifdef USE_HMMPARALLEL_STRUCTURES
+	num_workers=0;
 	this->alpha_cache=NULL;
 	this->beta_cache=NULL;
 	path_prob_updated = NULL;
@@ -249,6 +250,7 @@ CHMM::CHMM(int32_t p_N, float64_t* p, float64_t* q, float64_t* a)
 	this->reused_caches=false;
 
 #ifdef USE_HMMPARALLEL_STRUCTURES
+	num_workers=0;
 	this->alpha_cache=NULL;
 	this->beta_cache=NULL;
 #else
@@ -302,6 +304,7 @@ CHMM::CHMM(
 	this->reused_caches=false;
 
 #ifdef USE_HMMPARALLEL_STRUCTURES
+	num_workers=0;
 	this->alpha_cache=NULL;
 	this->beta_cache=NULL;
 #else
@@ -433,7 +436,7 @@ CHMM::~CHMM()
 #ifdef USE_HMMPARALLEL_STRUCTURES
 		if (mem_initialized)
 		{
-			for (int32_t i=0; i<parallel->get_num_threads(); i++)
+			for (int32_t i=0; i<num_workers; i++)
 			{
 				SG_FREE(alpha_cache[i].table);
 				SG_FREE(beta_cache[i].table);
@@ -461,7 +464,7 @@ CHMM::~CHMM()
 	{
 		if (mem_initialized)
 		{
-			for (int32_t i=0; i<parallel->get_num_threads(); i++)
+			for (int32_t i=0; i<num_workers; i++)
 				SG_FREE(arrayS[i]);
 		}
 		SG_FREE(arrayS);
@@ -478,7 +481,7 @@ CHMM::~CHMM()
 		{
 			SG_FREE(path_prob_updated);
 			SG_FREE(path_prob_dimension);
-			for (int32_t i=0; i<parallel->get_num_threads(); i++)
+			for (int32_t i=0; i<num_workers; i++)
 				SG_FREE(path[i]);
 		}
 #endif //USE_HMMPARALLEL_STRUCTURES
@@ -515,7 +518,7 @@ bool CHMM::alloc_state_dependend_arrays()
 	}
 
 #ifdef USE_HMMPARALLEL_STRUCTURES
-	for (int32_t i=0; i<parallel->get_num_threads(); i++)
+	for (int32_t i=0; i<num_workers; i++)
 	{
 		arrayN1[i]=SG_MALLOC(float64_t, N);
 		arrayN2[i]=SG_MALLOC(float64_t, N);
@@ -527,7 +530,7 @@ bool CHMM::alloc_state_dependend_arrays()
 
 #ifdef LOG_SUMARRAY
 #ifdef USE_HMMPARALLEL_STRUCTURES
-	for (int32_t i=0; i<parallel->get_num_threads(); i++)
+	for (int32_t i=0; i<num_workers; i++)
 		arrayS[i]=SG_MALLOC(float64_t, (int32_t)(this->N/2+1));
 #else //USE_HMMPARALLEL_STRUCTURES
 	arrayS=SG_MALLOC(float64_t, (int32_t)(this->N/2+1));
@@ -562,7 +565,7 @@ void CHMM::free_state_dependend_arrays()
 #ifdef USE_HMMPARALLEL_STRUCTURES
 	if (arrayN1 && arrayN2)
 	{
-		for (int32_t i=0; i<parallel->get_num_threads(); i++)
+		for (int32_t i=0; i<num_workers; i++)
 		{
 			SG_FREE(arrayN1[i]);
 			SG_FREE(arrayN2[i]);
@@ -618,11 +621,12 @@ bool CHMM::initialize_hmm(Model* m, float64_t pseudo, FILE* modelfile)
 	this->reused_caches=false;
 
 #ifdef USE_HMMPARALLEL_STRUCTURES
-	alpha_cache=SG_MALLOC(T_ALPHA_BETA, parallel->get_num_threads());
-	beta_cache=SG_MALLOC(T_ALPHA_BETA, parallel->get_num_threads());
-	states_per_observation_psi=SG_MALLOC(P_STATES, parallel->get_num_threads());
+	num_workers=parallel->get_num_threads();
+	alpha_cache=SG_MALLOC(T_ALPHA_BETA, num_workers);
+	beta_cache=SG_MALLOC(T_ALPHA_BETA, num_workers);
+	states_per_observation_psi=SG_MALLOC(P_STATES, num_workers);
 
-	for (int32_t i=0; i<parallel->get_num_threads(); i++)
+	for (int32_t i=0; i<num_workers; i++)
 	{
 		this->alpha_cache[i].table=NULL;
 		this->beta_cache[i].table=NULL;
@@ -643,12 +647,12 @@ bool CHMM::initialize_hmm(Model* m, float64_t pseudo, FILE* modelfile)
 		files_ok= files_ok && load_model(modelfile);
 
 #ifdef USE_HMMPARALLEL_STRUCTURES
-	path_prob_updated=SG_MALLOC(bool, parallel->get_num_threads());
-	path_prob_dimension=SG_MALLOC(int, parallel->get_num_threads());
+	path_prob_updated=SG_MALLOC(bool, num_workers);
+	path_prob_dimension=SG_MALLOC(int, num_workers);
 
-	path=SG_MALLOC(P_STATES, parallel->get_num_threads());
+	path=SG_MALLOC(P_STATES, num_workers);
 
-	for (int32_t i=0; i<parallel->get_num_threads(); i++)
+	for (int32_t i=0; i<num_workers; i++)
 		this->path[i]=NULL;
 
 #else // USE_HMMPARALLEL_STRUCTURES
@@ -657,13 +661,13 @@ bool CHMM::initialize_hmm(Model* m, float64_t pseudo, FILE* modelfile)
 #endif //USE_HMMPARALLEL_STRUCTURES
 
 #ifdef USE_HMMPARALLEL_STRUCTURES
-	arrayN1=SG_MALLOC(float64_t*, parallel->get_num_threads());
-	arrayN2=SG_MALLOC(float64_t*, parallel->get_num_threads());
+	arrayN1=SG_MALLOC(float64_t*, num_workers);
+	arrayN2=SG_MALLOC(float64_t*, num_workers);
 #endif //USE_HMMPARALLEL_STRUCTURES
 
 #ifdef LOG_SUMARRAY
 #ifdef USE_HMMPARALLEL_STRUCTURES
-	arrayS=SG_MALLOC(float64_t*, parallel->get_num_threads());
+	arrayS=SG_MALLOC(float64_t*, num_workers);
 #endif // USE_HMMPARALLEL_STRUCTURES
 #endif //LOG_SUMARRAY
 
@@ -1184,6 +1188,7 @@ float64_t CHMM::best_path(int32_t dimension)
 	{
 		register float64_t* delta= ARRAYN2(dimension);
 		register float64_t* delta_new= ARRAYN1(dimension);
+		float64_t path_prob;
 
 		{ //initialization
 			for (register int32_t i=0; i<N; i++)
@@ -1261,7 +1266,7 @@ float64_t CHMM::best_path(int32_t dimension)
 					argmax=i;
 				}
 			}
-			pat_prob=maxj;
+			path_prob=maxj;
 			PATH(dimension)[p_observations->get_vector_length(dimension)-1]=argmax;
 		} ;
 
@@ -1274,7 +1279,9 @@ float64_t CHMM::best_path(int32_t dimension)
 		}
 		PATH_PROB_UPDATED(dimension)=true;
 		PATH_PROB_DIMENSION(dimension)=dimension;
-		return pat_prob ;
+		pat_prob=path_prob;
+		/* pat_prob is shared by all cache slots, return the own result */
+		return path_prob;
 	}
 }
 
@@ -1294,83 +1301,30 @@ float64_t CHMM::model_probability_comp()
 
 float64_t CHMM::model_probability_comp()
 {
-	pthread_t *threads=SG_MALLOC(pthread_t, parallel->get_num_threads());
-	S_BW_THREAD_PARAM *params=SG_MALLOC(S_BW_THREAD_PARAM, parallel->get_num_threads());
+	int32_t num_vectors=p_observations->get_num_vectors();
+	float64_t* worker_prob=SG_MALLOC(float64_t, num_workers);
 
 	SG_INFO("computing full model probablity\n")
-	mod_prob=0;
 
-	for (int32_t cpu=0; cpu<parallel->get_num_threads(); cpu++)
+	/* worker w owns the cache slot w, i.e. sequences w, w+num_workers, ... */
+#pragma omp parallel for num_threads(num_workers)
+	for (int32_t w=0; w<num_workers; w++)
 	{
-		params[cpu].hmm=this ;
-		params[cpu].dim_start= p_observations->get_num_vectors()*cpu/parallel->get_num_threads();
-		params[cpu].dim_stop= p_observations->get_num_vectors()*(cpu+1)/parallel->get_num_threads();
-		params[cpu].p_buf=SG_MALLOC(float64_t, N);
-		params[cpu].q_buf=SG_MALLOC(float64_t, N);
-		params[cpu].a_buf=SG_MALLOC(float64_t, N*N);
-		params[cpu].b_buf=SG_MALLOC(float64_t, N*M);
-		pthread_create(&threads[cpu], NULL, bw_dim_prefetch, (void*)&params[cpu]);
+		worker_prob[w]=0;
+		for (int32_t dim=w; dim<num_vectors; dim+=num_workers)
+			worker_prob[w]+=forward(p_observations->get_vector_length(dim), 0, dim);
 	}
 
-	for (int32_t cpu=0; cpu<parallel->get_num_threads(); cpu++)
-	{
-		pthread_join(threads[cpu], NULL);
-		mod_prob+=params[cpu].ret;
-	}
-
-	for (int32_t i=0; i<parallel->get_num_threads(); i++)
-	{
-		SG_FREE(params[i].p_buf);
-		SG_FREE(params[i].q_buf);
-		SG_FREE(params[i].a_buf);
-		SG_FREE(params[i].b_buf);
-	}
+	mod_prob=0;
+	for (int32_t w=0; w<num_workers; w++)
+		mod_prob+=worker_prob[w];
 
-	SG_FREE(threads);
-	SG_FREE(params);
+	SG_FREE(worker_prob);
 
 	mod_prob_updated=true;
 	return mod_prob;
 }
 
-void* CHMM::bw_dim_prefetch(void* params)
-{
-	CHMM* hmm=((S_BW_THREAD_PARAM*) params)->hmm;
-	int32_t start=((S_BW_THREAD_PARAM*) params)->dim_start;
-	int32_t stop=((S_BW_THREAD_PARAM*) params)->dim_stop;
-	float64_t* p_buf=((S_BW_THREAD_PARAM*) params)->p_buf;
-	float64_t* q_buf=((S_BW_THREAD_PARAM*) params)->q_buf;
-	float64_t* a_buf=((S_BW_THREAD_PARAM*) params)->a_buf;
-	float64_t* b_buf=((S_BW_THREAD_PARAM*) params)->b_buf;
-	((S_BW_THREAD_PARAM*)params)->ret=0;
-
-	for (int32_t dim=start; dim<stop; dim++)
-	{
-		hmm->forward_comp(hmm->p_observations->get_vector_length(dim), hmm->N-1, dim) ;
-		hmm->backward_comp(hmm->p_observations->get_vector_length(dim), hmm->N-1, dim) ;
-		float64_t modprob=hmm->model_probability(dim) ;
-		hmm->ab_buf_comp(p_buf, q_buf, a_buf, b_buf, dim) ;
-		((S_BW_THREAD_PARAM*)params)->ret+= modprob;
-	}
-	return NULL ;
-}
-
-void* CHMM::bw_single_dim_prefetch(void * params)
-{
-	CHMM* hmm=((S_BW_THREAD_PARAM*)params)->hmm ;
-	int32_t dim=((S_DIM_THREAD_PARAM*)params)->dim ;
-	((S_DIM_THREAD_PARAM*)params)->prob_sum = hmm->model_probability(dim);
-	return NULL ;
-}
-
-void* CHMM::vit_dim_prefetch(void * params)
-{
-	CHMM* hmm=((S_DIM_THREAD_PARAM*)params)->hmm ;
-	int32_t dim=((S_DIM_THREAD_PARAM*)params)->dim ;
-	((S_DIM_THREAD_PARAM*)params)->prob_sum = hmm->best_path(dim);
-	return NULL ;
-}
-
 #endif //USE_HMMPARALLEL
 
 
@@ -1389,8 +1343,8 @@ void CHMM::ab_buf_comp(
 	for (i=0; i<N; i++)
 	{
 		//estimate initial+end state distribution numerator
-		p_buf[i]=get_p(i)+get_b(i,p_observations->get_feature(dim,0))+backward(0,i,dim) - dimmodprob;
-		q_buf[i]=forward(p_observations->get_vector_length(dim)-1, i, dim)+get_q(i) - dimmodprob;
+		p_buf[i]=CMath::logarithmic_sum(p_buf[i], get_p(i)+get_b(i,p_observations->get_feature(dim,0))+backward(0,i,dim) - dimmodprob);
+		q_buf[i]=CMath::logarithmic_sum(q_buf[i], forward(p_observations->get_vector_length(dim)-1, i, dim)+get_q(i) - dimmodprob);
 
 		//estimate a
 		for (j=0; j<N; j++)
@@ -1402,7 +1356,7 @@ void CHMM::ab_buf_comp(
 				a_sum= CMath::logarithmic_sum(a_sum, forward(t,i,dim)+
 						get_a(i,j)+get_b(j,p_observations->get_feature(dim,t+1))+backward(t+1,j,dim));
 			}
-			a_buf[N*i+j]=a_sum-dimmodprob ;
+			a_buf[N*i+j]=CMath::logarithmic_sum(a_buf[N*i+j], a_sum-dimmodprob);
 		}
 
 		//estimate b
@@ -1416,7 +1370,7 @@ void CHMM::ab_buf_comp(
 					b_sum=CMath::logarithmic_sum(b_sum, forward(t,i,dim)+backward(t, i, dim));
 			}
 
-			b_buf[M*i+j]=b_sum-dimmodprob ;
+			b_buf[M*i+j]=CMath::logarithmic_sum(b_buf[M*i+j], b_sum-dimmodprob);
 		}
 	}
 }
@@ -1452,68 +1406,73 @@ void CHMM::estimate_model_baum_welch(CHMM* hmm)
 	}
 	invalidate_model();
 
-	int32_t num_threads = parallel->get_num_threads();
-
-	pthread_t *threads=SG_MALLOC(pthread_t, num_threads);
-	S_BW_THREAD_PARAM *params=SG_MALLOC(S_BW_THREAD_PARAM, num_threads);
+	int32_t num_vectors=p_observations->get_num_vectors();
+	int32_t num_threads=hmm->num_workers;
 
-	if (p_observations->get_num_vectors()<num_threads)
-		num_threads=p_observations->get_num_vectors();
+	/* per worker numerators, summed in log space */
+	float64_t* p_buf=SG_MALLOC(float64_t, num_threads*N);
+	float64_t* q_buf=SG_MALLOC(float64_t, num_threads*N);
+	float64_t* a_buf=SG_MALLOC(float64_t, num_threads*N*N);
+	float64_t* b_buf=SG_MALLOC(float64_t, num_threads*N*M);
+	float64_t* worker_prob=SG_MALLOC(float64_t, num_threads);
 
+	/* E-step: worker w owns the cache slot w of hmm, i.e. sequences w,
+	 * w+num_threads, ...
+	 */
+#pragma omp parallel for num_threads(num_threads)
 	for (cpu=0; cpu<num_threads; cpu++)
 	{
-		params[cpu].p_buf=SG_MALLOC(float64_t, N);
-		params[cpu].q_buf=SG_MALLOC(float64_t, N);
-		params[cpu].a_buf=SG_MALLOC(float64_t, N*N);
-		params[cpu].b_buf=SG_MALLOC(float64_t, N*M);
-
-		params[cpu].hmm=hmm;
-		int32_t start = p_observations->get_num_vectors()*cpu / num_threads;
-		int32_t stop=p_observations->get_num_vectors()*(cpu+1) / num_threads;
-
-		if (cpu == parallel->get_num_threads()-1)
-			stop=p_observations->get_num_vectors();
+		float64_t* p=&p_buf[cpu*N];
+		float64_t* q=&q_buf[cpu*N];
+		float64_t* a=&a_buf[cpu*N*N];
+		float64_t* b=&b_buf[cpu*N*M];
 
-		ASSERT(start<stop)
-		params[cpu].dim_start=start;
-		params[cpu].dim_stop=stop;
+		for (int32_t k=0; k<N; k++)
+		{
+			p[k]=-CMath::INFTY;
+			q[k]=-CMath::INFTY;
+		}
+		for (int32_t k=0; k<N*N; k++)
+			a[k]=-CMath::INFTY;
+		for (int32_t k=0; k<N*M; k++)
+			b[k]=-CMath::INFTY;
 
-		pthread_create(&threads[cpu], NULL, bw_dim_prefetch, &params[cpu]);
+		worker_prob[cpu]=0;
+		for (int32_t dim=cpu; dim<num_vectors; dim+=num_threads)
+		{
+			hmm->forward_comp(p_observations->get_vector_length(dim), N-1, dim);
+			hmm->backward_comp(p_observations->get_vector_length(dim), N-1, dim);
+			worker_prob[cpu]+=hmm->model_probability(dim);
+			hmm->ab_buf_comp(p, q, a, b, dim);
+		}
 	}
 
+	/* M-step numerators, reduced in worker order */
 	for (cpu=0; cpu<num_threads; cpu++)
 	{
-		pthread_join(threads[cpu], NULL);
-
 		for (i=0; i<N; i++)
 		{
 			//estimate initial+end state distribution numerator
-			set_p(i, CMath::logarithmic_sum(get_p(i), params[cpu].p_buf[i]));
-			set_q(i, CMath::logarithmic_sum(get_q(i), params[cpu].q_buf[i]));
+			set_p(i, CMath::logarithmic_sum(get_p(i), p_buf[cpu*N+i]));
+			set_q(i, CMath::logarithmic_sum(get_q(i), q_buf[cpu*N+i]));
 
 			//estimate numerator for a
 			for (j=0; j<N; j++)
-				set_a(i,j, CMath::logarithmic_sum(get_a(i,j), params[cpu].a_buf[N*i+j]));
+				set_a(i,j, CMath::logarithmic_sum(get_a(i,j), a_buf[cpu*N*N+N*i+j]));
 
 			//estimate numerator for b
 			for (j=0; j<M; j++)
-				set_b(i,j, CMath::logarithmic_sum(get_b(i,j), params[cpu].b_buf[M*i+j]));
+				set_b(i,j, CMath::logarithmic_sum(get_b(i,j), b_buf[cpu*N*M+M*i+j]));
 		}
 
-		fullmodprob+=params[cpu].ret;
-
-	}
-
-	for (cpu=0; cpu<num_threads; cpu++)
-	{
-		SG_FREE(params[cpu].p_buf);
-		SG_FREE(params[cpu].q_buf);
-		SG_FREE(params[cpu].a_buf);
-		SG_FREE(params[cpu].b_buf);
+		fullmodprob+=worker_prob[cpu];
 	}
 
-	SG_FREE(threads);
-	SG_FREE(params);
+	SG_FREE(p_buf);
+	SG_FREE(q_buf);
+	SG_FREE(a_buf);
+	SG_FREE(b_buf);
+	SG_FREE(worker_prob);
 
 	//cache hmm model probability
 	hmm->mod_prob=fullmodprob;
@@ -1805,12 +1764,9 @@ void CHMM::estimate_model_baum_welch_defined(CHMM* estimate)
 	}
 
 #ifdef USE_HMMPARALLEL
-	int32_t num_threads = parallel->get_num_threads();
-	pthread_t *threads=SG_MALLOC(pthread_t, num_threads);
-	S_DIM_THREAD_PARAM *params=SG_MALLOC(S_DIM_THREAD_PARAM, num_threads);
-
-	if (p_observations->get_num_vectors()<num_threads)
-		num_threads=p_observations->get_num_vectors();
+	/* a batch of num_threads sequences occupies every cache slot once */
+	int32_t num_threads=estimate->num_workers;
+	float64_t* dim_prob=SG_MALLOC(float64_t, num_threads);
 #endif
 
 	//change summation order to make use of alpha/beta caches
@@ -1819,24 +1775,16 @@ void CHMM::estimate_model_baum_welch_defined(CHMM* estimate)
 #ifdef USE_HMMPARALLEL
 		if (dim%num_threads==0)
 		{
-			for (i=0; i<num_threads; i++)
+			int32_t num_batch=CMath::min(num_threads, p_observations->get_num_vectors()-dim);
+#pragma omp parallel for num_threads(num_batch)
+			for (i=0; i<num_batch; i++)
 			{
-				if (dim+i<p_observations->get_num_vectors())
-				{
-					params[i].hmm=estimate ;
-					params[i].dim=dim+i ;
-					pthread_create(&threads[i], NULL, bw_single_dim_prefetch, (void*)&params[i]) ;
-				}
-			}
-			for (i=0; i<num_threads; i++)
-			{
-				if (dim+i<p_observations->get_num_vectors())
-				{
-					pthread_join(threads[i], NULL);
-					dimmodprob = params[i].prob_sum;
-				}
+				int32_t len=p_observations->get_vector_length(dim+i);
+				estimate->backward_comp(len, N-1, dim+i);
+				dim_prob[i]=estimate->model_probability(dim+i);
 			}
 		}
+		dimmodprob=dim_prob[dim%num_threads];
 #else
 		dimmodprob=estimate->model_probability(dim);
 #endif // USE_HMMPARALLEL
@@ -1910,8 +1858,7 @@ void CHMM::estimate_model_baum_welch_defined(CHMM* estimate)
 		}
 	}
 #ifdef USE_HMMPARALLEL
-	SG_FREE(threads);
-	SG_FREE(params);
+	SG_FREE(dim_prob);
 #endif
 
 
@@ -1969,12 +1916,9 @@ void CHMM::estimate_model_viterbi(CHMM* estimate)
 	float64_t allpatprob=0 ;
 
 #ifdef USE_HMMPARALLEL
-	int32_t num_threads = parallel->get_num_threads();
-	pthread_t *threads=SG_MALLOC(pthread_t, num_threads);
-	S_DIM_THREAD_PARAM *params=SG_MALLOC(S_DIM_THREAD_PARAM, num_threads);
-
-	if (p_observations->get_num_vectors()<num_threads)
-		num_threads=p_observations->get_num_vectors();
+	/* a batch of num_threads sequences occupies every cache slot once */
+	int32_t num_threads=estimate->num_workers;
+	float64_t* dim_prob=SG_MALLOC(float64_t, num_threads);
 #endif
 
 	for (int32_t dim=0; dim<p_observations->get_num_vectors(); dim++)
@@ -1983,23 +1927,13 @@ void CHMM::estimate_model_viterbi(CHMM* estimate)
 #ifdef USE_HMMPARALLEL
 		if (dim%num_threads==0)
 		{
-			for (i=0; i<num_threads; i++)
-			{
-				if (dim+i<p_observations->get_num_vectors())
-				{
-					params[i].hmm=estimate ;
-					params[i].dim=dim+i ;
-					pthread_create(&threads[i], NULL, vit_dim_prefetch, (void*)&params[i]) ;
-				}
-			}
-			for (i=0; i<num_threads; i++)
-			{
-				if (dim+i<p_observations->get_num_vectors())
-				{
-					pthread_join(threads[i], NULL);
-					allpatprob += params[i].prob_sum;
-				}
-			}
+			int32_t num_batch=CMath::min(num_threads, p_observations->get_num_vectors()-dim);
+#pragma omp parallel for num_threads(num_batch)
+			for (i=0; i<num_batch; i++)
+				dim_prob[i]=estimate->best_path(dim+i);
+
+			for (i=0; i<num_batch; i++)
+				allpatprob+=dim_prob[i];
 		}
 #else
 		//using viterbi to find best path
@@ -2020,8 +1954,7 @@ void CHMM::estimate_model_viterbi(CHMM* estimate)
 	}
 
 #ifdef USE_HMMPARALLEL
-	SG_FREE(threads);
-	SG_FREE(params);
+	SG_FREE(dim_prob);
 #endif
 
 	allpatprob/=p_observations->get_num_vectors() ;
@@ -2094,9 +2027,9 @@ void CHMM::estimate_model_viterbi_defined(CHMM* estimate)
 	}
 
 #ifdef USE_HMMPARALLEL
-	int32_t num_threads = parallel->get_num_threads();
-	pthread_t *threads=SG_MALLOC(pthread_t, num_threads);
-	S_DIM_THREAD_PARAM *params=SG_MALLOC(S_DIM_THREAD_PARAM, num_threads);
+	/* a batch of num_threads sequences occupies every cache slot once */
+	int32_t num_threads=estimate->num_workers;
+	float64_t* dim_prob=SG_MALLOC(float64_t, num_threads);
 #endif
 
 	float64_t allpatprob=0.0 ;
@@ -2106,23 +2039,13 @@ void CHMM::estimate_model_viterbi_defined(CHMM* estimate)
 #ifdef USE_HMMPARALLEL
 		if (dim%num_threads==0)
 		{
-			for (i=0; i<num_threads; i++)
-			{
-				if (dim+i<p_observations->get_num_vectors())
-				{
-					params[i].hmm=estimate ;
-					params[i].dim=dim+i ;
-					pthread_create(&threads[i], NULL, vit_dim_prefetch, (void*)&params[i]) ;
-				}
-			}
-			for (i=0; i<num_threads; i++)
-			{
-				if (dim+i<p_observations->get_num_vectors())
-				{
-					pthread_join(threads[i], NULL);
-					allpatprob += params[i].prob_sum;
-				}
-			}
+			int32_t num_batch=CMath::min(num_threads, p_observations->get_num_vectors()-dim);
+#pragma omp parallel for num_threads(num_batch)
+			for (i=0; i<num_batch; i++)
+				dim_prob[i]=estimate->best_path(dim+i);
+
+			for (i=0; i<num_batch; i++)
+				allpatprob+=dim_prob[i];
 		}
 #else // USE_HMMPARALLEL
 		//using viterbi to find best path
@@ -2144,8 +2067,7 @@ void CHMM::estimate_model_viterbi_defined(CHMM* estimate)
 	}
 
 #ifdef USE_HMMPARALLEL
-	SG_FREE(threads);
-	SG_FREE(params);
+	SG_FREE(dim_prob);
 #endif
 
 	//estimate->invalidate_model() ;
@@ -2784,7 +2706,7 @@ void CHMM::invalidate_model()
 
 #ifdef USE_HMMPARALLEL_STRUCTURES
 	{
-		for (int32_t i=0; i<parallel->get_num_threads(); i++)
+		for (int32_t i=0; i<num_workers; i++)
 		{
 			this->alpha_cache[i].updated=false;
 			this->beta_cache[i].updated=false;
@@ -4390,12 +4312,8 @@ bool CHMM::save_model_derivatives_bin(FILE* file)
 		SG_INFO("writing derivatives of changed weights only\n")
 
 #ifdef USE_HMMPARALLEL
-	int32_t num_threads = parallel->get_num_threads();
-	pthread_t *threads=SG_MALLOC(pthread_t, num_threads);
-	S_DIM_THREAD_PARAM *params=SG_MALLOC(S_DIM_THREAD_PARAM, num_threads);
-
-	if (p_observations->get_num_vectors()<num_threads)
-		num_threads=p_observations->get_num_vectors();
+	/* a batch of num_threads sequences occupies every cache slot once */
+	int32_t num_threads=num_workers;
 #endif
 
 	for (dim=0; dim<p_observations->get_num_vectors(); dim++)
@@ -4409,20 +4327,13 @@ bool CHMM::save_model_derivatives_bin(FILE* file)
 #ifdef USE_HMMPARALLEL
 		if (dim%num_threads==0)
 		{
-			for (i=0; i<num_threads; i++)
+			int32_t num_batch=CMath::min(num_threads, p_observations->get_num_vectors()-dim);
+#pragma omp parallel for num_threads(num_batch)
+			for (i=0; i<num_batch; i++)
 			{
-				if (dim+i<p_observations->get_num_vectors())
-				{
-					params[i].hmm=this ;
-					params[i].dim=dim+i ;
-					pthread_create(&threads[i], NULL, bw_dim_prefetch, (void*)&params[i]) ;
-				}
-			}
-
-			for (i=0; i<num_threads; i++)
-			{
-				if (dim+i<p_observations->get_num_vectors())
-					pthread_join(threads[i], NULL);
+				int32_t len=p_observations->get_vector_length(dim+i);
+				forward_comp(len, N-1, dim+i);
+				backward_comp(len, N-1, dim+i);
 			}
 		}
 #endif
@@ -4489,11 +4400,6 @@ bool CHMM::save_model_derivatives_bin(FILE* file)
 	}
 	save_model_bin(file) ;
 
-#ifdef USE_HMMPARALLEL
-	SG_FREE(threads);
-	SG_FREE(params);
-#endif
-
 	result=true;
 	SG_PRINT("\n")
 	return result;
@@ -5278,7 +5184,7 @@ void CHMM::set_observation_nocache(CStringFeatures<uint16_t>* obs)
 	if (!reused_caches)
 	{
 #ifdef USE_HMMPARALLEL_STRUCTURES
-		for (int32_t i=0; i<parallel->get_num_threads(); i++)
+		for (int32_t i=0; i<num_workers; i++)
 		{
 			SG_FREE(alpha_cache[i].table);
 			SG_FREE(beta_cache[i].table);
@@ -5334,7 +5240,7 @@ void CHMM::set_observations(CStringFeatures<uint16_t>* obs, CHMM* lambda)
 	if (!reused_caches)
 	{
 #ifdef USE_HMMPARALLEL_STRUCTURES
-		for (int32_t i=0; i<parallel->get_num_threads(); i++)
+		for (int32_t i=0; i<num_workers; i++)
 		{
 			SG_FREE(alpha_cache[i].table);
 			SG_FREE(beta_cache[i].table);
@@ -5367,7 +5273,10 @@ void CHMM::set_observations(CStringFeatures<uint16_t>* obs, CHMM* lambda)
 		if (lambda)
 		{
 #ifdef USE_HMMPARALLEL_STRUCTURES
-			for (int32_t i=0; i<parallel->get_num_threads(); i++)
+			REQUIRE(lambda->num_workers==num_workers, "Can not share caches "
+					"of %d workers with a model using %d workers\n",
+					lambda->num_workers, num_workers);
+			for (int32_t i=0; i<num_workers; i++)
 			{
 				this->alpha_cache[i].table= lambda->alpha_cache[i].table;
 				this->beta_cache[i].table=	lambda->beta_cache[i].table;
@@ -5388,7 +5297,7 @@ void CHMM::set_observations(CStringFeatures<uint16_t>* obs, CHMM* lambda)
 			this->reused_caches=false;
 #ifdef USE_HMMPARALLEL_STRUCTURES
 			SG_INFO("allocating mem for path-table of size %.2f Megabytes (%d*%d) each:\n", ((float32_t)max_T)*N*sizeof(T_STATES)/(1024*1024), max_T, N)
-			for (int32_t i=0; i<parallel->get_num_threads(); i++)
+			for (int32_t i=0; i<num_workers; i++)
 			{
 				if ((states_per_observation_psi[i]=SG_MALLOC(T_STATES,max_T*N))!=NULL)
 					SG_DEBUG("path_table[%i] successfully allocated\n",i)
@@ -5409,7 +5318,7 @@ void CHMM::set_observations(CStringFeatures<uint16_t>* obs, CHMM* lambda)
 			SG_INFO("allocating mem for caches each of size %.2f Megabytes (%d*%d) ....\n", ((float32_t)max_T)*N*sizeof(T_ALPHA_BETA_TABLE)/(1024*1024), max_T, N)
 
 #ifdef USE_HMMPARALLEL_STRUCTURES
-			for (int32_t i=0; i<parallel->get_num_threads(); i++)
+			for (int32_t i=0; i<num_workers; i++)
 			{
 				if ((alpha_cache[i].table=SG_MALLOC(T_ALPHA_BETA_TABLE, max_T*N))!=NULL)
 					SG_DEBUG("alpha_cache[%i].table successfully allocated\n",i)
@@ -5435,7 +5344,7 @@ void CHMM::set_observations(CStringFeatures<uint16_t>* obs, CHMM* lambda)
 #endif // USE_HMMPARALLEL_STRUCTURES
 #else // USE_HMMCACHE
 #ifdef USE_HMMPARALLEL_STRUCTURES
-			for (int32_t i=0; i<parallel->get_num_threads(); i++)
+			for (int32_t i=0; i<num_workers; i++)
 			{
 				alpha_cache[i].table=NULL ;
 				beta_cache[i].table=NULL ;
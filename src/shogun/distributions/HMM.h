@@ -380,51 +380,28 @@ class CHMM : public CDistribution
 
 #ifdef USE_HMMPARALLEL_STRUCTURES
 
-		/// Datatype that is used in parrallel computation of viterbi
-		struct S_DIM_THREAD_PARAM
-		{
-			CHMM* hmm;
-			int32_t dim;
-			float64_t prob_sum;
-		};
-
-		/// Datatype that is used in parrallel baum welch model estimation
-		struct S_BW_THREAD_PARAM
-		{
-			CHMM* hmm;
-			int32_t dim_start;
-			int32_t dim_stop;
-
-			float64_t ret;
-
-			float64_t* p_buf;
-			float64_t* q_buf;
-			float64_t* a_buf;
-			float64_t* b_buf;
-		};
-
 		inline T_ALPHA_BETA & ALPHA_CACHE(int32_t dim) {
-			return alpha_cache[dim%parallel->get_num_threads()] ; } ;
+			return alpha_cache[dim%num_workers] ; } ;
 		inline T_ALPHA_BETA & BETA_CACHE(int32_t dim) {
-			return beta_cache[dim%parallel->get_num_threads()] ; } ;
+			return beta_cache[dim%num_workers] ; } ;
 #ifdef USE_LOGSUMARRAY
 		inline float64_t* ARRAYS(int32_t dim) {
-			return arrayS[dim%parallel->get_num_threads()] ; } ;
+			return arrayS[dim%num_workers] ; } ;
 #endif
 		inline float64_t* ARRAYN1(int32_t dim) {
-			return arrayN1[dim%parallel->get_num_threads()] ; } ;
+			return arrayN1[dim%num_workers] ; } ;
 		inline float64_t* ARRAYN2(int32_t dim) {
-			return arrayN2[dim%parallel->get_num_threads()] ; } ;
+			return arrayN2[dim%num_workers] ; } ;
 		inline T_STATES* STATES_PER_OBSERVATION_PSI(int32_t dim) {
-			return states_per_observation_psi[dim%parallel->get_num_threads()] ; } ;
+			return states_per_observation_psi[dim%num_workers] ; } ;
 		inline const T_STATES* STATES_PER_OBSERVATION_PSI(int32_t dim) const {
-			return states_per_observation_psi[dim%parallel->get_num_threads()] ; } ;
+			return states_per_observation_psi[dim%num_workers] ; } ;
 		inline T_STATES* PATH(int32_t dim) {
-			return path[dim%parallel->get_num_threads()] ; } ;
+			return path[dim%num_workers] ; } ;
 		inline bool & PATH_PROB_UPDATED(int32_t dim) {
-			return path_prob_updated[dim%parallel->get_num_threads()] ; } ;
+			return path_prob_updated[dim%num_workers] ; } ;
 		inline int32_t & PATH_PROB_DIMENSION(int32_t dim) {
-			return path_prob_dimension[dim%parallel->get_num_threads()] ; } ;
+			return path_prob_dimension[dim%num_workers] ; } ;
 #else
 		inline T_ALPHA_BETA & ALPHA_CACHE(int32_t /*dim*/) {
 			return alpha_cache ; } ;
@@ -760,12 +737,6 @@ class CHMM : public CDistribution
 			PSEUDO=pseudo ;
 		}
 
-#ifdef USE_HMMPARALLEL_STRUCTURES
-		static void* bw_dim_prefetch(void * params);
-		static void* bw_single_dim_prefetch(void * params);
-		static void* vit_dim_prefetch(void * params);
-#endif
-
 #ifdef FIX_POS
 		/** access function to set value in fix_pos_state vector in underlying model
 		 * @see Model
@@ -1266,10 +1237,10 @@ class CHMM : public CDistribution
 		//@}
 
 #ifdef USE_HMMPARALLEL_STRUCTURES
-		/** array of size N*parallel.get_num_threads() for temporary calculations */
-		float64_t** arrayN1 /*[parallel.get_num_threads()]*/ ;
-		/** array of size N*parallel.get_num_threads() for temporary calculations */
-		float64_t** arrayN2 /*[parallel.get_num_threads()]*/ ;
+		/** array of size N*num_workers for temporary calculations */
+		float64_t** arrayN1 /*[num_workers]*/ ;
+		/** array of size N*num_workers for temporary calculations */
+		float64_t** arrayN2 /*[num_workers]*/ ;
 #else //USE_HMMPARALLEL_STRUCTURES
 		/** array of size N for temporary calculations */
 		float64_t* arrayN1;
@@ -1280,7 +1251,7 @@ class CHMM : public CDistribution
 #ifdef USE_LOGSUMARRAY
 #ifdef USE_HMMPARALLEL_STRUCTURES
 		/** array for for temporary calculations of log_sum */
-		float64_t** arrayS /*[parallel.get_num_threads()]*/;
+		float64_t** arrayS /*[num_workers]*/;
 #else
 		/** array for for temporary calculations of log_sum */
 		float64_t* arrayS;
@@ -1288,23 +1259,28 @@ class CHMM : public CDistribution
 #endif // USE_LOGSUMARRAY
 
 #ifdef USE_HMMPARALLEL_STRUCTURES
+		/** number of per worker slots of the caches and temporary arrays,
+		 * fixed when they are allocated. Sequence dim always uses slot
+		 * dim%num_workers.
+		 */
+		int32_t num_workers;
 
 		/// cache for forward variables can be terrible HUGE O(T*N)
-		T_ALPHA_BETA* alpha_cache /*[parallel.get_num_threads()]*/ ;
+		T_ALPHA_BETA* alpha_cache /*[num_workers]*/ ;
 		/// cache for backward variables can be terrible HUGE O(T*N)
-		T_ALPHA_BETA* beta_cache /*[parallel.get_num_threads()]*/ ;
+		T_ALPHA_BETA* beta_cache /*[num_workers]*/ ;
 
 		/// backtracking table for viterbi can be terrible HUGE O(T*N)
-		T_STATES** states_per_observation_psi /*[parallel.get_num_threads()]*/ ;
+		T_STATES** states_per_observation_psi /*[num_workers]*/ ;
 
 		/// best path (=state sequence) through model
-		T_STATES** path /*[parallel.get_num_threads()]*/ ;
+		T_STATES** path /*[num_workers]*/ ;
 
 		/// true if path probability is up to date
-		bool* path_prob_updated /*[parallel.get_num_threads()]*/;
+		bool* path_prob_updated /*[num_workers]*/;
 
 		/// dimension for which path_prob was calculated
-		int32_t* path_prob_dimension /*[parallel.get_num_threads()]*/ ;
+		int32_t* path_prob_dimension /*[num_workers]*/ ;
 
 #else //USE_HMMPARALLEL_STRUCTURES
 		/// cache for forward variables can be terrible HUGE O(T*N)
@@ -132,6 +132,36 @@ float64_t CMixtureModel::get_log_likelihood_example(int32_t num_example)
 	return CMath::log_sum_exp(log_likelihood_component);
 }
 
+SGVector<float64_t> CMixtureModel::get_log_likelihood_examples(int32_t start, int32_t stop)
+{
+	REQUIRE(features,"features not set\n")
+	REQUIRE(features->get_feature_class() == C_DENSE,"Dense features required\n")
+	REQUIRE(features->get_feature_type() == F_DREAL,"Real features required\n")
+
+	int32_t num_comp=m_components->get_num_elements();
+	int32_t len=stop-start;
+	SGMatrix<float64_t> log_likelihood_component(num_comp,len);
+	for (int32_t i=0;i<num_comp;i++)
+	{
+		CDistribution* ith_comp=CDistribution::obtain_from_generic(m_components->get_element(i));
+		SGVector<float64_t> log_likelihood=ith_comp->get_log_likelihood_examples(start,stop);
+		float64_t log_weight=CMath::log(m_weights[i]);
+		for (int32_t j=0;j<len;j++)
+			log_likelihood_component(i,j)=log_likelihood[j]+log_weight;
+
+		SG_UNREF(ith_comp);
+	}
+
+	SGVector<float64_t> result(len);
+	for (int32_t j=0;j<len;j++)
+	{
+		SGVector<float64_t> column(log_likelihood_component.get_column_vector(j),num_comp,false);
+		result[j]=CMath::log_sum_exp(column);
+	}
+
+	return result;
+}
+
 SGVector<float64_t> CMixtureModel::get_weights() const
 {
 	return m_weights;
@@ -95,6 +95,16 @@ class CMixtureModel : public CDistribution
 		 */
 		virtual float64_t get_log_likelihood_example(int32_t num_example);
 
+		/** compute log likelihood for a range of examples. Every component
+		 * evaluates all examples at once.
+		 *
+		 * @param start index of first example
+		 * @param stop index one past the last example
+		 * @return log likelihood vector of length stop-start
+		 */
+		virtual SGVector<float64_t> get_log_likelihood_examples(
+			int32_t start, int32_t stop);
+
 		/** get weights
 		 *
 		 * @return weights
@@ -0,0 +1,84 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/evaluation/BinaryClassEvaluation.h>
+#include <shogun/base/Parallel.h>
+#include <shogun/mathematics/Math.h>
+
+#include <algorithm>
+
+/* scores sorted by one thread at least */
+#define SORT_MIN_BLOCK_SIZE 4096
+
+using namespace shogun;
+
+namespace
+{
+
+/** a column of the matrix returned by sort_scores */
+struct ScoredLabel
+{
+	float64_t score;
+	float64_t label;
+};
+
+inline bool greater_score(const ScoredLabel& a, const ScoredLabel& b)
+{
+	return a.score>b.score;
+}
+
+}
+
+SGMatrix<float64_t> CBinaryClassEvaluation::sort_scores(CLabels* predicted,
+		CLabels* ground_truth)
+{
+	index_t length=predicted->get_num_labels();
+	SGMatrix<float64_t> sorted(2, length);
+	ScoredLabel* src=(ScoredLabel*) sorted.matrix;
+
+	int32_t num_blocks=CMath::max(1, CMath::min(parallel->get_num_threads(),
+			length/SORT_MIN_BLOCK_SIZE));
+	SGVector<index_t> bounds(num_blocks+1);
+	for (int32_t b=0; b<=num_blocks; b++)
+		bounds[b]=int64_t(length)*b/num_blocks;
+
+#pragma omp parallel for num_threads(num_blocks)
+	for (int32_t b=0; b<num_blocks; b++)
+	{
+		for (index_t i=bounds[b]; i<bounds[b+1]; i++)
+		{
+			src[i].score=predicted->get_value(i);
+			src[i].label=ground_truth->get_value(i);
+		}
+		std::sort(src+bounds[b], src+bounds[b+1], greater_score);
+	}
+
+	if (num_blocks==1)
+		return sorted;
+
+	// merge neighbouring runs until one is left
+	SGMatrix<float64_t> merged(2, length);
+	for (int32_t width=1; width<num_blocks; width*=2)
+	{
+		ScoredLabel* from=(ScoredLabel*) sorted.matrix;
+		ScoredLabel* to=(ScoredLabel*) merged.matrix;
+
+#pragma omp parallel for num_threads(num_blocks)
+		for (int32_t b=0; b<num_blocks; b+=2*width)
+		{
+			index_t lo=bounds[b];
+			index_t mid=bounds[CMath::min(b+width, num_blocks)];
+			index_t hi=bounds[CMath::min(b+2*width, num_blocks)];
+			std::merge(from+lo, from+mid, from+mid, from+hi, to+lo,
+					greater_score);
+		}
+
+		CMath::swap(sorted, merged);
+	}
+
+	return sorted;
+}
@@ -21,6 +21,16 @@ namespace shogun
 
 class CLabels;
 
+/** how ROC and PRC evaluations compute their curves */
+enum ECurveMethod
+{
+	/** exact curve from the sorted scores */
+	CM_EXACT=0,
+	/** approximate curve from a histogram of the scores, see
+	 * CScoreHistogram */
+	CM_HISTOGRAM=1
+};
+
 /** @brief The class TwoClassEvaluation,
  * a base class used to evaluate binary classification
  * labels.
@@ -43,6 +53,18 @@ public:
 	 * @return evaluation result
 	 */
 	virtual float64_t evaluate(CLabels* predicted, CLabels* ground_truth) = 0;
+
+protected:
+
+	/** sorts predicted scores in descending order together with the
+	 * ground truth. Blocks of the scores are sorted in parallel and merged
+	 * afterwards.
+	 *
+	 * @param predicted labels
+	 * @param ground_truth labels assumed to be correct
+	 * @return 2 x num_labels matrix whose columns are (score, ground truth)
+	 */
+	SGMatrix<float64_t> sort_scores(CLabels* predicted, CLabels* ground_truth);
 };
 
 }
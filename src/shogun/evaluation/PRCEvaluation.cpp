@@ -9,9 +9,12 @@
  */
 
 #include <shogun/evaluation/PRCEvaluation.h>
+#include <shogun/evaluation/ScoreHistogram.h>
 #include <shogun/labels/RegressionLabels.h>
 #include <shogun/labels/BinaryLabels.h>
+#include <shogun/base/Parameter.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/simd/SIMD.h>
 
 using namespace shogun;
 
@@ -19,6 +22,17 @@ CPRCEvaluation::~CPRCEvaluation()
 {
 }
 
+void CPRCEvaluation::init()
+{
+	m_method=CM_EXACT;
+	m_num_bins=4096;
+
+	SG_ADD((machine_int_t*) &m_method, "method", "How the PRC is computed",
+			MS_NOT_AVAILABLE);
+	SG_ADD(&m_num_bins, "num_bins", "Number of bins in histogram mode",
+			MS_NOT_AVAILABLE);
+}
+
 float64_t CPRCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 {
 	ASSERT(predicted && ground_truth)
@@ -27,6 +41,25 @@ float64_t CPRCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 	ASSERT(ground_truth->get_label_type()==LT_BINARY)
 	ground_truth->ensure_valid();
 
+	if (m_method==CM_HISTOGRAM)
+	{
+		SGVector<float64_t> scores(predicted->get_num_labels());
+		REQUIRE(scores.vlen>0, "%s::evaluate(): No labels given\n",
+				get_name());
+		for (index_t i=0; i<scores.vlen; i++)
+			scores[i]=predicted->get_value(i);
+
+		CScoreHistogram* histogram=new CScoreHistogram(m_num_bins,
+				simd::min(scores.vector, scores.vlen),
+				simd::max(scores.vector, scores.vlen));
+		SG_REF(histogram);
+		histogram->add(predicted, ground_truth);
+		float64_t auPRC=evaluate_histogram(histogram);
+		SG_UNREF(histogram);
+
+		return auPRC;
+	}
+
 	// number of true positive examples
 	float64_t tp = 0.0;
 	int32_t i;
@@ -34,21 +67,11 @@ float64_t CPRCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 	// total number of positive labels in predicted
 	int32_t pos_count=0;
 
-	// initialize number of labels and labels
-	SGVector<float64_t> orig_labels = predicted->get_values();
-	int32_t length = orig_labels.vlen;
-	float64_t* labels = SGVector<float64_t>::clone_vector(orig_labels.vector, length);
-
-	// get indexes for sort
-	int32_t* idxs = SG_MALLOC(int32_t, length);
-	for(i=0; i<length; i++)
-		idxs[i] = i;
-
-	// sort indexes by labels ascending
-	CMath::qsort_backward_index(labels,idxs,length);
+	// scores in descending order, each followed by its ground truth
+	SGMatrix<float64_t> sorted=sort_scores(predicted, ground_truth);
+	int32_t length=sorted.num_cols;
 
 	// clean and initialize graph and auPRC
-	SG_FREE(labels);
 	m_PRC_graph = SGMatrix<float64_t>(2,length);
 	m_thresholds = SGVector<float64_t>(length);
 	m_auPRC = 0.0;
@@ -56,7 +79,7 @@ float64_t CPRCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 	// get total numbers of positive and negative labels
 	for (i=0; i<length; i++)
 	{
-		if (ground_truth->get_value(i) > 0)
+		if (sorted[2*i+1] > 0)
 			pos_count++;
 	}
 
@@ -67,7 +90,7 @@ float64_t CPRCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 	for (i=0; i<length; i++)
 	{
 		// update number of true positive examples
-		if (ground_truth->get_value(idxs[i]) > 0)
+		if (sorted[2*i+1] > 0)
 			tp += 1.0;
 
 		// precision (x)
@@ -75,7 +98,7 @@ float64_t CPRCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 		// recall (y)
 		m_PRC_graph[2*i+1] = tp/float64_t(pos_count);
 
-		m_thresholds[i]= predicted->get_value(idxs[i]);
+		m_thresholds[i]= sorted[2*i];
 	}
 
 	// calc auRPC using area under curve
@@ -84,7 +107,19 @@ float64_t CPRCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 	// set computed indicator
 	m_computed = true;
 
-	SG_FREE(idxs);
+	return m_auPRC;
+}
+
+float64_t CPRCEvaluation::evaluate_histogram(CScoreHistogram* histogram)
+{
+	REQUIRE(histogram, "%s::evaluate_histogram(): Histogram is NULL\n",
+			get_name());
+
+	m_PRC_graph=histogram->get_PRC();
+	m_thresholds=histogram->get_PRC_thresholds();
+	m_auPRC=histogram->get_auPRC();
+	m_computed=true;
+
 	return m_auPRC;
 }
 
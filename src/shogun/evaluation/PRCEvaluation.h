@@ -19,6 +19,7 @@ namespace shogun
 {
 
 class CLabels;
+class CScoreHistogram;
 
 /** @brief Class PRCEvaluation used to evaluate PRC
  * (Precision Recall Curve) and an area under PRC curve (auPRC).
@@ -34,6 +35,7 @@ public:
 		m_PRC_graph = SGMatrix<float64_t>();
 		m_thresholds = SGVector<float64_t>();
 		m_auPRC = 0.0;
+		init();
 	};
 
 	/** destructor */
@@ -69,6 +71,34 @@ public:
 	 */
 	SGVector<float64_t> get_thresholds();
 
+	/** set how the PRC is computed. CM_HISTOGRAM counts the scores in
+	 * get_num_bins() bins between the smallest and largest score, which
+	 * makes the thresholds correspond to the points of the graph instead
+	 * of the examples.
+	 *
+	 * @param method method, CM_EXACT by default
+	 */
+	void set_method(ECurveMethod method) { m_method=method; }
+
+	/** @return method */
+	ECurveMethod get_method() const { return m_method; }
+
+	/** @param num_bins number of bins of the histogram in CM_HISTOGRAM
+	 * mode, 4096 by default
+	 */
+	void set_num_bins(int32_t num_bins) { m_num_bins=num_bins; }
+
+	/** @return number of bins */
+	int32_t get_num_bins() const { return m_num_bins; }
+
+	/** evaluate PRC and auPRC from a histogram of scores, e.g. one merged
+	 * from histograms of several shards of the data
+	 *
+	 * @param histogram histogram of scores
+	 * @return auPRC
+	 */
+	float64_t evaluate_histogram(CScoreHistogram* histogram);
+
 protected:
 
 	/** 2-d array used to store PRC graph */
@@ -82,6 +112,17 @@ protected:
 
 	/** indicator of PRC and auPRC being computed already */
 	bool m_computed;
+
+	/** how the PRC is computed */
+	ECurveMethod m_method;
+
+	/** number of bins in CM_HISTOGRAM mode */
+	int32_t m_num_bins;
+
+private:
+
+	/** register parameters */
+	void init();
 };
 
 }
@@ -9,7 +9,10 @@
  */
 
 #include <shogun/evaluation/ROCEvaluation.h>
+#include <shogun/evaluation/ScoreHistogram.h>
+#include <shogun/base/Parameter.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/simd/SIMD.h>
 
 using namespace shogun;
 
@@ -22,6 +25,17 @@ float64_t CROCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 	return evaluate_roc(predicted,ground_truth);
 }
 
+void CROCEvaluation::init()
+{
+	m_method=CM_EXACT;
+	m_num_bins=4096;
+
+	SG_ADD((machine_int_t*) &m_method, "method", "How the ROC is computed",
+			MS_NOT_AVAILABLE);
+	SG_ADD(&m_num_bins, "num_bins", "Number of bins in histogram mode",
+			MS_NOT_AVAILABLE);
+}
+
 float64_t CROCEvaluation::evaluate_roc(CLabels* predicted, CLabels* ground_truth)
 {
 	ASSERT(predicted && ground_truth)
@@ -30,6 +44,25 @@ float64_t CROCEvaluation::evaluate_roc(CLabels* predicted, CLabels* ground_truth
 	ASSERT(ground_truth->get_label_type()==LT_BINARY)
 	ground_truth->ensure_valid();
 
+	if (m_method==CM_HISTOGRAM)
+	{
+		SGVector<float64_t> scores(predicted->get_num_labels());
+		REQUIRE(scores.vlen>0, "%s::evaluate_roc(): No labels given\n",
+				get_name());
+		for (index_t i=0; i<scores.vlen; i++)
+			scores[i]=predicted->get_value(i);
+
+		CScoreHistogram* histogram=new CScoreHistogram(m_num_bins,
+				simd::min(scores.vector, scores.vlen),
+				simd::max(scores.vector, scores.vlen));
+		SG_REF(histogram);
+		histogram->add(predicted, ground_truth);
+		float64_t auROC=evaluate_histogram(histogram);
+		SG_UNREF(histogram);
+
+		return auROC;
+	}
+
 	// assume threshold as negative infinity
 	float64_t threshold = CMath::ALMOST_NEG_INFTY;
 	// false positive rate
@@ -42,41 +75,21 @@ float64_t CROCEvaluation::evaluate_roc(CLabels* predicted, CLabels* ground_truth
 	int32_t pos_count=0;
 	int32_t neg_count=0;
 
-	// initialize number of labels and labels
-	SGVector<float64_t> orig_labels(predicted->get_num_labels());
-	int32_t length = orig_labels.vlen;
-	for (i=0; i<length; i++)
-		orig_labels[i] = predicted->get_value(i);
-	float64_t* labels = SGVector<float64_t>::clone_vector(orig_labels.vector, length);
-
-	// get sorted indexes
-	SGVector<int32_t> idxs(length);
-	for(i=0; i<length; i++)
-		idxs[i] = i;
-
-	CMath::qsort_backward_index(labels,idxs.vector,idxs.vlen);
+	// scores in descending order, each followed by its ground truth
+	SGMatrix<float64_t> sorted=sort_scores(predicted, ground_truth);
+	int32_t length=sorted.num_cols;
 
 	// number of different predicted labels
 	int32_t diff_count=1;
 
-	// get number of different labels
-	for (i=0; i<length-1; i++)
+	// get number of different labels and numbers of positive and
+	// negative labels
+	for (i=0; i<length; i++)
 	{
-		if (labels[i] != labels[i+1])
+		if (i<length-1 && sorted[2*i] != sorted[2*(i+1)])
 			diff_count++;
-	}
-
-	SG_FREE(labels);
-
-	// initialize graph and auROC
-	m_ROC_graph = SGMatrix<float64_t>(2,diff_count+1);
-	m_thresholds = SGVector<float64_t>(length);
-	m_auROC = 0.0;
 
-	// get total numbers of positive and negative labels
-	for(i=0; i<length; i++)
-	{
-		if (ground_truth->get_value(i) >= 0)
+		if (sorted[2*i+1] > 0)
 			pos_count++;
 		else
 			neg_count++;
@@ -88,13 +101,18 @@ float64_t CROCEvaluation::evaluate_roc(CLabels* predicted, CLabels* ground_truth
 	REQUIRE(neg_count>0, "%s::evaluate_roc(): Number of negative labels is "
 			"zero, ROC fails!\n", get_name());
 
+	// initialize graph and auROC
+	m_ROC_graph = SGMatrix<float64_t>(2,diff_count+1);
+	m_thresholds = SGVector<float64_t>(length);
+	m_auROC = 0.0;
+
 	int32_t j = 0;
 	float64_t label;
 
 	// create ROC curve and calculate auROC
 	for(i=0; i<length; i++)
 	{
-		label = predicted->get_value(idxs[i]);
+		label = sorted[2*i];
 
 		if (label != threshold)
 		{
@@ -106,7 +124,7 @@ float64_t CROCEvaluation::evaluate_roc(CLabels* predicted, CLabels* ground_truth
 
 		m_thresholds[i]=threshold;
 
-		if (ground_truth->get_value(idxs[i]) > 0)
+		if (sorted[2*i+1] > 0)
 			tp+=1.0;
 		else
 			fp+=1.0;
@@ -124,6 +142,19 @@ float64_t CROCEvaluation::evaluate_roc(CLabels* predicted, CLabels* ground_truth
 	return m_auROC;
 }
 
+float64_t CROCEvaluation::evaluate_histogram(CScoreHistogram* histogram)
+{
+	REQUIRE(histogram, "%s::evaluate_histogram(): Histogram is NULL\n",
+			get_name());
+
+	m_ROC_graph=histogram->get_ROC();
+	m_thresholds=histogram->get_ROC_thresholds();
+	m_auROC=histogram->get_auROC();
+	m_computed=true;
+
+	return m_auROC;
+}
+
 SGMatrix<float64_t> CROCEvaluation::get_ROC()
 {
 	if (!m_computed)
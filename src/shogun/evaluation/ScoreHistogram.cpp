@@ -0,0 +1,308 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/evaluation/ScoreHistogram.h>
+#include <shogun/labels/Labels.h>
+#include <shogun/base/Parameter.h>
+#include <shogun/base/Parallel.h>
+#include <shogun/mathematics/Math.h>
+
+/* scores counted by one thread at least */
+#define HISTOGRAM_MIN_BLOCK_SIZE 16384
+
+using namespace shogun;
+
+CScoreHistogram::CScoreHistogram() : CSGObject()
+{
+	init();
+}
+
+CScoreHistogram::CScoreHistogram(int32_t num_bins, float64_t min_score,
+		float64_t max_score) : CSGObject()
+{
+	init();
+
+	REQUIRE(num_bins>0, "%s::CScoreHistogram(): Number of bins (%d) has to "
+			"be positive\n", get_name(), num_bins);
+	REQUIRE(min_score<=max_score, "%s::CScoreHistogram(): Lower bound of "
+			"the score range (%f) exceeds the upper bound (%f)\n", get_name(),
+			min_score, max_score);
+
+	m_num_bins=num_bins;
+	m_min_score=min_score;
+	m_max_score=max_score;
+	m_positives=SGVector<int64_t>(num_bins);
+	m_negatives=SGVector<int64_t>(num_bins);
+	reset();
+}
+
+CScoreHistogram::~CScoreHistogram()
+{
+}
+
+void CScoreHistogram::init()
+{
+	m_num_bins=0;
+	m_min_score=0;
+	m_max_score=0;
+
+	SG_ADD(&m_num_bins, "num_bins", "Number of bins", MS_NOT_AVAILABLE);
+	SG_ADD(&m_min_score, "min_score", "Lower bound of the score range",
+			MS_NOT_AVAILABLE);
+	SG_ADD(&m_max_score, "max_score", "Upper bound of the score range",
+			MS_NOT_AVAILABLE);
+	SG_ADD(&m_positives, "positives", "Number of positive examples per bin",
+			MS_NOT_AVAILABLE);
+	SG_ADD(&m_negatives, "negatives", "Number of negative examples per bin",
+			MS_NOT_AVAILABLE);
+}
+
+float64_t CScoreHistogram::get_scale() const
+{
+	if (m_max_score>m_min_score)
+		return m_num_bins/(m_max_score-m_min_score);
+
+	return 0;
+}
+
+void CScoreHistogram::add(CLabels* predicted, CLabels* ground_truth)
+{
+	REQUIRE(m_num_bins>0, "%s::add(): Histogram has no bins\n", get_name());
+	REQUIRE(predicted && ground_truth, "%s::add(): Labels are NULL\n",
+			get_name());
+	REQUIRE(predicted->get_num_labels()==ground_truth->get_num_labels(),
+			"%s::add(): Number of predicted labels (%d) differs from the "
+			"number of ground truth labels (%d)\n", get_name(),
+			predicted->get_num_labels(), ground_truth->get_num_labels());
+	REQUIRE(predicted->get_label_type()==LT_BINARY &&
+			ground_truth->get_label_type()==LT_BINARY,
+			"%s::add(): Labels have to be binary\n", get_name());
+	ground_truth->ensure_valid();
+
+	index_t length=predicted->get_num_labels();
+	float64_t scale=get_scale();
+	int32_t num_blocks=CMath::max(1, CMath::min(parallel->get_num_threads(),
+			length/HISTOGRAM_MIN_BLOCK_SIZE));
+
+	// every block counts into its own pair of histograms first
+	int64_t* counts=SG_CALLOC(int64_t, int64_t(2)*m_num_bins*num_blocks);
+
+#pragma omp parallel for num_threads(num_blocks)
+	for (int32_t b=0; b<num_blocks; b++)
+	{
+		int64_t* positives=counts+int64_t(2)*m_num_bins*b;
+		int64_t* negatives=positives+m_num_bins;
+		index_t from=int64_t(length)*b/num_blocks;
+		index_t to=int64_t(length)*(b+1)/num_blocks;
+
+		for (index_t i=from; i<to; i++)
+		{
+			int32_t bin=get_bin(predicted->get_value(i), scale);
+			if (ground_truth->get_value(i)>0)
+				positives[bin]++;
+			else
+				negatives[bin]++;
+		}
+	}
+
+	for (int32_t b=0; b<num_blocks; b++)
+	{
+		int64_t* positives=counts+int64_t(2)*m_num_bins*b;
+		int64_t* negatives=positives+m_num_bins;
+		for (int32_t j=0; j<m_num_bins; j++)
+		{
+			m_positives[j]+=positives[j];
+			m_negatives[j]+=negatives[j];
+		}
+	}
+
+	SG_FREE(counts);
+}
+
+void CScoreHistogram::add(SGVector<float64_t> scores, SGVector<float64_t> labels)
+{
+	REQUIRE(m_num_bins>0, "%s::add(): Histogram has no bins\n", get_name());
+	REQUIRE(scores.vlen==labels.vlen, "%s::add(): Number of scores (%d) "
+			"differs from the number of labels (%d)\n", get_name(),
+			scores.vlen, labels.vlen);
+
+	float64_t scale=get_scale();
+	for (index_t i=0; i<scores.vlen; i++)
+	{
+		int32_t bin=get_bin(scores[i], scale);
+		if (labels[i]>0)
+			m_positives[bin]++;
+		else
+			m_negatives[bin]++;
+	}
+}
+
+void CScoreHistogram::merge(CScoreHistogram* other)
+{
+	REQUIRE(other, "%s::merge(): Histogram is NULL\n", get_name());
+	REQUIRE(other->m_num_bins==m_num_bins &&
+			other->m_min_score==m_min_score &&
+			other->m_max_score==m_max_score,
+			"%s::merge(): Histograms have different bins\n", get_name());
+
+	for (int32_t j=0; j<m_num_bins; j++)
+	{
+		m_positives[j]+=other->m_positives[j];
+		m_negatives[j]+=other->m_negatives[j];
+	}
+}
+
+void CScoreHistogram::reset()
+{
+	m_positives.zero();
+	m_negatives.zero();
+}
+
+int64_t CScoreHistogram::get_num_positives() const
+{
+	int64_t count=0;
+	for (int32_t j=0; j<m_num_bins; j++)
+		count+=m_positives[j];
+
+	return count;
+}
+
+int64_t CScoreHistogram::get_num_negatives() const
+{
+	int64_t count=0;
+	for (int32_t j=0; j<m_num_bins; j++)
+		count+=m_negatives[j];
+
+	return count;
+}
+
+int32_t CScoreHistogram::get_num_nonempty_bins() const
+{
+	int32_t count=0;
+	for (int32_t j=0; j<m_num_bins; j++)
+	{
+		if (m_positives[j]+m_negatives[j]>0)
+			count++;
+	}
+
+	return count;
+}
+
+SGVector<float64_t> CScoreHistogram::get_nonempty_bin_edges() const
+{
+	SGVector<float64_t> edges(get_num_nonempty_bins());
+
+	// the points of the curves count the scores of a bin and all higher
+	// ones as predicted positive, so the lower edge is their threshold
+	index_t k=0;
+	for (int32_t j=m_num_bins-1; j>=0; j--)
+	{
+		if (m_positives[j]+m_negatives[j]>0)
+		{
+			edges[k++]=m_min_score+
+				(m_max_score-m_min_score)*j/m_num_bins;
+		}
+	}
+
+	return edges;
+}
+
+float64_t CScoreHistogram::get_auROC() const
+{
+	int64_t pos_count=get_num_positives();
+	int64_t neg_count=get_num_negatives();
+	REQUIRE(pos_count>0, "%s::get_auROC(): Number of positive labels is "
+			"zero, ROC fails!\n", get_name());
+	REQUIRE(neg_count>0, "%s::get_auROC(): Number of negative labels is "
+			"zero, ROC fails!\n", get_name());
+
+	// negatives ranked below the positives of higher bins, ties count half
+	float64_t area=0;
+	int64_t tp=0;
+	for (int32_t j=m_num_bins-1; j>=0; j--)
+	{
+		area+=m_negatives[j]*(tp+0.5*m_positives[j]);
+		tp+=m_positives[j];
+	}
+
+	return area/pos_count/neg_count;
+}
+
+SGMatrix<float64_t> CScoreHistogram::get_ROC() const
+{
+	int64_t pos_count=get_num_positives();
+	int64_t neg_count=get_num_negatives();
+	REQUIRE(pos_count>0, "%s::get_ROC(): Number of positive labels is "
+			"zero, ROC fails!\n", get_name());
+	REQUIRE(neg_count>0, "%s::get_ROC(): Number of negative labels is "
+			"zero, ROC fails!\n", get_name());
+
+	SGMatrix<float64_t> graph(2, get_num_nonempty_bins()+1);
+	graph[0]=0;
+	graph[1]=0;
+
+	int64_t tp=0;
+	int64_t fp=0;
+	index_t k=1;
+	for (int32_t j=m_num_bins-1; j>=0; j--)
+	{
+		if (m_positives[j]+m_negatives[j]==0)
+			continue;
+
+		tp+=m_positives[j];
+		fp+=m_negatives[j];
+		graph[2*k]=float64_t(fp)/neg_count;
+		graph[2*k+1]=float64_t(tp)/pos_count;
+		k++;
+	}
+
+	return graph;
+}
+
+SGVector<float64_t> CScoreHistogram::get_ROC_thresholds() const
+{
+	return get_nonempty_bin_edges();
+}
+
+float64_t CScoreHistogram::get_auPRC() const
+{
+	SGMatrix<float64_t> graph=get_PRC();
+	return CMath::area_under_curve(graph.matrix, graph.num_cols, true);
+}
+
+SGMatrix<float64_t> CScoreHistogram::get_PRC() const
+{
+	int64_t pos_count=get_num_positives();
+	REQUIRE(pos_count>0, "%s::get_PRC(): Number of positive labels is "
+			"zero, PRC fails!\n", get_name());
+
+	SGMatrix<float64_t> graph(2, get_num_nonempty_bins());
+
+	int64_t tp=0;
+	int64_t fp=0;
+	index_t k=0;
+	for (int32_t j=m_num_bins-1; j>=0; j--)
+	{
+		if (m_positives[j]+m_negatives[j]==0)
+			continue;
+
+		tp+=m_positives[j];
+		fp+=m_negatives[j];
+		// precision (x)
+		graph[2*k]=float64_t(tp)/(tp+fp);
+		// recall (y)
+		graph[2*k+1]=float64_t(tp)/pos_count;
+		k++;
+	}
+
+	return graph;
+}
+
+SGVector<float64_t> CScoreHistogram::get_PRC_thresholds() const
+{
+	return get_nonempty_bin_edges();
+}
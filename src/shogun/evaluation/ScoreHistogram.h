@@ -0,0 +1,178 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef SCOREHISTOGRAM_H_
+#define SCOREHISTOGRAM_H_
+
+#include <shogun/lib/config.h>
+
+#include <shogun/base/SGObject.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/SGMatrix.h>
+
+namespace shogun
+{
+
+class CLabels;
+
+/** @brief Histogram of the predicted scores of positive and negative
+ * examples, from which ROC and PRC curves and the areas under them are
+ * approximated.
+ *
+ * The score range is split into equally wide bins, and examples with
+ * scores in the same bin are treated as ties, so the curves have one point
+ * per non-empty bin. Scores outside of the range are counted in the first
+ * or last bin. The histogram only stores counts, so it can be filled with
+ * any number of scores in chunks, and histograms with the same bins that
+ * were filled separately (e.g. for shards of the data) can be merged.
+ *
+ * The error of the areas is bounded by the fraction of positive/negative
+ * pairs whose scores share a bin.
+ */
+class CScoreHistogram: public CSGObject
+{
+public:
+	/** default constructor */
+	CScoreHistogram();
+
+	/** constructor
+	 *
+	 * @param num_bins number of bins
+	 * @param min_score lower bound of the score range
+	 * @param max_score upper bound of the score range
+	 */
+	CScoreHistogram(int32_t num_bins, float64_t min_score, float64_t max_score);
+
+	/** destructor */
+	virtual ~CScoreHistogram();
+
+	/** counts predicted scores. Blocks of the scores are counted in
+	 * parallel
+	 *
+	 * @param predicted binary labels
+	 * @param ground_truth binary labels assumed to be correct
+	 */
+	void add(CLabels* predicted, CLabels* ground_truth);
+
+	/** counts predicted scores
+	 *
+	 * @param scores predicted scores
+	 * @param labels ground truth, positive examples are those with
+	 * positive labels
+	 */
+	void add(SGVector<float64_t> scores, SGVector<float64_t> labels);
+
+	/** adds the counts of another histogram with the same bins
+	 *
+	 * @param other histogram
+	 */
+	void merge(CScoreHistogram* other);
+
+	/** sets all counts to zero */
+	void reset();
+
+	/** @return number of bins */
+	int32_t get_num_bins() const { return m_num_bins; }
+
+	/** @return lower bound of the score range */
+	float64_t get_min_score() const { return m_min_score; }
+
+	/** @return upper bound of the score range */
+	float64_t get_max_score() const { return m_max_score; }
+
+	/** @return number of positive examples per bin */
+	SGVector<int64_t> get_positive_counts() const { return m_positives; }
+
+	/** @return number of negative examples per bin */
+	SGVector<int64_t> get_negative_counts() const { return m_negatives; }
+
+	/** @return number of counted positive examples */
+	int64_t get_num_positives() const;
+
+	/** @return number of counted negative examples */
+	int64_t get_num_negatives() const;
+
+	/** @return area under the ROC curve */
+	float64_t get_auROC() const;
+
+	/** @return ROC graph matrix, with one point more than there are
+	 * non-empty bins
+	 */
+	SGMatrix<float64_t> get_ROC() const;
+
+	/** @return thresholds of the points on the ROC graph except the first
+	 * one, the lower edges of the non-empty bins like get_PRC_thresholds()
+	 */
+	SGVector<float64_t> get_ROC_thresholds() const;
+
+	/** @return area under the PRC curve */
+	float64_t get_auPRC() const;
+
+	/** @return PRC graph matrix, with one point per non-empty bin */
+	SGMatrix<float64_t> get_PRC() const;
+
+	/** @return thresholds of the points on the PRC graph, the lower
+	 * edges of the non-empty bins, at or above which scores are counted
+	 * as predicted positive
+	 */
+	SGVector<float64_t> get_PRC_thresholds() const;
+
+	/** @return name of SGSerializable */
+	virtual const char* get_name() const { return "ScoreHistogram"; }
+
+protected:
+
+	/** @return bins per unit of score */
+	float64_t get_scale() const;
+
+	/** @param score predicted score
+	 * @param scale bins per unit of score
+	 * @return bin of the score
+	 */
+	inline int32_t get_bin(float64_t score, float64_t scale) const
+	{
+		float64_t pos=(score-m_min_score)*scale;
+		// NaN scores end up in the first bin
+		if (!(pos>0))
+			return 0;
+		if (pos>=m_num_bins)
+			return m_num_bins-1;
+		return (int32_t) pos;
+	}
+
+	/** @return number of non-empty bins */
+	int32_t get_num_nonempty_bins() const;
+
+	/** @return lower edges of the non-empty bins, highest first */
+	SGVector<float64_t> get_nonempty_bin_edges() const;
+
+private:
+
+	/** register parameters and initialize members */
+	void init();
+
+protected:
+
+	/** number of bins */
+	int32_t m_num_bins;
+
+	/** lower bound of the score range */
+	float64_t m_min_score;
+
+	/** upper bound of the score range */
+	float64_t m_max_score;
+
+	/** number of positive examples per bin */
+	SGVector<int64_t> m_positives;
+
+	/** number of negative examples per bin */
+	SGVector<int64_t> m_negatives;
+};
+
+}
+
+#endif /* SCOREHISTOGRAM_H_ */
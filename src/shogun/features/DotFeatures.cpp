@@ -150,6 +150,16 @@ void CDotFeatures::dense_dot_range(float64_t* output, int32_t start, int32_t sto
 #endif
 }
 
+void CDotFeatures::dot_subset(int32_t vec_idx1, CDotFeatures* df,
+		const int32_t* sub_index, int32_t num, float64_t* output)
+{
+	ASSERT(sub_index || num==0)
+	ASSERT(output || num==0)
+
+	for (int32_t i=0; i<num; i++)
+		output[i]=dot(vec_idx1, df, sub_index[i]);
+}
+
 void CDotFeatures::dense_dot_range_subset(int32_t* sub_index, int32_t num, float64_t* output, float64_t* alphas, float64_t* vec, int32_t dim, float64_t b)
 {
 	ASSERT(sub_index)
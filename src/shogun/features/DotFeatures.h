@@ -80,6 +80,21 @@ class CDotFeatures : public CFeatures
 		 */
 		virtual float64_t dot(int32_t vec_idx1, CDotFeatures* df, int32_t vec_idx2)=0;
 
+		/** compute dot products between vector1 and a subset of the
+		 * vectors of df, appointed by their indices
+		 *
+		 * calls dot() for every vector, feature types that can compute
+		 * many dot products with the same vector faster override this
+		 *
+		 * @param vec_idx1 index of first vector
+		 * @param df DotFeatures (of same kind) to compute dot products with
+		 * @param sub_index indices of vectors of df
+		 * @param num length of sub_index
+		 * @param output dot products (length num)
+		 */
+		virtual void dot_subset(int32_t vec_idx1, CDotFeatures* df,
+				const int32_t* sub_index, int32_t num, float64_t* output);
+
 		/** compute dot product between vector1 and a dense vector
 		 *
 		 * @param vec_idx1 index of first vector
@@ -4,6 +4,7 @@
 #include <shogun/preprocessor/SparsePreprocessor.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/io/SGIO.h>
+#include <shogun/base/Parallel.h>
 
 #include <string.h>
 #include <stdlib.h>
@@ -37,6 +38,7 @@ template<class ST> CSparseFeatures<ST>::CSparseFeatures(SGMatrix<ST> dense)
 
 template<class ST> CSparseFeatures<ST>::CSparseFeatures(const CSparseFeatures & orig)
 : CDotFeatures(orig), sparse_feature_matrix(orig.sparse_feature_matrix),
+	transposed_feature_matrix(orig.transposed_feature_matrix),
 	feature_cache(orig.feature_cache)
 {
 	init();
@@ -217,6 +219,17 @@ template<class ST> SGSparseMatrix<ST> CSparseFeatures<ST>::get_sparse_feature_ma
 	return sparse_feature_matrix;
 }
 
+template<class ST> SGSparseMatrix<ST> CSparseFeatures<ST>::get_transposed_sparse_feature_matrix()
+{
+	if (m_subset_stack->has_subsets())
+		SG_ERROR("Not allowed with subset\n");
+
+	if (!transposed_feature_matrix.sparse_matrix)
+		transposed_feature_matrix=sparse_feature_matrix.get_transposed();
+
+	return transposed_feature_matrix;
+}
+
 template<class ST> CSparseFeatures<ST>* CSparseFeatures<ST>::get_transposed()
 {
 	if (m_subset_stack->has_subsets())
@@ -225,12 +238,54 @@ template<class ST> CSparseFeatures<ST>* CSparseFeatures<ST>::get_transposed()
 	return new CSparseFeatures<ST>(sparse_feature_matrix.get_transposed());
 }
 
+template<class ST> void CSparseFeatures<ST>::compute_dot_matrix(
+		CSparseFeatures<ST>* rhs, SGMatrix<float64_t> result)
+{
+	REQUIRE(rhs, "Right hand side features must not be NULL\n");
+	REQUIRE(result.num_rows==get_num_vectors() &&
+		result.num_cols==rhs->get_num_vectors(),
+		"Result matrix (%dx%d) has to be %dx%d\n", result.num_rows,
+		result.num_cols, get_num_vectors(), rhs->get_num_vectors());
+
+	SGSparseMatrix<ST> transposed=get_transposed_sparse_feature_matrix();
+	int32_t num_rows=result.num_rows;
+	int32_t num_cols=result.num_cols;
+
+#pragma omp parallel for num_threads(parallel->get_num_threads())
+	for (int32_t j=0; j<num_cols; j++)
+	{
+		float64_t* col=result.matrix+int64_t(j)*num_rows;
+		memset(col, 0, sizeof(float64_t)*num_rows);
+
+		SGSparseVector<ST> vec=rhs->get_sparse_feature_vector(j);
+		for (int32_t k=0; k<vec.num_feat_entries; k++)
+		{
+			int32_t feat=vec.features[k].feat_index;
+			if (feat>=transposed.num_vectors)
+				continue;
+
+			float64_t alpha=vec.features[k].entry;
+			const SGSparseVector<ST>& t=transposed.sparse_matrix[feat];
+			for (int32_t l=0; l<t.num_feat_entries; l++)
+				col[t.features[l].feat_index]+=alpha*t.features[l].entry;
+		}
+		rhs->free_sparse_feature_vector(j);
+	}
+}
+
+template<> void CSparseFeatures<complex128_t>::compute_dot_matrix(
+		CSparseFeatures<complex128_t>* rhs, SGMatrix<float64_t> result)
+{
+	SG_NOTIMPLEMENTED;
+}
+
 template<class ST> void CSparseFeatures<ST>::set_sparse_feature_matrix(SGSparseMatrix<ST> sm)
 {
 	if (m_subset_stack->has_subsets())
 		SG_ERROR("Not allowed with subset\n");
 
 	sparse_feature_matrix=sm;
+	free_transposed_sparse_feature_matrix();
 
 	// TODO: check should be implemented in sparse matrix class
 	for (int32_t j=0; j<get_num_vectors(); j++) {
@@ -275,6 +330,12 @@ template<class ST> void CSparseFeatures<ST>::free_sparse_features()
 template<class ST> void CSparseFeatures<ST>::free_sparse_feature_matrix()
 {
 	sparse_feature_matrix=SGSparseMatrix<ST>();
+	free_transposed_sparse_feature_matrix();
+}
+
+template<class ST> void CSparseFeatures<ST>::free_transposed_sparse_feature_matrix()
+{
+	transposed_feature_matrix=SGSparseMatrix<ST>();
 }
 
 template<class ST> void CSparseFeatures<ST>::set_full_feature_matrix(SGMatrix<ST> full)
@@ -297,6 +358,7 @@ template<class ST> bool CSparseFeatures<ST>::apply_preprocessor(bool force_prepr
 				set_preprocessed(i);
 				CSparsePreprocessor<ST>* p = (CSparsePreprocessor<ST>*) get_preprocessor(i);
 				SG_INFO("preprocessing using preproc %s\n", p->get_name())
+				free_transposed_sparse_feature_matrix();
 
 				if (p->apply_to_sparse_feature_matrix(this) == NULL)
 				{
@@ -343,6 +405,7 @@ template<class ST> int32_t CSparseFeatures<ST>::set_num_features(int32_t num)
 	int32_t n=get_num_features();
 	ASSERT(n<=num)
 	sparse_feature_matrix.num_features=num;
+	free_transposed_sparse_feature_matrix();
 	return sparse_feature_matrix.num_features;
 }
 
@@ -484,6 +547,45 @@ template<> float64_t CSparseFeatures<complex128_t>::dot(int32_t vec_idx1,
 	return 0.0;
 }
 
+template<class ST> void CSparseFeatures<ST>::dot_subset(int32_t vec_idx1,
+		CDotFeatures* df, const int32_t* sub_index, int32_t num,
+		float64_t* output)
+{
+	ASSERT(df)
+	ASSERT(df->get_feature_type() == get_feature_type())
+	ASSERT(df->get_feature_class() == get_feature_class())
+
+	/* merging the indices costs about num times the entries of vector1,
+	 * the dense vector the dimension, so pairs are merged unless the
+	 * dense vector is paid for */
+	int32_t dim=CMath::max(get_num_features(),
+			((CSparseFeatures<ST>*) df)->get_num_features());
+	int64_t num_entries=get_sparse_feature_vector(vec_idx1).num_feat_entries;
+	free_sparse_feature_vector(vec_idx1);
+	if (num<2 || int64_t(num)*num_entries<=dim)
+	{
+		CDotFeatures::dot_subset(vec_idx1, df, sub_index, num, output);
+		return;
+	}
+
+	// large blocks are zeroed lazily by the allocator, so only the pages
+	// vector1 is added to are touched
+	float64_t* vec=SG_CALLOC(float64_t, dim);
+	add_to_dense_vec(1.0, vec_idx1, vec, dim);
+
+	for (int32_t i=0; i<num; i++)
+		output[i]=df->dense_dot(sub_index[i], vec, dim);
+
+	SG_FREE(vec);
+}
+
+template<> void CSparseFeatures<complex128_t>::dot_subset(int32_t vec_idx1,
+		CDotFeatures* df, const int32_t* sub_index, int32_t num,
+		float64_t* output)
+{
+	SG_NOTIMPLEMENTED;
+}
+
 template<class ST> float64_t CSparseFeatures<ST>::dense_dot(int32_t vec_idx1, const float64_t* vec2, int32_t vec2_len)
 {
 	REQUIRE(vec2, "dense_dot(vec_idx1=%d,vec2_len=%d): vec2 must not be NULL\n",
@@ -571,18 +673,23 @@ template<class ST> void CSparseFeatures<ST>::free_feature_iterator(void* iterato
 
 template<class ST> CFeatures* CSparseFeatures<ST>::copy_subset(SGVector<index_t> indices)
 {
+	SGVector<index_t> num_feat_entries(indices.vlen);
+	for (index_t i=0; i<indices.vlen; ++i)
+		num_feat_entries[i]=get_nnz_features_for_vector(indices.vector[i]);
+
+	/* the copies are stored contiguously */
 	SGSparseMatrix<ST> matrix_copy=SGSparseMatrix<ST>(get_dim_feature_space(),
-			indices.vlen);
+			num_feat_entries);
 
 	for (index_t i=0; i<indices.vlen; ++i)
 	{
 		/* index to copy */
 		index_t index=indices.vector[i];
-		index_t real_index=m_subset_stack->subset_idx_conversion(index);
 
 		/* copy sparse vector */
-		SGSparseVector<ST> current=get_sparse_feature_vector(real_index);
-		matrix_copy.sparse_matrix[i]=current;
+		SGSparseVector<ST> current=get_sparse_feature_vector(index);
+		memcpy(matrix_copy.sparse_matrix[i].features, current.features,
+				sizeof(SGSparseVectorEntry<ST>)*current.num_feat_entries);
 
 		free_sparse_feature_vector(index);
 	}
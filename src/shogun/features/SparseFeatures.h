@@ -36,7 +36,9 @@ template <class T> class CCache;
 /** @brief Template class SparseFeatures implements sparse matrices.
  *
  * Features are an array of SGSparseVector. Within each vector feat_index are
- * sorted (increasing).
+ * sorted (increasing). Matrices built with SGSparseMatrixBuilder or converted
+ * from dense ones keep all entries in one contiguous block, and the transpose
+ * is cached for column-wise access.
  *
  * Sparse feature vectors can be accessed via get_sparse_feature_vector() and
  * should be freed (this operation is a NOP in most cases) via
@@ -92,6 +94,13 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		 */
 		void free_sparse_feature_matrix();
 
+		/** free the cached transposed sparse feature matrix (see
+		 * get_transposed_sparse_feature_matrix()), it is recomputed on next
+		 * use. Call this after changing the entries of the matrix returned
+		 * by get_sparse_feature_matrix() in place
+		 */
+		void free_transposed_sparse_feature_matrix();
+
 		/** free sparse feature matrix and cache
 		 *
 		 * any subset is removed
@@ -188,6 +197,9 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		SGSparseVector<ST>* get_sparse_feature_matrix(int32_t &num_feat, int32_t &num_vec);
 
 		/** get the sparse feature matrix
+		 *
+		 * The matrix is shared, after changing its entries in place call
+		 * free_transposed_sparse_feature_matrix()
 		 *
 		 * not possible with subset
 		 *
@@ -196,14 +208,46 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		 */
 		SGSparseMatrix<ST> get_sparse_feature_matrix();
 
-		/** get a transposed copy of the features
+		/** get the transposed sparse feature matrix, i.e. the feature matrix
+		 * in compressed sparse column layout for column-wise access. It is
+		 * computed on first use and cached until a new feature matrix is
+		 * set or free_transposed_sparse_feature_matrix() is called
 		 *
 		 * not possible with subset
 		 *
-		 * @return transposed copy
+		 * @return transposed sparse matrix
+		 */
+		SGSparseMatrix<ST> get_transposed_sparse_feature_matrix();
+
+		/** get the transposed features
+		 *
+		 * The transposed features own a newly computed matrix, changing
+		 * their entries does not affect these features.
+		 *
+		 * not possible with subset
+		 *
+		 * @return transposed features
 		 */
 		CSparseFeatures<ST>* get_transposed();
 
+		/** compute the dot products between all vectors of these and of
+		 * the given features, i.e. the product of the transposed feature
+		 * matrix with the feature matrix of rhs
+		 *
+		 * Every rhs vector is multiplied with the cached transposed matrix
+		 * (see get_transposed_sparse_feature_matrix()), so only products
+		 * of non-zero entries are accumulated. The rhs vectors are
+		 * processed in parallel.
+		 *
+		 * not possible with subset, rhs may have one
+		 *
+		 * @param rhs features to compute the dot products with
+		 * @param result dot products (output, get_num_vectors() x
+		 * rhs->get_num_vectors())
+		 */
+		void compute_dot_matrix(CSparseFeatures<ST>* rhs,
+				SGMatrix<float64_t> result);
+
 		/** compute and return the transpose of the sparse feature matrix
 		 * which will be prepocessed.
 		 * num_feat, num_vectors are returned by reference
@@ -402,6 +446,26 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		 */
 		virtual float64_t dot(int32_t vec_idx1, CDotFeatures* df, int32_t vec_idx2);
 
+		/** compute dot products between vector1 and a subset of the
+		 * vectors of df
+		 *
+		 * vector1 is added to a dense vector once, which is then
+		 * multiplied with every vector of the subset, instead of merging
+		 * the feature indices of every pair of vectors. Pairs are still
+		 * merged if num times the number of entries of vector1 does not
+		 * exceed the dimension, i.e. the dense vector would cost more
+		 *
+		 * possible with subset of this instance and of DotFeatures
+		 *
+		 * @param vec_idx1 index of first vector
+		 * @param df DotFeatures (of same kind) to compute dot products with
+		 * @param sub_index indices of vectors of df
+		 * @param num length of sub_index
+		 * @param output dot products (length num)
+		 */
+		virtual void dot_subset(int32_t vec_idx1, CDotFeatures* df,
+				const int32_t* sub_index, int32_t num, float64_t* output);
+
 		/** compute dot product between vector1 and a dense vector
 		 *
 		 * possible with subset
@@ -499,6 +563,9 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		/// array of sparse vectors of size num_vectors
 		SGSparseMatrix<ST> sparse_feature_matrix;
 
+		/// cached transposed sparse feature matrix
+		SGSparseMatrix<ST> transposed_feature_matrix;
+
 		/** feature cache */
 		CCache< SGSparseVectorEntry<ST> >* feature_cache;
 };
@@ -92,6 +92,8 @@ bool CCombinedKernel::init(CFeatures* l, CFeatures* r)
 		init_subkernel_weights();
 	}
 
+	clear_subkernel_cache();
+
 	/* if the specified features are not combined features, but a single other
 	 * feature type, assume that the caller wants to use all kernels on these */
 	if (l && r && l->get_feature_class()==r->get_feature_class() &&
@@ -199,6 +201,7 @@ bool CCombinedKernel::init(CFeatures* l, CFeatures* r)
 void CCombinedKernel::remove_lhs()
 {
 	delete_optimization();
+	clear_subkernel_cache();
 
 	for (index_t k_idx=0; k_idx<get_num_kernels(); k_idx++)
 	{
@@ -216,6 +219,7 @@ void CCombinedKernel::remove_lhs()
 void CCombinedKernel::remove_rhs()
 {
 	delete_optimization();
+	clear_subkernel_cache();
 
 	for (index_t k_idx=0; k_idx<get_num_kernels(); k_idx++)
 	{
@@ -233,6 +237,7 @@ void CCombinedKernel::remove_rhs()
 void CCombinedKernel::remove_lhs_and_rhs()
 {
 	delete_optimization();
+	clear_subkernel_cache();
 
 	for (index_t k_idx=0; k_idx<get_num_kernels(); k_idx++)
 	{
@@ -259,6 +264,7 @@ void CCombinedKernel::cleanup()
 	}
 
 	delete_optimization();
+	clear_subkernel_cache();
 
 	CKernel::cleanup();
 
@@ -791,6 +797,174 @@ bool CCombinedKernel::precompute_subkernels()
 	return true;
 }
 
+void CCombinedKernel::set_subkernel_cache_size(int32_t size)
+{
+	REQUIRE(size>=0, "Subkernel cache size (%d) has to be non-negative\n", size);
+	subkernel_cache_size=size;
+	clear_subkernel_cache();
+}
+
+int32_t CCombinedKernel::get_subkernel_cache_size() const
+{
+	return subkernel_cache_size;
+}
+
+void CCombinedKernel::clear_subkernel_cache()
+{
+	subkernel_cache_idx=SGVector<int32_t>();
+	subkernel_cache=SGMatrix<float64_t>();
+}
+
+/* position of the pair (i,j) in a packed lower triangle */
+static inline int64_t packed_index(int64_t i, int64_t j)
+{
+	return i>=j ? i*(i+1)/2+j : j*(j+1)/2+i;
+}
+
+bool CCombinedKernel::update_subkernel_cache(SGVector<int32_t> idx,
+	CKernel** kernels)
+{
+	int32_t num_kernels=get_num_kernels();
+	int64_t n=idx.vlen;
+	int64_t num_packed=n*(n+1)/2;
+
+	if (num_packed*num_kernels*int64_t(sizeof(float64_t)) >
+			int64_t(subkernel_cache_size)*1024*1024)
+	{
+		clear_subkernel_cache();
+		return false;
+	}
+
+	if (subkernel_cache.num_cols!=num_kernels)
+		clear_subkernel_cache();
+
+	if (subkernel_cache_idx.vlen==n &&
+			!memcmp(subkernel_cache_idx.vector, idx.vector, sizeof(int32_t)*n))
+		return true;
+
+	/* position of every vector in the old cache, -1 if it is not cached */
+	SGVector<int32_t> lookup(num_lhs);
+	lookup.set_const(-1);
+	for (index_t i=0; i<subkernel_cache_idx.vlen; i++)
+		lookup[subkernel_cache_idx[i]]=i;
+
+	SGVector<int32_t> old_pos(n);
+	for (index_t i=0; i<n; i++)
+	{
+		REQUIRE(idx[i]>=0 && idx[i]<num_lhs, "Vector index %d out of range [0,%d)\n",
+			idx[i], num_lhs);
+		old_pos[i]=lookup[idx[i]];
+	}
+
+	SGMatrix<float64_t> cache(num_packed, num_kernels);
+	SGMatrix<float64_t> old_cache=subkernel_cache;
+
+#pragma omp parallel for schedule(dynamic)
+	for (int64_t t=0; t<n*num_kernels; t++)
+	{
+		int32_t k=t/n;
+		int64_t i=t%n;
+		float64_t* row=cache.get_column_vector(k)+packed_index(i, 0);
+		const float64_t* old_col=old_cache.matrix ? old_cache.get_column_vector(k) : NULL;
+
+		for (int64_t j=0; j<=i; j++)
+		{
+			if (old_pos[i]>=0 && old_pos[j]>=0)
+				row[j]=old_col[packed_index(old_pos[i], old_pos[j])];
+			else
+				row[j]=kernels[k]->kernel(idx[i], idx[j]);
+		}
+	}
+
+	subkernel_cache=cache;
+	subkernel_cache_idx=idx.clone();
+
+	return true;
+}
+
+bool CCombinedKernel::has_symmetric_subkernels()
+{
+	if (!lhs || !rhs)
+		return false;
+
+	bool symmetric=true;
+	for (index_t k_idx=0; k_idx<get_num_kernels() && symmetric; k_idx++)
+	{
+		CKernel* k=get_kernel(k_idx);
+		CFeatures* k_lhs=k->get_lhs();
+		CFeatures* k_rhs=k->get_rhs();
+		symmetric=k_lhs && k_lhs==k_rhs;
+		SG_UNREF(k_lhs);
+		SG_UNREF(k_rhs);
+		SG_UNREF(k);
+	}
+
+	return symmetric;
+}
+
+SGVector<float64_t> CCombinedKernel::compute_subkernel_quadratic_forms(
+	SGVector<int32_t> idx, SGVector<float64_t> weights)
+{
+	REQUIRE(idx.vlen==weights.vlen, "Number of vectors (%d) and weights (%d) differ\n",
+		idx.vlen, weights.vlen);
+	REQUIRE(get_num_subkernels()==get_num_kernels(),
+		"Quadratic forms of appended subkernel weights are not supported\n");
+	REQUIRE(has_symmetric_subkernels(), "Left- and right-hand side features "
+		"of every subkernel have to be the same\n");
+
+	int32_t num_kernels=get_num_kernels();
+	int64_t n=idx.vlen;
+	SGVector<float64_t> result(num_kernels);
+	result.zero();
+	if (n==0)
+		return result;
+
+	CKernel** kernels=SG_MALLOC(CKernel*, num_kernels);
+	for (index_t k_idx=0; k_idx<num_kernels; k_idx++)
+		kernels[k_idx]=get_kernel(k_idx);
+
+	bool cached=update_subkernel_cache(idx, kernels);
+
+	/* contribution of every row of every kernel, reduced afterwards so that
+	 * the result does not depend on the number of threads */
+	SGMatrix<float64_t> partial(n, num_kernels);
+
+#pragma omp parallel for schedule(dynamic)
+	for (int64_t t=0; t<n*num_kernels; t++)
+	{
+		int32_t k=t/n;
+		int64_t i=t%n;
+		float64_t sum=0;
+		float64_t diag=0;
+
+		if (cached)
+		{
+			const float64_t* row=subkernel_cache.get_column_vector(k)+packed_index(i, 0);
+			for (int64_t j=0; j<i; j++)
+				sum+=weights[j]*row[j];
+			diag=row[i];
+		}
+		else
+		{
+			for (int64_t j=0; j<i; j++)
+				sum+=weights[j]*kernels[k]->kernel(idx[i], idx[j]);
+			diag=kernels[k]->kernel(idx[i], idx[i]);
+		}
+
+		partial(i, k)=weights[i]*(2*sum+weights[i]*diag);
+	}
+
+	for (index_t k=0; k<num_kernels; k++)
+	{
+		for (int64_t i=0; i<n; i++)
+			result[k]+=partial(i, k);
+		SG_UNREF(kernels[k]);
+	}
+	SG_FREE(kernels);
+
+	return result;
+}
+
 void CCombinedKernel::init()
 {
 	sv_count=0;
@@ -825,6 +999,10 @@ void CCombinedKernel::init()
 	weight_update = false;
 	SG_ADD(&weight_update, "weight_update",
 	    "weight update", MS_NOT_AVAILABLE);
+
+	subkernel_cache_size=0;
+	SG_ADD(&subkernel_cache_size, "subkernel_cache_size",
+	    "Subkernel cache size in MB.", MS_NOT_AVAILABLE);
 }
 
 void CCombinedKernel::enable_subkernel_weight_learning()
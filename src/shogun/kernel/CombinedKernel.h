@@ -151,6 +151,7 @@ class CCombinedKernel : public CKernel
 			if (!(k->has_property(KP_LINADD)))
 				unset_property(KP_LINADD);
 
+			clear_subkernel_cache();
 			return kernel_array->insert_element(k, idx);
 		}
 
@@ -168,6 +169,7 @@ class CCombinedKernel : public CKernel
 				unset_property(KP_LINADD);
 
 			int n = get_num_kernels();
+			clear_subkernel_cache();
 			kernel_array->push_back(k);
 
 			if(enable_subkernel_weight_opt && n+1==get_num_kernels())
@@ -185,6 +187,7 @@ class CCombinedKernel : public CKernel
 		inline bool delete_kernel(int32_t idx)
 		{
 			bool succesful_deletion = kernel_array->delete_element(idx);
+			clear_subkernel_cache();
 
 			if (get_num_kernels()==0)
 			{
@@ -365,6 +368,51 @@ class CCombinedKernel : public CKernel
 		/** precompute all sub-kernels */
 		bool precompute_subkernels();
 
+		/** compute for every kernel m the quadratic form
+		 *
+		 * \f[
+		 *     q_m = \sum_{i,j} w_i w_j k_m({\bf x}_{idx_i}, {\bf x}_{idx_j})
+		 * \f]
+		 *
+		 * of its unweighted kernel matrix among the vectors idx, as needed by
+		 * MKL for every beta step. Kernels and rows are evaluated in
+		 * parallel. Left- and right-hand side features have to be the same.
+		 *
+		 * If a subkernel cache is set (see set_subkernel_cache_size()), the
+		 * subkernel values among idx are kept, and values among vectors that
+		 * were already passed in the previous call are not recomputed.
+		 *
+		 * @param idx vector indices, e.g. support vectors
+		 * @param weights weight of every vector, e.g. alpha_i*y_i
+		 * @return quadratic form of every kernel
+		 */
+		SGVector<float64_t> compute_subkernel_quadratic_forms(
+			SGVector<int32_t> idx, SGVector<float64_t> weights);
+
+		/** whether every subkernel has the same features on both sides, as
+		 * compute_subkernel_quadratic_forms() requires. The combined
+		 * features of both sides may differ, e.g. init() wraps plain
+		 * features separately for each side
+		 *
+		 * @return if all subkernels are initialized with lhs==rhs
+		 */
+		bool has_symmetric_subkernels();
+
+		/** set size of the subkernel cache used by
+		 * compute_subkernel_quadratic_forms()
+		 *
+		 * @param size cache size in MB, 0 disables the cache
+		 */
+		void set_subkernel_cache_size(int32_t size);
+
+		/** @return size of the subkernel cache in MB */
+		int32_t get_subkernel_cache_size() const;
+
+		/** drop all cached subkernel values. Has to be called if features
+		 * of the subkernels are changed directly
+		 */
+		void clear_subkernel_cache();
+
 		/** Returns a  casted version of the given kernel. Throws an error
 		 * if parameter is not of class CombinedKernel. SG_REF's the returned
 		 * kernel
@@ -464,6 +512,15 @@ class CCombinedKernel : public CKernel
 				initialized=false;
 		}
 
+		/** bring the subkernel cache to the vectors idx (in this order),
+		 * reusing values among vectors that were cached before
+		 *
+		 * @param idx vector indices
+		 * @param kernels kernels of the combination
+		 * @return whether the values fit into the cache
+		 */
+		bool update_subkernel_cache(SGVector<int32_t> idx, CKernel** kernels);
+
 	private:
 		void init();
 
@@ -490,6 +547,14 @@ class CCombinedKernel : public CKernel
 		bool enable_subkernel_weight_opt;
 		/** update the weight for subkernels */
 		bool weight_update;
+
+		/** subkernel cache size in MB */
+		int32_t subkernel_cache_size;
+		/** vectors whose subkernel values are cached */
+		SGVector<int32_t> subkernel_cache_idx;
+		/** packed lower triangles of the unweighted subkernel matrices among
+		 * subkernel_cache_idx, one column per kernel */
+		SGMatrix<float64_t> subkernel_cache;
 };
 }
 #endif /* _COMBINEDKERNEL_H__ */
@@ -15,6 +15,7 @@
 
 #include <shogun/kernel/Kernel.h>
 #include <shogun/features/DotFeatures.h>
+#include <shogun/features/SparseFeatures.h>
 #include <shogun/io/SGIO.h>
 
 namespace shogun
@@ -135,6 +136,49 @@ class CDotKernel : public CKernel
 		{
 			return ((CDotFeatures*) lhs)->dot(idx_a, ((CDotFeatures*) rhs), idx_b);
 		}
+
+		/** compute dot products between lhs vector idx_a and the rhs vectors
+		 * idx_b[0], ..., idx_b[num-1], see CDotFeatures::dot_subset()
+		 *
+		 * @param idx_a index of lhs vector
+		 * @param idx_b indices of rhs vectors
+		 * @param num number of rhs vectors
+		 * @param result dot products (output, length num)
+		 */
+		void compute_dot_row(int32_t idx_a, const int32_t* idx_b,
+				int32_t num, float64_t* result)
+		{
+			((CDotFeatures*) lhs)->dot_subset(idx_a, (CDotFeatures*) rhs,
+					idx_b, num, result);
+		}
+
+		/** compute the matrix of all dot products between lhs and rhs
+		 * vectors at once, which is supported for sparse real valued
+		 * features, see CSparseFeatures::compute_dot_matrix()
+		 *
+		 * @param result dot products (output, num_vec_lhs x num_vec_rhs)
+		 * @return whether the matrix was computed
+		 */
+		bool compute_dot_matrix(SGMatrix<float64_t> result)
+		{
+			if (lhs->get_feature_class()!=C_SPARSE ||
+					rhs->get_feature_class()!=C_SPARSE ||
+					lhs->get_feature_type()!=F_DREAL ||
+					rhs->get_feature_type()!=F_DREAL)
+				return false;
+
+			CSubsetStack* subsets=lhs->get_subset_stack();
+			bool has_subsets=subsets->has_subsets();
+			SG_UNREF(subsets);
+
+			CSparseFeatures<float64_t>* sf=(CSparseFeatures<float64_t>*) lhs;
+			// not for features computing their vectors on the fly
+			if (has_subsets || !sf->get_sparse_feature_matrix().sparse_matrix)
+				return false;
+
+			sf->compute_dot_matrix((CSparseFeatures<float64_t>*) rhs, result);
+			return true;
+		}
 };
 }
 #endif /* _DOTKERNEL_H__ */
@@ -133,6 +133,27 @@ float64_t CGaussianKernel::compute(int32_t idx_a, int32_t idx_b)
     return CMath::exp(-result);
 }
 
+void CGaussianKernel::compute_row(int32_t idx_a, const int32_t* idx_b,
+		int32_t num, float64_t* result)
+{
+	// subclasses compute differently from their distance
+	if (get_kernel_type()!=K_GAUSSIAN || has_precomputed_distance() ||
+			m_distance->get_distance_type()!=D_EUCLIDEAN ||
+			lhs->get_feature_class()!=C_SPARSE ||
+			rhs->get_feature_class()!=C_SPARSE)
+	{
+		CKernel::compute_row(idx_a, idx_b, num, result);
+		return;
+	}
+
+	((CEuclideanDistance*) m_distance)->distance_subset(idx_a, idx_b, num,
+		result);
+
+	const float64_t inv_width=1.0/get_width();
+	for (int32_t i=0; i<num; i++)
+		result[i]=CMath::exp(-result[i]*inv_width);
+}
+
 void CGaussianKernel::load_serializable_post() throw (ShogunException)
 {
 	CKernel::load_serializable_post();
@@ -146,6 +146,21 @@ protected:
 	 */
 	virtual float64_t compute(int32_t idx_a, int32_t idx_b);
 
+	/** compute kernel function between lhs vector idx_a and the rhs
+	 * vectors idx_b[0], ..., idx_b[num-1]
+	 *
+	 * For sparse features and the default Euclidean distance, the
+	 * distances are computed at once, see
+	 * CEuclideanDistance::distance_subset()
+	 *
+	 * @param idx_a index of lhs vector
+	 * @param idx_b indices of rhs vectors
+	 * @param num number of rhs vectors
+	 * @param result kernel values (output, length num)
+	 */
+	virtual void compute_row(int32_t idx_a, const int32_t* idx_b,
+			int32_t num, float64_t* result);
+
 	/** Can (optionally) be overridden to post-initialize some member
 	 * variables which are not PARAMETER::ADD'ed. Make sure that at first
 	 * the overridden method BASE_CLASS::LOAD_SERIALIZABLE_POST is called.
@@ -281,18 +281,27 @@ void CKernel::get_kernel_row(
 	{
 		if (full_line)
 		{
-			for(j=0;j<get_num_vec_lhs();j++)
-				buffer[j]=(KERNELCACHE_ELEM) kernel(docnum, j);
+			SGVector<int32_t> idx=SGVector<int32_t>(num_vectors);
+			idx.range_fill();
+			kernel_row(docnum, idx.vector, num_vectors, buffer);
 		}
 		else
 		{
+			for(i=0;active2dnum[i]>=0;i++);
+
+			SGVector<int32_t> idx=SGVector<int32_t>(i);
+			SGVector<float64_t> values=SGVector<float64_t>(i);
 			for(i=0;(j=active2dnum[i])>=0;i++)
 			{
 				int32_t k=j;
 				if (k>=num_vectors)
 					k=2*num_vectors-1-k;
-				buffer[j]=(KERNELCACHE_ELEM) kernel(docnum, k);
+				idx[i]=k;
 			}
+
+			kernel_row(docnum, idx.vector, idx.vlen, values.vector);
+			for(i=0;(j=active2dnum[i])>=0;i++)
+				buffer[j]=(KERNELCACHE_ELEM) values[i];
 		}
 	}
 }
@@ -315,6 +324,11 @@ void CKernel::cache_kernel_row(int32_t m)
 		if(cache) {
 			l=kernel_cache.totdoc2active[m];
 
+			// entries not found in other cached rows are computed at once
+			SGVector<int32_t> pos=SGVector<int32_t>(kernel_cache.activenum);
+			SGVector<int32_t> idx=SGVector<int32_t>(kernel_cache.activenum);
+			int32_t num=0;
+
 			for(j=0;j<kernel_cache.activenum;j++)  // fill cache
 			{
 				k=kernel_cache.active2totdoc[j];
@@ -328,9 +342,13 @@ void CKernel::cache_kernel_row(int32_t m)
 					if (k>=num_vectors)
 						k=2*num_vectors-1-k;
 
-					cache[j]=kernel(m, k);
+					pos[num]=j;
+					idx[num]=k;
+					num++;
 				}
 			}
+
+			fill_cache_row(m, cache, pos.vector, idx.vector, num);
 		}
 		else
 			perror("Error: Kernel cache full! => increase cache size");
@@ -338,16 +356,33 @@ void CKernel::cache_kernel_row(int32_t m)
 }
 
 
+void CKernel::fill_cache_row(int32_t m, KERNELCACHE_ELEM* cache,
+		const int32_t* pos, const int32_t* idx, int32_t num)
+{
+	if (num==0)
+		return;
+
+	SGVector<float64_t> values=SGVector<float64_t>(num);
+	kernel_row(m, idx, num, values.vector);
+
+	for (int32_t i=0; i<num; i++)
+		cache[pos[i]]=values[i];
+}
+
 void* CKernel::cache_multiple_kernel_row_helper(void* p)
 {
 	int32_t j,k,l;
 	S_KTHREAD_PARAM* params = (S_KTHREAD_PARAM*) p;
 
+	SGVector<int32_t> pos=SGVector<int32_t>(params->kernel_cache->activenum);
+	SGVector<int32_t> idx=SGVector<int32_t>(params->kernel_cache->activenum);
+
 	for (int32_t i=params->start; i<params->end; i++)
 	{
 		KERNELCACHE_ELEM* cache=params->cache[i];
 		int32_t m = params->uncached_rows[i];
 		l=params->kernel_cache->totdoc2active[m];
+		int32_t num=0;
 
 		for(j=0;j<params->kernel_cache->activenum;j++)  // fill cache
 		{
@@ -362,10 +397,14 @@ void* CKernel::cache_multiple_kernel_row_helper(void* p)
 					if (k>=params->num_vectors)
 						k=2*params->num_vectors-1-k;
 
-					cache[j]=params->kernel->kernel(m, k);
+					pos[num]=j;
+					idx[num]=k;
+					num++;
 				}
 		}
 
+		params->kernel->fill_cache_row(m, cache, pos.vector, idx.vector, num);
+
 		//now line m is cached
 		params->needs_computation[m]=0;
 	}
@@ -1290,6 +1329,49 @@ SGVector<float64_t> CKernel::row_col_wise_sum_block(index_t block_begin_row,
 	return sum;
 }
 
+void CKernel::compute_row(int32_t idx_a, const int32_t* idx_b, int32_t num,
+		float64_t* result)
+{
+	for (int32_t i=0; i<num; i++)
+		result[i]=compute(idx_a, idx_b[i]);
+}
+
+void CKernel::kernel_row(int32_t idx_a, const int32_t* idx_b, int32_t num,
+		float64_t* result)
+{
+	REQUIRE(idx_a>=0 && idx_a<num_lhs,
+		"%s::kernel_row(): index out of Range: idx_a=%d/%d\n",
+		get_name(), idx_a, num_lhs);
+
+	for (int32_t i=0; i<num; i++)
+	{
+		REQUIRE(idx_b[i]>=0 && idx_b[i]<num_rhs,
+			"%s::kernel_row(): index out of Range: idx_b=%d/%d\n",
+			get_name(), idx_b[i], num_rhs);
+	}
+
+	compute_row(idx_a, idx_b, num, result);
+
+	for (int32_t i=0; i<num; i++)
+		result[i]=normalizer->normalize(result[i], idx_a, idx_b[i]);
+}
+
+bool CKernel::compute_normalized_matrix(float64_t* result, int32_t m,
+		int32_t n)
+{
+	if (!compute_matrix(SGMatrix<float64_t>(result, m, n, false)))
+		return false;
+
+#pragma omp parallel for num_threads(parallel->get_num_threads())
+	for (int32_t j=0; j<n; j++)
+	{
+		for (int32_t i=0; i<m; i++)
+			result[i+int64_t(j)*m]=normalizer->normalize(result[i+int64_t(j)*m], i, j);
+	}
+
+	return true;
+}
+
 template <class T> void* CKernel::get_kernel_matrix_helper(void* p)
 {
 	K_THREAD_PARAM<T>* params= (K_THREAD_PARAM<T>*) p;
@@ -1305,6 +1387,11 @@ template <class T> void* CKernel::get_kernel_matrix_helper(void* p)
 	int64_t total_end=params->total_end;
 	int64_t total=total_start;
 
+	// a row is computed at once, see compute_row()
+	SGVector<int32_t> idx=SGVector<int32_t>(n);
+	SGVector<float64_t> row=SGVector<float64_t>(n);
+	idx.range_fill();
+
 	for (int32_t i=i_start; i<i_end; i++)
 	{
 		int32_t j_start=0;
@@ -1312,29 +1399,29 @@ template <class T> void* CKernel::get_kernel_matrix_helper(void* p)
 		if (symmetric)
 			j_start=i;
 
+		k->kernel_row(i, idx.vector+j_start, n-j_start, row.vector);
+
 		for (int32_t j=j_start; j<n; j++)
 		{
-			float64_t v=k->kernel(i,j);
-			result[i+j*m]=v;
+			T v=row[j-j_start];
+			result[i+int64_t(j)*m]=v;
 
 			if (symmetric && i!=j)
-				result[j+i*m]=v;
+				result[j+int64_t(i)*m]=v;
+		}
 
-			if (verbose)
-			{
-				total++;
+		if (verbose)
+		{
+			total+=n-j_start;
 
-				if (symmetric && i!=j)
-					total++;
+			if (symmetric)
+				total+=n-j_start-1;
 
-				if (total%100 == 0)
-					SG_OBJ_PROGRESS(k, total, total_start, total_end)
+			SG_OBJ_PROGRESS(k, total, total_start, total_end)
 
-				if (CSignal::cancel_computations())
-					break;
-			}
+			if (CSignal::cancel_computations())
+				break;
 		}
-
 	}
 
 	return NULL;
@@ -1360,7 +1447,9 @@ SGMatrix<T> CKernel::get_kernel_matrix()
 	result=SG_MALLOC(T, total_num);
 
 	int32_t num_threads=parallel->get_num_threads();
-	if (num_threads < 2)
+	if (compute_normalized_matrix(result, m, n))
+		SG_DEBUG("computed kernel matrix at once\n")
+	else if (num_threads < 2)
 	{
 		K_THREAD_PARAM<T> params;
 		params.kernel=this;
@@ -213,6 +213,20 @@ class CKernel : public CSGObject
 			return normalizer->normalize(compute(idx_a, idx_b), idx_a, idx_b);
 		}
 
+		/** get kernel function for lhs feature vector a and the rhs
+		 * feature vectors b[0], ..., b[num-1]
+		 *
+		 * computed at once, which is faster than calling kernel() for
+		 * every vector for some kernels and features (see compute_row())
+		 *
+		 * @param idx_a index of feature vector a
+		 * @param idx_b indices of rhs feature vectors
+		 * @param num number of rhs feature vectors
+		 * @param result kernel values (output, length num)
+		 */
+		void kernel_row(int32_t idx_a, const int32_t* idx_b, int32_t num,
+				float64_t* result);
+
 		/** get kernel matrix
 		 *
 		 * @return computed kernel matrix (needs to be cleaned up)
@@ -280,9 +294,10 @@ class CKernel : public CSGObject
 		virtual SGVector<float64_t> get_kernel_row(int32_t i)
 		{
 			SGVector<float64_t> row = SGVector<float64_t>(num_lhs);
+			SGVector<int32_t> idx = SGVector<int32_t>(num_lhs);
+			idx.range_fill();
 
-			for (int32_t j=0; j!=num_lhs; j++)
-				row[j] = kernel(i,j);
+			kernel_row(i, idx.vector, num_lhs, row.vector);
 
 			return row;
 		}
@@ -911,6 +926,34 @@ class CKernel : public CSGObject
 		 */
 		virtual float64_t compute(int32_t x, int32_t y)=0;
 
+		/** compute kernel function between lhs vector idx_a and the rhs
+		 * vectors idx_b[0], ..., idx_b[num-1]
+		 *
+		 * used for computing kernel matrices and rows for the kernel
+		 * cache. Calls compute() for every pair, override this if many
+		 * kernel values with the same left hand side vector can be
+		 * computed faster at once (e.g. for sparse features).
+		 *
+		 * @param idx_a index of lhs vector
+		 * @param idx_b indices of rhs vectors
+		 * @param num number of rhs vectors
+		 * @param result kernel values (output, length num)
+		 */
+		virtual void compute_row(int32_t idx_a, const int32_t* idx_b,
+				int32_t num, float64_t* result);
+
+		/** compute the whole unnormalized kernel matrix at once
+		 *
+		 * Can be overridden if this is faster than computing it row by row,
+		 * e.g. by a sparse matrix product.
+		 *
+		 * @param result kernel matrix to fill (output, num_vec_lhs x
+		 * num_vec_rhs)
+		 * @return whether the matrix was computed, false if not
+		 * supported for the current features
+		 */
+		virtual bool compute_matrix(SGMatrix<float64_t> result) { return false; }
+
 		/** compute row start offset for parallel kernel matrix computation
 		 *
 		 * @param offs offset
@@ -935,6 +978,24 @@ class CKernel : public CSGObject
 		 */
 		template <class T> static void* get_kernel_matrix_helper(void* p);
 
+		/** compute the normalized kernel matrix via compute_matrix()
+		 *
+		 * @param result kernel matrix (output, m x n)
+		 * @param m number of lhs vectors
+		 * @param n number of rhs vectors
+		 * @return whether the matrix was computed
+		 */
+		bool compute_normalized_matrix(float64_t* result, int32_t m, int32_t n);
+
+		/** single precision kernel matrices are always computed row by row
+		 *
+		 * @return false
+		 */
+		bool compute_normalized_matrix(float32_t* result, int32_t m, int32_t n)
+		{
+			return false;
+		}
+
 		/** Can (optionally) be overridden to post-initialize some member
 		 *  variables which are not PARAMETER::ADD'ed.  Make sure that at
 		 *  first the overridden method BASE_CLASS::LOAD_SERIALIZABLE_POST
@@ -1032,6 +1093,18 @@ class CKernel : public CSGObject
 		};
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
+		/** compute the kernel values of row m not taken from other cached
+		 * rows and store them in its cache
+		 *
+		 * @param m row
+		 * @param cache cache of row m
+		 * @param pos positions in the cache to fill
+		 * @param idx rhs vectors at these positions
+		 * @param num number of positions
+		 */
+		void fill_cache_row(int32_t m, KERNELCACHE_ELEM* cache,
+				const int32_t* pos, const int32_t* idx, int32_t num);
+
 		//@{
 		static void* cache_multiple_kernel_row_helper(void* p);
 
@@ -89,6 +89,17 @@ bool CLinearKernel::delete_optimization()
 	return true;
 }
 
+void CLinearKernel::compute_row(int32_t idx_a, const int32_t* idx_b,
+		int32_t num, float64_t* result)
+{
+	compute_dot_row(idx_a, idx_b, num, result);
+}
+
+bool CLinearKernel::compute_matrix(SGMatrix<float64_t> result)
+{
+	return compute_dot_matrix(result);
+}
+
 float64_t CLinearKernel::compute_optimized(int32_t idx)
 {
 	ASSERT(get_is_initialized())
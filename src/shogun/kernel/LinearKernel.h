@@ -134,6 +134,27 @@ class CLinearKernel: public CDotKernel
 			this->normal = w;
 		}
 
+	protected:
+		/** compute kernel function between lhs vector idx_a and the rhs
+		 * vectors idx_b[0], ..., idx_b[num-1], see
+		 * CDotFeatures::dot_subset()
+		 *
+		 * @param idx_a index of lhs vector
+		 * @param idx_b indices of rhs vectors
+		 * @param num number of rhs vectors
+		 * @param result kernel values (output, length num)
+		 */
+		virtual void compute_row(int32_t idx_a, const int32_t* idx_b,
+				int32_t num, float64_t* result);
+
+		/** compute the whole kernel matrix at once, supported for sparse
+		 * real valued features, see CDotKernel::compute_dot_matrix()
+		 *
+		 * @param result kernel matrix (output)
+		 * @return whether the matrix was computed
+		 */
+		virtual bool compute_matrix(SGMatrix<float64_t> result);
+
 	protected:
 		/** normal vector (used in case of optimized kernel) */
 		SGVector<float64_t> normal;
@@ -12,6 +12,7 @@
 #include <shogun/lib/config.h>
 #include <shogun/lib/common.h>
 #include <shogun/io/SGIO.h>
+#include <shogun/base/Parallel.h>
 #include <shogun/kernel/PolyKernel.h>
 #include <shogun/kernel/normalizer/SqrtDiagKernelNormalizer.h>
 #include <shogun/features/DotFeatures.h>
@@ -65,6 +66,31 @@ float64_t CPolyKernel::compute(int32_t idx_a, int32_t idx_b)
 	return CMath::pow(result, degree);
 }
 
+void CPolyKernel::compute_row(int32_t idx_a, const int32_t* idx_b,
+		int32_t num, float64_t* result)
+{
+	compute_dot_row(idx_a, idx_b, num, result);
+
+	for (int32_t i=0; i<num; i++)
+		result[i]=CMath::pow(inhomogene ? result[i]+1 : result[i], degree);
+}
+
+bool CPolyKernel::compute_matrix(SGMatrix<float64_t> result)
+{
+	if (!compute_dot_matrix(result))
+		return false;
+
+	int64_t num=int64_t(result.num_rows)*result.num_cols;
+#pragma omp parallel for num_threads(parallel->get_num_threads())
+	for (int64_t i=0; i<num; i++)
+	{
+		result.matrix[i]=CMath::pow(inhomogene ? result.matrix[i]+1 :
+				result.matrix[i], degree);
+	}
+
+	return true;
+}
+
 void CPolyKernel::init()
 {
 	set_normalizer(new CSqrtDiagKernelNormalizer());
@@ -18,21 +18,41 @@ SGSparseMatrix<T>::SGSparseMatrix(SGSparseVector<T>* vecs, index_t num_feat,
 		index_t num_vec, bool ref_counting) :
 	SGReferencedData(ref_counting),
 	num_vectors(num_vec), num_features(num_feat),
-	sparse_matrix(vecs)
+	sparse_matrix(vecs), entries(NULL)
 {
 }
 
 template <class T>
 SGSparseMatrix<T>::SGSparseMatrix(index_t num_feat, index_t num_vec, bool ref_counting) :
 	SGReferencedData(ref_counting),
-	num_vectors(num_vec), num_features(num_feat)
+	num_vectors(num_vec), num_features(num_feat), entries(NULL)
 {
 	sparse_matrix=SG_MALLOC(SGSparseVector<T>, num_vectors);
 }
 
+template <class T>
+SGSparseMatrix<T>::SGSparseMatrix(index_t num_feat,
+		SGVector<index_t> num_feat_entries) :
+	SGReferencedData(),
+	num_vectors(num_feat_entries.vlen), num_features(num_feat)
+{
+	init_contiguous(num_feat_entries);
+}
+
+template <class T>
+SGSparseMatrix<T>::SGSparseMatrix(SGSparseVectorEntry<T>* feats,
+		SGVector<int64_t> offsets, index_t num_feat) :
+	SGReferencedData(),
+	num_vectors(offsets.vlen-1), num_features(num_feat), entries(feats)
+{
+	REQUIRE(offsets.vlen>0, "Offsets of at least one vector end required\n");
+	init_vectors(offsets);
+}
+
 template <class T>
 SGSparseMatrix<T>::SGSparseMatrix(SGMatrix<T> dense) : SGReferencedData()
 {
+	init_data();
 	from_dense(dense);
 }
 
@@ -161,12 +181,14 @@ void SGSparseMatrix<T>::copy_data(const SGReferencedData& orig)
 	sparse_matrix = ((SGSparseMatrix*)(&orig))->sparse_matrix;
 	num_vectors = ((SGSparseMatrix*)(&orig))->num_vectors;
 	num_features = ((SGSparseMatrix*)(&orig))->num_features;
+	entries = ((SGSparseMatrix*)(&orig))->entries;
 }
 
 template <class T>
 void SGSparseMatrix<T>::init_data()
 {
 	sparse_matrix = NULL;
+	entries = NULL;
 	num_vectors = 0;
 	num_features = 0;
 }
@@ -174,16 +196,46 @@ void SGSparseMatrix<T>::init_data()
 template <class T>
 void SGSparseMatrix<T>::free_data()
 {
+	// the vectors free the contiguous block once none of them is left
 	SG_FREE(sparse_matrix);
+	entries = NULL;
 	num_vectors = 0;
 	num_features = 0;
 }
 
-template<class T> SGSparseMatrix<T> SGSparseMatrix<T>::get_transposed()
+template <class T>
+void SGSparseMatrix<T>::init_contiguous(SGVector<index_t> num_feat_entries)
+{
+	REQUIRE(num_feat_entries.vlen==num_vectors,
+		"Number of entries of %d vectors given, %d vectors expected\n",
+		num_feat_entries.vlen, num_vectors);
+
+	SGVector<int64_t> offsets(num_vectors+1);
+	offsets[0]=0;
+	for (index_t i=0; i<num_vectors; i++)
+		offsets[i+1]=offsets[i]+num_feat_entries[i];
+
+	entries=SG_MALLOC(SGSparseVectorEntry<T>, offsets[num_vectors]);
+	init_vectors(offsets);
+}
+
+template <class T>
+void SGSparseMatrix<T>::init_vectors(SGVector<int64_t> offsets)
 {
-	SGSparseMatrix<T> sfm(num_vectors, num_features);
+	// the vectors are views sharing the reference count of the block
+	SGSparseVector<T> block(entries, offsets[num_vectors]);
+	sparse_matrix=SG_MALLOC(SGSparseVector<T>, num_vectors);
+	for (index_t i=0; i<num_vectors; i++)
+	{
+		sparse_matrix[i]=SGSparseVector<T>(entries+offsets[i],
+			offsets[i+1]-offsets[i], block);
+	}
+}
 
-	int32_t* hist=SG_CALLOC(int32_t, num_features);
+template<class T> SGSparseMatrix<T> SGSparseMatrix<T>::get_transposed()
+{
+	SGVector<index_t> hist(num_features);
+	hist.zero();
 
 	// count the lengths of future feature vectors
 	for (int32_t v=0; v<num_vectors; v++)
@@ -194,10 +246,7 @@ template<class T> SGSparseMatrix<T> SGSparseMatrix<T>::get_transposed()
 			hist[sv.features[i].feat_index]++;
 	}
 
-	for (int32_t v=0; v<num_features; v++)
-		sfm[v]=SGSparseVector<T>(hist[v]);
-
-	SG_FREE(hist);
+	SGSparseMatrix<T> sfm(num_vectors, hist);
 
 	int32_t* index=SG_CALLOC(int32_t, num_features);
 
@@ -238,7 +287,7 @@ template<class T> void SGSparseMatrix<T>::from_dense(SGMatrix<T> full)
 	REQUIRE(num_vec>0, "Matrix should have > 0 vectors!\n");
 
 	SG_SINFO("converting dense feature matrix to sparse one\n")
-		int32_t* num_feat_entries=SG_MALLOC(int, num_vec);
+	SGVector<index_t> num_feat_entries(num_vec);
 
 
 	int64_t num_total_entries=0;
@@ -256,11 +305,10 @@ template<class T> void SGSparseMatrix<T>::from_dense(SGMatrix<T> full)
 
 	num_features=num_feat;
 	num_vectors=num_vec;
-	sparse_matrix=SG_MALLOC(SGSparseVector<T>,num_vec);
+	init_contiguous(num_feat_entries);
 
 	for (int32_t i=0; i< num_vec; i++)
 	{
-		sparse_matrix[i]=SGSparseVector<T>(num_feat_entries[i]);
 		int32_t sparse_feat_idx=0;
 
 		for (int32_t j=0; j< num_feat; j++)
@@ -279,7 +327,6 @@ template<class T> void SGSparseMatrix<T>::from_dense(SGMatrix<T> full)
 
 	SG_SINFO("sparse feature matrix has %ld entries (full matrix had %ld, sparsity %2.2f%%)\n",
 			num_total_entries, int64_t(num_feat)*num_vec, (100.0*num_total_entries)/(int64_t(num_feat)*num_vec));
-	SG_FREE(num_feat_entries);
 }
 
 template class SGSparseMatrix<bool>;
@@ -29,7 +29,16 @@ template<class T> class SGMatrix;
 class CFile;
 class CLibSVMFile;
 
-/** @brief template class SGSparseMatrix */
+/** @brief template class SGSparseMatrix
+ *
+ * The matrix is an array of sparse vectors. Matrices created by
+ * get_transposed(), from_dense(), the constructor taking the number of
+ * entries per vector or SGSparseMatrixBuilder store the entries of all
+ * vectors in one contiguous block of memory (compressed sparse row layout);
+ * their sparse vectors then point into this block and share its reference
+ * count, so vectors taken from the matrix stay valid after the matrix is
+ * gone, just like separately allocated ones.
+ */
 template <class T> class SGSparseMatrix : public SGReferencedData
 {
 	public:
@@ -43,6 +52,25 @@ template <class T> class SGSparseMatrix : public SGReferencedData
 		/** constructor to create new matrix in memory */
 		SGSparseMatrix(index_t num_feat, index_t num_vec, bool ref_counting=true);
 
+		/** constructor to create new matrix in memory whose vectors store
+		 * their entries in one contiguous block
+		 *
+		 * @param num_feat number of features
+		 * @param num_feat_entries number of entries of each vector
+		 */
+		SGSparseMatrix(index_t num_feat, SGVector<index_t> num_feat_entries);
+
+		/** constructor for a matrix in compressed sparse row layout
+		 *
+		 * @param feats entries of all vectors one after another, allocated
+		 * with SG_MALLOC; the matrix takes ownership of them
+		 * @param offsets offsets of the vectors into feats, i.e. vector i
+		 * consists of entries offsets[i] to offsets[i+1]-1
+		 * @param num_feat number of features
+		 */
+		SGSparseMatrix(SGSparseVectorEntry<T>* feats, SGVector<int64_t> offsets,
+				index_t num_feat);
+
 		/** constructor to create new sparse matrix from a dense one
 		 *
 		 * @param dense dense matrix to be converted
@@ -138,12 +166,18 @@ template <class T> class SGSparseMatrix : public SGReferencedData
 				if (i_row==sparse_matrix[i_col].features[i].feat_index)
 					return sparse_matrix[i_col].features[i].entry;
 			}
+			// the vector may point into the contiguous block, so it is
+			// copied instead of reallocated
 			index_t j=sparse_matrix[i_col].num_feat_entries;
-			sparse_matrix[i_col].num_feat_entries=j+1;
-			sparse_matrix[i_col].features=SG_REALLOC(SGSparseVectorEntry<T>,
-				sparse_matrix[i_col].features, j, j+1);
-			sparse_matrix[i_col].features[j].feat_index=i_row;
-			sparse_matrix[i_col].features[j].entry=static_cast<T>(0);
+			SGSparseVector<T> vec(j+1);
+			if (j>0)
+			{
+				memcpy(vec.features, sparse_matrix[i_col].features,
+					sizeof(SGSparseVectorEntry<T>)*j);
+			}
+			vec.features[j].feat_index=i_row;
+			vec.features[j].entry=static_cast<T>(0);
+			sparse_matrix[i_col]=vec;
 			return sparse_matrix[i_col].features[j].entry;
 		}
 
@@ -175,10 +209,12 @@ template <class T> class SGSparseMatrix : public SGReferencedData
 		 */
 		void save_with_labels(CLibSVMFile* saver, SGVector<float64_t> labels);
 
-		/** return the transposed of the sparse matrix */
+		/** return the transposed of the sparse matrix, its vectors are
+		 * stored contiguously */
 		SGSparseMatrix<T> get_transposed();
 
-		/** create a sparse matrix from a dense one
+		/** create a sparse matrix from a dense one, the vectors are stored
+		 * contiguously
 		 *
 		 * @param full the dense matrix to create the sparse one from
 		 */
@@ -198,6 +234,20 @@ protected:
 		/** free data */
 		virtual void free_data();
 
+		/** allocate the sparse vectors and a contiguous block for their
+		 * entries, num_vectors has to be set before
+		 *
+		 * @param num_feat_entries number of entries of each vector
+		 */
+		void init_contiguous(SGVector<index_t> num_feat_entries);
+
+		/** let the sparse vectors point into the contiguous block of entries
+		 * and share its reference count, num_vectors has to be set before
+		 *
+		 * @param offsets offsets of the vectors into entries
+		 */
+		void init_vectors(SGVector<int64_t> offsets);
+
 public:
 
 	/// total number of vectors
@@ -209,6 +259,10 @@ public:
 	/// array of sparse vectors of size num_vectors
 	SGSparseVector<T>* sparse_matrix;
 
+	/// block holding the entries of all vectors if they are stored
+	/// contiguously, NULL otherwise. Owned by the vectors pointing into it
+	SGSparseVectorEntry<T>* entries;
+
 };
 }
 #endif // __SGSPARSEMATRIX_H__
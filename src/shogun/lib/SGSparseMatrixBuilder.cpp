@@ -0,0 +1,133 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/lib/SGSparseMatrixBuilder.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/io/SGIO.h>
+
+#include <limits.h>
+
+/* initial number of entries and vectors memory is allocated for */
+#define INITIAL_CAPACITY 1024
+
+namespace shogun
+{
+
+template <class T>
+SGSparseMatrixBuilder<T>::SGSparseMatrixBuilder(index_t num_feat,
+		int64_t num_entries_hint) : num_features(num_feat)
+{
+	REQUIRE(num_feat>=0, "Number of features (%d) must not be negative\n",
+		num_feat);
+
+	init(num_entries_hint);
+}
+
+template <class T>
+SGSparseMatrixBuilder<T>::~SGSparseMatrixBuilder()
+{
+	SG_FREE(entries);
+	SG_FREE(offsets);
+}
+
+template <class T>
+void SGSparseMatrixBuilder<T>::init(int64_t num_entries_hint)
+{
+	num_entries=0;
+	entries_capacity=CMath::max(num_entries_hint, (int64_t) INITIAL_CAPACITY);
+	entries=SG_MALLOC(SGSparseVectorEntry<T>, entries_capacity);
+
+	num_vectors=0;
+	offsets_capacity=INITIAL_CAPACITY;
+	offsets=SG_MALLOC(int64_t, offsets_capacity);
+	offsets[0]=0;
+}
+
+template <class T>
+void SGSparseMatrixBuilder<T>::add_entry(index_t feat_index, T entry)
+{
+	REQUIRE(feat_index>=0, "Feature index (%d) must not be negative\n",
+		feat_index);
+
+	if (num_entries==entries_capacity)
+	{
+		entries=SG_REALLOC(SGSparseVectorEntry<T>, entries, entries_capacity,
+			2*entries_capacity);
+		entries_capacity*=2;
+	}
+
+	entries[num_entries].feat_index=feat_index;
+	entries[num_entries].entry=entry;
+	num_entries++;
+
+	if (feat_index>=num_features)
+		num_features=feat_index+1;
+}
+
+template <class T>
+void SGSparseMatrixBuilder<T>::finish_vector()
+{
+	REQUIRE(num_entries-offsets[num_vectors]<=INT_MAX,
+		"Vector %d has more than %d entries\n", num_vectors,
+		INT_MAX);
+
+	// one offset more than vectors is needed for the end of the last one
+	if (num_vectors+1==offsets_capacity)
+	{
+		offsets=SG_REALLOC(int64_t, offsets, offsets_capacity,
+			2*offsets_capacity);
+		offsets_capacity*=2;
+	}
+
+	num_vectors++;
+	offsets[num_vectors]=num_entries;
+}
+
+template <class T>
+void SGSparseMatrixBuilder<T>::add_vector(const SGSparseVector<T>& vec)
+{
+	for (index_t i=0; i<vec.num_feat_entries; i++)
+		add_entry(vec.features[i].feat_index, vec.features[i].entry);
+
+	finish_vector();
+}
+
+template <class T>
+SGSparseMatrix<T> SGSparseMatrixBuilder<T>::get_matrix()
+{
+	REQUIRE(num_entries==offsets[num_vectors],
+		"The last vector is not finished, call finish_vector() first\n");
+
+	// release the unused part of the block
+	SGSparseVectorEntry<T>* block=NULL;
+	if (num_entries>0)
+		block=SG_REALLOC(SGSparseVectorEntry<T>, entries, entries_capacity, num_entries);
+	else
+		SG_FREE(entries);
+
+	SGSparseMatrix<T> matrix(block,
+		SGVector<int64_t>(offsets, num_vectors+1), num_features);
+
+	init(0);
+	return matrix;
+}
+
+template class SGSparseMatrixBuilder<bool>;
+template class SGSparseMatrixBuilder<char>;
+template class SGSparseMatrixBuilder<int8_t>;
+template class SGSparseMatrixBuilder<uint8_t>;
+template class SGSparseMatrixBuilder<int16_t>;
+template class SGSparseMatrixBuilder<uint16_t>;
+template class SGSparseMatrixBuilder<int32_t>;
+template class SGSparseMatrixBuilder<uint32_t>;
+template class SGSparseMatrixBuilder<int64_t>;
+template class SGSparseMatrixBuilder<uint64_t>;
+template class SGSparseMatrixBuilder<float32_t>;
+template class SGSparseMatrixBuilder<float64_t>;
+template class SGSparseMatrixBuilder<floatmax_t>;
+template class SGSparseMatrixBuilder<complex128_t>;
+}
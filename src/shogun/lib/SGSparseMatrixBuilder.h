@@ -0,0 +1,111 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef __SGSPARSEMATRIXBUILDER_H__
+#define __SGSPARSEMATRIXBUILDER_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/lib/common.h>
+#include <shogun/lib/SGSparseMatrix.h>
+#include <shogun/lib/SGSparseVector.h>
+
+namespace shogun
+{
+
+/** @brief Builds a sparse matrix vector by vector, e.g. while reading it
+ * from a stream, without allocating memory for every vector.
+ *
+ * The entries of all vectors are appended to one block of memory which
+ * grows geometrically, so building a matrix of n entries takes O(log n)
+ * reallocations. get_matrix() hands this block to an SGSparseMatrix whose
+ * vectors point into it (compressed sparse row layout).
+ *
+ * Entries of a vector are added with add_entry() and the vector is completed
+ * with finish_vector(). As for SGSparseVector, the entries of a vector have
+ * to be added in ascending order of their feature index.
+ */
+template <class T> class SGSparseMatrixBuilder
+{
+	public:
+		/** constructor
+		 *
+		 * @param num_feat number of features, the largest feature index
+		 * added plus one is used if it is larger
+		 * @param num_entries_hint expected number of entries, to reserve
+		 * memory for them
+		 */
+		SGSparseMatrixBuilder(index_t num_feat=0, int64_t num_entries_hint=0);
+
+		/** destructor */
+		~SGSparseMatrixBuilder();
+
+		/** add an entry to the current vector
+		 *
+		 * @param feat_index feature index
+		 * @param entry value
+		 */
+		void add_entry(index_t feat_index, T entry);
+
+		/** complete the current vector, entries added afterwards belong to
+		 * the next one
+		 */
+		void finish_vector();
+
+		/** add all entries of a sparse vector as a new vector
+		 *
+		 * @param vec sparse vector
+		 */
+		void add_vector(const SGSparseVector<T>& vec);
+
+		/** @return number of completed vectors */
+		index_t get_num_vectors() const { return num_vectors; }
+
+		/** @return number of entries added */
+		int64_t get_num_entries() const { return num_entries; }
+
+		/** get the built matrix, the builder is empty afterwards
+		 *
+		 * @return sparse matrix of the completed vectors
+		 */
+		SGSparseMatrix<T> get_matrix();
+
+	private:
+		/** not copyable */
+		SGSparseMatrixBuilder(const SGSparseMatrixBuilder& orig);
+
+		/** not copyable */
+		SGSparseMatrixBuilder& operator=(const SGSparseMatrixBuilder& orig);
+
+		/** allocate the initial buffers */
+		void init(int64_t num_entries_hint);
+
+	private:
+		/// entries of all vectors
+		SGSparseVectorEntry<T>* entries;
+
+		/// number of entries
+		int64_t num_entries;
+
+		/// number of entries memory is allocated for
+		int64_t entries_capacity;
+
+		/// offsets of the vectors into entries, the last one is the start of
+		/// the current vector
+		int64_t* offsets;
+
+		/// number of completed vectors
+		index_t num_vectors;
+
+		/// number of offsets memory is allocated for
+		index_t offsets_capacity;
+
+		/// number of features
+		index_t num_features;
+};
+}
+#endif // __SGSPARSEMATRIXBUILDER_H__
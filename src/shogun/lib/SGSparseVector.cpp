@@ -29,18 +29,27 @@ template <class T>
 SGSparseVector<T>::SGSparseVector(SGSparseVectorEntry<T> * feats, index_t num_entries,
                                   bool ref_counting) :
 	SGReferencedData(ref_counting),
-	num_feat_entries(num_entries), features(feats)
+	num_feat_entries(num_entries), features(feats), m_block(NULL)
 {
 }
 
 template <class T>
 SGSparseVector<T>::SGSparseVector(index_t num_entries, bool ref_counting) :
 	SGReferencedData(ref_counting),
-	num_feat_entries(num_entries)
+	num_feat_entries(num_entries), m_block(NULL)
 {
 	features = SG_MALLOC(SGSparseVectorEntry<T>, num_feat_entries);
 }
 
+template <class T>
+SGSparseVector<T>::SGSparseVector(SGSparseVectorEntry<T>* feats, index_t num_entries,
+		const SGSparseVector<T>& block) :
+	SGReferencedData(block),
+	num_feat_entries(num_entries), features(feats)
+{
+	m_block = block.m_block ? block.m_block : block.features;
+}
+
 template <class T>
 SGSparseVector<T>::SGSparseVector(const SGSparseVector &orig) :
 	SGReferencedData(orig)
@@ -250,8 +259,8 @@ void SGSparseVector<T>::sort_features(bool stable_pointer)
 	int32_t new_feat_count = last_index + 1;
 	ASSERT(new_feat_count <= num_feat_entries);
 
-	// shrinking vector
-	if (!stable_pointer)
+	// shrinking vector, views into a block of entries cannot be shrunk
+	if (!stable_pointer && !m_block)
 	{
 		SG_SINFO("shrinking vector from %d to %d\n", num_feat_entries, new_feat_count);
 		features = SG_REALLOC(SGSparseVectorEntry<T>, features, num_feat_entries, new_feat_count);
@@ -394,6 +403,7 @@ void SGSparseVector<T>::copy_data(const SGReferencedData &orig)
 {
 	num_feat_entries = ((SGSparseVector *)(&orig))->num_feat_entries;
 	features = ((SGSparseVector *)(&orig))->features;
+	m_block = ((SGSparseVector *)(&orig))->m_block;
 }
 
 template <class T>
@@ -401,13 +411,19 @@ void SGSparseVector<T>::init_data()
 {
 	num_feat_entries = 0;
 	features = NULL;
+	m_block = NULL;
 }
 
 template <class T>
 void SGSparseVector<T>::free_data()
 {
 	num_feat_entries = 0;
-	SG_FREE(features);
+	// a view frees the whole block of entries once its last user is gone
+	if (m_block)
+		SG_FREE(m_block);
+	else
+		SG_FREE(features);
+	m_block = NULL;
 }
 
 template <class T>
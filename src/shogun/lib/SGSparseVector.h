@@ -55,6 +55,18 @@ public:
 	/** constructor to create new vector in memory */
 	SGSparseVector(index_t num_entries, bool ref_counting=true);
 
+	/** constructor for a view into the entries of another vector, e.g.
+	 * the block of entries of a sparse matrix. The view shares the
+	 * reference count of block, so the entries stay alive as long as
+	 * block or any of its views does.
+	 *
+	 * @param feats first entry of the view, within the entries of block
+	 * @param num_entries number of entries of the view
+	 * @param block vector holding the entries
+	 */
+	SGSparseVector(SGSparseVectorEntry<T>* feats, index_t num_entries,
+			const SGSparseVector<T>& block);
+
 	/** copy constructor */
 	SGSparseVector(const SGSparseVector& orig);
 
@@ -120,7 +132,7 @@ public:
 	 * sort features by indices  (Setting stable_pointer=true to
 	 * guarantee that pointer features does not change. On the
 	 * other hand, stable_pointer=false can shrink the vector if
-	 * possible.)
+	 * possible, which views into a block of entries never are.)
 	 *
 	 * @param stable_pointer (default false) enforce stable pointer
 	 */
@@ -214,6 +226,11 @@ public:
 	/** features */
 	SGSparseVectorEntry<T>* features;
 
+protected:
+	/** start of the block of entries features points into if this is a
+	 * view, NULL if features is an allocation of its own */
+	SGSparseVectorEntry<T>* m_block;
+
 };
 
 }
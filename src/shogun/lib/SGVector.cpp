@@ -22,6 +22,7 @@
 
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/lapack.h>
+#include <shogun/mathematics/simd/SIMD.h>
 #include <algorithm>
 
 #include <shogun/mathematics/eigen3.h>
@@ -527,8 +528,7 @@ void SGVector<float64_t>::vec1_plus_scalar_times_vec2(float64_t* vec1,
 	int32_t skip=1;
 	cblas_daxpy(n, scalar, vec2, skip, vec1, skip);
 #else
-	for (int32_t i=0; i<n; i++)
-		vec1[i]+=scalar*vec2[i];
+	simd::axpy(scalar, vec2, vec1, n);
 #endif
 }
 
@@ -253,15 +253,27 @@ public:
 		Qfloat* data=params->data;
 		const LibSVMKernel* q=params->q;
 
+		if (end<=start)
+			return NULL;
+
+		// the kernel values of the column are computed at once
+		SGVector<int32_t> idx(end-start);
+		SGVector<float64_t> values(end-start);
+		for(int32_t j=start;j<end;j++)
+			idx[j-start]=q->x[j]->index;
+
+		q->kernel->kernel_row(q->x[i]->index, idx.vector, idx.vlen,
+			values.vector);
+
 		if (y) // two class
 		{
 			for(int32_t j=start;j<end;j++)
-				data[j] = (Qfloat) y[i]*y[j]*q->kernel_function(i,j);
+				data[j] = (Qfloat) y[i]*y[j]*values[j-start];
 		}
 		else // one class, eps svr
 		{
 			for(int32_t j=start;j<end;j++)
-				data[j] = (Qfloat) q->kernel_function(i,j);
+				data[j] = (Qfloat) values[j-start];
 		}
 
 		return NULL;
@@ -295,8 +307,8 @@ public:
 			for (t=0; t<num_threads; t++)
 			{
 				params[t].i=i;
-				params[t].start=t*step;
-				params[t].end=(t+1)*step;
+				params[t].start=start+t*step;
+				params[t].end=start+(t+1)*step;
 				params[t].y=lab;
 				params[t].data=data;
 				params[t].q=this;
@@ -314,7 +326,7 @@ public:
 			}
 
 			params[t].i=i;
-			params[t].start=t*step;
+			params[t].start=start+t*step;
 			params[t].end=len;
 			params[t].y=lab;
 			params[t].data=data;
@@ -8,6 +8,7 @@
 
 /* Tapkee includes */
 #include <shogun/lib/tapkee/defines/types.hpp>
+#include <shogun/lib/tapkee/defines/synonyms.hpp>
 /* End of Tapkee includes */
 
 namespace tapkee
@@ -411,6 +412,23 @@ namespace tapkee
 			 */
 			const ParameterKeyword<ScalarType> squishing_rate("squishing rate", 0.99);
 
+			/** The keyword for the value that stores neighbors computed
+			 * before embedding, e.g. by a faster or approximate search.
+			 * If set, the neighbors are not searched with
+			 * @ref tapkee::keywords::neighbors_method.
+			 *
+			 * Used by the same methods as
+			 * @ref tapkee::keywords::check_connectivity.
+			 *
+			 * Default is empty, i.e. neighbors are searched.
+			 *
+			 * The corresponding value should have type
+			 * @ref tapkee::tapkee_internal::Neighbors with the neighbors
+			 * of every vector.
+			 */
+			const ParameterKeyword<tapkee_internal::Neighbors>
+				precomputed_neighbors("precomputed neighbors", tapkee_internal::Neighbors());
+
 			/** The default value - assigning any keyword to this
 			 * static struct produces a parameter with its default value.
 			 */
@@ -129,7 +129,13 @@ namespace tapkee
 		Randomized,
 		//! Eigen library dense method (could be useful for debugging). Computes
 		//! all eigenvectors thus can be very slow doing large-scale.
-		Dense
+		Dense,
+		//! Thick-restart Lanczos method. Only needs products with the
+		//! matrix (or solutions of linear systems to get the smallest
+		//! eigenvalues) and keeps a few dozens of vectors, so memory is
+		//! linear in the number of vectors. Supports only standard
+		//! but not generalized eigenproblems.
+		Lanczos
 	};
 #ifdef TAPKEE_WITH_ARPACK
 	static EigenMethod default_eigen_method = Arpack;
@@ -140,13 +140,14 @@ public:
 				if(exact) computeExactGradient(P, Y, N, no_dims, dY);
 				else computeGradient(P, row_P, col_P, val_P, Y, N, no_dims, dY, theta);
 
-				// Update gains
-				for(int i = 0; i < N * no_dims; i++) gains[i] = (sign(dY[i]) != sign(uY[i])) ? (gains[i] + .2) : (gains[i] * .8);
-				for(int i = 0; i < N * no_dims; i++) if(gains[i] < .01) gains[i] = .01;
-
-				// Perform gradient update (with momentum and gains)
-				for(int i = 0; i < N * no_dims; i++) uY[i] = momentum * uY[i] - eta * gains[i] * dY[i];
-				for(int i = 0; i < N * no_dims; i++)  Y[i] = Y[i] + uY[i];
+				// Update gains and perform gradient update (with momentum and gains)
+#pragma omp parallel for
+				for(int i = 0; i < N * no_dims; i++) {
+					gains[i] = (sign(dY[i]) != sign(uY[i])) ? (gains[i] + .2) : (gains[i] * .8);
+					if(gains[i] < .01) gains[i] = .01;
+					uY[i] = momentum * uY[i] - eta * gains[i] * dY[i];
+					Y[i] = Y[i] + uY[i];
+				}
 
 				// Make solution zero-mean
 				zeroMean(Y, N, no_dims);
@@ -286,20 +287,28 @@ private:
 		// Construct quadtree on current map
 		QuadTree* tree = new QuadTree(Y, N);
 
-		// Compute all terms required for t-SNE gradient
+		// Compute all terms required for t-SNE gradient, the forces of
+		// every point are computed independently
 		double sum_Q = .0;
 		double* pos_f = (double*) calloc(N * D, sizeof(double));
 		double* neg_f = (double*) calloc(N * D, sizeof(double));
-		if(pos_f == NULL || neg_f == NULL) { printf("Memory allocation failed!\n"); exit(1); }
+		double* point_Q = (double*) calloc(N, sizeof(double));
+		if(pos_f == NULL || neg_f == NULL || point_Q == NULL) { printf("Memory allocation failed!\n"); exit(1); }
 		tree->computeEdgeForces(inp_row_P, inp_col_P, inp_val_P, N, pos_f);
-		for(int n = 0; n < N; n++) tree->computeNonEdgeForces(n, theta, neg_f + n * D, &sum_Q);
+#pragma omp parallel for schedule(dynamic, 256)
+		for(int n = 0; n < N; n++) tree->computeNonEdgeForces(n, theta, neg_f + n * D, point_Q + n);
+
+		// Sum in fixed order so that the result does not depend on the number of threads
+		for(int n = 0; n < N; n++) sum_Q += point_Q[n];
 
 		// Compute final t-SNE gradient
+#pragma omp parallel for
 		for(int i = 0; i < N * D; i++) {
 			dC[i] = pos_f[i] - (neg_f[i] / sum_Q);
 		}
 		free(pos_f);
 		free(neg_f);
+		free(point_Q);
 		delete tree;
 	}
 
@@ -315,18 +324,23 @@ private:
 
 		// Compute Q-matrix and normalization sum
 		double* Q    = (double*) malloc(N * N * sizeof(double));
-		if(Q == NULL) { printf("Memory allocation failed!\n"); exit(1); }
+		double* row_Q = (double*) calloc(N, sizeof(double));
+		if(Q == NULL || row_Q == NULL) { printf("Memory allocation failed!\n"); exit(1); }
 		double sum_Q = .0;
+#pragma omp parallel for
 		for(int n = 0; n < N; n++) {
 			for(int m = 0; m < N; m++) {
 				if(n != m) {
 					Q[n * N + m] = 1 / (1 + DD[n * N + m]);
-					sum_Q += Q[n * N + m];
+					row_Q[n] += Q[n * N + m];
 				}
 			}
 		}
+		for(int n = 0; n < N; n++) sum_Q += row_Q[n];
+		free(row_Q);
 
 		// Perform the computation of the gradient
+#pragma omp parallel for
 		for(int n = 0; n < N; n++) {
 			for(int m = 0; m < N; m++) {
 				if(n != m) {
@@ -435,7 +449,8 @@ private:
 		if(DD == NULL) { printf("Memory allocation failed!\n"); exit(1); }
 		computeSquaredEuclideanDistance(X, N, D, DD);
 
-		// Compute the Gaussian kernel row by row
+		// Compute the Gaussian kernel row by row, rows are independent
+#pragma omp parallel for
 		for(int n = 0; n < N; n++) {
 
 			// Initialize some variables
@@ -507,8 +522,6 @@ private:
 		int* row_P = *_row_P;
 		int* col_P = *_col_P;
 		double* val_P = *_val_P;
-		double* cur_P = (double*) malloc((N - 1) * sizeof(double));
-		if(cur_P == NULL) { printf("Memory allocation failed!\n"); exit(1); }
 		row_P[0] = 0;
 		for(int n = 0; n < N; n++) row_P[n + 1] = row_P[n] + K;
 
@@ -518,77 +531,79 @@ private:
 		for(int n = 0; n < N; n++) obj_X[n] = DataPoint(D, n, X + n * D);
 		tree->create(obj_X);
 
-		// Loop over all points to find nearest neighbors
-		//printf("Building tree...\n");
-		std::vector<DataPoint> indices;
-		std::vector<double> distances;
-		for(int n = 0; n < N; n++) {
-
-			//if(n % 10000 == 0) printf(" - point %d of %d\n", n, N);
-
-			// Find nearest neighbors
-			indices.clear();
-			distances.clear();
-			tree->search(obj_X[n], K + 1, &indices, &distances);
-
-			// Initialize some variables for binary search
-			bool found = false;
-			double beta = 1.0;
-			double min_beta = -DBL_MAX;
-			double max_beta =  DBL_MAX;
-			double tol = 1e-5;
-
-			// Iterate until we found a good perplexity
-			int iter = 0; double sum_P;
-			while(!found && iter < 200) {
-
-				// Compute Gaussian kernel row
-				for(int m = 0; m < K; m++) cur_P[m] = exp(-beta * distances[m + 1]);
-
-				// Compute entropy of current row
-				sum_P = DBL_MIN;
-				for(int m = 0; m < K; m++) sum_P += cur_P[m];
-				double H = .0;
-				for(int m = 0; m < K; m++) H += beta * (distances[m + 1] * cur_P[m]);
-				H = (H / sum_P) + log(sum_P);
-
-				// Evaluate whether the entropy is within the tolerance level
-				double Hdiff = H - log(perplexity);
-				if(Hdiff < tol && -Hdiff < tol) {
-					found = true;
-				}
-				else {
-					if(Hdiff > 0) {
-						min_beta = beta;
-						if(max_beta == DBL_MAX || max_beta == -DBL_MAX)
-							beta *= 2.0;
-						else
-							beta = (beta + max_beta) / 2.0;
+		// Loop over all points to find nearest neighbors and calibrate
+		// their bandwidths, points are independent
+#pragma omp parallel
+		{
+			std::vector<DataPoint> indices;
+			std::vector<double> distances;
+			double* cur_P = (double*) malloc(K * sizeof(double));
+			if(cur_P == NULL) { printf("Memory allocation failed!\n"); exit(1); }
+#pragma omp for schedule(dynamic, 64)
+			for(int n = 0; n < N; n++) {
+
+				// Find nearest neighbors
+				tree->search(obj_X[n], K + 1, &indices, &distances);
+
+				// Initialize some variables for binary search
+				bool found = false;
+				double beta = 1.0;
+				double min_beta = -DBL_MAX;
+				double max_beta =  DBL_MAX;
+				double tol = 1e-5;
+
+				// Iterate until we found a good perplexity
+				int iter = 0; double sum_P;
+				while(!found && iter < 200) {
+
+					// Compute Gaussian kernel row
+					for(int m = 0; m < K; m++) cur_P[m] = exp(-beta * distances[m + 1]);
+
+					// Compute entropy of current row
+					sum_P = DBL_MIN;
+					for(int m = 0; m < K; m++) sum_P += cur_P[m];
+					double H = .0;
+					for(int m = 0; m < K; m++) H += beta * (distances[m + 1] * cur_P[m]);
+					H = (H / sum_P) + log(sum_P);
+
+					// Evaluate whether the entropy is within the tolerance level
+					double Hdiff = H - log(perplexity);
+					if(Hdiff < tol && -Hdiff < tol) {
+						found = true;
 					}
 					else {
-						max_beta = beta;
-						if(min_beta == -DBL_MAX || min_beta == DBL_MAX)
-							beta /= 2.0;
-						else
-							beta = (beta + min_beta) / 2.0;
+						if(Hdiff > 0) {
+							min_beta = beta;
+							if(max_beta == DBL_MAX || max_beta == -DBL_MAX)
+								beta *= 2.0;
+							else
+								beta = (beta + max_beta) / 2.0;
+						}
+						else {
+							max_beta = beta;
+							if(min_beta == -DBL_MAX || min_beta == DBL_MAX)
+								beta /= 2.0;
+							else
+								beta = (beta + min_beta) / 2.0;
+						}
 					}
-				}
 
-				// Update iteration counter
-				iter++;
-			}
+					// Update iteration counter
+					iter++;
+				}
 
-			// Row-normalize current row of P and store in matrix
-			for(int m = 0; m < K; m++) cur_P[m] /= sum_P;
-			for(int m = 0; m < K; m++) {
-				col_P[row_P[n] + m] = indices[m + 1].index();
-				val_P[row_P[n] + m] = cur_P[m];
+				// Row-normalize current row of P and store in matrix
+				for(int m = 0; m < K; m++) cur_P[m] /= sum_P;
+				for(int m = 0; m < K; m++) {
+					col_P[row_P[n] + m] = indices[m + 1].index();
+					val_P[row_P[n] + m] = cur_P[m];
+				}
 			}
+			free(cur_P);
 		}
 
 		// Clean up memory
 		obj_X.clear();
-		free(cur_P);
 		delete tree;
 	}
 
@@ -755,6 +770,9 @@ private:
 		free(cur_P); cur_P = NULL;
 	}
 
+public:
+	// Compute the N x N matrix of squared Euclidean distances between the
+	// D-dimensional rows of X
 	void computeSquaredEuclideanDistance(double* X, int N, int D, double* DD)
 	{
 		double* dataSums = (double*) calloc(N, sizeof(double));
@@ -771,7 +789,7 @@ private:
 		}
 		Eigen::Map<Eigen::MatrixXd> DD_map(DD,N,N);
 		Eigen::Map<Eigen::MatrixXd> X_map(X,D,N);
-		DD_map.noalias() = -2.0*X_map.transpose()*X_map;
+		DD_map.noalias() += -2.0*X_map.transpose()*X_map;
 
 		//cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, N, N, D, -2.0, X, D, X, D, 1.0, DD, N);
 		free(dataSums); dataSums = NULL;
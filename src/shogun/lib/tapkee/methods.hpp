@@ -51,7 +51,7 @@ public:
 		kernel_distance(KernelDistance<RandomAccessIterator,KernelCallback>(kernel)),
 		begin(b), end(e),
 		eigen_method(), neighbors_method(), eigenshift(), traceshift(),
-		check_connectivity(), n_neighbors(), width(), timesteps(),
+		check_connectivity(), precomputed_neighbors(), n_neighbors(), width(), timesteps(),
 		ratio(), max_iteration(), tolerance(), n_updates(), perplexity(),
 		theta(), squishing_rate(), global_strategy(), epsilon(), target_dimension(),
 		n_vectors(0), current_dimension(0)
@@ -72,6 +72,7 @@ public:
 		eigen_method = parameters(keywords::eigen_method);
 		neighbors_method = parameters(keywords::neighbors_method);
 		check_connectivity = parameters(keywords::check_connectivity);
+		precomputed_neighbors = parameters(keywords::precomputed_neighbors);
 		width = parameters(keywords::gaussian_kernel_width).checked().positive();
 		timesteps = parameters(keywords::diffusion_map_timesteps).checked().positive();
 		eigenshift = parameters(keywords::nullspace_shift);
@@ -167,6 +168,7 @@ private:
 	Parameter eigenshift;
 	Parameter traceshift;
 	Parameter check_connectivity;
+	Parameter precomputed_neighbors;
 	Parameter n_neighbors;
 	Parameter width;
 	Parameter timesteps;
@@ -187,7 +189,15 @@ private:
 	template<class Distance>
 	Neighbors findNeighborsWith(Distance d)
 	{
-		return find_neighbors(neighbors_method,begin,end,d,n_neighbors,check_connectivity);
+		Neighbors neighbors = precomputed_neighbors;
+		if (neighbors.empty())
+			return find_neighbors(neighbors_method,begin,end,d,n_neighbors,check_connectivity);
+
+		if (neighbors.size() != static_cast<size_t>(n_vectors))
+			throw wrong_parameter_error("Number of vectors with precomputed neighbors differs from number of vectors to embed");
+		if (check_connectivity.is(true) && !is_connected(begin,end,neighbors))
+			LoggingSingleton::instance().message_warning("The neighborhood graph is not connected.");
+		return neighbors;
 	}
 
 	static tapkee::ProjectingFunction unimplementedProjectingFunction()
@@ -379,6 +389,11 @@ private:
 		Neighbors neighbors = findNeighborsWith(plain_distance);
 		Laplacian laplacian =
 			compute_laplacian(begin,end,neighbors,distance,width);
+		if (eigen_method.is(Lanczos))
+		{
+			return TapkeeOutput(normalized_laplacian_eigendecomposition(eigen_method,
+				laplacian,target_dimension,SkipOneEigenvalue).first, unimplementedProjectingFunction());
+		}
 		return TapkeeOutput(generalized_eigendecomposition<SparseWeightMatrix,DenseDiagonalMatrix,SparseInverseMatrixOperation>(
 			eigen_method,laplacian.first,laplacian.second,target_dimension,SkipOneEigenvalue).first, unimplementedProjectingFunction());
 	}
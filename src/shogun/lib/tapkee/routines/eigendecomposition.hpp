@@ -139,6 +139,130 @@ EigendecompositionResult eigendecomposition_impl_randomized(const MatrixType& wm
 	return EigendecompositionResult();
 }
 
+//! Thick-restart Lanczos implementation of eigendecomposition-based embedding.
+//! Builds an orthonormal basis of the Krylov subspace of the operation with
+//! full reorthogonalization, computes Ritz pairs of its projection and
+//! restarts from the wanted Ritz vectors until their residuals are small.
+//! Only the basis of a few dozens of vectors is stored.
+template <class MatrixType, class MatrixOperationType>
+EigendecompositionResult eigendecomposition_impl_lanczos(const MatrixType& wm, IndexType target_dimension, unsigned int skip)
+{
+	timed_context context("Lanczos eigendecomposition");
+
+	const IndexType n = wm.rows();
+	const IndexType n_wanted = target_dimension+skip;
+	if (n_wanted > n)
+		throw eigendecomposition_error("more eigenvectors requested than the matrix has");
+
+	const IndexType n_basis = std::min(n, std::max(2*n_wanted+1, n_wanted+32));
+	const IndexType max_restarts = 1000;
+	const ScalarType tolerance = 1e-10;
+
+	MatrixOperationType operation(wm);
+
+	DenseMatrix V(n, n_basis+1);
+	DenseMatrix T = DenseMatrix::Zero(n_basis, n_basis);
+	for (IndexType i=0; i<n; i++)
+		V(i,0) = tapkee::gaussian_random();
+	V.col(0).normalize();
+
+	DenseSelfAdjointEigenSolver solver;
+	IndexType n_kept = 0;
+	IndexType restart = 0;
+	for (;; restart++)
+	{
+		ScalarType beta = 0.0;
+		for (IndexType j=n_kept; j<n_basis; j++)
+		{
+			DenseVector w = operation(V.col(j));
+			// orthogonalize twice, once does not keep the basis
+			// orthogonal in floating point
+			DenseVector h = V.leftCols(j+1).transpose()*w;
+			w.noalias() -= V.leftCols(j+1)*h;
+			DenseVector correction = V.leftCols(j+1).transpose()*w;
+			w.noalias() -= V.leftCols(j+1)*correction;
+			h += correction;
+			T.col(j).head(j+1) = h;
+			T.row(j).head(j+1) = h.transpose();
+
+			beta = w.norm();
+			if (beta <= 1e-12*h.norm())
+			{
+				// the basis spans an invariant subspace,
+				// continue with any vector orthogonal to it
+				beta = 0.0;
+				w.setZero();
+				if (j+1 < n_basis)
+				{
+					for (IndexType i=0; i<n; i++)
+						w(i) = tapkee::gaussian_random();
+					for (int pass=0; pass<2; pass++)
+						w -= V.leftCols(j+1)*(V.leftCols(j+1).transpose()*w);
+					w.normalize();
+				}
+				V.col(j+1) = w;
+			}
+			else
+			{
+				V.col(j+1) = w/beta;
+			}
+		}
+
+		solver.compute(T);
+		if (solver.info() != Eigen::Success)
+			throw eigendecomposition_error("eigendecomposition failed");
+
+		// residual of a Ritz pair is the coupling of the last basis vector
+		// to the next one times the last component of the Ritz vector
+		const ScalarType scale = solver.eigenvalues().cwiseAbs().maxCoeff();
+		bool converged = true;
+		for (IndexType i=n_basis-n_wanted; i<n_basis; i++)
+		{
+			if (std::abs(beta*solver.eigenvectors()(n_basis-1,i)) > tolerance*scale)
+				converged = false;
+		}
+		if (converged || restart == max_restarts)
+			break;
+
+		// keep the wanted Ritz vectors and some more to speed up convergence
+		n_kept = std::min(n_basis-1, n_wanted+(n_basis-n_wanted)/2);
+		DenseMatrix kept = V.leftCols(n_basis)*solver.eigenvectors().rightCols(n_kept);
+		V.leftCols(n_kept) = kept;
+		V.col(n_kept) = V.col(n_basis);
+		T.setZero();
+		T.diagonal().head(n_kept) = solver.eigenvalues().tail(n_kept);
+	}
+
+	std::stringstream ss;
+	ss << "Took " << restart << " restarts.";
+	LoggingSingleton::instance().message_info(ss.str());
+	if (restart == max_restarts)
+		LoggingSingleton::instance().message_warning("Lanczos eigendecomposition did not converge");
+
+	DenseMatrix ritz_vectors = V.leftCols(n_basis)*solver.eigenvectors().rightCols(n_wanted);
+	DenseVector ritz_values = solver.eigenvalues().tail(n_wanted);
+	if (MatrixOperationType::largest)
+	{
+		// ascending order as the other methods, the skipped ones are the largest
+		DenseMatrix selected_eigenvectors = ritz_vectors.leftCols(target_dimension);
+		return EigendecompositionResult(selected_eigenvectors,ritz_values.head(target_dimension));
+	}
+	else
+	{
+		// largest eigenvalues of the inverse are the smallest ones in
+		// reverse order, the skipped ones are the smallest
+		DenseMatrix selected_eigenvectors(n,target_dimension);
+		DenseVector selected_eigenvalues(target_dimension);
+		for (IndexType i=0; i<target_dimension; i++)
+		{
+			const IndexType idx = n_wanted-1-skip-i;
+			selected_eigenvectors.col(i) = ritz_vectors.col(idx);
+			selected_eigenvalues(i) = 1.0/ritz_values(idx);
+		}
+		return EigendecompositionResult(selected_eigenvectors,selected_eigenvalues);
+	}
+}
+
 //! Multiple implementation handler method for various eigendecomposition methods.
 //!
 //! Has three template parameters:
@@ -153,12 +277,13 @@ EigendecompositionResult eigendecomposition_impl_randomized(const MatrixType& wm
 //! implementation of operator()(DenseMatrix) which solves linear system with
 //! given right-hand side part.
 //!
-//! Currently supports three methods:
+//! Currently supports four methods:
 //!
 //! <ul>
 //! <li> Arpack
 //! <li> Randomized
 //! <li> Dense
+//! <li> Lanczos
 //! </ul>
 //!
 //! @param method one of supported eigendecomposition methods
@@ -182,6 +307,8 @@ EigendecompositionResult eigendecomposition(EigenMethod method, const MatrixType
 			return eigendecomposition_impl_randomized<MatrixType, MatrixOperationType>(m, target_dimension, skip);
 		case Dense:
 			return eigendecomposition_impl_dense<MatrixType, MatrixOperationType>(m, target_dimension, skip);
+		case Lanczos:
+			return eigendecomposition_impl_lanczos<MatrixType, MatrixOperationType>(m, target_dimension, skip);
 		default: break;
 	}
 	return EigendecompositionResult();
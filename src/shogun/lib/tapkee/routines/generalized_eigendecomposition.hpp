@@ -94,6 +94,9 @@ EigendecompositionResult generalized_eigendecomposition(EigenMethod method, cons
 		case Randomized:
 			throw unsupported_method_error("Randomized method is not supported for generalized eigenproblems");
 			return EigendecompositionResult();
+		case Lanczos:
+			throw unsupported_method_error("Lanczos method is not supported for generalized eigenproblems");
+			return EigendecompositionResult();
 		default: break;
 	}
 	return EigendecompositionResult();
@@ -32,6 +32,76 @@ struct HeapElementComparator
 };
 #endif
 
+//! Neighborhood graph with the edges in both directions
+//! in compressed sparse row layout
+struct NeighborhoodGraph
+{
+	//! offsets of the edges of each vector, one more than vectors
+	std::vector<IndexType> offsets;
+	//! vectors the edges lead to
+	std::vector<IndexType> targets;
+	//! distances along the edges
+	std::vector<ScalarType> weights;
+};
+
+//! Computes the undirected neighborhood graph, i.e. vectors are
+//! connected to their neighbors and to the vectors they are neighbors
+//! of. Distances along the edges are computed once here so that shortest
+//! paths from many vectors do not recompute them.
+//!
+//! @param begin begin data iterator
+//! @param end end data iterator
+//! @param neighbors neighbors of each vector
+//! @param callback distance callback
+//!
+template <class RandomAccessIterator, class DistanceCallback>
+NeighborhoodGraph compute_neighborhood_graph(const RandomAccessIterator& begin, const RandomAccessIterator& end,
+		const Neighbors& neighbors, DistanceCallback callback)
+{
+	const IndexType n_neighbors = neighbors[0].size();
+	const IndexType N = end-begin;
+
+	DenseMatrix distances(n_neighbors,N);
+
+#pragma omp parallel shared(distances,neighbors,begin,callback) default(none)
+	{
+		IndexType k;
+#pragma omp for nowait
+		for (k=0; k<N; k++)
+		{
+			for (IndexType i=0; i<n_neighbors; i++)
+				distances(i,k) = callback.distance(begin[k],begin[neighbors[k][i]]);
+		}
+	}
+
+	NeighborhoodGraph graph;
+	graph.offsets.assign(N+1,0);
+	for (IndexType k=0; k<N; k++)
+	{
+		graph.offsets[k+1] += n_neighbors;
+		for (IndexType i=0; i<n_neighbors; i++)
+			graph.offsets[neighbors[k][i]+1]++;
+	}
+	for (IndexType k=0; k<N; k++)
+		graph.offsets[k+1] += graph.offsets[k];
+
+	graph.targets.resize(graph.offsets[N]);
+	graph.weights.resize(graph.offsets[N]);
+	std::vector<IndexType> filled(graph.offsets.begin(),graph.offsets.end()-1);
+	for (IndexType k=0; k<N; k++)
+	{
+		for (IndexType i=0; i<n_neighbors; i++)
+		{
+			const IndexType j = neighbors[k][i];
+			graph.targets[filled[k]] = j;
+			graph.weights[filled[k]++] = distances(i,k);
+			graph.targets[filled[j]] = k;
+			graph.weights[filled[j]++] = distances(i,k);
+		}
+	}
+	return graph;
+}
+
 //! Computes shortest distances (so-called geodesic distances)
 //! using Dijkstra algorithm.
 //!
@@ -45,12 +115,12 @@ DenseSymmetricMatrix compute_shortest_distances_matrix(const RandomAccessIterato
 		const Neighbors& neighbors, DistanceCallback callback)
 {
 	timed_context context("Distances shortest path relaxing");
-	const IndexType n_neighbors = neighbors[0].size();
 	const IndexType N = (end-begin);
 
+	const NeighborhoodGraph graph = compute_neighborhood_graph(begin,end,neighbors,callback);
 	DenseSymmetricMatrix shortest_distances(N,N);
 
-#pragma omp parallel shared(shortest_distances,neighbors,begin,callback) default(none)
+#pragma omp parallel shared(shortest_distances,graph) default(none)
 	{
 		bool* f = new bool[N];
 		bool* s = new bool[N];
@@ -103,15 +173,15 @@ DenseSymmetricMatrix compute_shortest_distances_matrix(const RandomAccessIterato
 				f[min_item] = false;
 
 				// for-each edge (min_item->w)
-				for (IndexType i=0; i<n_neighbors; i++)
+				for (IndexType i=graph.offsets[min_item]; i<graph.offsets[min_item+1]; i++)
 				{
 					// get w idx
-					int w = neighbors[min_item][i];
+					int w = graph.targets[i];
 					// if w is not in solution yet
 					if (s[w] == false)
 					{
 						// get distance from k to i through min_item
-						ScalarType dist = shortest_distances(k,min_item) + callback.distance(begin[min_item],begin[w]);
+						ScalarType dist = shortest_distances(k,min_item) + graph.weights[i];
 						// if distance can be relaxed
 						if (dist < shortest_distances(k,w))
 						{
@@ -162,13 +232,13 @@ DenseMatrix compute_shortest_distances_matrix(const RandomAccessIterator& begin,
 		const Landmarks& landmarks, const Neighbors& neighbors, DistanceCallback callback)
 {
 	timed_context context("Distances shortest path relaxing");
-	const IndexType n_neighbors = neighbors[0].size();
 	const IndexType N = end-begin;
 	const IndexType N_landmarks = landmarks.size();
 
+	const NeighborhoodGraph graph = compute_neighborhood_graph(begin,end,neighbors,callback);
 	DenseMatrix shortest_distances(landmarks.size(),N);
 
-#pragma omp parallel shared(shortest_distances,begin,landmarks,neighbors,callback) default(none)
+#pragma omp parallel shared(shortest_distances,landmarks,graph) default(none)
 	{
 		bool* f = new bool[N];
 		bool* s = new bool[N];
@@ -200,7 +270,7 @@ DenseMatrix compute_shortest_distances_matrix(const RandomAccessIterator& begin,
 #else
 			heap.insert(landmarks[k],0.0);
 #endif
-			f[k] = true;
+			f[landmarks[k]] = true;
 
 			// while heap is not empty
 			while (!heap.empty())
@@ -221,15 +291,15 @@ DenseMatrix compute_shortest_distances_matrix(const RandomAccessIterator& begin,
 				f[min_item] = false;
 
 				// for-each edge (min_item->w)
-				for (IndexType i=0; i<n_neighbors; i++)
+				for (IndexType i=graph.offsets[min_item]; i<graph.offsets[min_item+1]; i++)
 				{
 					// get w idx
-					int w = neighbors[min_item][i];
+					int w = graph.targets[i];
 					// if w is not in solution yet
 					if (s[w] == false)
 					{
 						// get distance from k to i through min_item
-						ScalarType dist = shortest_distances(k,min_item) + callback.distance(begin[min_item],begin[w]);
+						ScalarType dist = shortest_distances(k,min_item) + graph.weights[i];
 						// if distance can be relaxed
 						if (dist < shortest_distances(k,w))
 						{
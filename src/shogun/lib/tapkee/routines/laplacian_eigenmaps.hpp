@@ -9,6 +9,7 @@
 /* Tapkee includes */
 #include <shogun/lib/tapkee/defines.hpp>
 #include <shogun/lib/tapkee/utils/time.hpp>
+#include <shogun/lib/tapkee/routines/eigendecomposition.hpp>
 /* End of Tapkee includes */
 
 namespace tapkee
@@ -78,6 +79,50 @@ Laplacian compute_laplacian(RandomAccessIterator begin,
 	return Laplacian(weight_matrix,DenseDiagonalMatrix(D));
 }
 
+//! Computes the smallest eigenvectors of the generalized eigenproblem
+//! \f$ L v = \lambda D v \f$ of a laplacian with products of sparse
+//! matrices only, i.e. without factorizing or densifying \f$ L \f$.
+//!
+//! Follows the algorithm described below:
+//! <ul>
+//! <li> Normalize the laplacian to \f$ S = D^{-1/2} L D^{-1/2} \f$ whose
+//!      eigenvalues lie in \f$ [0,2] \f$.
+//! <li> Compute largest eigenvectors \f$ u \f$ of \f$ 2I - S \f$, which
+//!      are the smallest ones of \f$ S \f$ with \f$ \lambda = 2 - \mu \f$.
+//! <li> Output \f$ v = D^{-1/2} u \f$, which are normalized
+//!      so that \f$ v^T D v = 1 \f$.
+//! </ul>
+//!
+//! @param method standard eigendecomposition method to use
+//! @param laplacian laplacian and its diagonal matrix
+//! @param target_dimension number of eigenvectors to compute
+//! @param skip number of smallest eigenvectors to skip
+//!
+inline EigendecompositionResult normalized_laplacian_eigendecomposition(EigenMethod method,
+		const Laplacian& laplacian, IndexType target_dimension, unsigned int skip)
+{
+	timed_context context("Normalized laplacian eigendecomposition");
+	const DenseVector inv_sqrt_degree = laplacian.second.diagonal().array().sqrt().inverse();
+
+	SparseWeightMatrix shifted = -(inv_sqrt_degree.asDiagonal()*laplacian.first*inv_sqrt_degree.asDiagonal());
+	for (IndexType i=0; i<shifted.rows(); ++i)
+		shifted.coeffRef(i,i) += 2.0;
+
+	EigendecompositionResult result =
+		eigendecomposition<SparseWeightMatrix,SparseMatrixOperation>(method,shifted,target_dimension+skip,0);
+
+	// largest eigenvalues come last, smallest laplacian ones first
+	DenseMatrix eigenvectors(shifted.rows(),target_dimension);
+	DenseVector eigenvalues(target_dimension);
+	for (IndexType i=0; i<target_dimension; ++i)
+	{
+		const IndexType idx = target_dimension-1-i;
+		eigenvectors.col(i) = inv_sqrt_degree.asDiagonal()*result.first.col(idx);
+		eigenvalues(i) = 2.0-result.second(idx);
+	}
+	return EigendecompositionResult(eigenvectors,eigenvalues);
+}
+
 template<class RandomAccessIterator, class FeatureVectorCallback>
 DenseSymmetricMatrixPair construct_locality_preserving_eigenproblem(SparseWeightMatrix& L,
 		DenseDiagonalMatrix& D, RandomAccessIterator begin, RandomAccessIterator end, FeatureVectorCallback feature_vector_callback,
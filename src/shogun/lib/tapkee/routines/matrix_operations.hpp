@@ -66,6 +66,33 @@ struct DenseInverseMatrixOperation
 const char* DenseInverseMatrixOperation::ARPACK_CODE = "SM";
 const bool DenseInverseMatrixOperation::largest = false;
 
+//! Matrix-matrix operation used to
+//! compute largest eigenvalues and
+//! associated eigenvectors of a sparse
+//! matrix. Essentially computes matrix
+//! product with provided right-hand side part.
+//!
+struct SparseMatrixOperation
+{
+	SparseMatrixOperation(const SparseWeightMatrix& matrix) : _matrix(matrix)
+	{
+	}
+	//! Computes matrix product of the matrix and provided right-hand
+	//! side matrix
+	//!
+	//! @param rhs right-hand size matrix
+	//!
+	inline DenseMatrix operator()(const DenseMatrix& rhs)
+	{
+		return _matrix*rhs;
+	}
+	const SparseWeightMatrix& _matrix;
+	static const char* ARPACK_CODE;
+	static const bool largest;
+};
+const char* SparseMatrixOperation::ARPACK_CODE = "LM";
+const bool SparseMatrixOperation::largest = true;
+
 //! Matrix-matrix operation used to
 //! compute largest eigenvalues and
 //! associated eigenvectors. Essentially
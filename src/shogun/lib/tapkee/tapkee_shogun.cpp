@@ -67,6 +67,40 @@ struct ShogunFeatureVectorCallback
 	CDotFeatures* features;
 };
 
+/* find the neighbors of all vectors in parallel with a shogun distance or
+ * kernel instead of the sequential search of tapkee. If a tree search was
+ * asked for but the shogun trees do not support the kernel or distance,
+ * no neighbors are returned and tapkee searches its cover tree, which
+ * unlike the brute force fallback of the builder does not compare all
+ * pairs of vectors */
+template <class T>
+tapkee::tapkee_internal::Neighbors find_knn_graph(T* similarity,
+		const TAPKEE_PARAMETERS_FOR_SHOGUN& parameters)
+{
+	if ((parameters.knn_method==KNNG_KD_TREE ||
+		parameters.knn_method==KNNG_BALL_TREE) &&
+		!CKNNGraphBuilder::is_tree_supported(similarity))
+	{
+		SG_SINFO("Trees do not support the %s, searching the neighbors "
+			"with the cover tree of tapkee\n", similarity->get_name())
+		return tapkee::tapkee_internal::Neighbors();
+	}
+
+	CKNNGraphBuilder* builder = new CKNNGraphBuilder(parameters.n_neighbors,
+			parameters.knn_method);
+	SG_REF(builder);
+	builder->build(similarity);
+	SGMatrix<index_t> indices = builder->get_neighbors();
+	SG_UNREF(builder);
+
+	tapkee::tapkee_internal::Neighbors neighbors(indices.num_cols);
+	for (index_t i=0; i<indices.num_cols; i++)
+	{
+		neighbors[i].assign(indices.get_column_vector(i),
+				indices.get_column_vector(i)+indices.num_rows);
+	}
+	return neighbors;
+}
 
 CDenseFeatures<float64_t>* shogun::tapkee_embed(const shogun::TAPKEE_PARAMETERS_FOR_SHOGUN& parameters)
 {
@@ -81,10 +115,14 @@ CDenseFeatures<float64_t>* shogun::tapkee_embed(const shogun::TAPKEE_PARAMETERS_
 	tapkee::DimensionReductionMethod method;
 #ifdef HAVE_ARPACK
 	tapkee::EigenMethod eigen_method = tapkee::Arpack;
+	tapkee::EigenMethod scalable_eigen_method = tapkee::Arpack;
 #else
 	tapkee::EigenMethod eigen_method = tapkee::Dense;
+	// does not decompose or densify N x N matrices
+	tapkee::EigenMethod scalable_eigen_method = tapkee::Lanczos;
 #endif
 	tapkee::NeighborsMethod neighbors_method = tapkee::CoverTree;
+	tapkee::tapkee_internal::Neighbors neighbors;
 	size_t N = 0;
 
 	switch (parameters.method)
@@ -93,22 +131,27 @@ CDenseFeatures<float64_t>* shogun::tapkee_embed(const shogun::TAPKEE_PARAMETERS_
 		case SHOGUN_LOCALLY_LINEAR_EMBEDDING:
 			method = tapkee::KernelLocallyLinearEmbedding;
 			N = parameters.kernel->get_num_vec_lhs();
+			neighbors = find_knn_graph(parameters.kernel, parameters);
 			break;
 		case SHOGUN_NEIGHBORHOOD_PRESERVING_EMBEDDING:
 			method = tapkee::NeighborhoodPreservingEmbedding;
 			N = parameters.kernel->get_num_vec_lhs();
+			neighbors = find_knn_graph(parameters.kernel, parameters);
 			break;
 		case SHOGUN_LOCAL_TANGENT_SPACE_ALIGNMENT:
 			method = tapkee::KernelLocalTangentSpaceAlignment;
 			N = parameters.kernel->get_num_vec_lhs();
+			neighbors = find_knn_graph(parameters.kernel, parameters);
 			break;
 		case SHOGUN_LINEAR_LOCAL_TANGENT_SPACE_ALIGNMENT:
 			method = tapkee::LinearLocalTangentSpaceAlignment;
 			N = parameters.kernel->get_num_vec_lhs();
+			neighbors = find_knn_graph(parameters.kernel, parameters);
 			break;
 		case SHOGUN_HESSIAN_LOCALLY_LINEAR_EMBEDDING:
 			method = tapkee::HessianLocallyLinearEmbedding;
 			N = parameters.kernel->get_num_vec_lhs();
+			neighbors = find_knn_graph(parameters.kernel, parameters);
 			break;
 		case SHOGUN_DIFFUSION_MAPS:
 			method = tapkee::DiffusionMap;
@@ -117,10 +160,13 @@ CDenseFeatures<float64_t>* shogun::tapkee_embed(const shogun::TAPKEE_PARAMETERS_
 		case SHOGUN_LAPLACIAN_EIGENMAPS:
 			method = tapkee::LaplacianEigenmaps;
 			N = parameters.distance->get_num_vec_lhs();
+			neighbors = find_knn_graph(parameters.distance, parameters);
+			eigen_method = scalable_eigen_method;
 			break;
 		case SHOGUN_LOCALITY_PRESERVING_PROJECTIONS:
 			method = tapkee::LocalityPreservingProjections;
 			N = parameters.distance->get_num_vec_lhs();
+			neighbors = find_knn_graph(parameters.distance, parameters);
 			break;
 		case SHOGUN_MULTIDIMENSIONAL_SCALING:
 			method = tapkee::MultidimensionalScaling;
@@ -133,14 +179,20 @@ CDenseFeatures<float64_t>* shogun::tapkee_embed(const shogun::TAPKEE_PARAMETERS_
 		case SHOGUN_ISOMAP:
 			method = tapkee::Isomap;
 			N = parameters.distance->get_num_vec_lhs();
+			neighbors = find_knn_graph(parameters.distance, parameters);
+			eigen_method = scalable_eigen_method;
 			break;
 		case SHOGUN_LANDMARK_ISOMAP:
 			method = tapkee::LandmarkIsomap;
 			N = parameters.distance->get_num_vec_lhs();
+			neighbors = find_knn_graph(parameters.distance, parameters);
+			eigen_method = scalable_eigen_method;
 			break;
 		case SHOGUN_STOCHASTIC_PROXIMITY_EMBEDDING:
 			method = tapkee::StochasticProximityEmbedding;
 			N = parameters.distance->get_num_vec_lhs();
+			if (!parameters.spe_global_strategy)
+				neighbors = find_knn_graph(parameters.distance, parameters);
 			break;
 		case SHOGUN_FACTOR_ANALYSIS:
 			method = tapkee::FactorAnalysis;
@@ -153,6 +205,7 @@ CDenseFeatures<float64_t>* shogun::tapkee_embed(const shogun::TAPKEE_PARAMETERS_
 		case SHOGUN_MANIFOLD_SCULPTING:
 			method = tapkee::ManifoldSculpting;
 			N = parameters.features->get_num_vectors();
+			neighbors = find_knn_graph(parameters.distance, parameters);
 			break;
 	}
 
@@ -177,7 +230,8 @@ CDenseFeatures<float64_t>* shogun::tapkee_embed(const shogun::TAPKEE_PARAMETERS_
 		 tapkee::keywords::fa_epsilon = parameters.fa_epsilon,
 		 tapkee::keywords::sne_perplexity = parameters.sne_perplexity,
 		 tapkee::keywords::sne_theta = parameters.sne_theta,
-		 tapkee::keywords::squishing_rate = parameters.squishing_rate
+		 tapkee::keywords::squishing_rate = parameters.squishing_rate,
+		 tapkee::keywords::precomputed_neighbors = neighbors
 		 );
 
 	tapkee::TapkeeOutput output = tapkee::embed(indices.begin(),indices.end(),
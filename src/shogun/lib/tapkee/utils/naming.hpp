@@ -62,6 +62,7 @@ std::string get_eigen_method_name(EigenMethod m)
 #endif
 		case Dense: return "Dense";
 		case Randomized: return "Randomized";
+		case Lanczos: return "Lanczos";
 	}
 	return "hello";
 }
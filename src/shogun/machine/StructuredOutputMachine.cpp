@@ -14,6 +14,8 @@
 #include <shogun/labels/StructuredLabels.h>
 #include <shogun/loss/LossFunction.h>
 #include <shogun/structure/StructuredModel.h>
+#include <shogun/base/Parallel.h>
+#include <shogun/mathematics/Math.h>
 
 using namespace shogun;
 
@@ -112,19 +114,45 @@ float64_t CStructuredOutputMachine::risk_nslack_margin_rescale(float64_t* subgra
 	}
 	SG_UNREF(features);
 
-	float64_t R = 0.0;
-	for (int32_t i=0; i<dim; i++)
-		subgrad[i] = 0;
+	/* examples are split into contiguous blocks, one per thread, each with
+	 * its own subgradient and risk, which are added up in block order */
+	SGVector<float64_t> w(W, dim, false);
+	int32_t num_blocks = 1;
+	if (m_model->init_parallel_argmax(w))
+		num_blocks = CMath::max(1, CMath::min(parallel->get_num_threads(), to-from));
+
+	SGMatrix<float64_t> block_subgrads(dim, num_blocks);
+	SGVector<float64_t> block_risks(num_blocks);
+	block_subgrads.zero();
+	block_risks.zero();
+
+#pragma omp parallel for num_threads(num_blocks)
+	for (int32_t b=0; b<num_blocks; b++)
+	{
+		int32_t block_from = from + int64_t(to-from)*b/num_blocks;
+		int32_t block_to = from + int64_t(to-from)*(b+1)/num_blocks;
+		float64_t* block_subgrad = block_subgrads.get_column_vector(b);
+
+		for (int32_t i=block_from; i<block_to; i++)
+		{
+			CResultSet* result = m_model->argmax(w, i, true);
+			SGVector<float64_t> psi_pred = result->psi_pred;
+			SGVector<float64_t> psi_truth = result->psi_truth;
+			SGVector<float64_t>::vec1_plus_scalar_times_vec2(block_subgrad, 1.0, psi_pred.vector, dim);
+			SGVector<float64_t>::vec1_plus_scalar_times_vec2(block_subgrad, -1.0, psi_truth.vector, dim);
+			block_risks[b] += result->score;
+			SG_UNREF(result);
+		}
+	}
 
-	for (int32_t i=from; i<to; i++)
+	float64_t R = 0.0;
+	memcpy(subgrad, block_subgrads.matrix, sizeof(float64_t)*dim);
+	R += block_risks[0];
+	for (int32_t b=1; b<num_blocks; b++)
 	{
-		CResultSet* result = m_model->argmax(SGVector<float64_t>(W,dim,false), i, true);
-		SGVector<float64_t> psi_pred = result->psi_pred;
-		SGVector<float64_t> psi_truth = result->psi_truth;
-		SGVector<float64_t>::vec1_plus_scalar_times_vec2(subgrad, 1.0, psi_pred.vector, dim);
-		SGVector<float64_t>::vec1_plus_scalar_times_vec2(subgrad, -1.0, psi_truth.vector, dim);
-		R += result->score;
-		SG_UNREF(result);
+		SGVector<float64_t>::vec1_plus_scalar_times_vec2(subgrad, 1.0,
+				block_subgrads.get_column_vector(b), dim);
+		R += block_risks[b];
 	}
 
 	return R;
@@ -162,6 +162,10 @@ class CStructuredOutputMachine : public CMachine
 		 * + \langle {\bf w}, \Psi(x_i, y)  \rangle \right]
 		 * \f]
 		 *
+		 * The examples are split among the threads if the model supports
+		 * concurrent argmax calls (see CStructuredModel::init_parallel_argmax).
+		 * Results do not depend on thread scheduling.
+		 *
 		 * @param subgrad Subgradient computed at given point W
 		 * @param W Given weight vector
 		 * @param info Helper info for multiple cutting plane models algorithm
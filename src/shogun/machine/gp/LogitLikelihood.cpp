@@ -35,6 +35,7 @@
 #include <shogun/mathematics/Integration.h>
 #include <shogun/labels/BinaryLabels.h>
 #include <shogun/mathematics/eigen3.h>
+#include <shogun/mathematics/simd/SIMD.h>
 
 using namespace shogun;
 using namespace Eigen;
@@ -287,7 +288,11 @@ SGVector<float64_t> CLogitLikelihood::get_log_probability_f(const CLabels* lab,
 	Map<VectorXd> eigen_r(r.vector, r.vlen);
 
 	// compute log probability: -log(1+exp(-f.*y))
-	eigen_r=-(1.0+(-eigen_y.array()*eigen_f.array()).exp()).log();
+	eigen_r=-eigen_y.cwiseProduct(eigen_f);
+	simd::exp(r.vector, r.vector, r.vlen);
+	eigen_r.array()+=1.0;
+	simd::log(r.vector, r.vector, r.vlen);
+	eigen_r=-eigen_r;
 
 	return r;
 }
@@ -312,8 +317,8 @@ SGVector<float64_t> CLogitLikelihood::get_log_probability_derivative_f(
 	Map<VectorXd> eigen_r(r.vector, r.vlen);
 
 	// compute s(f)=1./(1+exp(-f))
-	VectorXd eigen_s=(VectorXd::Ones(func.vlen)).cwiseQuotient((1.0+
-		(-eigen_f).array().exp()).matrix());
+	VectorXd eigen_s(func.vlen);
+	simd::sigmoid(func.vector, eigen_s.data(), func.vlen);
 
 	// compute derivatives of log probability wrt f
 	if (i == 1)
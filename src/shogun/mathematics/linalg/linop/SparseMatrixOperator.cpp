@@ -202,12 +202,7 @@ void CSparseMatrixOperator<T>::set_diagonal(SGVector<T> diag)
 			// we create a new entry if the diagonal element for this row doesn't exist
 			if (!inserted)
 			{
-				index_t j=m_operator[i].num_feat_entries;
-				m_operator[i].num_feat_entries=j+1;
-				m_operator[i].features=SG_REALLOC(SGSparseVectorEntry<T>,
-					m_operator[i].features, j, j+1);
-				m_operator[i].features[j].feat_index=i;
-				m_operator[i].features[j].entry=diag[i];
+				m_operator(i,i)=diag[i];
 				need_sorting=true;
 			}
 		}
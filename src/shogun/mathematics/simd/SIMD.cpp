@@ -0,0 +1,222 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/mathematics/simd/SIMD.h>
+#include <shogun/mathematics/simd/SIMDKernels.h>
+#include <shogun/io/SGIO.h>
+
+#include <math.h>
+
+namespace shogun
+{
+namespace simd
+{
+
+namespace
+{
+
+void scalar_exp(const float64_t* x, float64_t* y, index_t n)
+{
+	for (index_t i=0; i<n; i++)
+		y[i]=::exp(x[i]);
+}
+
+void scalar_log(const float64_t* x, float64_t* y, index_t n)
+{
+	for (index_t i=0; i<n; i++)
+		y[i]=::log(x[i]);
+}
+
+void scalar_sigmoid(const float64_t* x, float64_t* y, index_t n)
+{
+	for (index_t i=0; i<n; i++)
+		y[i]=1.0/(1.0+::exp(-x[i]));
+}
+
+float64_t scalar_dot(const float64_t* a, const float64_t* b, index_t n)
+{
+	float64_t r=0;
+	for (index_t i=0; i<n; i++)
+		r+=a[i]*b[i];
+	return r;
+}
+
+void scalar_axpy(float64_t alpha, const float64_t* x, float64_t* y, index_t n)
+{
+	for (index_t i=0; i<n; i++)
+		y[i]+=alpha*x[i];
+}
+
+float64_t scalar_squared_distance(const float64_t* a, const float64_t* b, index_t n)
+{
+	float64_t r=0;
+	for (index_t i=0; i<n; i++)
+		r+=(a[i]-b[i])*(a[i]-b[i]);
+	return r;
+}
+
+float64_t scalar_min(const float64_t* x, index_t n)
+{
+	float64_t r=x[0];
+	for (index_t i=1; i<n; i++)
+		r=x[i]<r ? x[i] : r;
+	return r;
+}
+
+float64_t scalar_max(const float64_t* x, index_t n)
+{
+	float64_t r=x[0];
+	for (index_t i=1; i<n; i++)
+		r=x[i]>r ? x[i] : r;
+	return r;
+}
+
+bool cpu_supports(ESIMDInstructionSet instruction_set)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	switch (instruction_set)
+	{
+		case SIMD_SCALAR:
+			return true;
+		case SIMD_SSE2:
+			return __builtin_cpu_supports("sse2");
+		case SIMD_AVX2:
+			return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+		case SIMD_AVX512:
+			return __builtin_cpu_supports("avx512f");
+	}
+	return false;
+#else
+	return instruction_set==SIMD_SCALAR;
+#endif
+}
+
+const SIMDKernelTable* compiled_kernels(ESIMDInstructionSet instruction_set)
+{
+	switch (instruction_set)
+	{
+		case SIMD_SCALAR:
+			return &scalar_kernels;
+#ifdef HAVE_SSE2
+		case SIMD_SSE2:
+			return &sse2_kernels;
+#endif
+#ifdef HAVE_AVX2
+		case SIMD_AVX2:
+			return &avx2_kernels;
+#endif
+#ifdef HAVE_AVX512F
+		case SIMD_AVX512:
+			return &avx512_kernels;
+#endif
+		default:
+			return NULL;
+	}
+}
+
+ESIMDInstructionSet best_instruction_set()
+{
+	const ESIMDInstructionSet candidates[]={SIMD_AVX512, SIMD_AVX2, SIMD_SSE2};
+	for (int32_t i=0; i<3; i++)
+	{
+		if (is_supported(candidates[i]))
+			return candidates[i];
+	}
+	return SIMD_SCALAR;
+}
+
+struct Dispatch
+{
+	Dispatch()
+	{
+		instruction_set=best_instruction_set();
+		kernels=compiled_kernels(instruction_set);
+	}
+
+	ESIMDInstructionSet instruction_set;
+	const SIMDKernelTable* kernels;
+};
+
+/* initialized on first use, which is thread safe with C++11 */
+Dispatch& dispatch()
+{
+	static Dispatch d;
+	return d;
+}
+
+}
+
+const SIMDKernelTable scalar_kernels=
+{
+	&scalar_exp, &scalar_log, &scalar_sigmoid, &scalar_dot, &scalar_axpy,
+	&scalar_squared_distance, &scalar_min, &scalar_max
+};
+
+ESIMDInstructionSet get_instruction_set()
+{
+	return dispatch().instruction_set;
+}
+
+bool is_supported(ESIMDInstructionSet instruction_set)
+{
+	return compiled_kernels(instruction_set)!=NULL && cpu_supports(instruction_set);
+}
+
+void set_instruction_set(ESIMDInstructionSet instruction_set)
+{
+	REQUIRE(is_supported(instruction_set),
+		"Instruction set %d is not supported\n", instruction_set);
+
+	Dispatch& d=dispatch();
+	d.instruction_set=instruction_set;
+	d.kernels=compiled_kernels(instruction_set);
+}
+
+void exp(const float64_t* x, float64_t* y, index_t n)
+{
+	dispatch().kernels->exp(x, y, n);
+}
+
+void log(const float64_t* x, float64_t* y, index_t n)
+{
+	dispatch().kernels->log(x, y, n);
+}
+
+void sigmoid(const float64_t* x, float64_t* y, index_t n)
+{
+	dispatch().kernels->sigmoid(x, y, n);
+}
+
+float64_t dot(const float64_t* a, const float64_t* b, index_t n)
+{
+	return dispatch().kernels->dot(a, b, n);
+}
+
+void axpy(float64_t alpha, const float64_t* x, float64_t* y, index_t n)
+{
+	dispatch().kernels->axpy(alpha, x, y, n);
+}
+
+float64_t squared_distance(const float64_t* a, const float64_t* b, index_t n)
+{
+	return dispatch().kernels->squared_distance(a, b, n);
+}
+
+float64_t min(const float64_t* x, index_t n)
+{
+	REQUIRE(n>0, "Number of elements (%d) has to be positive\n", n);
+	return dispatch().kernels->min(x, n);
+}
+
+float64_t max(const float64_t* x, index_t n)
+{
+	REQUIRE(n>0, "Number of elements (%d) has to be positive\n", n);
+	return dispatch().kernels->max(x, n);
+}
+
+}
+}
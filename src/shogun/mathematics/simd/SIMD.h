@@ -0,0 +1,124 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef SIMD_H_
+#define SIMD_H_
+
+#include <shogun/lib/config.h>
+#include <shogun/lib/common.h>
+
+namespace shogun
+{
+
+/** instruction sets the elementwise kernels in namespace simd are
+ * available for */
+enum ESIMDInstructionSet
+{
+	SIMD_SCALAR=0,
+	SIMD_SSE2=1,
+	SIMD_AVX2=2,
+	SIMD_AVX512=3
+};
+
+/**
+ * Vectorized elementwise kernels for float64_t arrays.
+ *
+ * Every kernel is compiled for SSE2, AVX2 (with FMA) and AVX-512 if the
+ * compiler supports these instruction sets, and the best one the CPU
+ * supports is chosen when a kernel is called first. exp() and log() use
+ * the rational approximations of the Cephes library and are accurate to
+ * about one unit in the last place; arguments whose results would not
+ * be normal numbers (and NaN or infinite arguments) are passed on to the
+ * C library. Sums (dot(), squared_distance()) are accumulated in a
+ * different order than a plain loop, so they may differ from it by
+ * rounding.
+ *
+ * Input and output arrays may be the same.
+ */
+namespace simd
+{
+
+/** @return instruction set the kernels use */
+ESIMDInstructionSet get_instruction_set();
+
+/** @param instruction_set instruction set
+ * @return whether the kernels are compiled for the given instruction set
+ * and the CPU supports it
+ */
+bool is_supported(ESIMDInstructionSet instruction_set);
+
+/** force the kernels to use the given instruction set, e.g. to compare
+ * against the scalar kernels. Not to be called while other threads use
+ * the kernels
+ *
+ * @param instruction_set supported instruction set
+ */
+void set_instruction_set(ESIMDInstructionSet instruction_set);
+
+/** y[i]=exp(x[i])
+ *
+ * @param x input
+ * @param y output
+ * @param n number of elements
+ */
+void exp(const float64_t* x, float64_t* y, index_t n);
+
+/** y[i]=log(x[i])
+ *
+ * @param x input
+ * @param y output
+ * @param n number of elements
+ */
+void log(const float64_t* x, float64_t* y, index_t n);
+
+/** logistic function y[i]=1/(1+exp(-x[i]))
+ *
+ * @param x input
+ * @param y output
+ * @param n number of elements
+ */
+void sigmoid(const float64_t* x, float64_t* y, index_t n);
+
+/** @param a first vector
+ * @param b second vector
+ * @param n number of elements
+ * @return dot product of a and b
+ */
+float64_t dot(const float64_t* a, const float64_t* b, index_t n);
+
+/** y[i]+=alpha*x[i]
+ *
+ * @param alpha scalar
+ * @param x input
+ * @param y output
+ * @param n number of elements
+ */
+void axpy(float64_t alpha, const float64_t* x, float64_t* y, index_t n);
+
+/** @param a first vector
+ * @param b second vector
+ * @param n number of elements
+ * @return squared Euclidean distance between a and b
+ */
+float64_t squared_distance(const float64_t* a, const float64_t* b, index_t n);
+
+/** @param x input
+ * @param n number of elements, at least one
+ * @return smallest element of x
+ */
+float64_t min(const float64_t* x, index_t n);
+
+/** @param x input
+ * @param n number of elements, at least one
+ * @return largest element of x
+ */
+float64_t max(const float64_t* x, index_t n);
+
+}
+
+}
+#endif /* SIMD_H_ */
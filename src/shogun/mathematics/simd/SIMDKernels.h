@@ -0,0 +1,332 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef SIMD_KERNELS_H_
+#define SIMD_KERNELS_H_
+
+#include <shogun/lib/config.h>
+#include <shogun/lib/common.h>
+
+#include <math.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+namespace shogun
+{
+namespace simd
+{
+
+/** the kernels of one instruction set */
+struct SIMDKernelTable
+{
+	void (*exp)(const float64_t*, float64_t*, index_t);
+	void (*log)(const float64_t*, float64_t*, index_t);
+	void (*sigmoid)(const float64_t*, float64_t*, index_t);
+	float64_t (*dot)(const float64_t*, const float64_t*, index_t);
+	void (*axpy)(float64_t, const float64_t*, float64_t*, index_t);
+	float64_t (*squared_distance)(const float64_t*, const float64_t*, index_t);
+	float64_t (*min)(const float64_t*, index_t);
+	float64_t (*max)(const float64_t*, index_t);
+};
+
+extern const SIMDKernelTable scalar_kernels;
+#ifdef HAVE_SSE2
+extern const SIMDKernelTable sse2_kernels;
+#endif
+#ifdef HAVE_AVX2
+extern const SIMDKernelTable avx2_kernels;
+#endif
+#ifdef HAVE_AVX512F
+extern const SIMDKernelTable avx512_kernels;
+#endif
+
+/** table of the kernels of an instruction set */
+#define SIMD_KERNEL_TABLE(V) \
+	{ \
+		&SIMDKernels<V>::exp, &SIMDKernels<V>::log, &SIMDKernels<V>::sigmoid, \
+		&SIMDKernels<V>::dot, &SIMDKernels<V>::axpy, \
+		&SIMDKernels<V>::squared_distance, &SIMDKernels<V>::min, \
+		&SIMDKernels<V>::max \
+	}
+
+/** Kernels written once against the register type V of an instruction
+ * set. Only to be included by the translation unit compiled for that
+ * instruction set, with V in an anonymous namespace, so that no code
+ * using the instruction set leaks into other translation units.
+ *
+ * V provides the double register type reg, the 64 bit integer register
+ * type ireg, the number of lanes width, and load, store, set1, set1_int,
+ * add, sub, mul, div, fmadd (a*b+c), min, max, round (to nearest
+ * integer), lt_select (a<b ? c : 0), as_int, as_double, add_int, and_int,
+ * or_int, shl<n>, shr<n> and in_range, which returns a bit mask of the
+ * lanes with lo<=a<=hi.
+ */
+template <class V>
+struct SIMDKernels
+{
+	typedef typename V::reg reg;
+	typedef typename V::ireg ireg;
+
+	/** exp of lanes in [-708,709], Cephes' Pade approximation of
+	 * exp(r) after reduction x=n*log(2)+r
+	 */
+	static inline reg exp_reg(reg x)
+	{
+		reg n=V::round(V::mul(x, V::set1(1.4426950408889634073599)));
+		x=V::sub(x, V::mul(n, V::set1(6.93145751953125E-1)));
+		x=V::sub(x, V::mul(n, V::set1(1.42860682030941723212E-6)));
+
+		reg xx=V::mul(x, x);
+		reg px=V::fmadd(xx, V::set1(1.26177193074810590878E-4),
+			V::set1(3.02994407707441961300E-2));
+		px=V::fmadd(px, xx, V::set1(9.99999999999999999910E-1));
+		px=V::mul(px, x);
+		reg qx=V::fmadd(xx, V::set1(3.00198505138664455042E-6),
+			V::set1(2.52448340349684104192E-3));
+		qx=V::fmadd(qx, xx, V::set1(2.27265548208155028766E-1));
+		qx=V::fmadd(qx, xx, V::set1(2.00000000000000000009E0));
+		x=V::div(px, V::sub(qx, px));
+		x=V::add(V::set1(1.0), V::add(x, x));
+
+		/* the low bits of n+1.5*2^52 are n, shifting n+1023 into the
+		 * exponent field gives 2^n */
+		ireg e=V::as_int(V::add(n, V::set1(6755399441055744.0)));
+		e=V::template shl<52>(V::add_int(e, V::set1_int(1023)));
+		return V::mul(x, V::as_double(e));
+	}
+
+	/** log of normal positive lanes, Cephes' rational approximation of
+	 * log(1+x) after splitting off the exponent
+	 */
+	static inline reg log_reg(reg x)
+	{
+		ireg bits=V::as_int(x);
+
+		/* biased exponent as double through the bits of 2^52+e */
+		reg e=V::sub(V::as_double(V::or_int(V::template shr<52>(bits),
+			V::set1_int(0x4330000000000000LL))), V::set1(4503599627370496.0+1022.0));
+		/* mantissa in [0.5,1) */
+		reg m=V::as_double(V::or_int(V::and_int(bits,
+			V::set1_int(0x000fffffffffffffLL)), V::set1_int(0x3fe0000000000000LL)));
+
+		/* below sqrt(1/2) use 2m-1 and one less in the exponent */
+		reg sqrth=V::set1(7.07106781186547524401E-1);
+		e=V::sub(e, V::lt_select(m, sqrth, V::set1(1.0)));
+		x=V::add(V::sub(m, V::set1(1.0)), V::lt_select(m, sqrth, m));
+
+		reg z=V::mul(x, x);
+		reg p=V::fmadd(x, V::set1(1.01875663804580931796E-4),
+			V::set1(4.97494994976747001425E-1));
+		p=V::fmadd(p, x, V::set1(4.70579119878881725854E0));
+		p=V::fmadd(p, x, V::set1(1.44989225341610930846E1));
+		p=V::fmadd(p, x, V::set1(1.79368678507819816313E1));
+		p=V::fmadd(p, x, V::set1(7.70838733755885391666E0));
+		reg q=V::add(x, V::set1(1.12873587189167450590E1));
+		q=V::fmadd(q, x, V::set1(4.52279145837532221105E1));
+		q=V::fmadd(q, x, V::set1(8.29875266912776603211E1));
+		q=V::fmadd(q, x, V::set1(7.11544750618563894466E1));
+		q=V::fmadd(q, x, V::set1(2.31251620126765340583E1));
+
+		reg y=V::mul(x, V::div(V::mul(z, p), q));
+		y=V::fmadd(e, V::set1(-2.121944400546905827679e-4), y);
+		y=V::sub(y, V::mul(V::set1(0.5), z));
+		z=V::add(x, y);
+		return V::fmadd(e, V::set1(0.693359375), z);
+	}
+
+	static inline float64_t reduce_add(reg a)
+	{
+		float64_t lanes[V::width];
+		V::store(lanes, a);
+		float64_t r=0;
+		for (index_t l=0; l<V::width; l++)
+			r+=lanes[l];
+		return r;
+	}
+
+	static void exp(const float64_t* x, float64_t* y, index_t n)
+	{
+		const reg lo=V::set1(-708.0);
+		const reg hi=V::set1(709.0);
+		index_t i=0;
+		for (; i+V::width<=n; i+=V::width)
+		{
+			reg v=V::load(x+i);
+			int32_t in=V::in_range(v, lo, hi);
+			if (in==(1<<V::width)-1)
+				V::store(y+i, exp_reg(v));
+			else
+			{
+				float64_t lanes[V::width];
+				V::store(lanes, v);
+				V::store(y+i, exp_reg(v));
+				for (index_t l=0; l<V::width; l++)
+				{
+					if (!(in&(1<<l)))
+						y[i+l]=::exp(lanes[l]);
+				}
+			}
+		}
+		for (; i<n; i++)
+			y[i]=::exp(x[i]);
+	}
+
+	static void log(const float64_t* x, float64_t* y, index_t n)
+	{
+		const reg lo=V::set1(2.2250738585072014e-308);
+		const reg hi=V::set1(1.7976931348623157e308);
+		index_t i=0;
+		for (; i+V::width<=n; i+=V::width)
+		{
+			reg v=V::load(x+i);
+			int32_t in=V::in_range(v, lo, hi);
+			if (in==(1<<V::width)-1)
+				V::store(y+i, log_reg(v));
+			else
+			{
+				float64_t lanes[V::width];
+				V::store(lanes, v);
+				V::store(y+i, log_reg(v));
+				for (index_t l=0; l<V::width; l++)
+				{
+					if (!(in&(1<<l)))
+						y[i+l]=::log(lanes[l]);
+				}
+			}
+		}
+		for (; i<n; i++)
+			y[i]=::log(x[i]);
+	}
+
+	static void sigmoid(const float64_t* x, float64_t* y, index_t n)
+	{
+		const reg lo=V::set1(-709.0);
+		const reg hi=V::set1(708.0);
+		const reg one=V::set1(1.0);
+		index_t i=0;
+		for (; i+V::width<=n; i+=V::width)
+		{
+			reg v=V::load(x+i);
+			int32_t in=V::in_range(v, lo, hi);
+			reg s=V::div(one, V::add(one, exp_reg(V::sub(V::set1(0.0), v))));
+			if (in==(1<<V::width)-1)
+				V::store(y+i, s);
+			else
+			{
+				float64_t lanes[V::width];
+				V::store(lanes, v);
+				V::store(y+i, s);
+				for (index_t l=0; l<V::width; l++)
+				{
+					if (!(in&(1<<l)))
+						y[i+l]=1.0/(1.0+::exp(-lanes[l]));
+				}
+			}
+		}
+		for (; i<n; i++)
+			y[i]=1.0/(1.0+::exp(-x[i]));
+	}
+
+	static float64_t dot(const float64_t* a, const float64_t* b, index_t n)
+	{
+		reg s0=V::set1(0.0);
+		reg s1=V::set1(0.0);
+		index_t i=0;
+		for (; i+2*V::width<=n; i+=2*V::width)
+		{
+			s0=V::fmadd(V::load(a+i), V::load(b+i), s0);
+			s1=V::fmadd(V::load(a+i+V::width), V::load(b+i+V::width), s1);
+		}
+		for (; i+V::width<=n; i+=V::width)
+			s0=V::fmadd(V::load(a+i), V::load(b+i), s0);
+
+		float64_t r=reduce_add(V::add(s0, s1));
+		for (; i<n; i++)
+			r+=a[i]*b[i];
+		return r;
+	}
+
+	static void axpy(float64_t alpha, const float64_t* x, float64_t* y, index_t n)
+	{
+		const reg a=V::set1(alpha);
+		index_t i=0;
+		for (; i+V::width<=n; i+=V::width)
+			V::store(y+i, V::fmadd(a, V::load(x+i), V::load(y+i)));
+		for (; i<n; i++)
+			y[i]+=alpha*x[i];
+	}
+
+	static float64_t squared_distance(const float64_t* a, const float64_t* b, index_t n)
+	{
+		reg s0=V::set1(0.0);
+		reg s1=V::set1(0.0);
+		index_t i=0;
+		for (; i+2*V::width<=n; i+=2*V::width)
+		{
+			reg d0=V::sub(V::load(a+i), V::load(b+i));
+			reg d1=V::sub(V::load(a+i+V::width), V::load(b+i+V::width));
+			s0=V::fmadd(d0, d0, s0);
+			s1=V::fmadd(d1, d1, s1);
+		}
+		for (; i+V::width<=n; i+=V::width)
+		{
+			reg d=V::sub(V::load(a+i), V::load(b+i));
+			s0=V::fmadd(d, d, s0);
+		}
+
+		float64_t r=reduce_add(V::add(s0, s1));
+		for (; i<n; i++)
+			r+=(a[i]-b[i])*(a[i]-b[i]);
+		return r;
+	}
+
+	static float64_t min(const float64_t* x, index_t n)
+	{
+		float64_t r=x[0];
+		index_t i=0;
+		if (n>=V::width)
+		{
+			reg m=V::load(x);
+			for (i=V::width; i+V::width<=n; i+=V::width)
+				m=V::min(m, V::load(x+i));
+
+			float64_t lanes[V::width];
+			V::store(lanes, m);
+			for (index_t l=0; l<V::width; l++)
+				r=lanes[l]<r ? lanes[l] : r;
+		}
+		for (; i<n; i++)
+			r=x[i]<r ? x[i] : r;
+		return r;
+	}
+
+	static float64_t max(const float64_t* x, index_t n)
+	{
+		float64_t r=x[0];
+		index_t i=0;
+		if (n>=V::width)
+		{
+			reg m=V::load(x);
+			for (i=V::width; i+V::width<=n; i+=V::width)
+				m=V::max(m, V::load(x+i));
+
+			float64_t lanes[V::width];
+			V::store(lanes, m);
+			for (index_t l=0; l<V::width; l++)
+				r=lanes[l]>r ? lanes[l] : r;
+		}
+		for (; i<n; i++)
+			r=x[i]>r ? x[i] : r;
+		return r;
+	}
+};
+
+}
+}
+
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+#endif /* SIMD_KERNELS_H_ */
@@ -0,0 +1,68 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/lib/config.h>
+
+/* compiled with -mavx2 -mfma, only called if the CPU supports both */
+#ifdef HAVE_AVX2
+#include <shogun/mathematics/simd/SIMDKernels.h>
+
+#include <immintrin.h>
+
+using namespace shogun::simd;
+
+namespace
+{
+
+struct AVX2
+{
+	typedef __m256d reg;
+	typedef __m256i ireg;
+	static const index_t width=4;
+
+	static inline reg load(const float64_t* p) { return _mm256_loadu_pd(p); }
+	static inline void store(float64_t* p, reg a) { _mm256_storeu_pd(p, a); }
+	static inline reg set1(float64_t a) { return _mm256_set1_pd(a); }
+	static inline ireg set1_int(int64_t a) { return _mm256_set1_epi64x(a); }
+	static inline reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+	static inline reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+	static inline reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+	static inline reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+	static inline reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+	static inline reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+	static inline reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+	static inline reg lt_select(reg a, reg b, reg c) { return _mm256_and_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ), c); }
+	static inline ireg as_int(reg a) { return _mm256_castpd_si256(a); }
+	static inline reg as_double(ireg a) { return _mm256_castsi256_pd(a); }
+	static inline ireg add_int(ireg a, ireg b) { return _mm256_add_epi64(a, b); }
+	static inline ireg and_int(ireg a, ireg b) { return _mm256_and_si256(a, b); }
+	static inline ireg or_int(ireg a, ireg b) { return _mm256_or_si256(a, b); }
+	template <int N> static inline ireg shl(ireg a) { return _mm256_slli_epi64(a, N); }
+	template <int N> static inline ireg shr(ireg a) { return _mm256_srli_epi64(a, N); }
+
+	static inline reg round(reg a)
+	{
+		return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT|_MM_FROUND_NO_EXC);
+	}
+
+	static inline int32_t in_range(reg a, reg lo, reg hi)
+	{
+		return _mm256_movemask_pd(_mm256_and_pd(_mm256_cmp_pd(a, lo, _CMP_GE_OQ),
+			_mm256_cmp_pd(a, hi, _CMP_LE_OQ)));
+	}
+};
+
+}
+
+namespace shogun
+{
+namespace simd
+{
+const SIMDKernelTable avx2_kernels=SIMD_KERNEL_TABLE(AVX2);
+}
+}
+#endif /* HAVE_AVX2 */
@@ -0,0 +1,74 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/lib/config.h>
+
+/* compiled with -mavx512f, only called if the CPU supports it */
+#ifdef HAVE_AVX512F
+#include <shogun/mathematics/simd/SIMDKernels.h>
+
+#include <immintrin.h>
+
+using namespace shogun::simd;
+
+namespace
+{
+
+/* the unmasked min, max, roundscale and shift intrinsics of gcc pass an
+ * undefined register through, which -O2 reports as maybe uninitialized.
+ * Their zero-masking forms with all lanes selected compute the same and
+ * pass zeros instead */
+#define AVX512_ALL_LANES ((__mmask8) 0xFF)
+
+struct AVX512
+{
+	typedef __m512d reg;
+	typedef __m512i ireg;
+	static const index_t width=8;
+
+	static inline reg load(const float64_t* p) { return _mm512_loadu_pd(p); }
+	static inline void store(float64_t* p, reg a) { _mm512_storeu_pd(p, a); }
+	static inline reg set1(float64_t a) { return _mm512_set1_pd(a); }
+	static inline ireg set1_int(int64_t a) { return _mm512_set1_epi64(a); }
+	static inline reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+	static inline reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+	static inline reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+	static inline reg div(reg a, reg b) { return _mm512_div_pd(a, b); }
+	static inline reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+	static inline reg min(reg a, reg b) { return _mm512_maskz_min_pd(AVX512_ALL_LANES, a, b); }
+	static inline reg max(reg a, reg b) { return _mm512_maskz_max_pd(AVX512_ALL_LANES, a, b); }
+	static inline reg lt_select(reg a, reg b, reg c) { return _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(a, b, _CMP_LT_OQ), c); }
+	static inline ireg as_int(reg a) { return _mm512_castpd_si512(a); }
+	static inline reg as_double(ireg a) { return _mm512_castsi512_pd(a); }
+	static inline ireg add_int(ireg a, ireg b) { return _mm512_add_epi64(a, b); }
+	static inline ireg and_int(ireg a, ireg b) { return _mm512_and_si512(a, b); }
+	static inline ireg or_int(ireg a, ireg b) { return _mm512_or_si512(a, b); }
+	template <int N> static inline ireg shl(ireg a) { return _mm512_maskz_slli_epi64(AVX512_ALL_LANES, a, N); }
+	template <int N> static inline ireg shr(ireg a) { return _mm512_maskz_srli_epi64(AVX512_ALL_LANES, a, N); }
+
+	static inline reg round(reg a)
+	{
+		return _mm512_maskz_roundscale_pd(AVX512_ALL_LANES, a,
+			_MM_FROUND_TO_NEAREST_INT|_MM_FROUND_NO_EXC);
+	}
+
+	static inline int32_t in_range(reg a, reg lo, reg hi)
+	{
+		return _mm512_cmp_pd_mask(a, lo, _CMP_GE_OQ) & _mm512_cmp_pd_mask(a, hi, _CMP_LE_OQ);
+	}
+};
+
+}
+
+namespace shogun
+{
+namespace simd
+{
+const SIMDKernelTable avx512_kernels=SIMD_KERNEL_TABLE(AVX512);
+}
+}
+#endif /* HAVE_AVX512F */
@@ -0,0 +1,69 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/lib/config.h>
+
+#ifdef HAVE_SSE2
+#include <shogun/mathematics/simd/SIMDKernels.h>
+
+#include <emmintrin.h>
+
+using namespace shogun::simd;
+
+namespace
+{
+
+struct SSE2
+{
+	typedef __m128d reg;
+	typedef __m128i ireg;
+	static const index_t width=2;
+
+	static inline reg load(const float64_t* p) { return _mm_loadu_pd(p); }
+	static inline void store(float64_t* p, reg a) { _mm_storeu_pd(p, a); }
+	static inline reg set1(float64_t a) { return _mm_set1_pd(a); }
+	static inline ireg set1_int(int64_t a) { return _mm_set1_epi64x(a); }
+	static inline reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+	static inline reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+	static inline reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+	static inline reg div(reg a, reg b) { return _mm_div_pd(a, b); }
+	static inline reg fmadd(reg a, reg b, reg c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+	static inline reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+	static inline reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+	static inline reg lt_select(reg a, reg b, reg c) { return _mm_and_pd(_mm_cmplt_pd(a, b), c); }
+	static inline ireg as_int(reg a) { return _mm_castpd_si128(a); }
+	static inline reg as_double(ireg a) { return _mm_castsi128_pd(a); }
+	static inline ireg add_int(ireg a, ireg b) { return _mm_add_epi64(a, b); }
+	static inline ireg and_int(ireg a, ireg b) { return _mm_and_si128(a, b); }
+	static inline ireg or_int(ireg a, ireg b) { return _mm_or_si128(a, b); }
+	template <int N> static inline ireg shl(ireg a) { return _mm_slli_epi64(a, N); }
+	template <int N> static inline ireg shr(ireg a) { return _mm_srli_epi64(a, N); }
+
+	/* SSE2 has no rounding instruction, adding and subtracting 1.5*2^52
+	 * rounds to the nearest integer for |a|<2^51 */
+	static inline reg round(reg a)
+	{
+		const reg magic=_mm_set1_pd(6755399441055744.0);
+		return _mm_sub_pd(_mm_add_pd(a, magic), magic);
+	}
+
+	static inline int32_t in_range(reg a, reg lo, reg hi)
+	{
+		return _mm_movemask_pd(_mm_and_pd(_mm_cmpge_pd(a, lo), _mm_cmple_pd(a, hi)));
+	}
+};
+
+}
+
+namespace shogun
+{
+namespace simd
+{
+const SIMDKernelTable sse2_kernels=SIMD_KERNEL_TABLE(SSE2);
+}
+}
+#endif /* HAVE_SSE2 */
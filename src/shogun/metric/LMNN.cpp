@@ -100,7 +100,7 @@ void CLMNN::train(SGMatrix<float64_t> init_transform)
 
 		// Find current set of impostors
 		SG_DEBUG("Finding impostors.\n")
-		cur_impostors = CLMNNImpl::find_impostors(x,y,L,target_nn,iter,m_correction);
+		cur_impostors = CLMNNImpl::find_impostors(x,y,L,target_nn,iter,m_correction,m_ball_tree);
 		SG_DEBUG("Found %d impostors in the current set.\n", cur_impostors.size())
 
 		// (Sub-) gradient computation
@@ -261,6 +261,16 @@ void CLMNN::set_diagonal(const bool diagonal)
 	m_diagonal = diagonal;
 }
 
+bool CLMNN::get_ball_tree() const
+{
+	return m_ball_tree;
+}
+
+void CLMNN::set_ball_tree(const bool ball_tree)
+{
+	m_ball_tree = ball_tree;
+}
+
 CLMNNStatistics* CLMNN::get_statistics() const
 {
 	SG_REF(m_statistics);
@@ -290,6 +300,7 @@ void CLMNN::init()
 	SG_ADD(&m_obj_threshold, "obj_threshold", "Objective threshold",
 			MS_NOT_AVAILABLE)
 	SG_ADD(&m_diagonal, "m_diagonal", "Diagonal transformation", MS_NOT_AVAILABLE);
+	SG_ADD(&m_ball_tree, "ball_tree", "Ball tree impostors search", MS_NOT_AVAILABLE);
 	SG_ADD((CSGObject**) &m_statistics, "statistics", "Training statistics",
 			MS_NOT_AVAILABLE);
 
@@ -303,6 +314,7 @@ void CLMNN::init()
 	m_correction = 15;
 	m_obj_threshold = 1e-9;
 	m_diagonal = false;
+	m_ball_tree = false;
 	m_statistics = NULL;
 }
 
@@ -172,6 +172,20 @@ class CLMNN : public CSGObject
 		 */
 		void set_diagonal(const bool diagonal);
 
+		/** get whether impostors are searched with a ball tree
+		 *
+		 * @return whether impostors are searched with a ball tree
+		 */
+		bool get_ball_tree() const;
+
+		/** set whether impostors are searched with a ball tree over the
+		 * transformed features instead of comparing all pairs of examples,
+		 * which is faster when the features have few dimensions
+		 *
+		 * @param ball_tree whether impostors are searched with a ball tree
+		 */
+		void set_ball_tree(const bool ball_tree);
+
 		/** get LMNN training statistics
 		 *
 		 * @return LMNN training statistics
@@ -237,6 +251,12 @@ class CLMNN : public CSGObject
 		 */
 		bool m_diagonal;
 
+		/**
+		 * whether the exact impostors search uses a ball tree instead of
+		 * blocked pairwise distances. Its default value is false.
+		 */
+		bool m_ball_tree;
+
 		/** training statistics, @see CLMNNStatistics */
 		CLMNNStatistics* m_statistics;
 
@@ -11,10 +11,12 @@
 #include <shogun/metric/LMNNImpl.h>
 
 
-#include <shogun/multiclass/KNN.h>
+#include <shogun/multiclass/tree/BallTree.h>
+#include <shogun/multiclass/tree/KNNGraphBuilder.h>
 #include <shogun/preprocessor/PruneVarSubMean.h>
 #include <shogun/preprocessor/PCA.h>
 
+#include <algorithm>
 #include <iterator>
 
 /// useful shorthands to perform operations with Eigen matrices
@@ -22,6 +24,11 @@
 // column-wise sum of the squared elements of a matrix
 #define SUMSQCOLS(A)	((A).array().square().colwise().sum())
 
+// number of examples per block in the exact impostors search
+#define LMNN_BLOCK_SIZE	256
+// leaf size of the ball tree used in the impostors search
+#define LMNN_LEAF_SIZE	32
+
 using namespace shogun;
 using namespace Eigen;
 
@@ -43,6 +50,11 @@ bool CImpostorNode::operator<(const CImpostorNode& rhs) const
 		return example < rhs.example;
 }
 
+bool CImpostorNode::operator==(const CImpostorNode& rhs) const
+{
+	return example == rhs.example && target == rhs.target && impostor == rhs.impostor;
+}
+
 void CLMNNImpl::check_training_setup(CFeatures* features, const CLabels* labels,
 		SGMatrix<float64_t>& init_transform)
 {
@@ -79,13 +91,15 @@ SGMatrix<index_t> CLMNNImpl::find_target_nn(CDenseFeatures<float64_t>* x,
 	SGMatrix<index_t> target_neighbors(k, x->get_num_vectors());
 	SGVector<float64_t> unique_labels = y->get_unique_labels();
 	CDenseFeatures<float64_t>* features_slice = new CDenseFeatures<float64_t>();
-	CMulticlassLabels* labels_slice = new CMulticlassLabels();
 	SGVector<index_t> idxsmap(x->get_num_vectors());
 
-	// increase ref count because a KNN instance will be created for each slice, and it
-	// decreses the ref count of its labels and features when destroyed
+	// the target neighbors are the nearest neighbors within every class,
+	// found with a kd-tree, a vector is not its own target neighbor
+	CEuclideanDistance* euclidean = new CEuclideanDistance();
+	CKNNGraphBuilder* knn_graph = new CKNNGraphBuilder(k, KNNG_KD_TREE);
 	SG_REF(features_slice)
-	SG_REF(labels_slice)
+	SG_REF(euclidean)
+	SG_REF(knn_graph)
 
 	for (index_t i = 0; i < unique_labels.vlen; ++i)
 	{
@@ -105,30 +119,23 @@ SGMatrix<index_t> CLMNNImpl::find_target_nn(CDenseFeatures<float64_t>* x,
 
 		features_slice->set_feature_matrix(SGMatrix<float64_t>(slice_mat.data(), d, slice_size, false));
 
-		//FIXME the labels are not actually necessary to get the nearest neighbors, the
-		//features suffice. The labels are needed when we want to classify.
-		SGVector<float64_t> labels_vec(slice_size);
-		labels_vec.set_const(unique_labels[i]);
-		labels_slice->set_labels(labels_vec);
-
-		CKNN* knn = new CKNN(k+1, new CEuclideanDistance(features_slice, features_slice), labels_slice);
-		SGMatrix<int32_t> target_slice = knn->nearest_neighbors();
+		euclidean->init(features_slice, features_slice);
+		knn_graph->build(euclidean);
+		SGMatrix<index_t> target_slice = knn_graph->get_neighbors();
 		// sanity check
-		ASSERT(target_slice.num_rows==k+1 && target_slice.num_cols==slice_size)
+		ASSERT(target_slice.num_rows==k && target_slice.num_cols==slice_size)
 
 		for (index_t j = 0; j < target_slice.num_cols; ++j)
 		{
-			for (index_t l = 1; l < target_slice.num_rows; ++l)
-				target_neighbors(l-1, idxsmap[j]) = idxsmap[ target_slice(l,j) ];
+			for (index_t l = 0; l < target_slice.num_rows; ++l)
+				target_neighbors(l, idxsmap[j]) = idxsmap[ target_slice(l,j) ];
 		}
-
-		// clean up knn
-		SG_UNREF(knn)
 	}
 
-	// clean up features and labels
+	// clean up
+	SG_UNREF(knn_graph)
+	SG_UNREF(euclidean)
 	SG_UNREF(features_slice)
-	SG_UNREF(labels_slice)
 
 	SG_SDEBUG("Leaving CLMNNImpl::find_target_nn().\n")
 
@@ -160,7 +167,7 @@ MatrixXd CLMNNImpl::sum_outer_products(CDenseFeatures<float64_t>* x, const SGMat
 
 ImpostorsSetType CLMNNImpl::find_impostors(CDenseFeatures<float64_t>* x,
 		CMulticlassLabels* y, const MatrixXd& L, const SGMatrix<index_t> target_nn,
-		const uint32_t iter, const uint32_t correction)
+		const uint32_t iter, const uint32_t correction, bool ball_tree)
 {
 	SG_SDEBUG("Entering CLMNNImpl::find_impostors().\n")
 
@@ -189,7 +196,10 @@ ImpostorsSetType CLMNNImpl::find_impostors(CDenseFeatures<float64_t>* x,
 			"impostors set must be greater than 0\n")
 	if ((iter % correction)==0)
 	{
-		Nexact = CLMNNImpl::find_impostors_exact(LX, sqdists, y, target_nn, k);
+		if (ball_tree)
+			Nexact = CLMNNImpl::find_impostors_ball_tree(LX, sqdists, y, target_nn);
+		else
+			Nexact = CLMNNImpl::find_impostors_exact(LX, sqdists, y, target_nn, k);
 		N = Nexact;
 	}
 	else
@@ -207,8 +217,8 @@ void CLMNNImpl::update_gradient(CDenseFeatures<float64_t>* x, MatrixXd& G,
 {
 	// compute the difference sets
 	ImpostorsSetType Np_Nc, Nc_Np;
-	set_difference(Np.begin(), Np.end(), Nc.begin(), Nc.end(), inserter(Np_Nc, Np_Nc.begin()));
-	set_difference(Nc.begin(), Nc.end(), Np.begin(), Np.end(), inserter(Nc_Np, Nc_Np.begin()));
+	set_difference(Np.begin(), Np.end(), Nc.begin(), Nc.end(), back_inserter(Np_Nc));
+	set_difference(Nc.begin(), Nc.end(), Np.begin(), Np.end(), back_inserter(Nc_Np));
 
 	// map the feature matrix (each column is a feature vector) to an Eigen matrix
 	Map<const MatrixXd> X(x->get_feature_matrix().matrix, x->get_num_features(), x->get_num_vectors());
@@ -378,16 +388,15 @@ ImpostorsSetType CLMNNImpl::find_impostors_exact(MatrixXd& LX, const MatrixXd& s
 {
 	SG_SDEBUG("Entering CLMNNImpl::find_impostors_exact().\n")
 
-	// initialize empty impostors set
-	ImpostorsSetType N = ImpostorsSetType();
-
-	// get the number of examples from data
-	int32_t n = LX.cols();
 	// get the number of features
 	int32_t d = LX.rows();
-	// create Shogun features from LX to later apply subset
-	SGMatrix<float64_t> lx_mat(LX.data(), d, n, false);
-	CDenseFeatures<float64_t>* lx = new CDenseFeatures<float64_t>(lx_mat);
+	// squared norms of the examples, distances are computed from dot products
+	VectorXd sqnorms = SUMSQCOLS(LX).transpose();
+	// an example cannot be an impostor further away than the farthest target
+	VectorXd max_sqdists = sqdists.colwise().maxCoeff().transpose();
+
+	// impostors found in each block of examples
+	std::vector<ImpostorsSetType> blocks;
 
 	// get a vector with unique label values
 	SGVector<float64_t> unique = y->get_unique_labels();
@@ -401,34 +410,149 @@ ImpostorsSetType CLMNNImpl::find_impostors_exact(MatrixXd& LX, const MatrixXd& s
 		// pairwise distances are computed once
 		std::vector<index_t> gtidxs = CLMNNImpl::get_examples_gtlabel(y,unique[i]);
 
-		// get distance with features indexed by iidxs and gtidxs separated
-		CEuclideanDistance* euclidean = CLMNNImpl::setup_distance(lx,iidxs,gtidxs);
-		euclidean->set_disable_sqrt(true);
+		index_t num_iidxs = iidxs.size();
+		index_t num_gtidxs = gtidxs.size();
+		index_t num_blocks = (num_iidxs+LMNN_BLOCK_SIZE-1)/LMNN_BLOCK_SIZE;
+		size_t first_block = blocks.size();
+		blocks.resize(first_block+num_blocks);
 
-		for (int32_t j = 0; j < k; ++j)
+#pragma omp parallel for schedule(dynamic)
+		for (index_t b = 0; b < num_blocks; ++b)
 		{
-			for (std::size_t ii = 0; ii < iidxs.size(); ++ii)
+			index_t istart = b*LMNN_BLOCK_SIZE;
+			index_t iend = CMath::min(istart+LMNN_BLOCK_SIZE, num_iidxs);
+			ImpostorsSetType& N = blocks[first_block+b];
+
+			MatrixXd A(d, iend-istart);
+			for (index_t ii = istart; ii < iend; ++ii)
+				A.col(ii-istart) = LX.col(iidxs[ii]);
+
+			MatrixXd B, D;
+			for (index_t jstart = 0; jstart < num_gtidxs; jstart += LMNN_BLOCK_SIZE)
 			{
-				for (std::size_t jj = 0; jj < gtidxs.size(); ++jj)
-				{
-					// FIXME study if using upper bounded distances can be an improvement
-					float64_t distance = euclidean->distance(ii,jj);
+				index_t jend = CMath::min(jstart+LMNN_BLOCK_SIZE, num_gtidxs);
+				B.resize(d, jend-jstart);
+				for (index_t jj = jstart; jj < jend; ++jj)
+					B.col(jj-jstart) = LX.col(gtidxs[jj]);
 
-					if (distance <= sqdists(j,iidxs[ii]))
-						N.insert( CImpostorNode(iidxs[ii], target_nn(j,iidxs[ii]), gtidxs[jj]) );
+				D.noalias() = A.transpose()*B;
 
-					if (distance <= sqdists(j,gtidxs[jj]))
-						N.insert( CImpostorNode(gtidxs[jj], target_nn(j,gtidxs[jj]), iidxs[ii]) );
+				for (index_t jj = jstart; jj < jend; ++jj)
+				{
+					index_t gt = gtidxs[jj];
+					for (index_t ii = istart; ii < iend; ++ii)
+					{
+						index_t ex = iidxs[ii];
+						float64_t distance = sqnorms[ex] + sqnorms[gt] - 2*D(ii-istart,jj-jstart);
+
+						if (distance <= max_sqdists[ex])
+						{
+							for (int32_t j = 0; j < k; ++j)
+							{
+								if (distance <= sqdists(j,ex))
+									N.push_back(CImpostorNode(ex, target_nn(j,ex), gt));
+							}
+						}
+
+						if (distance <= max_sqdists[gt])
+						{
+							for (int32_t j = 0; j < k; ++j)
+							{
+								if (distance <= sqdists(j,gt))
+									N.push_back(CImpostorNode(gt, target_nn(j,gt), ex));
+							}
+						}
+					}
 				}
 			}
 		}
+	}
+
+	ImpostorsSetType N = CLMNNImpl::merge_impostors(blocks);
+
+	SG_SDEBUG("Leaving CLMNNImpl::find_impostors_exact().\n")
+
+	return N;
+}
+
+ImpostorsSetType CLMNNImpl::find_impostors_ball_tree(MatrixXd& LX, const MatrixXd& sqdists,
+		CMulticlassLabels* y, const SGMatrix<index_t> target_nn)
+{
+	SG_SDEBUG("Entering CLMNNImpl::find_impostors_ball_tree().\n")
+
+	// get the number of examples from data
+	int32_t n = LX.cols();
+	// get the number of features
+	int32_t d = LX.rows();
+	// get the number of neighbors
+	int32_t k = target_nn.num_rows;
 
-		SG_UNREF(euclidean);
+	// build the tree over the transformed features
+	SGMatrix<float64_t> lx_mat(LX.data(), d, n, false);
+	CDenseFeatures<float64_t>* lx = new CDenseFeatures<float64_t>(lx_mat);
+	SG_REF(lx);
+	CBallTree* tree = new CBallTree(LMNN_LEAF_SIZE);
+	SG_REF(tree);
+	tree->build_tree(lx);
+
+	SGVector<float64_t> labels = y->get_labels();
+	// impostors found for each example
+	std::vector<ImpostorsSetType> found(n);
+
+#pragma omp parallel for schedule(dynamic)
+	for (index_t ex = 0; ex < n; ++ex)
+	{
+		// an example cannot be an impostor further away than the farthest target;
+		// the radius is enlarged slightly so that rounding in the tree can only
+		// add candidates, which are checked below
+		float64_t max_sqdist = sqdists.col(ex).maxCoeff();
+		float64_t radius = CMath::sqrt(max_sqdist)*(1+1e-10) + 1e-10;
+		SGVector<index_t> candidates = tree->query_range(
+				SGVector<float64_t>(LX.data()+int64_t(ex)*d, d, false), radius);
+
+		ImpostorsSetType& N = found[ex];
+		for (index_t c = 0; c < candidates.vlen; ++c)
+		{
+			index_t imp = candidates[c];
+			if (labels[imp] == labels[ex])
+				continue;
+
+			float64_t distance = (LX.col(ex) - LX.col(imp)).squaredNorm();
+			for (int32_t j = 0; j < k; ++j)
+			{
+				if (distance <= sqdists(j,ex))
+					N.push_back(CImpostorNode(ex, target_nn(j,ex), imp));
+			}
+		}
 	}
 
+	SG_UNREF(tree);
 	SG_UNREF(lx);
 
-	SG_SDEBUG("Leaving CLMNNImpl::find_impostors_exact().\n")
+	ImpostorsSetType N = CLMNNImpl::merge_impostors(found);
+
+	SG_SDEBUG("Leaving CLMNNImpl::find_impostors_ball_tree().\n")
+
+	return N;
+}
+
+ImpostorsSetType CLMNNImpl::merge_impostors(std::vector<ImpostorsSetType>& sets)
+{
+	size_t num_impostors = 0;
+	for (size_t i = 0; i < sets.size(); ++i)
+		num_impostors += sets[i].size();
+
+	ImpostorsSetType N;
+	N.reserve(num_impostors);
+	for (size_t i = 0; i < sets.size(); ++i)
+	{
+		N.insert(N.end(), sets[i].begin(), sets[i].end());
+		// release the partial set right away to bound the peak memory
+		ImpostorsSetType().swap(sets[i]);
+	}
+
+	std::sort(N.begin(), N.end());
+	N.erase(std::unique(N.begin(), N.end()), N.end());
 
 	return N;
 }
@@ -445,20 +569,22 @@ ImpostorsSetType CLMNNImpl::find_impostors_approx(MatrixXd& LX, const MatrixXd&
 	SGVector<float64_t> impostors_sqdists = CLMNNImpl::compute_impostors_sqdists(LX,Nexact);
 
 	// find in the exact set of impostors computed last, the triplets that remain impostors
-	index_t i = 0;
-	for (ImpostorsSetType::iterator it = Nexact.begin(); it != Nexact.end(); ++it)
+	for (size_t i = 0; i < Nexact.size(); ++i)
 	{
-		// find in target_nn(:,it->example) the position of the target neighbor it->target
+		const CImpostorNode& node = Nexact[i];
+
+		// find in target_nn(:,node.example) the position of the target neighbor node.target
 		index_t target_idx = 0;
-		while (target_nn(target_idx, it->example)!=it->target && target_idx<target_nn.num_rows)
+		while (target_idx<target_nn.num_rows && target_nn(target_idx, node.example)!=node.target)
 			++target_idx;
 
 		REQUIRE(target_idx<target_nn.num_rows, "The index of the target neighbour in the "
 				"impostors set was not found in the target neighbours matrix. "
 				"There must be a bug in find_impostors_exact.\n")
 
-		if ( impostors_sqdists[i++] <= sqdists(target_idx, it->example) )
-			N.insert(*it);
+		// Nexact is sorted, so is N
+		if ( impostors_sqdists[i] <= sqdists(target_idx, node.example) )
+			N.push_back(node);
 	}
 
 	SG_SDEBUG("Leaving CLMNNImpl::find_impostors_approx().\n")
@@ -468,30 +594,14 @@ ImpostorsSetType CLMNNImpl::find_impostors_approx(MatrixXd& LX, const MatrixXd&
 
 SGVector<float64_t> CLMNNImpl::compute_impostors_sqdists(MatrixXd& LX, const ImpostorsSetType& Nexact)
 {
-	// get the number of examples
-	int32_t n = LX.cols();
-	// get the number of features
-	int32_t d = LX.rows();
 	// get the number of impostors
-	size_t num_impostors = Nexact.size();
+	index_t num_impostors = Nexact.size();
 
 	/// compute square distances to impostors
-
-	// create Shogun features from LX and distance
-	SGMatrix<float64_t> lx_mat(LX.data(), d, n, false);
-	CDenseFeatures<float64_t>* lx = new CDenseFeatures<float64_t>(lx_mat);
-	CEuclideanDistance* euclidean = new CEuclideanDistance(lx,lx);
-	euclidean->set_disable_sqrt(true);
-
-	// initialize vector of square distances
 	SGVector<float64_t> sqdists(num_impostors);
-	// compute square distances
-	index_t i = 0;
-	for (ImpostorsSetType::iterator it = Nexact.begin(); it != Nexact.end(); ++it)
-		sqdists[i++] = euclidean->distance(it->example,it->impostor);
-
-	// clean up distance
-	SG_UNREF(euclidean);
+#pragma omp parallel for
+	for (index_t i = 0; i < num_impostors; ++i)
+		sqdists[i] = (LX.col(Nexact[i].example) - LX.col(Nexact[i].impostor)).squaredNorm();
 
 	return sqdists;
 }
@@ -525,22 +635,3 @@ std::vector<index_t> CLMNNImpl::get_examples_gtlabel(CMulticlassLabels* y,
 
 	return idxs;
 }
-
-CEuclideanDistance* CLMNNImpl::setup_distance(CDenseFeatures<float64_t>* x,
-		std::vector<index_t>& a, std::vector<index_t>& b)
-{
-	// create new features only containing examples whose indices are in a
-	x->add_subset(SGVector<index_t>(a.data(), a.size(), false));
-	CDenseFeatures<float64_t>* afeats = new CDenseFeatures<float64_t>(x->get_feature_matrix());
-	x->remove_subset();
-
-	// create new features only containing examples whose indices are in b
-	x->add_subset(SGVector<index_t>(b.data(), b.size(), false));
-	CDenseFeatures<float64_t>* bfeats = new CDenseFeatures<float64_t>(x->get_feature_matrix());
-	x->remove_subset();
-
-	// create and return distance
-	CEuclideanDistance* euclidean = new CEuclideanDistance(afeats,bfeats);
-	return euclidean;
-}
-
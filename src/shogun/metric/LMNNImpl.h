@@ -21,7 +21,6 @@
 #include <shogun/distance/EuclideanDistance.h>
 #include <Eigen/Dense>
 
-#include <set>
 #include <vector>
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -31,7 +30,12 @@ namespace shogun
 
 struct CImpostorNode;
 
-typedef std::set<CImpostorNode> ImpostorsSetType;
+/**
+ * A set of impostors is a flat vector of impostor nodes, kept sorted and free of
+ * duplicates so that set operations can be done with the standard algorithms
+ * on sorted ranges.
+ */
+typedef std::vector<CImpostorNode> ImpostorsSetType;
 
 /**
  * Struct ImpostorNode used to represent the sets of impostors. Each of the elements
@@ -62,6 +66,15 @@ struct CImpostorNode
 	 */
 	bool operator<(const CImpostorNode& rhs) const;
 
+	/**
+	 * Two impostor nodes are equal if their example, target and impostor
+	 * indices are
+	 *
+	 * @param rhs right hand side argument of the operator
+	 * @return whether both nodes represent the same triplet
+	 */
+	bool operator==(const CImpostorNode& rhs) const;
+
 	/** example index */
 	index_t example;
 
@@ -94,8 +107,12 @@ class CLMNNImpl
 		/** sum the outer products indicated by target_nn */
 		static Eigen::MatrixXd sum_outer_products(CDenseFeatures<float64_t>* x, const SGMatrix<index_t> target_nn);
 
-		/** find the impostors that remain after applying the transformation L */
-		static ImpostorsSetType find_impostors(CDenseFeatures<float64_t>* x, CMulticlassLabels* y, const Eigen::MatrixXd& L, const SGMatrix<index_t> target_nn, const uint32_t iter, const uint32_t correction);
+		/**
+		 * find the impostors that remain after applying the transformation L; the
+		 * exact search is done with a ball tree over the transformed features if
+		 * ball_tree is true, and with blocked pairwise distances otherwise
+		 */
+		static ImpostorsSetType find_impostors(CDenseFeatures<float64_t>* x, CMulticlassLabels* y, const Eigen::MatrixXd& L, const SGMatrix<index_t> target_nn, const uint32_t iter, const uint32_t correction, bool ball_tree=false);
 
 		/** update the gradient using the last transition in the impostors sets */
 		static void update_gradient(CDenseFeatures<float64_t>* x, Eigen::MatrixXd& G, const ImpostorsSetType& Nc, const ImpostorsSetType& Np, float64_t mu);
@@ -130,9 +147,22 @@ class CLMNNImpl
 		 */
 		static SGVector<float64_t> compute_impostors_sqdists(Eigen::MatrixXd& L, const ImpostorsSetType& Nexact);
 
-		/** find impostors; variant computing the impostors exactly, using all the data */
+		/**
+		 * find impostors; variant computing the impostors exactly, using all the data.
+		 * Distances are computed in parallel for blocks of examples, so memory does
+		 * not grow with the square of the number of examples
+		 */
 		static ImpostorsSetType find_impostors_exact(Eigen::MatrixXd& LX, const Eigen::MatrixXd& sqdists, CMulticlassLabels* y, const SGMatrix<index_t> target_nn, int32_t k);
 
+		/**
+		 * find impostors; exact variant that only looks at the examples a ball tree
+		 * over LX finds within the largest target distance of every example
+		 */
+		static ImpostorsSetType find_impostors_ball_tree(Eigen::MatrixXd& LX, const Eigen::MatrixXd& sqdists, CMulticlassLabels* y, const SGMatrix<index_t> target_nn);
+
+		/** concatenate impostor sets, then sort and remove duplicates */
+		static ImpostorsSetType merge_impostors(std::vector<ImpostorsSetType>& sets);
+
 		/** find impostors; approximate variant, using the last exact set of impostors */
 		static ImpostorsSetType find_impostors_approx(Eigen::MatrixXd& LX, const Eigen::MatrixXd& sqdists, const ImpostorsSetType& Nexact, const SGMatrix<index_t> target_nn);
 
@@ -142,13 +172,6 @@ class CLMNNImpl
 		/** get the indices of the examples whose label is greater than yi */
 		static std::vector<index_t> get_examples_gtlabel(CMulticlassLabels* y, float64_t yi);
 
-		/**
-		 * create Euclidean distance where the lhs features are the features in x indexed
-		 * by the elements in a, and the rhs features are the ones indexed by b; caller
-		 * is responsible of releasing memory
-		 */
-		static CEuclideanDistance* setup_distance(CDenseFeatures<float64_t>* x, std::vector<index_t>& a, std::vector<index_t>& b);
-
 
 }; /* class CLMNNImpl */
 
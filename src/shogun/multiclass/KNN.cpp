@@ -20,6 +20,7 @@
 #include <shogun/lib/Time.h>
 #include <shogun/base/Parameter.h>
 #include <shogun/multiclass/tree/KDTree.h>
+#include <shogun/multiclass/tree/KNNGraphBuilder.h>
 #include <shogun/mathematics/eigen3.h>
 
 #ifdef HAVE_CXX11
@@ -121,49 +122,21 @@ bool CKNN::train_machine(CFeatures* data)
 
 SGMatrix<index_t> CKNN::nearest_neighbors()
 {
-	//number of examples to which kNN is applied
-	int32_t n=distance->get_num_vec_rhs();
-	//distances to train data
-	float64_t* dists=SG_MALLOC(float64_t, m_train_labels.vlen);
-	//indices to train data
-	index_t* train_idxs=SG_MALLOC(index_t, m_train_labels.vlen);
-	//pre-allocation of the nearest neighbors
-	SGMatrix<index_t> NN(m_k, n);
+	// the test examples are searched in parallel, all train examples are
+	// candidates, also if the test examples are the train examples
+	CKNNGraphBuilder* knn_graph=new CKNNGraphBuilder(m_k, KNNG_BRUTE);
+	SG_REF(knn_graph);
+	knn_graph->set_exclude_self(false);
 
 	distance->precompute_lhs();
 	distance->precompute_rhs();
 
-	//for each test example
-	for (int32_t i=0; i<n && (!CSignal::cancel_computations()); i++)
-	{
-		SG_PROGRESS(i, 0, n)
-
-		//lhs idx 0..num train examples-1 (i.e., all train examples) and rhs idx i
-		distances_lhs(dists,0,m_train_labels.vlen-1,i);
-
-		//fill in an array with 0..num train examples-1
-		for (int32_t j=0; j<m_train_labels.vlen; j++)
-			train_idxs[j]=j;
-
-		//sort the distance vector between test example i and all train examples
-		CMath::qsort_index(dists, train_idxs, m_train_labels.vlen);
-
-#ifdef DEBUG_KNN
-		SG_PRINT("\nQuick sort query %d\n", i)
-		for (int32_t j=0; j<m_k; j++)
-			SG_PRINT("%d ", train_idxs[j])
-		SG_PRINT("\n")
-#endif
-
-		//fill in the output the indices of the nearest neighbors
-		for (int32_t j=0; j<m_k; j++)
-			NN(j,i) = train_idxs[j];
-	}
+	knn_graph->build(distance);
 
 	distance->reset_precompute();
 
-	SG_FREE(train_idxs);
-	SG_FREE(dists);
+	SGMatrix<index_t> NN=knn_graph->get_neighbors();
+	SG_UNREF(knn_graph);
 
 	return NN;
 }
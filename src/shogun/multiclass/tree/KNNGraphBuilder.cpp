@@ -0,0 +1,609 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/multiclass/tree/KNNGraphBuilder.h>
+#include <shogun/multiclass/tree/KDTree.h>
+#include <shogun/multiclass/tree/BallTree.h>
+#include <shogun/multiclass/tree/KNNHeap.h>
+#include <shogun/distance/EuclideanDistance.h>
+#include <shogun/kernel/Kernel.h>
+#include <shogun/kernel/normalizer/IdentityKernelNormalizer.h>
+#include <shogun/lib/SGSparseMatrixBuilder.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/base/Parameter.h>
+#include <shogun/base/Parallel.h>
+
+#include <algorithm>
+#include <vector>
+
+/* number of vectors nearest neighbor descent joins the neighbors of before
+ * applying the found updates, bounds the memory of the updates */
+#define NN_DESCENT_BLOCK 8192
+
+using namespace shogun;
+
+namespace
+{
+	/* candidate neighbor of a vector found by nearest neighbor descent */
+	struct NeighborUpdate
+	{
+		index_t target;
+		index_t neighbor;
+		float64_t dist;
+
+		bool operator<(const NeighborUpdate& other) const
+		{
+			if (target!=other.target)
+				return target<other.target;
+			if (dist!=other.dist)
+				return dist<other.dist;
+			return neighbor<other.neighbor;
+		}
+	};
+
+	/* move up to num randomly chosen elements of from to the end of to,
+	 * skipping those to already contains */
+	void sample_into(std::vector<index_t>& from, int32_t num,
+		std::vector<index_t>& to)
+	{
+		int32_t size=from.size();
+		for (int32_t i=0; i<CMath::min(num, size); i++)
+		{
+			std::swap(from[i], from[CMath::random(i, size-1)]);
+			if (std::find(to.begin(), to.end(), from[i])==to.end())
+				to.push_back(from[i]);
+		}
+	}
+}
+
+CKNNGraphBuilder::CKNNGraphBuilder() : CSGObject()
+{
+	init();
+}
+
+CKNNGraphBuilder::CKNNGraphBuilder(int32_t k, EKNNGraphMethod method)
+: CSGObject()
+{
+	init();
+	set_k(k);
+	m_method=method;
+}
+
+CKNNGraphBuilder::~CKNNGraphBuilder()
+{
+}
+
+void CKNNGraphBuilder::init()
+{
+	m_k=1;
+	m_method=KNNG_KD_TREE;
+	m_leaf_size=10;
+	m_exclude_self=true;
+	m_max_iterations=10;
+	m_sample_rate=0.5;
+	m_tolerance=0.001;
+	m_distance=NULL;
+	m_kernel=NULL;
+	m_num_lhs=0;
+	m_num_rhs=0;
+	m_same_features=false;
+	m_num_neighbors=0;
+
+	SG_ADD(&m_k, "k", "number of neighbors", MS_AVAILABLE);
+	SG_ADD((machine_int_t*) &m_method, "method", "search method",
+		MS_NOT_AVAILABLE);
+	SG_ADD(&m_leaf_size, "leaf_size", "min number of vectors in a leaf",
+		MS_NOT_AVAILABLE);
+	SG_ADD(&m_exclude_self, "exclude_self",
+		"whether vectors are not their own neighbors", MS_NOT_AVAILABLE);
+	SG_ADD(&m_max_iterations, "max_iterations",
+		"max number of iterations of nearest neighbor descent",
+		MS_NOT_AVAILABLE);
+	SG_ADD(&m_sample_rate, "sample_rate",
+		"fraction of the neighbors joined per iteration", MS_NOT_AVAILABLE);
+	SG_ADD(&m_tolerance, "tolerance",
+		"relative number of changed neighbors to stop at", MS_NOT_AVAILABLE);
+	SG_ADD(&m_neighbors, "neighbors", "neighbor indices", MS_NOT_AVAILABLE);
+	SG_ADD(&m_distances, "distances", "neighbor distances",
+		MS_NOT_AVAILABLE);
+}
+
+void CKNNGraphBuilder::set_k(int32_t k)
+{
+	REQUIRE(k>0, "Number of neighbors (%d) must be positive\n", k)
+	m_k=k;
+}
+
+void CKNNGraphBuilder::set_leaf_size(int32_t leaf_size)
+{
+	REQUIRE(leaf_size>0, "Leaf size (%d) must be positive\n", leaf_size)
+	m_leaf_size=leaf_size;
+}
+
+void CKNNGraphBuilder::set_max_iterations(int32_t max_iterations)
+{
+	REQUIRE(max_iterations>=0, "Max number of iterations (%d) must not be "
+		"negative\n", max_iterations)
+	m_max_iterations=max_iterations;
+}
+
+void CKNNGraphBuilder::set_sample_rate(float64_t sample_rate)
+{
+	REQUIRE(sample_rate>0 && sample_rate<=1, "Sample rate (%f) must be in "
+		"(0,1]\n", sample_rate)
+	m_sample_rate=sample_rate;
+}
+
+void CKNNGraphBuilder::set_tolerance(float64_t tolerance)
+{
+	REQUIRE(tolerance>=0, "Tolerance (%f) must not be negative\n", tolerance)
+	m_tolerance=tolerance;
+}
+
+void CKNNGraphBuilder::build(CDistance* distance)
+{
+	REQUIRE(distance, "No distance given\n")
+
+	CFeatures* lhs=distance->get_lhs();
+	CFeatures* rhs=distance->get_rhs();
+	REQUIRE(lhs && rhs, "Distance is not initialized with features\n")
+
+	m_distance=distance;
+	build_graph(lhs, rhs);
+	m_distance=NULL;
+
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
+}
+
+void CKNNGraphBuilder::build(CKernel* kernel)
+{
+	REQUIRE(kernel, "No kernel given\n")
+
+	CFeatures* lhs=kernel->get_lhs();
+	CFeatures* rhs=kernel->get_rhs();
+	REQUIRE(lhs && lhs==rhs, "Kernel has to be initialized with the same "
+		"features on both sides\n")
+
+	m_kernel=kernel;
+	m_kernel_diag=SGVector<float64_t>(kernel->get_num_vec_lhs());
+
+#pragma omp parallel for num_threads(parallel->get_num_threads())
+	for (int32_t i=0; i<m_kernel_diag.vlen; i++)
+		m_kernel_diag[i]=kernel->kernel(i, i);
+
+	build_graph(lhs, rhs);
+	m_kernel=NULL;
+	m_kernel_diag=SGVector<float64_t>();
+
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
+}
+
+void CKNNGraphBuilder::build_graph(CFeatures* lhs, CFeatures* rhs)
+{
+	m_num_lhs=lhs->get_num_vectors();
+	m_num_rhs=rhs->get_num_vectors();
+	m_same_features=m_exclude_self && lhs==rhs;
+
+	int32_t max_k=m_same_features ? m_num_lhs-1 : m_num_lhs;
+	REQUIRE(max_k>0, "Not enough vectors (%d) to find neighbors among\n",
+		m_num_lhs)
+
+	m_num_neighbors=m_k;
+	if (m_k>max_k)
+	{
+		SG_WARNING("Number of neighbors (%d) is larger than the number of "
+			"vectors they are found among, using %d\n", m_k, max_k)
+		m_num_neighbors=max_k;
+	}
+
+	m_neighbors=SGMatrix<index_t>(m_num_neighbors, m_num_rhs);
+	m_distances=SGMatrix<float64_t>(m_num_neighbors, m_num_rhs);
+
+	EKNNGraphMethod method=m_method;
+	if (method==KNNG_NN_DESCENT && !m_same_features)
+	{
+		SG_DEBUG("Nearest neighbor descent needs neighbors among the same "
+			"vectors, searching a kd-tree\n")
+		method=KNNG_KD_TREE;
+	}
+
+	EDistanceType tree_distance=D_UNKNOWN;
+	if (method==KNNG_KD_TREE || method==KNNG_BALL_TREE)
+	{
+		tree_distance=get_tree_distance(lhs, rhs, m_distance, m_kernel);
+		if (tree_distance==D_UNKNOWN)
+		{
+			SG_WARNING("Trees do not support the %s or features, comparing "
+				"all %d x %d pairs of vectors instead, KNNG_NN_DESCENT scales "
+				"to more vectors\n", m_kernel ? "kernel" : "distance",
+				m_num_lhs, m_num_rhs)
+			method=KNNG_BRUTE;
+		}
+	}
+
+	switch (method)
+	{
+		case KNNG_KD_TREE:
+		case KNNG_BALL_TREE:
+			build_tree((CDenseFeatures<float64_t>*) lhs,
+				(CDenseFeatures<float64_t>*) rhs, tree_distance, method);
+			break;
+		case KNNG_BRUTE:
+			build_brute();
+			break;
+		case KNNG_NN_DESCENT:
+			build_nn_descent();
+			break;
+	}
+}
+
+bool CKNNGraphBuilder::is_tree_supported(CDistance* distance)
+{
+	REQUIRE(distance, "No distance given\n")
+
+	CFeatures* lhs=distance->get_lhs();
+	CFeatures* rhs=distance->get_rhs();
+	REQUIRE(lhs && rhs, "Distance is not initialized with features\n")
+
+	bool supported=get_tree_distance(lhs, rhs, distance, NULL)!=D_UNKNOWN;
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
+	return supported;
+}
+
+bool CKNNGraphBuilder::is_tree_supported(CKernel* kernel)
+{
+	REQUIRE(kernel, "No kernel given\n")
+
+	CFeatures* lhs=kernel->get_lhs();
+	CFeatures* rhs=kernel->get_rhs();
+	REQUIRE(lhs && rhs, "Kernel is not initialized with features\n")
+
+	bool supported=get_tree_distance(lhs, rhs, NULL, kernel)!=D_UNKNOWN;
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
+	return supported;
+}
+
+EDistanceType CKNNGraphBuilder::get_tree_distance(CFeatures* lhs,
+	CFeatures* rhs, CDistance* distance, CKernel* kernel)
+{
+	if (lhs->get_feature_class()!=C_DENSE || lhs->get_feature_type()!=F_DREAL ||
+		rhs->get_feature_class()!=C_DENSE || rhs->get_feature_type()!=F_DREAL)
+		return D_UNKNOWN;
+
+	if (kernel)
+	{
+		// the distance induced by the linear kernel is the Euclidean one
+		CKernelNormalizer* normalizer=kernel->get_normalizer();
+		bool identity=dynamic_cast<CIdentityKernelNormalizer*>(normalizer)!=NULL;
+		SG_UNREF(normalizer);
+
+		if (kernel->get_kernel_type()==K_LINEAR && identity)
+			return D_EUCLIDEAN;
+
+		return D_UNKNOWN;
+	}
+
+	EDistanceType type=distance->get_distance_type();
+	if (type==D_EUCLIDEAN || type==D_MANHATTAN)
+		return type;
+
+	return D_UNKNOWN;
+}
+
+void CKNNGraphBuilder::build_tree(CDenseFeatures<float64_t>* lhs,
+	CDenseFeatures<float64_t>* rhs, EDistanceType type, EKNNGraphMethod method)
+{
+	CNbodyTree* tree=NULL;
+	if (method==KNNG_KD_TREE)
+		tree=new CKDTree(m_leaf_size, type);
+	else
+		tree=new CBallTree(m_leaf_size, type);
+	SG_REF(tree);
+
+	// a vector is found as its own nearest neighbor
+	int32_t num_query=m_same_features ? m_num_neighbors+1 : m_num_neighbors;
+	tree->build_tree(lhs);
+	tree->query_knn(rhs, num_query);
+	SGMatrix<index_t> indices=tree->get_knn_indices();
+	SGMatrix<float64_t> dists=tree->get_knn_dists();
+
+	// trees find the actual distances, not the squared ones
+	bool squared=m_distance && type==D_EUCLIDEAN &&
+		((CEuclideanDistance*) m_distance)->get_disable_sqrt();
+
+#pragma omp parallel for num_threads(parallel->get_num_threads())
+	for (int32_t i=0; i<m_num_rhs; i++)
+	{
+		int32_t l=0;
+		for (int32_t j=0; j<num_query && l<m_num_neighbors; j++)
+		{
+			// a duplicate may come first, so skip the vector by its index
+			if (m_same_features && indices(j,i)==i)
+				continue;
+
+			m_neighbors(l,i)=indices(j,i);
+			m_distances(l,i)=squared ? CMath::sq(dists(j,i)) : dists(j,i);
+			l++;
+		}
+	}
+
+	SG_UNREF(tree);
+}
+
+void CKNNGraphBuilder::build_brute()
+{
+#pragma omp parallel for num_threads(parallel->get_num_threads())
+	for (int32_t i=0; i<m_num_rhs; i++)
+	{
+		CKNNHeap heap(m_num_neighbors);
+		for (int32_t j=0; j<m_num_lhs; j++)
+		{
+			if (m_same_features && j==i)
+				continue;
+
+			heap.push(j, distance(j, i));
+		}
+
+		SGVector<float64_t> dists=heap.get_dists();
+		SGVector<index_t> indices=heap.get_indices();
+		memcpy(m_distances.get_column_vector(i), dists.vector,
+			sizeof(float64_t)*m_num_neighbors);
+		memcpy(m_neighbors.get_column_vector(i), indices.vector,
+			sizeof(index_t)*m_num_neighbors);
+	}
+}
+
+void CKNNGraphBuilder::build_nn_descent()
+{
+	int32_t n=m_num_rhs;
+	int32_t k=m_num_neighbors;
+	int32_t sample_size=CMath::max(1, (int32_t) CMath::ceil(m_sample_rate*k));
+
+	// whether a neighbor was added since it was last joined
+	SGMatrix<bool> is_new(k, n);
+	m_neighbors.set_const(-1);
+	m_distances.set_const(CMath::INFTY);
+
+	// random initial neighbors, drawn sequentially to be reproducible
+	SGMatrix<index_t> initial(k, n);
+	for (int32_t i=0; i<n; i++)
+	{
+		for (int32_t j=0; j<k; j++)
+		{
+			index_t candidate;
+			do
+			{
+				candidate=CMath::random(0, n-1);
+			}
+			while (candidate==i ||
+				std::find(initial.get_column_vector(i),
+					initial.get_column_vector(i)+j, candidate)!=
+					initial.get_column_vector(i)+j);
+
+			initial(j,i)=candidate;
+		}
+	}
+
+#pragma omp parallel for num_threads(parallel->get_num_threads())
+	for (int32_t i=0; i<n; i++)
+	{
+		for (int32_t j=0; j<k; j++)
+			heap_push(i, initial(j,i), distance(initial(j,i), i),
+				is_new.get_column_vector(i));
+	}
+
+	for (int32_t iter=0; iter<m_max_iterations; iter++)
+	{
+		// sample the new neighbors to join, they are old afterwards
+		std::vector<std::vector<index_t> > new_candidates(n);
+		std::vector<std::vector<index_t> > old_candidates(n);
+		std::vector<std::vector<index_t> > new_reverse(n);
+		std::vector<std::vector<index_t> > old_reverse(n);
+		std::vector<index_t> fresh;
+		for (int32_t i=0; i<n; i++)
+		{
+			fresh.clear();
+			for (int32_t j=0; j<k; j++)
+			{
+				if (is_new(j,i))
+					fresh.push_back(j);
+				else
+					old_candidates[i].push_back(m_neighbors(j,i));
+			}
+
+			for (int32_t s=0; s<CMath::min(sample_size, (int32_t) fresh.size()); s++)
+			{
+				std::swap(fresh[s], fresh[CMath::random(s, (int32_t) fresh.size()-1)]);
+				is_new(fresh[s],i)=false;
+				new_candidates[i].push_back(m_neighbors(fresh[s],i));
+			}
+
+			for (size_t j=0; j<new_candidates[i].size(); j++)
+				new_reverse[new_candidates[i][j]].push_back(i);
+			for (size_t j=0; j<old_candidates[i].size(); j++)
+				old_reverse[old_candidates[i][j]].push_back(i);
+		}
+
+		// vectors which have a vector as neighbor are joined with it as well
+		for (int32_t i=0; i<n; i++)
+		{
+			sample_into(new_reverse[i], sample_size, new_candidates[i]);
+			sample_into(old_reverse[i], sample_size, old_candidates[i]);
+		}
+		new_reverse.clear();
+		old_reverse.clear();
+
+		int64_t num_updates=0;
+		for (int32_t start=0; start<n; start+=NN_DESCENT_BLOCK)
+		{
+			int32_t end=CMath::min(start+NN_DESCENT_BLOCK, n);
+
+			// joins only read the heaps, the updates are applied afterwards
+			std::vector<NeighborUpdate> updates;
+#pragma omp parallel num_threads(parallel->get_num_threads())
+			{
+				std::vector<NeighborUpdate> local_updates;
+				NeighborUpdate update;
+
+#pragma omp for schedule(dynamic, 64)
+				for (int32_t v=start; v<end; v++)
+				{
+					const std::vector<index_t>& new_v=new_candidates[v];
+					const std::vector<index_t>& old_v=old_candidates[v];
+					for (size_t a=0; a<new_v.size(); a++)
+					{
+						for (size_t b=a+1; b<new_v.size()+old_v.size(); b++)
+						{
+							index_t u=b<new_v.size() ? new_v[b] : old_v[b-new_v.size()];
+							if (u==new_v[a])
+								continue;
+
+							update.dist=distance(new_v[a], u);
+							if (update.dist<m_distances(0,new_v[a]))
+							{
+								update.target=new_v[a];
+								update.neighbor=u;
+								local_updates.push_back(update);
+							}
+							if (update.dist<m_distances(0,u))
+							{
+								update.target=u;
+								update.neighbor=new_v[a];
+								local_updates.push_back(update);
+							}
+						}
+					}
+				}
+
+#pragma omp critical
+				updates.insert(updates.end(), local_updates.begin(),
+					local_updates.end());
+			}
+
+			// sorting groups the updates of a vector and makes the result
+			// independent of the number of threads
+			std::sort(updates.begin(), updates.end());
+			std::vector<int64_t> offsets;
+			for (int64_t u=0; u<(int64_t) updates.size(); u++)
+			{
+				if (u==0 || updates[u].target!=updates[u-1].target)
+					offsets.push_back(u);
+			}
+			offsets.push_back(updates.size());
+
+#pragma omp parallel for num_threads(parallel->get_num_threads()) \
+	reduction(+:num_updates)
+			for (int64_t g=0; g<(int64_t) offsets.size()-1; g++)
+			{
+				for (int64_t u=offsets[g]; u<offsets[g+1]; u++)
+				{
+					const NeighborUpdate& update=updates[u];
+					if (heap_push(update.target, update.neighbor, update.dist,
+						is_new.get_column_vector(update.target)))
+						num_updates++;
+				}
+			}
+		}
+
+		SG_DEBUG("Nearest neighbor descent iteration %d changed %ld "
+			"neighbors\n", iter, num_updates)
+		if (num_updates<=m_tolerance*k*n)
+			break;
+	}
+
+	sort_neighbors();
+}
+
+bool CKNNGraphBuilder::heap_push(int32_t idx, index_t neighbor,
+	float64_t dist, bool* is_new)
+{
+	index_t* indices=m_neighbors.get_column_vector(idx);
+	float64_t* dists=m_distances.get_column_vector(idx);
+	int32_t k=m_num_neighbors;
+
+	if (dist>=dists[0])
+		return false;
+
+	for (int32_t j=0; j<k; j++)
+	{
+		if (indices[j]==neighbor)
+			return false;
+	}
+
+	// replace the farthest neighbor and sift it down
+	int32_t i=0;
+	while (true)
+	{
+		int32_t child=2*i+1;
+		if (child>=k)
+			break;
+		if (child+1<k && dists[child+1]>dists[child])
+			child++;
+		if (dists[child]<=dist)
+			break;
+
+		indices[i]=indices[child];
+		dists[i]=dists[child];
+		is_new[i]=is_new[child];
+		i=child;
+	}
+
+	indices[i]=neighbor;
+	dists[i]=dist;
+	is_new[i]=true;
+
+	return true;
+}
+
+void CKNNGraphBuilder::sort_neighbors()
+{
+#pragma omp parallel for num_threads(parallel->get_num_threads())
+	for (int32_t i=0; i<m_num_rhs; i++)
+		CMath::qsort_index(m_distances.get_column_vector(i),
+			m_neighbors.get_column_vector(i), m_num_neighbors);
+}
+
+float64_t CKNNGraphBuilder::distance(int32_t idx_a, int32_t idx_b) const
+{
+	if (m_kernel)
+	{
+		float64_t dist=m_kernel_diag[idx_a]-2*m_kernel->kernel(idx_a, idx_b)+
+			m_kernel_diag[idx_b];
+
+		return CMath::sqrt(CMath::max(dist, 0.0));
+	}
+
+	return m_distance->distance(idx_a, idx_b);
+}
+
+SGSparseMatrix<float64_t> CKNNGraphBuilder::get_graph() const
+{
+	int32_t k=m_neighbors.num_rows;
+	SGSparseMatrixBuilder<float64_t> builder(m_num_lhs,
+		int64_t(k)*m_neighbors.num_cols);
+
+	SGVector<index_t> indices(k);
+	SGVector<float64_t> dists(k);
+	for (int32_t i=0; i<m_neighbors.num_cols; i++)
+	{
+		memcpy(indices.vector, m_neighbors.get_column_vector(i),
+			sizeof(index_t)*k);
+		memcpy(dists.vector, m_distances.get_column_vector(i),
+			sizeof(float64_t)*k);
+		CMath::qsort_index(indices.vector, dists.vector, k);
+
+		for (int32_t j=0; j<k; j++)
+			builder.add_entry(indices[j], dists[j]);
+		builder.finish_vector();
+	}
+
+	return builder.get_matrix();
+}
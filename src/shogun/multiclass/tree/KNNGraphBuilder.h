@@ -0,0 +1,269 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef _KNNGRAPHBUILDER_H__
+#define _KNNGRAPHBUILDER_H__
+
+#include <shogun/lib/config.h>
+
+#include <shogun/base/SGObject.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/SGSparseMatrix.h>
+#include <shogun/distance/Distance.h>
+#include <shogun/features/DenseFeatures.h>
+
+namespace shogun
+{
+
+class CKernel;
+
+/** methods CKNNGraphBuilder finds the nearest neighbors with */
+enum EKNNGraphMethod
+{
+	/** compare every pair of vectors, exact, any distance or kernel */
+	KNNG_BRUTE = 0,
+	/** exact search in a kd-tree, needs dense real valued features and
+	 * Euclidean or Manhattan distances */
+	KNNG_KD_TREE = 1,
+	/** exact search in a ball tree, same requirements as KNNG_KD_TREE */
+	KNNG_BALL_TREE = 2,
+	/** approximate nearest neighbor descent, any distance or kernel, but
+	 * only for the neighbors of vectors among themselves */
+	KNNG_NN_DESCENT = 3
+};
+
+/** @brief Builds the graph of the k nearest neighbors of a set of vectors,
+ * which kNN classification, metric learning and the manifold learning
+ * converters all start from.
+ *
+ * For every vector on the right hand side of a distance, the k nearest
+ * vectors on its left hand side are found. If both sides are the same
+ * features, vectors are not their own neighbors (see set_exclude_self()).
+ * A kernel may be given instead of a distance, neighbors are then found
+ * with the distance it induces \f$\sqrt{k(a,a)-2k(a,b)+k(b,b)}\f$.
+ *
+ * All methods run the queries in parallel. KNNG_KD_TREE and KNNG_BALL_TREE
+ * are exact and fall back to KNNG_BRUTE, with a warning, for distances,
+ * kernels or features the trees do not support (see is_tree_supported()). KNNG_NN_DESCENT is approximate and scales to large data:
+ * starting from random neighbors it repeatedly checks whether neighbors of
+ * neighbors are closer, until less than tolerance*k*n neighbors change.
+ * cf. Dong, W., Moses, C., & Li, K. (2011). Efficient k-nearest neighbor
+ * graph construction for generic similarity measures. WWW 2011.
+ *
+ * The graph is available as a k x n matrix of neighbor indices sorted by
+ * distance (get_neighbors(), get_distances()) or as a sparse matrix in
+ * compressed sparse row layout with the distances as entries (get_graph()).
+ */
+class CKNNGraphBuilder : public CSGObject
+{
+public:
+	/** default constructor */
+	CKNNGraphBuilder();
+
+	/** constructor
+	 *
+	 * @param k number of neighbors
+	 * @param method search method
+	 */
+	CKNNGraphBuilder(int32_t k, EKNNGraphMethod method=KNNG_KD_TREE);
+
+	/** destructor */
+	virtual ~CKNNGraphBuilder();
+
+	/** find the nearest neighbors with a distance
+	 *
+	 * @param distance distance initialized with the vectors
+	 */
+	void build(CDistance* distance);
+
+	/** find the nearest neighbors with the distance induced by a kernel,
+	 * which has to be initialized with the same features on both sides
+	 *
+	 * @param kernel kernel initialized with the vectors
+	 */
+	void build(CKernel* kernel);
+
+	/** @param distance distance initialized with the vectors
+	 * @return whether KNNG_KD_TREE and KNNG_BALL_TREE can search the
+	 * neighbors with the distance instead of falling back to KNNG_BRUTE
+	 */
+	static bool is_tree_supported(CDistance* distance);
+
+	/** @param kernel kernel initialized with the vectors
+	 * @return whether KNNG_KD_TREE and KNNG_BALL_TREE can search the
+	 * neighbors with the distance induced by the kernel instead of falling
+	 * back to KNNG_BRUTE, which is only the case for the linear kernel
+	 */
+	static bool is_tree_supported(CKernel* kernel);
+
+	/** @return indices of the neighbors, one column per vector, nearest
+	 * neighbor first
+	 */
+	SGMatrix<index_t> get_neighbors() const { return m_neighbors; }
+
+	/** @return distances to the neighbors, in the order of get_neighbors() */
+	SGMatrix<float64_t> get_distances() const { return m_distances; }
+
+	/** get the graph as a sparse matrix, one row per vector, whose entries
+	 * are the distances to its neighbors in ascending order of their indices
+	 *
+	 * @return sparse matrix of neighbor distances
+	 */
+	SGSparseMatrix<float64_t> get_graph() const;
+
+	/** @param k number of neighbors */
+	void set_k(int32_t k);
+
+	/** @return number of neighbors */
+	int32_t get_k() const { return m_k; }
+
+	/** @param method search method */
+	void set_method(EKNNGraphMethod method) { m_method=method; }
+
+	/** @return search method */
+	EKNNGraphMethod get_method() const { return m_method; }
+
+	/** @param leaf_size min number of vectors in a leaf of the trees */
+	void set_leaf_size(int32_t leaf_size);
+
+	/** @return min number of vectors in a leaf of the trees */
+	int32_t get_leaf_size() const { return m_leaf_size; }
+
+	/** @param exclude_self whether vectors are not their own neighbors
+	 * if both sides are the same features (true by default)
+	 */
+	void set_exclude_self(bool exclude_self) { m_exclude_self=exclude_self; }
+
+	/** @return whether vectors are not their own neighbors */
+	bool get_exclude_self() const { return m_exclude_self; }
+
+	/** @param max_iterations max number of iterations of KNNG_NN_DESCENT */
+	void set_max_iterations(int32_t max_iterations);
+
+	/** @return max number of iterations of KNNG_NN_DESCENT */
+	int32_t get_max_iterations() const { return m_max_iterations; }
+
+	/** @param sample_rate fraction of the neighbors KNNG_NN_DESCENT joins
+	 * per iteration, in (0,1]
+	 */
+	void set_sample_rate(float64_t sample_rate);
+
+	/** @return fraction of the neighbors KNNG_NN_DESCENT joins */
+	float64_t get_sample_rate() const { return m_sample_rate; }
+
+	/** @param tolerance KNNG_NN_DESCENT stops once less than tolerance*k*n
+	 * neighbors change in an iteration
+	 */
+	void set_tolerance(float64_t tolerance);
+
+	/** @return tolerance of KNNG_NN_DESCENT */
+	float64_t get_tolerance() const { return m_tolerance; }
+
+	/** @return name of the SGSerializable */
+	virtual const char* get_name() const { return "KNNGraphBuilder"; }
+
+private:
+	/** register parameters */
+	void init();
+
+	/** find the neighbors, the distance or kernel and the sizes are set */
+	void build_graph(CFeatures* lhs, CFeatures* rhs);
+
+	/** exact search of a tree built on the lhs vectors
+	 *
+	 * @param lhs vectors in the tree
+	 * @param rhs query vectors
+	 * @param type distance type of the tree
+	 * @param method KNNG_KD_TREE or KNNG_BALL_TREE
+	 */
+	void build_tree(CDenseFeatures<float64_t>* lhs,
+		CDenseFeatures<float64_t>* rhs, EDistanceType type,
+		EKNNGraphMethod method);
+
+	/** exact search comparing all pairs of vectors */
+	void build_brute();
+
+	/** approximate search by nearest neighbor descent */
+	void build_nn_descent();
+
+	/** distance type of a tree the neighbors can be found with,
+	 * D_UNKNOWN if none
+	 *
+	 * @param lhs vectors in the tree
+	 * @param rhs query vectors
+	 * @param distance distance to search with, or NULL
+	 * @param kernel kernel whose induced distance is searched with, or NULL
+	 */
+	static EDistanceType get_tree_distance(CFeatures* lhs, CFeatures* rhs,
+		CDistance* distance, CKernel* kernel);
+
+	/** distance between lhs vector idx_a and rhs vector idx_b */
+	float64_t distance(int32_t idx_a, int32_t idx_b) const;
+
+	/** push a neighbor into the max-heap of a vector in column idx of
+	 * m_neighbors and m_distances
+	 *
+	 * @return whether the neighbor was added
+	 */
+	bool heap_push(int32_t idx, index_t neighbor, float64_t dist,
+		bool* is_new);
+
+	/** sort the columns of m_neighbors by distance */
+	void sort_neighbors();
+
+private:
+	/** number of neighbors */
+	int32_t m_k;
+
+	/** search method */
+	EKNNGraphMethod m_method;
+
+	/** min number of vectors in a leaf of the trees */
+	int32_t m_leaf_size;
+
+	/** whether vectors are not their own neighbors */
+	bool m_exclude_self;
+
+	/** max number of iterations of nearest neighbor descent */
+	int32_t m_max_iterations;
+
+	/** fraction of the neighbors joined per iteration */
+	float64_t m_sample_rate;
+
+	/** relative number of changed neighbors to stop at */
+	float64_t m_tolerance;
+
+	/** neighbor indices, one column per vector */
+	SGMatrix<index_t> m_neighbors;
+
+	/** neighbor distances, one column per vector */
+	SGMatrix<float64_t> m_distances;
+
+	/** distance used while building */
+	CDistance* m_distance;
+
+	/** kernel used while building */
+	CKernel* m_kernel;
+
+	/** kernel values k(a,a) while building with a kernel */
+	SGVector<float64_t> m_kernel_diag;
+
+	/** number of lhs vectors while building */
+	int32_t m_num_lhs;
+
+	/** number of rhs vectors while building */
+	int32_t m_num_rhs;
+
+	/** whether self matches are excluded while building */
+	bool m_same_features;
+
+	/** number of neighbors searched while building */
+	int32_t m_num_neighbors;
+};
+}
+#endif /* _KNNGRAPHBUILDER_H__ */
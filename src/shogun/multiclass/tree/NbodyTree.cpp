@@ -30,6 +30,7 @@
 
 #include <shogun/multiclass/tree/NbodyTree.h>
 #include <shogun/distributions/KernelDensity.h>
+#include <shogun/base/Parallel.h>
 
 using namespace shogun;
 
@@ -67,13 +68,15 @@ void CNbodyTree::query_knn(CDenseFeatures<float64_t>* data, int32_t k)
 	m_knn_indices=SGMatrix<index_t>(k,qfeats.num_cols);
 	int32_t dim=qfeats.num_rows;
 
+	bnode_t* root=NULL;
+	if (m_root)
+		root=dynamic_cast<bnode_t*>(m_root);
+
+	// queries only read the tree, every one fills its own column
+#pragma omp parallel for num_threads(parallel->get_num_threads())
 	for (int32_t i=0;i<qfeats.num_cols;i++)
 	{
 		CKNNHeap* heap=new CKNNHeap(k);
-		bnode_t* root=NULL;
-		if (m_root)
-			root=dynamic_cast<bnode_t*>(m_root);
-
 		float64_t mdist=min_dist(root,qfeats.matrix+i*dim,dim);
 		query_knn_single(heap,mdist,root,qfeats.matrix+i*dim,dim);
 		memcpy(m_knn_dists.matrix+i*k,heap->get_dists(),k*sizeof(float64_t));
@@ -83,6 +86,26 @@ void CNbodyTree::query_knn(CDenseFeatures<float64_t>* data, int32_t k)
 	}
 }
 
+SGVector<index_t> CNbodyTree::query_range(SGVector<float64_t> point, float64_t radius)
+{
+	REQUIRE(point.vlen==m_data.num_rows,"query vector dimension should be same as training data dimension\n")
+	REQUIRE(radius>=0,"radius (%f) should be non-negative\n",radius)
+
+	DynArray<index_t> result;
+	bnode_t* root=NULL;
+	if (m_root)
+		root=dynamic_cast<bnode_t*>(m_root);
+
+	if (root && min_dist(root,point.vector,point.vlen)<=radius)
+		query_range_single(root,point.vector,point.vlen,radius,result);
+
+	SGVector<index_t> indices(result.get_num_elements());
+	for (int32_t i=0;i<indices.vlen;i++)
+		indices[i]=result[i];
+
+	return indices;
+}
+
 SGVector<float64_t> CNbodyTree::log_kernel_density(SGMatrix<float64_t> test, EKernelType kernel, float64_t h, float64_t atol, float64_t rtol)
 {
 	int32_t dim=m_data.num_rows;
@@ -198,6 +221,34 @@ void CNbodyTree::query_knn_single(CKNNHeap* heap, float64_t mdist, bnode_t* node
 	SG_UNREF(cright);
 }
 
+void CNbodyTree::query_range_single(bnode_t* node, float64_t* arr, int32_t dim, float64_t radius, DynArray<index_t>& result)
+{
+	if (node->data.is_leaf)
+	{
+		index_t start=node->data.start_idx;
+		index_t end=node->data.end_idx;
+
+		for (int32_t i=start;i<=end;i++)
+		{
+			if (distance(m_vec_id[i],arr,dim)<=radius)
+				result.push_back(m_vec_id[i]);
+		}
+
+		return;
+	}
+
+	bnode_t* cleft=node->left();
+	bnode_t* cright=node->right();
+
+	if (min_dist(cleft,arr,dim)<=radius)
+		query_range_single(cleft,arr,dim,radius,result);
+	if (min_dist(cright,arr,dim)<=radius)
+		query_range_single(cright,arr,dim,radius,result);
+
+	SG_UNREF(cleft);
+	SG_UNREF(cright);
+}
+
 float64_t CNbodyTree::distance(index_t vec, float64_t* arr, int32_t dim)
 {
 	float64_t ret=0;
@@ -39,6 +39,7 @@
 #include <shogun/distance/Distance.h>
 #include <shogun/multiclass/tree/NbodyTreeNodeData.h>
 #include <shogun/multiclass/tree/KNNHeap.h>
+#include <shogun/base/DynArray.h>
 #include <shogun/features/DenseFeatures.h>
 
 namespace shogun
@@ -84,6 +85,15 @@ public:
 	 */
 	void query_knn(CDenseFeatures<float64_t>* data, int32_t k);
 
+	/** find all vectors within a distance of a query vector. Queries do
+	 * not modify the tree and can be run in parallel
+	 *
+	 * @param point query vector
+	 * @param radius maximum distance to the query vector (inclusive)
+	 * @return indices of the vectors within radius
+	 */
+	SGVector<index_t> query_range(SGVector<float64_t> point, float64_t radius);
+
 	/** get log of kernel density at query points
 	 *
 	 * @param test query points at which kernel density is to be calculated
@@ -215,6 +225,16 @@ private:
 	 */
 	void query_knn_single(CKNNHeap* heap, float64_t min_dist, bnode_t* node, float64_t* arr, int32_t dim);
 
+	/** collect the vectors of a subtree within radius of a query vector
+	 *
+	 * @param node current node
+	 * @param arr query vector
+	 * @param dim dimension of query vector
+	 * @param radius maximum distance to the query vector
+	 * @param result indices of vectors found so far
+	 */
+	void query_range_single(bnode_t* node, float64_t* arr, int32_t dim, float64_t radius, DynArray<index_t>& result);
+
 	/** find kde at each query point
 	 *
 	 * @param node current node
@@ -141,14 +141,14 @@ CDenseFeatures< float64_t >* CAutoencoder::transform(
 	CDenseFeatures< float64_t >* data)
 {
 	SGMatrix<float64_t> hidden_activation = forward_propagate(data, m_num_layers-2);
-	return new CDenseFeatures<float64_t>(hidden_activation);
+	return new CDenseFeatures<float64_t>(hidden_activation.clone());
 }
 
 CDenseFeatures< float64_t >* CAutoencoder::reconstruct(
 	CDenseFeatures< float64_t >* data)
 {
 	SGMatrix<float64_t> reconstructed = forward_propagate(data);
-	return new CDenseFeatures<float64_t>(reconstructed);
+	return new CDenseFeatures<float64_t>(reconstructed.clone());
 }
 
 float64_t CAutoencoder::compute_error(SGMatrix< float64_t > targets)
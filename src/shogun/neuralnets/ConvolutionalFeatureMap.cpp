@@ -37,32 +37,112 @@
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/eigen3.h>
+#include <shogun/mathematics/simd/SIMD.h>
+
+#include <vector>
 
 using namespace shogun;
 
+/* the samples of a mini-batch are split into at most this many blocks,
+ * which are processed in parallel. The gradients are summed up per block,
+ * so that the result does not depend on the number of threads */
+#define CONV_NUM_BATCH_BLOCKS 32
+
+typedef Eigen::Map<Eigen::MatrixXd> EMatrix;
+typedef Eigen::Map<const Eigen::MatrixXd, 0, Eigen::OuterStride<> > EFilters;
+
+namespace
+{
+
+/** input channels of a map, the images of sample j start at
+ * activations[k]+j*stride[k] */
+struct ConvInputChannels
+{
+	std::vector<float64_t*> activations;
+	std::vector<float64_t*> gradients;
+	std::vector<index_t> stride;
+
+	ConvInputChannels(CDynamicObjectArray* layers,
+		SGVector<int32_t> input_indices, int32_t input_num_neurons)
+	{
+		for (int32_t l=0; l<input_indices.vlen; l++)
+		{
+			CNeuralLayer* layer =
+				(CNeuralLayer*)layers->element(input_indices[l]);
+
+			SGMatrix<float64_t> A = layer->get_activations();
+			SGMatrix<float64_t> G;
+			if (!layer->is_input())
+				G = layer->get_activation_gradients();
+
+			int32_t num_maps = layer->get_num_neurons()/input_num_neurons;
+			for (int32_t m=0; m<num_maps; m++)
+			{
+				activations.push_back(A.matrix+m*input_num_neurons);
+				gradients.push_back(G.matrix ?
+					G.matrix+m*input_num_neurons : NULL);
+				stride.push_back(A.num_rows);
+			}
+
+			SG_UNREF(layer);
+		}
+	}
+
+	int32_t size() const { return activations.size(); }
+
+	bool has_gradients() const
+	{
+		for (int32_t k=0; k<size(); k++)
+		{
+			if (gradients[k])
+				return true;
+		}
+		return false;
+	}
+
+	void get_sample(int32_t j, std::vector<float64_t*>& inputs,
+		std::vector<float64_t*>& input_gradients) const
+	{
+		for (int32_t k=0; k<size(); k++)
+		{
+			inputs[k] = activations[k]+j*stride[k];
+			input_gradients[k] = gradients[k] ? gradients[k]+j*stride[k] : NULL;
+		}
+	}
+};
+
+}
+
 CConvolutionalFeatureMap::CConvolutionalFeatureMap(
 	int32_t input_width, int32_t input_height,
 	int32_t radius_x, int32_t radius_y,
 	int32_t stride_x, int32_t stride_y,
 	int32_t index,
 	EConvMapActivationFunction function,
-	ENLAutoencoderPosition autoencoder_position) :
+	ENLAutoencoderPosition autoencoder_position,
+	int32_t num_maps) :
 		m_input_width(input_width), m_input_height(input_height),
 		m_radius_x(radius_x), m_radius_y(radius_y),
 		m_stride_x(stride_x), m_stride_y(stride_y),
 		m_index(index),
 		m_activation_function(function),
+		m_num_maps(num_maps),
 		m_autoencoder_position(autoencoder_position)
 {
 	if (m_autoencoder_position == NLAP_NONE)
 	{
 		m_output_width = m_input_width/m_stride_x;
 		m_output_height = m_input_height/m_stride_y;
+		m_num_positions_x = m_output_width;
+		m_num_positions_y = m_output_height;
 	}
 	else
 	{
 		m_output_width = m_input_width;
 		m_output_height = m_input_height;
+		m_num_positions_x = (m_input_width+m_stride_x-1)/m_stride_x;
+		m_num_positions_y = (m_input_height+m_stride_y-1)/m_stride_y;
 	}
 
 	m_input_num_neurons = m_input_width*m_input_height;
@@ -79,52 +159,105 @@ void CConvolutionalFeatureMap::compute_activations(
 	CDynamicObjectArray* layers,
 	SGVector< int32_t > input_indices,
 	SGMatrix<float64_t> activations)
+{
+	compute_activations_impl(parameters, layers, input_indices, activations,
+		0, 0, SGMatrix<float64_t>(), SGMatrix<float64_t>());
+}
+
+void CConvolutionalFeatureMap::compute_activations(
+	SGVector< float64_t > parameters,
+	CDynamicObjectArray* layers,
+	SGVector< int32_t > input_indices,
+	SGMatrix<float64_t> activations,
+	int32_t pooling_width, int32_t pooling_height,
+	SGMatrix<float64_t> pooled_activations,
+	SGMatrix<float64_t> max_indices)
+{
+	REQUIRE(pooled_activations.num_cols==activations.num_cols,
+		"Number of pooled samples (%d) has to match the batch size (%d)\n",
+		pooled_activations.num_cols, activations.num_cols);
+
+	compute_activations_impl(parameters, layers, input_indices, activations,
+		pooling_width, pooling_height, pooled_activations, max_indices);
+}
+
+void CConvolutionalFeatureMap::compute_activations_impl(
+	SGVector< float64_t > parameters,
+	CDynamicObjectArray* layers,
+	SGVector< int32_t > input_indices,
+	SGMatrix<float64_t> activations,
+	int32_t pooling_width, int32_t pooling_height,
+	SGMatrix<float64_t> pooled_activations,
+	SGMatrix<float64_t> max_indices)
 {
 	int32_t batch_size = activations.num_cols;
 
-	float64_t bias = parameters[0];
-	for (int32_t i=0; i<m_output_num_neurons; i++)
-	{
-		for (int32_t j=0; j<batch_size; j++)
-		{
-			activations(i+m_row_offset,j) = bias;
-		}
-	}
+	ConvInputChannels channels(layers, input_indices, m_input_num_neurons);
+	int32_t num_channels = channels.size();
+	int32_t num_weights = num_channels*m_filter_height*m_filter_width;
+	int32_t num_parameters_per_map = 1+num_weights;
+	int32_t num_positions = m_num_positions_x*m_num_positions_y;
 
-	int32_t weights_index_offset = 1;
-	for (int32_t l=0; l<input_indices.vlen; l++)
-	{
-		CNeuralLayer* layer =
-			(CNeuralLayer*)layers->element(input_indices[l]);
+	REQUIRE(parameters.vlen>=m_num_maps*num_parameters_per_map,
+		"Expected %d parameters, got %d\n", m_num_maps*num_parameters_per_map,
+		parameters.vlen);
+
+	// filters of all maps as columns
+	EFilters W(parameters.vector+1, num_weights, m_num_maps,
+		Eigen::OuterStride<>(num_parameters_per_map));
 
-		int32_t num_maps = layer->get_num_neurons()/m_input_num_neurons;
+	bool identity_positions = num_positions==m_output_num_neurons;
+	int32_t num_blocks = CMath::min(batch_size, CONV_NUM_BATCH_BLOCKS);
+
+	#pragma omp parallel for
+	for (int32_t b=0; b<num_blocks; b++)
+	{
+		std::vector<float64_t*> inputs(num_channels);
+		std::vector<float64_t*> input_gradients(num_channels);
+		Eigen::MatrixXd cols(num_positions, num_weights);
+		Eigen::MatrixXd conv(num_positions, m_num_maps);
 
-		for (int32_t m=0; m<num_maps; m++)
+		for (int32_t j=b*batch_size/num_blocks; j<(b+1)*batch_size/num_blocks; j++)
 		{
-			SGMatrix<float64_t> weights_matrix(parameters.vector+weights_index_offset,
-				m_filter_height, m_filter_width, false);
-			weights_index_offset += m_filter_height*m_filter_width;
+			channels.get_sample(j, inputs, input_gradients);
+			im2col(&inputs[0], num_channels, cols.data());
+			conv.noalias() = cols*W;
 
-			convolve(layer->get_activations(), weights_matrix, activations,
-				false, false, m*m_input_num_neurons, m_row_offset);
-		}
+			for (int32_t m=0; m<m_num_maps; m++)
+			{
+				float64_t bias = parameters[m*num_parameters_per_map];
+				float64_t* a = &activations(m_row_offset+m*m_output_num_neurons, j);
 
-		SG_UNREF(layer);
-	}
+				if (identity_positions)
+				{
+					for (int32_t i=0; i<num_positions; i++)
+						a[i] = conv(i,m)+bias;
+				}
+				else
+				{
+					for (int32_t i=0; i<m_output_num_neurons; i++)
+						a[i] = bias;
+					for (int32_t i=0; i<num_positions; i++)
+						a[position_to_output_index(i)] += conv(i,m);
+				}
 
-	if (m_activation_function==CMAF_LOGISTIC)
-	{
-		for (int32_t i=0; i<m_output_num_neurons; i++)
-			for (int32_t j=0; j<batch_size; j++)
-				activations(i+m_row_offset,j) =
-					1.0/(1.0+CMath::exp(-1.0*activations(i+m_row_offset,j)));
-	}
-	else if (m_activation_function==CMAF_RECTIFIED_LINEAR)
-	{
-		for (int32_t i=0; i<m_output_num_neurons; i++)
-			for (int32_t j=0; j<batch_size; j++)
-				activations(i+m_row_offset,j) =
-					CMath::max<float64_t>(0, activations(i+m_row_offset,j));
+				if (m_activation_function==CMAF_LOGISTIC)
+					simd::sigmoid(a, a, m_output_num_neurons);
+				else if (m_activation_function==CMAF_RECTIFIED_LINEAR)
+				{
+					for (int32_t i=0; i<m_output_num_neurons; i++)
+						a[i] = CMath::max<float64_t>(0, a[i]);
+				}
+			}
+
+			if (pooled_activations.num_cols>0)
+			{
+				pool_sample(activations.get_column_vector(j),
+					pooling_width, pooling_height,
+					pooled_activations.get_column_vector(j),
+					max_indices.get_column_vector(j));
+			}
+		}
 	}
 }
 
@@ -138,59 +271,95 @@ void CConvolutionalFeatureMap::compute_gradients(
 {
 	int32_t batch_size = activation_gradients.num_cols;
 
-	if (m_activation_function==CMAF_LOGISTIC)
+	ConvInputChannels channels(layers, input_indices, m_input_num_neurons);
+	int32_t num_channels = channels.size();
+	int32_t num_weights = num_channels*m_filter_height*m_filter_width;
+	int32_t num_parameters_per_map = 1+num_weights;
+	int32_t num_positions = m_num_positions_x*m_num_positions_y;
+	bool propagate = channels.has_gradients();
+
+	REQUIRE(parameters.vlen>=m_num_maps*num_parameters_per_map,
+		"Expected %d parameters, got %d\n", m_num_maps*num_parameters_per_map,
+		parameters.vlen);
+
+	EFilters W(parameters.vector+1, num_weights, m_num_maps,
+		Eigen::OuterStride<>(num_parameters_per_map));
+
+	int32_t num_blocks = CMath::min(batch_size, CONV_NUM_BATCH_BLOCKS);
+
+	// gradients of the filters (one column per map) and biases of each block
+	SGMatrix<float64_t> block_weight_gradients(num_weights*m_num_maps,
+		CMath::max(num_blocks, 1));
+	SGMatrix<float64_t> block_bias_gradients(m_num_maps,
+		CMath::max(num_blocks, 1));
+	block_weight_gradients.zero();
+	block_bias_gradients.zero();
+
+	#pragma omp parallel for
+	for (int32_t b=0; b<num_blocks; b++)
 	{
-		for (int32_t i=0; i<m_output_num_neurons; i++)
+		std::vector<float64_t*> inputs(num_channels);
+		std::vector<float64_t*> input_gradients(num_channels);
+		Eigen::MatrixXd cols(num_positions, num_weights);
+		Eigen::MatrixXd local_gradients(num_positions, m_num_maps);
+		EMatrix WG(block_weight_gradients.get_column_vector(b),
+			num_weights, m_num_maps);
+		float64_t* bias_gradients = block_bias_gradients.get_column_vector(b);
+
+		for (int32_t j=b*batch_size/num_blocks; j<(b+1)*batch_size/num_blocks; j++)
 		{
-			for (int32_t j=0; j<batch_size; j++)
+			for (int32_t m=0; m<m_num_maps; m++)
 			{
-				activation_gradients(i+m_row_offset,j) *=
-					activation_gradients(i+m_row_offset,j) *
-					(1.0-activation_gradients(i+m_row_offset,j));
+				int32_t offset = m_row_offset+m*m_output_num_neurons;
+				float64_t* g = &activation_gradients(offset, j);
+				const float64_t* a = &activations(offset, j);
+
+				if (m_activation_function==CMAF_LOGISTIC)
+				{
+					for (int32_t i=0; i<m_output_num_neurons; i++)
+						g[i] *= a[i]*(1.0-a[i]);
+				}
+				else if (m_activation_function==CMAF_RECTIFIED_LINEAR)
+				{
+					for (int32_t i=0; i<m_output_num_neurons; i++)
+						if (a[i]==0)
+							g[i] = 0;
+				}
+
+				for (int32_t i=0; i<m_output_num_neurons; i++)
+					bias_gradients[m] += g[i];
+
+				for (int32_t i=0; i<num_positions; i++)
+					local_gradients(i,m) = g[position_to_output_index(i)];
 			}
-		}
-	}
-	else if (m_activation_function==CMAF_RECTIFIED_LINEAR)
-	{
-		for (int32_t i=0; i<m_output_num_neurons; i++)
-			for (int32_t j=0; j<batch_size; j++)
-				if (activations(i+m_row_offset,j)==0)
-					activation_gradients(i+m_row_offset,j) = 0;
-	}
 
-	float64_t bias_gradient = 0;
-	for (int32_t i=0; i<m_output_num_neurons; i++)
-		for (int32_t j=0; j<batch_size; j++)
-			bias_gradient += activation_gradients(i+m_row_offset,j);
+			channels.get_sample(j, inputs, input_gradients);
+			im2col(&inputs[0], num_channels, cols.data());
+			WG.noalias() += cols.transpose()*local_gradients;
 
-	parameter_gradients[0] = bias_gradient;
+			if (propagate)
+			{
+				cols.noalias() = local_gradients*W.transpose();
+				col2im(cols.data(), num_channels, &input_gradients[0]);
+			}
+		}
+	}
 
-	int32_t weights_index_offset = 1;
-	for (int32_t l=0; l<input_indices.vlen; l++)
+	for (int32_t m=0; m<m_num_maps; m++)
 	{
-		CNeuralLayer* layer =
-			(CNeuralLayer*)layers->element(input_indices[l]);
+		float64_t* map_gradients =
+			parameter_gradients.vector+m*num_parameters_per_map;
 
-		int32_t num_maps = layer->get_num_neurons()/m_input_num_neurons;
+		map_gradients[0] = 0;
+		for (int32_t i=0; i<num_weights; i++)
+			map_gradients[1+i] = 0;
 
-		for (int32_t m=0; m<num_maps; m++)
+		for (int32_t b=0; b<num_blocks; b++)
 		{
-			SGMatrix<float64_t> W(parameters.vector+weights_index_offset,
-				m_filter_height, m_filter_width, false);
-			SGMatrix<float64_t> WG(parameter_gradients.vector+weights_index_offset,
-				m_filter_height, m_filter_width, false);
-			weights_index_offset += m_filter_height*m_filter_width;
-
-			compute_weight_gradients(layer->get_activations(),
-				activation_gradients, WG, m*m_input_num_neurons, m_row_offset);
-
-			if (!layer->is_input())
-				convolve(activation_gradients, W,
-					layer->get_activation_gradients(), true, false,
-					m_row_offset, m*m_input_num_neurons);
+			map_gradients[0] += block_bias_gradients(m,b);
+			for (int32_t i=0; i<num_weights; i++)
+				map_gradients[1+i] += block_weight_gradients(m*num_weights+i,b);
 		}
-
-		SG_UNREF(layer);
 	}
 }
 
@@ -200,156 +369,168 @@ void CConvolutionalFeatureMap::pool_activations(
 	SGMatrix< float64_t > pooled_activations,
 	SGMatrix< float64_t > max_indices)
 {
-	int32_t result_row_offset = m_row_offset;
+	#pragma omp parallel for
+	for (int32_t i=0; i<pooled_activations.num_cols; i++)
+	{
+		pool_sample(activations.get_column_vector(i),
+			pooling_width, pooling_height,
+			pooled_activations.get_column_vector(i),
+			max_indices.get_column_vector(i));
+	}
+}
+
+void CConvolutionalFeatureMap::pool_sample(const float64_t* activations,
+	int32_t pooling_width, int32_t pooling_height,
+	float64_t* pooled_activations, float64_t* max_indices)
+{
 	int32_t result_width = m_output_width;
 	int32_t result_height = m_output_height;
 
 	if (m_autoencoder_position == NLAP_NONE)
 	{
-		result_row_offset /= (pooling_width*pooling_height);
 		result_width /= pooling_width;
 		result_height /= pooling_height;
 	}
 
-	for (int32_t i=0; i<pooled_activations.num_cols; i++)
+	for (int32_t m=0; m<m_num_maps; m++)
 	{
-		SGMatrix<float64_t> image(
-			activations.matrix+i*activations.num_rows + m_row_offset,
-			m_output_height, m_output_width, false);
+		int32_t row_offset = m_row_offset+m*m_output_num_neurons;
+		int32_t result_row_offset = row_offset;
+		if (m_autoencoder_position == NLAP_NONE)
+			result_row_offset /= (pooling_width*pooling_height);
 
-		SGMatrix<float64_t> result(
-			pooled_activations.matrix+i*pooled_activations.num_rows + result_row_offset,
-			result_height, result_width, false);
-
-		SGMatrix<float64_t> indices(
-			max_indices.matrix+i*max_indices.num_rows + result_row_offset,
-			result_height, result_width, false);
+		const float64_t* image = activations+row_offset;
+		float64_t* result = pooled_activations+result_row_offset;
+		float64_t* indices = max_indices+result_row_offset;
 
 		if (m_autoencoder_position != NLAP_NONE)
 		{
-			result.zero();
-			indices.set_const(-1.0);
+			for (int32_t i=0; i<result_width*result_height; i++)
+			{
+				result[i] = 0;
+				indices[i] = -1.0;
+			}
 		}
 
 		for (int32_t x=0; x<m_output_width; x+=pooling_width)
 		{
 			for (int32_t y=0; y<m_output_height; y+=pooling_height)
 			{
-				float64_t max = image(y,x);
-				int32_t max_index = m_row_offset+y+x*image.num_rows;
+				float64_t max = image[y+x*m_output_height];
+				int32_t max_index = row_offset+y+x*m_output_height;
 
 				for (int32_t x1=x; x1<x+pooling_width; x1++)
 				{
 					for (int32_t y1=y; y1<y+pooling_height; y1++)
 					{
-						if (image(y1,x1) > max)
+						if (image[y1+x1*m_output_height] > max)
 						{
-							max = image(y1,x1);
-							max_index = m_row_offset+y1+x1*image.num_rows;
+							max = image[y1+x1*m_output_height];
+							max_index = row_offset+y1+x1*m_output_height;
 						}
 					}
 				}
-				if (m_autoencoder_position == NLAP_NONE)
-				{
-					result(y/pooling_height, x/pooling_width) = max;
-					indices(y/pooling_height, x/pooling_width) = max_index;
-				}
-				else
-				{
-					result(y, x) = max;
-					indices(y, x) = max_index;
-				}
+
+				int32_t r = m_autoencoder_position == NLAP_NONE ?
+					y/pooling_height + (x/pooling_width)*result_height :
+					y + x*result_height;
+				result[r] = max;
+				indices[r] = max_index;
 			}
 		}
 	}
 }
 
-void CConvolutionalFeatureMap::convolve(
-	SGMatrix< float64_t > inputs,
-	SGMatrix< float64_t > weights,
-	SGMatrix< float64_t > outputs,
-	bool flip,
-	bool reset_output,
-	int32_t inputs_row_offset,
- 	int32_t outputs_row_offset)
+void CConvolutionalFeatureMap::im2col(const float64_t* const* inputs,
+	int32_t num_channels, float64_t* cols)
 {
-	for (int32_t i=0; i<outputs.num_cols; i++)
-	{
-		SGMatrix<float64_t> image(
-			inputs.matrix+i*inputs.num_rows + inputs_row_offset,
-			m_input_height, m_input_width, false);
+	int32_t num_positions = m_num_positions_x*m_num_positions_y;
 
-		SGMatrix<float64_t> result(
-			outputs.matrix+i*outputs.num_rows + outputs_row_offset,
-			m_output_height, m_output_width, false);
-
-		for (int32_t x=0; x<m_input_width; x+=m_stride_x)
+	for (int32_t c=0; c<num_channels; c++)
+	{
+		const float64_t* image = inputs[c];
+		for (int32_t wx=0; wx<m_filter_width; wx++)
 		{
-			for (int32_t y=0; y<m_input_height; y+=m_stride_y)
+			for (int32_t wy=0; wy<m_filter_height; wy++)
 			{
-				int32_t res_x = m_autoencoder_position == NLAP_NONE ? x/m_stride_x : x;
-				int32_t res_y = m_autoencoder_position == NLAP_NONE ? y/m_stride_y : y;
+				int32_t k = (c*m_filter_width+wx)*m_filter_height+wy;
+				float64_t* col = cols+k*num_positions;
 
-				float64_t sum = reset_output ? 0 : result(res_y,res_x);
-				for (int32_t x1=x-m_radius_x; x1<=x+m_radius_x; x1++)
+				// weight (wy,wx) is applied to the pixel at this offset
+				int32_t dx = m_radius_x-wx;
+				int32_t dy = m_radius_y-wy;
+
+				for (int32_t px=0; px<m_num_positions_x; px++)
 				{
-					for (int32_t y1=y-m_radius_y; y1<=y+m_radius_y; y1++)
+					float64_t* col_x = col+px*m_num_positions_y;
+					int32_t x1 = px*m_stride_x+dx;
+					if (x1<0 || x1>=m_input_width)
 					{
-						if (x1>=0 && y1>=0 && x1<image.num_cols && y1<image.num_rows)
-						{
-							if (flip)
-								sum +=
-									weights(y1-y+m_radius_y,x1-x+m_radius_x)*image(y1,x1);
-							else
-								sum +=
-									weights(m_radius_y-y1+y,m_radius_x-x1+x)*image(y1,x1);
-						}
+						for (int32_t py=0; py<m_num_positions_y; py++)
+							col_x[py] = 0;
+						continue;
+					}
+
+					const float64_t* image_x = image+x1*m_input_height;
+					for (int32_t py=0; py<m_num_positions_y; py++)
+					{
+						int32_t y1 = py*m_stride_y+dy;
+						col_x[py] = (y1>=0 && y1<m_input_height) ? image_x[y1] : 0;
 					}
 				}
-				result(res_y,res_x) = sum;
 			}
 		}
 	}
 }
 
-void CConvolutionalFeatureMap::compute_weight_gradients(
-	SGMatrix< float64_t > inputs,
-	SGMatrix< float64_t > local_gradients,
-	SGMatrix< float64_t > weight_gradients,
-	int32_t inputs_row_offset,
- 	int32_t local_gradients_row_offset)
+void CConvolutionalFeatureMap::col2im(const float64_t* cols,
+	int32_t num_channels, float64_t* const* inputs)
 {
-	weight_gradients.zero();
-	for (int32_t i=0; i<local_gradients.num_cols; i++)
-	{
-		SGMatrix<float64_t> image(
-			inputs.matrix+i*inputs.num_rows + inputs_row_offset,
-			m_input_height, m_input_width, false);
+	int32_t num_positions = m_num_positions_x*m_num_positions_y;
 
-		SGMatrix<float64_t> LG_image(
-			local_gradients.matrix+i*local_gradients.num_rows
-			+ local_gradients_row_offset, m_output_height, m_output_width, false);
+	for (int32_t c=0; c<num_channels; c++)
+	{
+		float64_t* image = inputs[c];
+		if (!image)
+			continue;
 
-		for (int32_t x=0; x<m_input_width; x+=m_stride_x)
+		for (int32_t wx=0; wx<m_filter_width; wx++)
 		{
-			for (int32_t y=0; y<m_input_height; y+=m_stride_y)
+			for (int32_t wy=0; wy<m_filter_height; wy++)
 			{
-				for (int32_t x1=x-m_radius_x; x1<=x+m_radius_x; x1++)
+				int32_t k = (c*m_filter_width+wx)*m_filter_height+wy;
+				const float64_t* col = cols+k*num_positions;
+
+				int32_t dx = m_radius_x-wx;
+				int32_t dy = m_radius_y-wy;
+
+				for (int32_t px=0; px<m_num_positions_x; px++)
 				{
-					for (int32_t y1=y-m_radius_y; y1<=y+m_radius_y; y1++)
+					int32_t x1 = px*m_stride_x+dx;
+					if (x1<0 || x1>=m_input_width)
+						continue;
+
+					const float64_t* col_x = col+px*m_num_positions_y;
+					float64_t* image_x = image+x1*m_input_height;
+					for (int32_t py=0; py<m_num_positions_y; py++)
 					{
-						if (x1>=0 && y1>=0 && x1<image.num_cols && y1<image.num_rows)
-						{
-							if (m_autoencoder_position == NLAP_NONE)
-								weight_gradients(m_radius_y-y1+y,m_radius_x-x1+x) +=
-									LG_image(y/m_stride_y,x/m_stride_x)*image(y1,x1);
-							else
-								weight_gradients(m_radius_y-y1+y,m_radius_x-x1+x) +=
-									LG_image(y,x)*image(y1,x1);
-						}
+						int32_t y1 = py*m_stride_y+dy;
+						if (y1>=0 && y1<m_input_height)
+							image_x[y1] += col_x[py];
 					}
 				}
 			}
 		}
 	}
 }
+
+int32_t CConvolutionalFeatureMap::position_to_output_index(int32_t index) const
+{
+	int32_t px = index/m_num_positions_y;
+	int32_t py = index%m_num_positions_y;
+
+	if (m_autoencoder_position == NLAP_NONE)
+		return py+px*m_output_height;
+	else
+		return py*m_stride_y+px*m_stride_x*m_output_height;
+}
@@ -60,7 +60,13 @@ template <class T> class SGMatrix;
 class CDynamicObjectArray;
 
 /** @brief Handles convolution and gradient calculation for a single feature
- * map in a convolutional neural network
+ * map, or a group of consecutive feature maps, in a convolutional neural
+ * network
+ *
+ * The convolutions are computed as matrix products: the input patches of
+ * each sample are unfolded into a matrix (im2col) which is multiplied with
+ * the filters of all maps at once. The samples of a mini-batch are
+ * processed in parallel.
  */
 class CConvolutionalFeatureMap
 {
@@ -78,13 +84,17 @@ public:
 	 * its outputs in.
 	 * @param function Activation function
 	 * @param autoencoder_position Autoencoder position
+	 * @param num_maps Number of consecutive maps, starting at index, that
+	 * are handled together. Their parameters are expected one after another
+	 * in the parameter vector.
 	 */
 	CConvolutionalFeatureMap(int32_t input_width, int32_t input_height,
 			int32_t radius_x, int32_t radius_y,
 			int32_t stride_x=1, int32_t stride_y=1,
 			int32_t index=0,
 			EConvMapActivationFunction function = CMAF_IDENTITY,
-			ENLAutoencoderPosition autoencoder_position = NLAP_NONE);
+			ENLAutoencoderPosition autoencoder_position = NLAP_NONE,
+			int32_t num_maps=1);
 
 	/** Computes the activations of the feature map
 	 *
@@ -101,6 +111,29 @@ public:
 			SGVector<int32_t> input_indices,
 			SGMatrix<float64_t> activations);
 
+	/** Computes the activations of the feature map and applies max pooling
+	 * to them, while the activations of each sample are still in cache
+	 *
+	 * @param parameters Vector of parameters for the map
+	 * @param layers The layers array that forms the network in which the map
+	 * is being used
+	 * @param input_indices Indices of the layers that are connected to the map
+	 * as input
+	 * @param activations Matrix in which the activations are to be stored
+	 * @param pooling_width Width of the pooling region
+	 * @param pooling_height Height of the pooling region
+	 * @param pooled_activations Result of the pooling process
+	 * @param max_indices Row indices of the max elements for each pooling region
+	 */
+	void compute_activations(SGVector<float64_t> parameters,
+			CDynamicObjectArray* layers,
+			SGVector<int32_t> input_indices,
+			SGMatrix<float64_t> activations,
+			int32_t pooling_width,
+			int32_t pooling_height,
+			SGMatrix<float64_t> pooled_activations,
+			SGMatrix<float64_t> max_indices);
+
 	/** Computes the gradients with respect to the parameters and the inputs to
 	 * the map
 	 *
@@ -135,41 +168,62 @@ public:
 			SGMatrix<float64_t> max_indices);
 
 protected:
-	/** Perfoms convolution
+	/** Computes the activations, and pools them if pooled_activations is
+	 * not empty
+	 */
+	void compute_activations_impl(SGVector<float64_t> parameters,
+			CDynamicObjectArray* layers,
+			SGVector<int32_t> input_indices,
+			SGMatrix<float64_t> activations,
+			int32_t pooling_width,
+			int32_t pooling_height,
+			SGMatrix<float64_t> pooled_activations,
+			SGMatrix<float64_t> max_indices);
+
+	/** Applies max pooling to the activations of a single sample
+	 *
+	 * @param activations Activations of the sample
+	 * @param pooling_width Width of the pooling region
+	 * @param pooling_height Height of the pooling region
+	 * @param pooled_activations Pooled activations of the sample
+	 * @param max_indices Row indices of the max elements of the sample
+	 */
+	void pool_sample(const float64_t* activations,
+			int32_t pooling_width,
+			int32_t pooling_height,
+			float64_t* pooled_activations,
+			float64_t* max_indices);
+
+	/** Unfolds the input patches of a single sample into a matrix with one
+	 * row per position the filters are applied at and one column per filter
+	 * weight (im2col)
 	 *
-	 * @param inputs Inputs matrix. Each column in the matrix is treated as an
-	 * image in column major format
-	 * @param weights Convolution filter
-	 * @param outputs Output matrix
-	 * @param flip If true the weights are flipped, performing cross-correlation
-	 * instead of convolution
-	 * @param reset_output true the output is reset to zero before performing
-	 * convolution
-	 * @param inputs_row_offset Index of the row at which the input image starts
-	 * @param outputs_row_offset Index of the row at which the output image starts
+	 * @param inputs Input images of the sample, one per channel
+	 * @param num_channels Number of input channels
+	 * @param cols Column major matrix of size
+	 * num_positions x num_channels*filter_height*filter_width
 	 */
-	void convolve(SGMatrix<float64_t> inputs,
-			SGMatrix<float64_t> weights,
-			SGMatrix<float64_t> outputs,
-			bool flip,
-			bool reset_output,
-			int32_t inputs_row_offset,
- 			int32_t outputs_row_offset);
-
-	/** Computes the gradients of the error with respect to the weights, for a
-	 * particular input matrix
+	void im2col(const float64_t* const* inputs, int32_t num_channels,
+			float64_t* cols);
+
+	/** Adds a matrix in the layout of im2col() back onto the input images,
+	 * i.e. each entry is added to the input pixel it was taken from
 	 *
-	 * @param inputs Inputs matrix
-	 * @param local_gradients Gradients with respect the map's pre-activations
-	 * @param weight_gradients Matrix to store the gradients in
-	 * @param inputs_row_offset Offset for accessing the rows of the inputs matrix
-	 * @param local_gradients_row_offset Offset for accessing the rows of the local gradients matrix
+	 * @param cols Column major matrix of size
+	 * num_positions x num_channels*filter_height*filter_width
+	 * @param num_channels Number of input channels
+	 * @param inputs Input images of the sample, one per channel. Channels
+	 * that are NULL are skipped.
 	 */
-	void compute_weight_gradients(SGMatrix<float64_t> inputs,
-			SGMatrix<float64_t> local_gradients,
-			SGMatrix<float64_t> weight_gradients,
-			int32_t inputs_row_offset,
- 			int32_t local_gradients_row_offset);
+	void col2im(const float64_t* cols, int32_t num_channels,
+			float64_t* const* inputs);
+
+	/** @return row of the output image that the convolution at position
+	 * index of im2col() is stored in
+	 *
+	 * @param index Position index
+	 */
+	int32_t position_to_output_index(int32_t index) const;
 
 protected:
 	/** Width of the input */
@@ -219,6 +273,15 @@ protected:
 	/** Height of the convolution filter */
 	int32_t m_filter_height;
 
+	/** Number of maps handled together */
+	int32_t m_num_maps;
+
+	/** Number of positions the filter is applied at along the x axis */
+	int32_t m_num_positions_x;
+
+	/** Number of positions the filter is applied at along the y axis */
+	int32_t m_num_positions_y;
+
 	/** For autoencoders, specifies the position of the layer in the autoencoder,
 	 * i.e an encoding layer or a decoding layer. Default value is NLAP_NONE
 	 */
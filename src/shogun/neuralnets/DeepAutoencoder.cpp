@@ -158,14 +158,14 @@ CDenseFeatures< float64_t >* CDeepAutoencoder::transform(
 	CDenseFeatures< float64_t >* data)
 {
 	SGMatrix<float64_t> transformed = forward_propagate(data, (m_num_layers-1)/2);
-	return new CDenseFeatures<float64_t>(transformed);
+	return new CDenseFeatures<float64_t>(transformed.clone());
 }
 
 CDenseFeatures< float64_t >* CDeepAutoencoder::reconstruct(
 	CDenseFeatures< float64_t >* data)
 {
 	SGMatrix<float64_t> reconstructed = forward_propagate(data);
-	return new CDenseFeatures<float64_t>(reconstructed);
+	return new CDenseFeatures<float64_t>(reconstructed.clone());
 }
 
 CNeuralNetwork* CDeepAutoencoder::convert_to_neural_network(
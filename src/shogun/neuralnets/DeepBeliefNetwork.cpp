@@ -37,6 +37,7 @@
 #include <shogun/base/Parameter.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/eigen3.h>
+#include <shogun/mathematics/simd/SIMD.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/features/DenseFeatures.h>
@@ -411,8 +412,7 @@ void CDeepBeliefNetwork::down_step(int32_t index, SGVector< float64_t > params,
 	if (index > 0 || (index==0 && m_visible_units_type==RBMVUT_BINARY))
 	{
 		int32_t len = m_layer_sizes->element(index)*m_batch_size;
-		for (int32_t i=0; i<len; i++)
-				result[i] = 1.0/(1.0+CMath::exp(-1.0*result[i]));
+		simd::sigmoid(result.matrix, result.matrix, len);
 	}
 
 	if (index == 0 && m_visible_units_type==RBMVUT_SOFTMAX)
@@ -459,8 +459,7 @@ void CDeepBeliefNetwork::up_step(int32_t index, SGVector< float64_t > params,
 	}
 
 	int32_t len = result.num_rows*result.num_cols;
-	for (int32_t i=0; i<len; i++)
-		result[i] = 1.0/(1.0+CMath::exp(-1.0*result[i]));
+	simd::sigmoid(result.matrix, result.matrix, len);
 
 	if (sample_states && index>0)
 	{
@@ -61,21 +61,27 @@ CNeuralConvolutionalLayer::CNeuralConvolutionalLayer(
 	m_initialization_mode = initialization_mode;
 }
 
-void CNeuralConvolutionalLayer::set_batch_size(int32_t batch_size)
+void CNeuralConvolutionalLayer::set_batch_size(int32_t batch_size,
+		bool inference_only)
 {
-	CNeuralLayer::set_batch_size(batch_size);
+	int32_t max_batch_size = m_max_batch_size;
+	CNeuralLayer::set_batch_size(batch_size, inference_only);
+	bool reallocate = m_max_batch_size!=max_batch_size;
 
 	if (autoencoder_position==NLAP_NONE)
-		m_convolution_output = SGMatrix<float64_t>(m_num_maps*
-			(m_input_width/m_stride_x)*(m_input_height/m_stride_y), batch_size);
+		resize_batch_buffer(m_convolution_output, m_num_maps*
+			(m_input_width/m_stride_x)*(m_input_height/m_stride_y), reallocate);
 	else
-		m_convolution_output = SGMatrix<float64_t>(
-			m_num_maps*m_input_width*m_input_height, batch_size);
+		resize_batch_buffer(m_convolution_output,
+			m_num_maps*m_input_width*m_input_height, reallocate);
 
-	m_max_indices = SGMatrix<float64_t>(m_num_neurons, m_batch_size);
+	resize_batch_buffer(m_max_indices, m_num_neurons, reallocate);
 
-	m_convolution_output_gradients = SGMatrix<float64_t>(
-		m_convolution_output.num_rows, m_convolution_output.num_cols);
+	if (!inference_only)
+		resize_batch_buffer(m_convolution_output_gradients,
+			m_convolution_output.num_rows, reallocate);
+	else
+		m_convolution_output_gradients = SGMatrix<float64_t>();
 }
 
 
@@ -158,25 +164,15 @@ void CNeuralConvolutionalLayer::compute_activations(
 		SGVector<float64_t> parameters,
 		CDynamicObjectArray* layers)
 {
-	int32_t num_parameters_per_map =
-		1 + m_input_num_channels*(2*m_radius_x+1)*(2*m_radius_y+1);
-
-	for (int32_t m=0; m<m_num_maps; m++)
-	{
-		SGVector<float64_t> map_params(
-			parameters.vector+m*num_parameters_per_map,
-			num_parameters_per_map, false);
-
-		CConvolutionalFeatureMap map(m_input_width, m_input_height,
-			m_radius_x, m_radius_y, m_stride_x, m_stride_y, m,
-			m_activation_function, autoencoder_position);
-
-		map.compute_activations(map_params, layers, m_input_indices,
-			m_convolution_output);
-
-		map.pool_activations(m_convolution_output,
-			m_pooling_width, m_pooling_height, m_activations, m_max_indices);
-	}
+	// all maps at once, so that the convolutions of a sample are a single
+	// matrix product
+	CConvolutionalFeatureMap maps(m_input_width, m_input_height,
+		m_radius_x, m_radius_y, m_stride_x, m_stride_y, 0,
+		m_activation_function, autoencoder_position, m_num_maps);
+
+	maps.compute_activations(parameters, layers, m_input_indices,
+		m_convolution_output, m_pooling_width, m_pooling_height,
+		m_activations, m_max_indices);
 }
 
 void CNeuralConvolutionalLayer::compute_gradients(
@@ -203,33 +199,20 @@ void CNeuralConvolutionalLayer::compute_gradients(
 
 	// compute the pre-pooling activation gradients
 	m_convolution_output_gradients.zero();
-	for (int32_t i=0; i<m_num_neurons; i++)
-		for (int32_t j=0; j<m_batch_size; j++)
+	#pragma omp parallel for
+	for (int32_t j=0; j<m_batch_size; j++)
+		for (int32_t i=0; i<m_num_neurons; i++)
 			if (m_max_indices(i,j)!=-1.0)
 				m_convolution_output_gradients(m_max_indices(i,j),j) =
 					m_activation_gradients(i,j);
 
-	int32_t num_parameters_per_map =
-		1 + m_input_num_channels*(2*m_radius_x+1)*(2*m_radius_y+1);
+	CConvolutionalFeatureMap maps(m_input_width, m_input_height,
+		m_radius_x, m_radius_y, m_stride_x, m_stride_y, 0,
+		m_activation_function, autoencoder_position, m_num_maps);
 
-	for (int32_t m=0; m<m_num_maps; m++)
-	{
-		SGVector<float64_t> map_params(
-			parameters.vector+m*num_parameters_per_map,
-			num_parameters_per_map, false);
-
-		SGVector<float64_t> map_gradients(
-			parameter_gradients.vector+m*num_parameters_per_map,
-			num_parameters_per_map, false);
-
-		CConvolutionalFeatureMap map(m_input_width, m_input_height,
-			m_radius_x, m_radius_y, m_stride_x, m_stride_y, m,
-			m_activation_function, autoencoder_position);
-
-		map.compute_gradients(map_params, m_convolution_output,
-			m_convolution_output_gradients, layers,
-			m_input_indices, map_gradients);
-	}
+	maps.compute_gradients(parameters, m_convolution_output,
+		m_convolution_output_gradients, layers,
+		m_input_indices, parameter_gradients);
 }
 
 float64_t CNeuralConvolutionalLayer::compute_error(SGMatrix<float64_t> targets)
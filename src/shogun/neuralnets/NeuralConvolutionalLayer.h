@@ -113,8 +113,11 @@ public:
 	 *
 	 * @param batch_size number of training/test cases the network is
 	 * currently working with
+	 * @param inference_only if true, only the activations are computed until
+	 * the next call, the buffers that are only needed during training
+	 * (gradients, dropout mask) are released
 	 */
-	virtual void set_batch_size(int32_t batch_size);
+	virtual void set_batch_size(int32_t batch_size, bool inference_only=false);
 
 	/** Initializes the layer, computes the number of parameters needed for
 	 * the layer
@@ -38,6 +38,11 @@
 
 using namespace shogun;
 
+/** the buffers are reallocated if the batch size shrinks below
+ * 1/NL_BUFFER_SHRINK_FACTOR of the number of cases they can hold
+ */
+#define NL_BUFFER_SHRINK_FACTOR 4
+
 CNeuralLayer::CNeuralLayer()
 : CSGObject()
 {
@@ -72,18 +77,34 @@ void CNeuralLayer::initialize_neural_layer(CDynamicObjectArray* layers,
 	}
 }
 
-void CNeuralLayer::set_batch_size(int32_t batch_size)
+void CNeuralLayer::set_batch_size(int32_t batch_size, bool inference_only)
 {
 	m_batch_size = batch_size;
 
-	m_activations = SGMatrix<float64_t>(m_num_neurons, m_batch_size);
-	m_dropout_mask = SGMatrix<bool>(m_num_neurons, m_batch_size);
+	// keep the memory as long as it is not much larger than needed, so
+	// that e.g the last parts of the training set or different test sets
+	// do not cause reallocations
+	bool reallocate = m_batch_size>m_max_batch_size ||
+		m_batch_size*NL_BUFFER_SHRINK_FACTOR<m_max_batch_size;
+	if (reallocate)
+		m_max_batch_size = m_batch_size;
+
+	resize_batch_buffer(m_activations, m_num_neurons, reallocate);
+
+	if (!inference_only)
+		resize_batch_buffer(m_dropout_mask, m_num_neurons, reallocate);
+	else
+		m_dropout_mask = SGMatrix<bool>();
 
-	if (!is_input())
+	if (!is_input() && !inference_only)
+	{
+		resize_batch_buffer(m_activation_gradients, m_num_neurons, reallocate);
+		resize_batch_buffer(m_local_gradients, m_num_neurons, reallocate);
+	}
+	else
 	{
-		m_activation_gradients =
-			SGMatrix<float64_t>(m_num_neurons, m_batch_size);
-		m_local_gradients = SGMatrix<float64_t>(m_num_neurons, m_batch_size);
+		m_activation_gradients = SGMatrix<float64_t>();
+		m_local_gradients = SGMatrix<float64_t>();
 	}
 }
 
@@ -115,6 +136,7 @@ void CNeuralLayer::init()
 	m_height = 0;
 	m_num_parameters = 0;
 	m_batch_size = 0;
+	m_max_batch_size = 0;
 	dropout_prop = 0.0;
 	contraction_coefficient = 0.0;
 	is_training = false;
@@ -126,6 +148,8 @@ void CNeuralLayer::init()
 	       "Width", MS_NOT_AVAILABLE);
 	SG_ADD(&m_height, "height",
 	       "Height", MS_NOT_AVAILABLE);
+	SG_ADD(&m_num_parameters, "num_parameters",
+	       "Number of Parameters", MS_NOT_AVAILABLE);
 	SG_ADD(&m_input_indices, "input_indices",
 	       "Input Indices", MS_NOT_AVAILABLE);
 	SG_ADD(&m_input_sizes, "input_sizes",
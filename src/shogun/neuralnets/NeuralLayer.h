@@ -83,6 +83,10 @@ template <class T> class SGVector;
  * m_activations: size m_num_neurons*m_batch_size
  * m_activation_gradients: size m_num_neurons*m_batch_size
  * m_local_gradients: size m_num_neurons*m_batch_size
+ *
+ * The buffers are allocated for m_max_batch_size cases and only reallocated
+ * when the batch size grows beyond that or shrinks to a small fraction of it,
+ * for smaller batches they are views of the first m_batch_size columns.
  */
 class CNeuralLayer : public CSGObject
 {
@@ -115,8 +119,11 @@ public:
 	 *
 	 * @param batch_size number of training/test cases the network is
 	 * currently working with
+	 * @param inference_only if true, only the activations are computed until
+	 * the next call, the buffers that are only needed during training
+	 * (gradients, dropout mask) are released
 	 */
-	virtual void set_batch_size(int32_t batch_size);
+	virtual void set_batch_size(int32_t batch_size, bool inference_only=false);
 
 	/** returns true if the layer is an input layer. Input layers are the root
 	 * layers of a network, that is, they don't receive signals from other
@@ -343,6 +350,22 @@ public:
 	ENLAutoencoderPosition autoencoder_position;
 
 protected:
+	/** Makes buffer a num_rows*m_batch_size matrix, keeping its memory
+	 * unless it has to be reallocated
+	 *
+	 * @param buffer buffer to resize
+	 * @param num_rows number of rows
+	 * @param reallocate whether m_max_batch_size has changed
+	 */
+	template <class T>
+	void resize_batch_buffer(SGMatrix<T>& buffer, int32_t num_rows,
+			bool reallocate)
+	{
+		if (reallocate || buffer.matrix==NULL || buffer.num_rows!=num_rows)
+			buffer = SGMatrix<T>(num_rows, m_max_batch_size);
+		buffer.num_cols = m_batch_size;
+	}
+
 	/** Number of neurons in this layer */
 	int32_t m_num_neurons;
 
@@ -370,6 +393,9 @@ protected:
 	/** number of training/test cases the network is currently working with */
 	int32_t m_batch_size;
 
+	/** number of cases the buffers are allocated for */
+	int32_t m_max_batch_size;
+
 	/** activations of the neurons in this layer
 	 * size num_neurons * batch_size
 	 */
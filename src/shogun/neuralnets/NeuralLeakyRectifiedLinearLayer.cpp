@@ -39,13 +39,20 @@ using namespace shogun;
 
 CNeuralLeakyRectifiedLinearLayer::CNeuralLeakyRectifiedLinearLayer() : CNeuralRectifiedLinearLayer()
 {
-	m_alpha=0.01;
+	init();
 }
 
 CNeuralLeakyRectifiedLinearLayer::CNeuralLeakyRectifiedLinearLayer(int32_t num_neurons):
 CNeuralRectifiedLinearLayer(num_neurons)
+{
+	init();
+}
+
+void CNeuralLeakyRectifiedLinearLayer::init()
 {
 	m_alpha=0.01;
+
+	SG_ADD(&m_alpha, "alpha", "Alpha", MS_NOT_AVAILABLE);
 }
 
 void CNeuralLeakyRectifiedLinearLayer::compute_activations(
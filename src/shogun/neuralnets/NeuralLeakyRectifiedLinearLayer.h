@@ -88,6 +88,9 @@ public:
 
 	virtual const char* get_name() const { return "NeuralLeakyRectifiedLinearLayer"; }
 
+private:
+	void init();
+
 protected:
 	/** Parameter used to calculate max(alpha*(W*x+b),W*x+b).
 	 * Default value is 0.01
@@ -33,6 +33,7 @@
 
 #include <shogun/neuralnets/NeuralLogisticLayer.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/simd/SIMD.h>
 #include <shogun/lib/SGVector.h>
 
 using namespace shogun;
@@ -53,8 +54,7 @@ void CNeuralLogisticLayer::compute_activations(SGVector<float64_t> parameters,
 
 	// apply logistic activation function
 	int32_t length = m_num_neurons*m_batch_size;
-	for (int32_t i=0; i<length; i++)
-		m_activations[i] = 1.0/(1.0+CMath::exp(-1.0*m_activations[i]));
+	simd::sigmoid(m_activations.matrix, m_activations.matrix, length);
 }
 
 float64_t CNeuralLogisticLayer::compute_contraction_term(
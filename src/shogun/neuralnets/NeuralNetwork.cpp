@@ -37,9 +37,14 @@
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/lib/DynamicObjectArray.h>
 #include <shogun/neuralnets/NeuralLayer.h>
+#include <shogun/neuralnets/NeuralInputLayer.h>
+#include <shogun/base/Parallel.h>
 
 using namespace shogun;
 
+/** smallest number of cases a gradient worker is given */
+#define NN_MIN_WORKER_BATCH_SIZE 16
+
 CNeuralNetwork::CNeuralNetwork()
 : CMachine()
 {
@@ -152,6 +157,7 @@ void CNeuralNetwork::initialize_neural_network(float64_t sigma)
 
 CNeuralNetwork::~CNeuralNetwork()
 {
+	SG_UNREF(m_gradient_workers);
 	SG_UNREF(m_layers);
 }
 
@@ -222,8 +228,10 @@ CMulticlassLabels* CNeuralNetwork::apply_multiclass(CFeatures* data)
 CDenseFeatures< float64_t >* CNeuralNetwork::transform(
 	CDenseFeatures< float64_t >* data)
 {
+	// the activations are the output layer's buffer, which later calls
+	// reuse
 	SGMatrix<float64_t> output_activations = forward_propagate(data);
-	return new CDenseFeatures<float64_t>(output_activations);
+	return new CDenseFeatures<float64_t>(output_activations.clone());
 }
 
 bool CNeuralNetwork::train_machine(CFeatures* data)
@@ -269,6 +277,7 @@ bool CNeuralNetwork::train_gradient_descent(SGMatrix<float64_t> inputs,
 	int32_t training_set_size = inputs.num_cols;
 	if (m_gd_mini_batch_size==0) m_gd_mini_batch_size = training_set_size;
 	set_batch_size(m_gd_mini_batch_size);
+	init_gradient_workers(m_gd_mini_batch_size);
 
 	int32_t n_param = get_num_parameters();
 	SGVector<float64_t> gradients(n_param);
@@ -351,6 +360,7 @@ bool CNeuralNetwork::train_gradient_descent(SGMatrix<float64_t> inputs,
 		}
 	}
 
+	free_gradient_workers();
 	return true;
 }
 
@@ -359,6 +369,7 @@ bool CNeuralNetwork::train_lbfgs(SGMatrix<float64_t> inputs,
 {
 	int32_t training_set_size = inputs.num_cols;
 	set_batch_size(training_set_size);
+	init_gradient_workers(training_set_size);
 
 	lbfgs_parameter_t lbfgs_param;
 	lbfgs_parameter_init(&lbfgs_param);
@@ -380,6 +391,7 @@ bool CNeuralNetwork::train_lbfgs(SGMatrix<float64_t> inputs,
 
 	m_lbfgs_temp_inputs = NULL;
 	m_lbfgs_temp_targets = NULL;
+	free_gradient_workers();
 
 	if (result==LBFGS_SUCCESS || 1)
 	{
@@ -439,7 +451,13 @@ int CNeuralNetwork::lbfgs_progress(void* instance,
 SGMatrix<float64_t> CNeuralNetwork::forward_propagate(CFeatures* data, int32_t j)
 {
 	SGMatrix<float64_t> inputs = features_to_matrix(data);
-	set_batch_size(data->get_num_vectors());
+
+	// only the activations are needed, so the layers can release the
+	// buffers used during training
+	m_batch_size = data->get_num_vectors();
+	for (int32_t i=0; i<m_num_layers; i++)
+		get_layer(i)->set_batch_size(m_batch_size, true);
+
 	return forward_propagate(inputs, j);
 }
 
@@ -467,6 +485,9 @@ SGMatrix<float64_t> CNeuralNetwork::forward_propagate(
 float64_t CNeuralNetwork::compute_gradients(SGMatrix<float64_t> inputs,
 		SGMatrix<float64_t> targets, SGVector<float64_t> gradients)
 {
+	if (m_gradient_workers && m_gradient_workers->get_num_elements()>1)
+		return compute_gradients_parallel(inputs, targets, gradients);
+
 	forward_propagate(inputs);
 
 	for (int32_t i=0; i<m_num_layers; i++)
@@ -516,6 +537,123 @@ float64_t CNeuralNetwork::compute_gradients(SGMatrix<float64_t> inputs,
 	return compute_error(targets);
 }
 
+float64_t CNeuralNetwork::compute_gradients_parallel(
+		SGMatrix<float64_t> inputs, SGMatrix<float64_t> targets,
+		SGVector<float64_t> gradients)
+{
+	int32_t num_workers = m_gradient_workers->get_num_elements();
+	int32_t batch_size = inputs.num_cols;
+	int32_t num_outputs = get_num_outputs();
+
+	CNeuralNetwork** workers = SG_MALLOC(CNeuralNetwork*, num_workers);
+	for (int32_t k=0; k<num_workers; k++)
+	{
+		workers[k] = (CNeuralNetwork*)m_gradient_workers->get_element(k);
+		SG_UNREF(workers[k]);
+	}
+
+	SGMatrix<float64_t> worker_gradients(m_total_num_parameters, num_workers);
+	SGVector<float64_t> worker_errors(num_workers);
+
+	#pragma omp parallel for
+	for (int32_t k=0; k<num_workers; k++)
+	{
+		int32_t begin = (int64_t)k*batch_size/num_workers;
+		int32_t end = (int64_t)(k+1)*batch_size/num_workers;
+
+		CNeuralNetwork* worker = workers[k];
+		memcpy(worker->m_params.vector, m_params.vector,
+			sizeof(float64_t)*m_total_num_parameters);
+		worker->set_batch_size(end-begin);
+
+		SGMatrix<float64_t> worker_inputs(inputs.matrix+(int64_t)begin*m_num_inputs,
+			m_num_inputs, end-begin, false);
+		SGMatrix<float64_t> worker_targets(targets.matrix+(int64_t)begin*num_outputs,
+			num_outputs, end-begin, false);
+
+		worker_errors[k] = worker->compute_gradients(worker_inputs,
+			worker_targets, SGVector<float64_t>(worker_gradients.get_column_vector(k),
+				m_total_num_parameters, false));
+	}
+
+	// every term of the error is either an average over the cases or does
+	// not depend on them, so averaging the workers' results weighted by
+	// the sizes of their parts gives the result for the whole batch
+	gradients.zero();
+	float64_t error = 0;
+	for (int32_t k=0; k<num_workers; k++)
+	{
+		int32_t begin = (int64_t)k*batch_size/num_workers;
+		int32_t end = (int64_t)(k+1)*batch_size/num_workers;
+		float64_t w = float64_t(end-begin)/batch_size;
+
+		float64_t* g = worker_gradients.get_column_vector(k);
+		for (int32_t i=0; i<m_total_num_parameters; i++)
+			gradients[i] += w*g[i];
+
+		error += w*worker_errors[k];
+	}
+	SG_FREE(workers);
+
+	// max-norm regularization
+	if (m_max_norm != -1.0)
+	{
+		for (int32_t i=0; i<m_num_layers; i++)
+		{
+			SGVector<float64_t> layer_params = get_section(m_params,i);
+			get_layer(i)->enforce_max_norm(layer_params, m_max_norm);
+		}
+	}
+
+	return error;
+}
+
+void CNeuralNetwork::init_gradient_workers(int32_t batch_size)
+{
+	free_gradient_workers();
+
+	int32_t num_workers = CMath::min(parallel->get_num_threads(),
+		batch_size/NN_MIN_WORKER_BATCH_SIZE);
+	if (num_workers<2)
+		return;
+
+	// the workers would draw random numbers concurrently
+	for (int32_t i=0; i<m_num_layers; i++)
+	{
+		CNeuralLayer* layer = get_layer(i);
+		if (layer->dropout_prop>0)
+			return;
+		if (layer->is_input() && ((CNeuralInputLayer*)layer)->gaussian_noise>0)
+			return;
+	}
+
+	m_gradient_workers = new CDynamicObjectArray(num_workers);
+	SG_REF(m_gradient_workers);
+
+	for (int32_t k=0; k<num_workers; k++)
+	{
+		CNeuralNetwork* worker = (CNeuralNetwork*)clone();
+		if (worker==NULL)
+		{
+			SG_WARNING("Could not copy the network, computing the gradients "
+				"serially\n");
+			free_gradient_workers();
+			return;
+		}
+
+		// max-norm is enforced once, on this network
+		worker->m_max_norm = -1.0;
+		m_gradient_workers->append_element(worker);
+		SG_UNREF(worker);
+	}
+}
+
+void CNeuralNetwork::free_gradient_workers()
+{
+	SG_UNREF(m_gradient_workers);
+	m_gradient_workers = NULL;
+}
+
 float64_t CNeuralNetwork::compute_error(SGMatrix<float64_t> targets)
 {
 	float64_t error = get_layer(m_num_layers-1)->compute_error(targets);
@@ -603,12 +741,12 @@ float64_t CNeuralNetwork::check_gradients(float64_t approx_epsilon, float64_t s)
 
 void CNeuralNetwork::set_batch_size(int32_t batch_size)
 {
-	if (batch_size!=m_batch_size)
-	{
-		m_batch_size = batch_size;
-		for (int32_t i=0; i<m_num_layers; i++)
-			get_layer(i)->set_batch_size(m_batch_size);
-	}
+	// cheap if the batch size has not changed much, the layers then keep
+	// their memory. Always done as the buffers used during training may
+	// have been released by forward_propagate()
+	m_batch_size = batch_size;
+	for (int32_t i=0; i<m_num_layers; i++)
+		get_layer(i)->set_batch_size(m_batch_size);
 }
 
 SGMatrix<float64_t> CNeuralNetwork::features_to_matrix(CFeatures* features)
@@ -770,6 +908,7 @@ void CNeuralNetwork::init()
 	m_lbfgs_temp_inputs = NULL;
 	m_lbfgs_temp_targets = NULL;
 	m_is_training = false;
+	m_gradient_workers = NULL;
 
 	SG_ADD((machine_int_t*)&m_optimization_method, "optimization_method",
 	       "Optimization Method", MS_NOT_AVAILABLE);
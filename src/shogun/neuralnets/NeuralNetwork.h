@@ -504,6 +504,9 @@ protected:
 	/** Applies backpropagation to compute the gradients of the error with
 	 * repsect to every parameter in the network.
 	 *
+	 * If gradient workers were set up with init_gradient_workers(), the
+	 * batch is split between them and their gradients are averaged.
+	 *
 	 * @param inputs inputs to the network, a matrix of size
 	 * m_num_inputs*m_batch_size
 	 *
@@ -553,9 +556,27 @@ protected:
 	 */
 	SGMatrix<float64_t> labels_to_matrix(CLabels* labs);
 
+	/** Sets up copies of the network that compute_gradients() splits the
+	 * batch between, one per thread. Nothing is set up (and the gradients
+	 * are computed serially) if the batch is too small to be split or if
+	 * training draws random numbers (dropout, gaussian input noise).
+	 *
+	 * @param batch_size number of cases compute_gradients() is called with
+	 */
+	void init_gradient_workers(int32_t batch_size);
+
+	/** Releases the copies set up by init_gradient_workers() */
+	void free_gradient_workers();
+
 private:
 	void init();
 
+	/** compute_gradients() on the gradient workers, each one computes the
+	 * gradients for a contiguous part of the batch
+	 */
+	float64_t compute_gradients_parallel(SGMatrix<float64_t> inputs,
+			SGMatrix<float64_t> targets, SGVector<float64_t> gradients);
+
 	/** callback for l-bfgs */
 	static float64_t lbfgs_evaluate(void *userdata,
 			const float64_t *W,
@@ -716,6 +737,11 @@ private:
 	 */
 	const SGMatrix<float64_t>* m_lbfgs_temp_inputs;
 	const SGMatrix<float64_t>* m_lbfgs_temp_targets;
+
+	/** copies of the network that the gradient computation is split between
+	 * during training, see init_gradient_workers()
+	 */
+	CDynamicObjectArray* m_gradient_workers;
 };
 
 }
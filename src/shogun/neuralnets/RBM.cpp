@@ -37,6 +37,7 @@
 #include <shogun/base/Parameter.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/eigen3.h>
+#include <shogun/mathematics/simd/SIMD.h>
 
 using namespace shogun;
 
@@ -461,8 +462,7 @@ void CRBM::mean_hidden(SGMatrix< float64_t > visible, SGMatrix< float64_t > resu
 	H += W*V;
 
 	int32_t len = result.num_rows*result.num_cols;
-	for (int32_t i=0; i<len; i++)
-		result[i] = 1.0/(1.0+CMath::exp(-1.0*result[i]));
+	simd::sigmoid(result.matrix, result.matrix, len);
 }
 
 void CRBM::mean_visible(SGMatrix< float64_t > hidden, SGMatrix< float64_t > result)
@@ -484,9 +484,11 @@ void CRBM::mean_visible(SGMatrix< float64_t > hidden, SGMatrix< float64_t > resu
 
 		if (m_visible_group_types->element(k)==RBMVUT_BINARY)
 		{
-			for (int32_t i=0; i<m_visible_group_sizes->element(k); i++)
-				for (int32_t j=0; j<m_batch_size; j++)
-					result(i+offset,j) = 1.0/(1.0+CMath::exp(-1.0*result(i+offset,j)));
+			for (int32_t j=0; j<m_batch_size; j++)
+			{
+				float64_t* r = &result(offset,j);
+				simd::sigmoid(r, r, m_visible_group_sizes->element(k));
+			}
 		}
 		if (m_visible_group_types->element(k)==RBMVUT_SOFTMAX)
 		{
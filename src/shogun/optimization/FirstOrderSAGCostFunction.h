@@ -79,6 +79,49 @@ public:
 	 */
 	virtual int32_t get_sample_size()=0;
 
+	/** Get the index of the sample given by next_sample()
+	 *
+	 * Used by minimizers which keep information per sample, such as
+	 * SAGAMinimizer
+	 *
+	 * @return index of the sample between 0 and get_sample_size()-1
+	 */
+	virtual index_t get_sample_index()
+	{
+		SG_NOTIMPLEMENTED
+		return -1;
+	}
+
+	/** Does the cost function provide sparse gradients of given samples,
+	 * see get_sparse_sample_gradient()?
+	 *
+	 * @return whether get_sparse_sample_gradient() is implemented
+	 */
+	virtual bool supports_sparse_sample_gradient() { return false; }
+
+	/** Get the SAMPLE gradient of a given sample at given target variables
+	 * as sparse vector
+	 *
+	 * Used by minimizers which go through the samples with several threads
+	 * at once, so it has to be thread-safe and must not use the state set by
+	 * begin_sample() and next_sample(). The variables can be changed by
+	 * other threads during the call
+	 *
+	 * The target variables are scale*variable, which lets minimizers defer
+	 * scaling all variables, e.g. for an L2 penalty
+	 *
+	 * @param sample_idx index of the sample between 0 and get_sample_size()-1
+	 * @param variable target variables up to scaling
+	 * @param scale scaling of variable
+	 * @return sparse sample gradient of variables
+	 */
+	virtual SGSparseVector<float64_t> get_sparse_sample_gradient(index_t sample_idx,
+		SGVector<float64_t> variable, float64_t scale=1.0)
+	{
+		SG_NOTIMPLEMENTED
+		return SGSparseVector<float64_t>();
+	}
+
 	/** Get the AVERAGE gradient value wrt target variables 
 	 *
 	 * Note that the average gradient is the mean of sample gradient from get_gradient()
@@ -33,6 +33,7 @@
 #define FIRSTORDERSTOCHASTICCOSTFUNCTION_H
 #include <shogun/lib/config.h>
 #include <shogun/optimization/FirstOrderCostFunction.h>
+#include <shogun/lib/SGSparseVector.h>
 namespace shogun
 {
 /** @brief The first order stochastic cost function base class.
@@ -79,6 +80,47 @@ public:
 	 */
 	virtual SGVector<float64_t> get_gradient()=0;
 
+	/** Does the cost function provide sparse SAMPLE gradients?
+	 *
+	 * If so, minimizers can update the target variables lazily, such that
+	 * a step only costs as much as the number of non-zero elements of the
+	 * sample gradient instead of the number of target variables
+	 *
+	 * @return whether get_gradient_support() and get_sparse_gradient() are
+	 * implemented
+	 */
+	virtual bool supports_sparse_gradient() { return false; }
+
+	/** Get the indices of the target variables the SAMPLE gradient depends
+	 * on, which include all indices where it can be non-zero
+	 *
+	 * For a linear model with sparse features, these are the indices of the
+	 * non-zero features of the sample given by next_sample(). Minimizers
+	 * updating the target variables lazily only bring the variables with
+	 * these indices up to date before they call get_sparse_gradient()
+	 *
+	 * @return indices of target variables
+	 */
+	virtual SGVector<index_t> get_gradient_support()
+	{
+		SG_NOTIMPLEMENTED
+		return SGVector<index_t>();
+	}
+
+	/** Get the SAMPLE gradient value wrt target variables as sparse vector
+	 *
+	 * Same as get_gradient(), except that only elements with indices given
+	 * by get_gradient_support() may be stored and that only the target
+	 * variables with these indices may be used
+	 *
+	 * @return sparse sample gradient of variables
+	 */
+	virtual SGSparseVector<float64_t> get_sparse_gradient()
+	{
+		SG_NOTIMPLEMENTED
+		return SGSparseVector<float64_t>();
+	}
+
 	/** Get the cost given current target variables 
 	 *
 	 * For least squares, that is the value of \f$f(w)\f$.
@@ -32,7 +32,14 @@
 #include <shogun/optimization/FirstOrderStochasticMinimizer.h>
 #include <shogun/optimization/SparsePenalty.h>
 #include <shogun/optimization/ProximalPenalty.h>
+#include <shogun/optimization/L2Penalty.h>
+#include <shogun/optimization/GradientDescendUpdater.h>
 #include <shogun/base/Parameter.h>
+
+/* lazy updates start over before the scaling factors of the penalty
+ * multiply to less than this */
+#define LAZY_UPDATE_MIN_SCALE 1e-100
+
 using namespace shogun;
 
 void FirstOrderStochasticMinimizer::set_gradient_updater(DescendUpdater* gradient_updater)
@@ -92,6 +99,91 @@ void FirstOrderStochasticMinimizer::init_minimization()
 	m_cur_passes=0;
 }
 
+bool FirstOrderStochasticMinimizer::supports_lazy_update()
+{
+	FirstOrderStochasticCostFunction* fun=dynamic_cast<FirstOrderStochasticCostFunction*>(m_fun);
+	if(!fun || !fun->supports_sparse_gradient())
+		return false;
+
+	GradientDescendUpdater* updater=dynamic_cast<GradientDescendUpdater*>(m_gradient_updater);
+	if(!updater || updater->enables_descend_correction())
+		return false;
+
+	return !m_penalty_type || dynamic_cast<L2Penalty*>(m_penalty_type);
+}
+
+void FirstOrderStochasticMinimizer::begin_lazy_update(index_t num_variables)
+{
+	m_lazy_step=0;
+	m_lazy_last_step=SGVector<int32_t>(num_variables);
+	m_lazy_last_step.zero();
+	m_lazy_scale=SGVector<float64_t>(1024);
+	m_lazy_rate_sum=SGVector<float64_t>(1024);
+	m_lazy_scale[0]=1.0;
+	m_lazy_rate_sum[0]=0.0;
+}
+
+void FirstOrderStochasticMinimizer::catch_up_lazy_variable(SGVector<float64_t> variable_reference,
+	SGVector<float64_t> direction, index_t idx)
+{
+	int32_t last_step=m_lazy_last_step[idx];
+	if(last_step==m_lazy_step)
+		return;
+
+	/* each step scales the variable by (1-learning_rate*penalty_weight) and
+	 * subtracts learning_rate*direction, which sums up to
+	 * scale*(variable/last_scale-direction*(rate_sum-last_rate_sum))
+	 */
+	float64_t variable=variable_reference[idx]/m_lazy_scale[last_step];
+	if(direction.vlen>0)
+		variable-=direction[idx]*(m_lazy_rate_sum[m_lazy_step]-m_lazy_rate_sum[last_step]);
+
+	variable_reference[idx]=variable*m_lazy_scale[m_lazy_step];
+	m_lazy_last_step[idx]=m_lazy_step;
+}
+
+void FirstOrderStochasticMinimizer::next_lazy_step(SGVector<float64_t> variable_reference,
+	SGVector<float64_t> direction, float64_t learning_rate)
+{
+	float64_t scale=1.0;
+	if(m_penalty_type)
+	{
+		REQUIRE(m_penalty_weight>0,"The weight of penalty must be set first\n");
+		scale-=learning_rate*m_penalty_weight;
+		REQUIRE(scale>0, "The learning rate (%f) times the weight of penalty (%f) "
+			"must be less than one for lazy updates\n", learning_rate, m_penalty_weight);
+	}
+
+	if(m_lazy_scale[m_lazy_step]*scale<LAZY_UPDATE_MIN_SCALE)
+	{
+		end_lazy_update(variable_reference, direction);
+		begin_lazy_update(variable_reference.vlen);
+	}
+
+	if(m_lazy_step+1==m_lazy_scale.vlen)
+	{
+		m_lazy_scale.resize_vector(2*m_lazy_scale.vlen);
+		m_lazy_rate_sum.resize_vector(2*m_lazy_rate_sum.vlen);
+	}
+
+	m_lazy_step++;
+	m_lazy_scale[m_lazy_step]=m_lazy_scale[m_lazy_step-1]*scale;
+	m_lazy_rate_sum[m_lazy_step]=m_lazy_rate_sum[m_lazy_step-1]+
+		learning_rate/m_lazy_scale[m_lazy_step];
+}
+
+void FirstOrderStochasticMinimizer::end_lazy_update(SGVector<float64_t> variable_reference,
+	SGVector<float64_t> direction)
+{
+	for(index_t idx=0; idx<variable_reference.vlen; idx++)
+		catch_up_lazy_variable(variable_reference, direction, idx);
+
+	m_lazy_step=0;
+	m_lazy_last_step=SGVector<int32_t>();
+	m_lazy_scale=SGVector<float64_t>();
+	m_lazy_rate_sum=SGVector<float64_t>();
+}
+
 void FirstOrderStochasticMinimizer::init()
 {
 	m_gradient_updater=NULL;
@@ -99,6 +191,7 @@ void FirstOrderStochasticMinimizer::init()
 	m_num_passes=0;
 	m_cur_passes=0;
 	m_iter_counter=0;
+	m_lazy_step=0;
 
 	SG_ADD((CSGObject **)&m_learning_rate, "FirstOrderMinimizer__m_learning_rate",
 		"learning_rate in FirstOrderStochasticMinimizer", MS_NOT_AVAILABLE);
@@ -146,6 +146,60 @@ protected:
 	/** init the minimization process*/
 	virtual void init_minimization();
 
+	/** Can the target variables be updated lazily?
+	 *
+	 * This is the case if the cost function provides sparse sample
+	 * gradients, the gradient updater is a GradientDescendUpdater without
+	 * descend correction and there is no penalty or an L2 penalty.
+	 *
+	 * In a lazy update, each step only updates the target variables where
+	 * the sample gradient is non-zero. The scaling by the L2 penalty and
+	 * a dense direction shared by all steps (e.g. the average gradient in
+	 * SVRG) are applied to the remaining variables only when they are used
+	 * next, at once for all steps they missed.
+	 *
+	 * @return whether lazy updates are possible
+	 */
+	virtual bool supports_lazy_update();
+
+	/** Start updating the target variables lazily
+	 *
+	 * @param num_variables number of target variables
+	 */
+	virtual void begin_lazy_update(index_t num_variables);
+
+	/** Bring a target variable up to date, applying the penalty and the
+	 * dense direction of all steps since it was updated last
+	 *
+	 * @param variable_reference target variables
+	 * @param direction dense direction subtracted in every step, scaled by
+	 * the learning rate, or an empty vector
+	 * @param idx index of the variable
+	 */
+	virtual void catch_up_lazy_variable(SGVector<float64_t> variable_reference,
+		SGVector<float64_t> direction, index_t idx);
+
+	/** Start the next lazy step. Afterwards, variables brought up to date
+	 * with catch_up_lazy_variable() include the penalty and dense direction
+	 * of this step, so only the sparse gradient remains to be applied to
+	 * them
+	 *
+	 * @param variable_reference target variables
+	 * @param direction dense direction or an empty vector
+	 * @param learning_rate learning rate of the step
+	 */
+	virtual void next_lazy_step(SGVector<float64_t> variable_reference,
+		SGVector<float64_t> direction, float64_t learning_rate);
+
+	/** Bring all target variables up to date and finish the lazy update,
+	 * e.g. at the end of a pass through the data
+	 *
+	 * @param variable_reference target variables
+	 * @param direction dense direction or an empty vector
+	 */
+	virtual void end_lazy_update(SGVector<float64_t> variable_reference,
+		SGVector<float64_t> direction);
+
 	/** the gradient update step */
 	DescendUpdater* m_gradient_updater;
 
@@ -160,6 +214,18 @@ protected:
 
 	/** learning_rate object */
 	LearningRate* m_learning_rate;
+
+	/** number of steps since the lazy update started */
+	int32_t m_lazy_step;
+
+	/** step each target variable was brought up to date last */
+	SGVector<int32_t> m_lazy_last_step;
+
+	/** product of the scaling factors of the penalty up to each step */
+	SGVector<float64_t> m_lazy_scale;
+
+	/** sum of the learning rates divided by m_lazy_scale up to each step */
+	SGVector<float64_t> m_lazy_rate_sum;
 	
 private:
 	/** Init */
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) The Shogun Machine Learning Toolbox
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the Shogun Development Team.
+ *
+ */
+
+#include <shogun/optimization/MarginLossCostFunction.h>
+#include <shogun/features/SparseFeatures.h>
+using namespace shogun;
+
+MarginLossCostFunction::MarginLossCostFunction()
+	:FirstOrderSAGCostFunction()
+{
+	init();
+}
+
+MarginLossCostFunction::MarginLossCostFunction(CDotFeatures* features,
+	CBinaryLabels* labels, CLossFunction* loss)
+	:FirstOrderSAGCostFunction()
+{
+	init();
+	REQUIRE(features, "Features must not be NULL\n");
+	REQUIRE(labels, "Labels must not be NULL\n");
+	REQUIRE(loss, "Loss must not be NULL\n");
+	REQUIRE(features->get_num_vectors()==labels->get_num_labels(),
+		"Number of vectors (%d) and labels (%d) differ\n",
+		features->get_num_vectors(), labels->get_num_labels());
+
+	SG_REF(features);
+	SG_REF(labels);
+	SG_REF(loss);
+	m_features=features;
+	m_labels=labels;
+	m_loss=loss;
+	m_weights=SGVector<float64_t>(features->get_dim_feature_space());
+	m_weights.zero();
+}
+
+MarginLossCostFunction::~MarginLossCostFunction()
+{
+	SG_UNREF(m_features);
+	SG_UNREF(m_labels);
+	SG_UNREF(m_loss);
+}
+
+void MarginLossCostFunction::init()
+{
+	m_features=NULL;
+	m_labels=NULL;
+	m_loss=NULL;
+	m_sample_idx=-1;
+}
+
+int32_t MarginLossCostFunction::get_sample_size()
+{
+	return m_features->get_num_vectors();
+}
+
+void MarginLossCostFunction::begin_sample()
+{
+	m_sample_idx=-1;
+}
+
+bool MarginLossCostFunction::next_sample()
+{
+	m_sample_idx++;
+	return m_sample_idx<get_sample_size();
+}
+
+SGVector<float64_t> MarginLossCostFunction::obtain_variable_reference()
+{
+	return m_weights;
+}
+
+float64_t MarginLossCostFunction::get_derivative(index_t sample_idx,
+	const SGVector<float64_t>& weights, float64_t scale)
+{
+	float64_t label=m_labels->get_label(sample_idx);
+	float64_t margin=label*scale*m_features->dense_dot(sample_idx,
+		weights.vector, weights.vlen);
+	return label*m_loss->first_derivative(margin);
+}
+
+SGVector<float64_t> MarginLossCostFunction::get_gradient()
+{
+	SGVector<float64_t> grad(m_weights.vlen);
+	grad.zero();
+	m_features->add_to_dense_vec(get_derivative(m_sample_idx, m_weights),
+		m_sample_idx, grad.vector, grad.vlen);
+	return grad;
+}
+
+SGVector<float64_t> MarginLossCostFunction::get_average_gradient()
+{
+	int32_t num_samples=get_sample_size();
+	SGVector<float64_t> grad(m_weights.vlen);
+	grad.zero();
+	for(index_t idx=0; idx<num_samples; idx++)
+	{
+		m_features->add_to_dense_vec(get_derivative(idx, m_weights)/num_samples,
+			idx, grad.vector, grad.vlen);
+	}
+	return grad;
+}
+
+float64_t MarginLossCostFunction::get_cost()
+{
+	int32_t num_samples=get_sample_size();
+	float64_t cost=0.0;
+#pragma omp parallel for reduction(+:cost)
+	for(index_t idx=0; idx<num_samples; idx++)
+	{
+		float64_t label=m_labels->get_label(idx);
+		cost+=m_loss->loss(label*m_features->dense_dot(idx,
+			m_weights.vector, m_weights.vlen));
+	}
+	return cost;
+}
+
+bool MarginLossCostFunction::supports_sparse_gradient()
+{
+	return m_features && m_features->get_feature_class()==C_SPARSE &&
+		m_features->get_feature_type()==F_DREAL;
+}
+
+SGVector<index_t> MarginLossCostFunction::get_gradient_support()
+{
+	CSparseFeatures<float64_t>* features=(CSparseFeatures<float64_t>*) m_features;
+	SGSparseVector<float64_t> x=features->get_sparse_feature_vector(m_sample_idx);
+	SGVector<index_t> support(x.num_feat_entries);
+	for(index_t k=0; k<x.num_feat_entries; k++)
+		support[k]=x.features[k].feat_index;
+	features->free_sparse_feature_vector(m_sample_idx);
+	return support;
+}
+
+SGSparseVector<float64_t> MarginLossCostFunction::get_sparse_gradient(
+	index_t sample_idx, float64_t derivative)
+{
+	CSparseFeatures<float64_t>* features=(CSparseFeatures<float64_t>*) m_features;
+	SGSparseVector<float64_t> x=features->get_sparse_feature_vector(sample_idx);
+	SGSparseVector<float64_t> grad(x.num_feat_entries);
+	for(index_t k=0; k<x.num_feat_entries; k++)
+	{
+		grad.features[k].feat_index=x.features[k].feat_index;
+		grad.features[k].entry=derivative*x.features[k].entry;
+	}
+	features->free_sparse_feature_vector(sample_idx);
+	return grad;
+}
+
+SGSparseVector<float64_t> MarginLossCostFunction::get_sparse_gradient()
+{
+	return get_sparse_gradient(m_sample_idx, get_derivative(m_sample_idx, m_weights));
+}
+
+bool MarginLossCostFunction::supports_sparse_sample_gradient()
+{
+	return supports_sparse_gradient();
+}
+
+SGSparseVector<float64_t> MarginLossCostFunction::get_sparse_sample_gradient(
+	index_t sample_idx, SGVector<float64_t> variable, float64_t scale)
+{
+	return get_sparse_gradient(sample_idx, get_derivative(sample_idx, variable, scale));
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) The Shogun Machine Learning Toolbox
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the Shogun Development Team.
+ *
+ */
+
+#ifndef MARGINLOSSCOSTFUNCTION_H
+#define MARGINLOSSCOSTFUNCTION_H
+#include <shogun/lib/config.h>
+#include <shogun/optimization/FirstOrderSAGCostFunction.h>
+#include <shogun/features/DotFeatures.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/loss/LossFunction.h>
+namespace shogun
+{
+
+/** @brief The cost function of a linear binary classifier trained with a
+ * margin loss
+ *
+ * \f[
+ * f(w)=\sum_i{ l(y_i w^T x_i) }
+ * \f]
+ * where \f$(y_i,x_i)\f$ is the i-th sample with label \f$y_i\in\{-1,+1\}\f$
+ * and \f$l\f$ is a loss of the margin such as CLogLoss, CSmoothHingeLoss or
+ * CSquaredHingeLoss.
+ *
+ * With CSparseFeatures<float64_t> the sample gradients are sparse, so
+ * minimizers can update the weights lazily (see supports_sparse_gradient())
+ * or go through the samples with several threads at once (see
+ * supports_sparse_sample_gradient()).
+ */
+class MarginLossCostFunction: public FirstOrderSAGCostFunction
+{
+public:
+	/** default constructor */
+	MarginLossCostFunction();
+
+	/** constructor
+	 *
+	 * @param features features of the samples
+	 * @param labels labels of the samples
+	 * @param loss margin loss
+	 */
+	MarginLossCostFunction(CDotFeatures* features, CBinaryLabels* labels,
+		CLossFunction* loss);
+
+	virtual ~MarginLossCostFunction();
+
+	/** Get the sample size
+	 *
+	 * @return the sample size
+	 */
+	virtual int32_t get_sample_size();
+
+	/** Get the index of the sample given by next_sample()
+	 *
+	 * @return index of the sample
+	 */
+	virtual index_t get_sample_index() { return m_sample_idx; }
+
+	/** Initialize to generate a sample sequence */
+	virtual void begin_sample();
+
+	/** Get next sample
+	 *
+	 * @return false if reach the end of the sample sequence
+	 */
+	virtual bool next_sample();
+
+	/** Obtain a reference of the weights, which are zero initially
+	 *
+	 * @return reference of weights
+	 */
+	virtual SGVector<float64_t> obtain_variable_reference();
+
+	/** Get the SAMPLE gradient of the sample given by next_sample()
+	 *
+	 * @return sample gradient of weights
+	 */
+	virtual SGVector<float64_t> get_gradient();
+
+	/** Get the AVERAGE gradient of all samples
+	 *
+	 * @return average gradient of weights
+	 */
+	virtual SGVector<float64_t> get_average_gradient();
+
+	/** Get the cost of all samples
+	 *
+	 * @return cost
+	 */
+	virtual float64_t get_cost();
+
+	/** Are the sample gradients sparse, i.e. are the features
+	 * CSparseFeatures<float64_t>?
+	 *
+	 * @return whether sparse sample gradients are supported
+	 */
+	virtual bool supports_sparse_gradient();
+
+	/** Get the indices of the non-zero features of the sample given by
+	 * next_sample()
+	 *
+	 * @return indices of weights
+	 */
+	virtual SGVector<index_t> get_gradient_support();
+
+	/** Get the SAMPLE gradient of the sample given by next_sample() as
+	 * sparse vector
+	 *
+	 * @return sparse sample gradient of weights
+	 */
+	virtual SGSparseVector<float64_t> get_sparse_gradient();
+
+	/** Are the sample gradients sparse, i.e. are the features
+	 * CSparseFeatures<float64_t>?
+	 *
+	 * @return whether get_sparse_sample_gradient() is supported
+	 */
+	virtual bool supports_sparse_sample_gradient();
+
+	/** Get the SAMPLE gradient of a given sample at given weights as
+	 * sparse vector, thread-safe
+	 *
+	 * @param sample_idx index of the sample
+	 * @param variable weights up to scaling
+	 * @param scale scaling of variable
+	 * @return sparse sample gradient of weights
+	 */
+	virtual SGSparseVector<float64_t> get_sparse_sample_gradient(index_t sample_idx,
+		SGVector<float64_t> variable, float64_t scale=1.0);
+
+	/** @return object name */
+	virtual const char* get_name() const { return "MarginLossCostFunction"; }
+
+private:
+	/** init */
+	void init();
+
+	/** derivative of the sample cost with respect to w^T x_i
+	 *
+	 * @param sample_idx index of the sample
+	 * @param weights weights up to scaling
+	 * @param scale scaling of weights
+	 */
+	float64_t get_derivative(index_t sample_idx, const SGVector<float64_t>& weights,
+		float64_t scale=1.0);
+
+	/** sparse gradient of a sample
+	 *
+	 * @param sample_idx index of the sample
+	 * @param derivative derivative of the sample cost with respect to w^T x_i
+	 */
+	SGSparseVector<float64_t> get_sparse_gradient(index_t sample_idx,
+		float64_t derivative);
+
+	/** features of the samples */
+	CDotFeatures* m_features;
+
+	/** labels of the samples */
+	CBinaryLabels* m_labels;
+
+	/** margin loss */
+	CLossFunction* m_loss;
+
+	/** weights */
+	SGVector<float64_t> m_weights;
+
+	/** index of the current sample */
+	index_t m_sample_idx;
+};
+
+}
+#endif
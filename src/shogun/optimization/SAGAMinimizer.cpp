@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) The Shogun Machine Learning Toolbox
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the Shogun Development Team.
+ *
+ */
+#include <shogun/optimization/SAGAMinimizer.h>
+#include <shogun/base/Parameter.h>
+using namespace shogun;
+
+SAGAMinimizer::SAGAMinimizer()
+	:FirstOrderStochasticMinimizer()
+{
+	init();
+}
+
+SAGAMinimizer::~SAGAMinimizer()
+{
+}
+
+SAGAMinimizer::SAGAMinimizer(FirstOrderSAGCostFunction *fun)
+	:FirstOrderStochasticMinimizer(fun)
+{
+	init();
+}
+
+void SAGAMinimizer::init()
+{
+	m_average_gradient=SGVector<float64_t>();
+	m_gradients=SGMatrix<float64_t>();
+	m_sparse_gradients=SGSparseMatrix<float64_t>();
+
+	SG_ADD(&m_average_gradient, "SAGAMinimizer__m_average_gradient",
+		"average_gradient in SAGAMinimizer", MS_NOT_AVAILABLE);
+}
+
+void SAGAMinimizer::init_minimization()
+{
+	FirstOrderStochasticMinimizer::init_minimization();
+	FirstOrderSAGCostFunction *fun=dynamic_cast<FirstOrderSAGCostFunction *>(m_fun);
+	REQUIRE(fun,"the cost function must be a stochastic average gradient cost function\n");
+
+	SGVector<float64_t> variable_reference=m_fun->obtain_variable_reference();
+	index_t num_samples=fun->get_sample_size();
+	m_average_gradient=SGVector<float64_t>(variable_reference.vlen);
+	m_average_gradient.zero();
+	if(supports_lazy_update())
+	{
+		m_gradients=SGMatrix<float64_t>();
+		m_sparse_gradients=SGSparseMatrix<float64_t>(variable_reference.vlen, num_samples);
+	}
+	else
+	{
+		m_gradients=SGMatrix<float64_t>(variable_reference.vlen, num_samples);
+		m_gradients.zero();
+		m_sparse_gradients=SGSparseMatrix<float64_t>();
+	}
+}
+
+float64_t SAGAMinimizer::minimize()
+{
+	init_minimization();
+	if(supports_lazy_update())
+		return minimize_lazily();
+
+	SGVector<float64_t> variable_reference=m_fun->obtain_variable_reference();
+	FirstOrderSAGCostFunction *fun=dynamic_cast<FirstOrderSAGCostFunction *>(m_fun);
+	float64_t num_samples=fun->get_sample_size();
+	SGVector<float64_t> grad(variable_reference.vlen);
+	for(;m_cur_passes<m_num_passes;m_cur_passes++)
+	{
+		fun->begin_sample();
+		while(fun->next_sample())
+		{
+			m_iter_counter++;
+			float64_t learning_rate=1.0;
+			if(m_learning_rate)
+				learning_rate=m_learning_rate->get_learning_rate(m_iter_counter);
+
+			index_t sample_idx=fun->get_sample_index();
+			REQUIRE(sample_idx>=0 && sample_idx<m_gradients.num_cols,
+				"Sample index (%d) must be between 0 and %d\n", sample_idx, m_gradients.num_cols-1);
+			SGVector<float64_t> grad_new=m_fun->get_gradient();
+			float64_t* grad_old=m_gradients.get_column_vector(sample_idx);
+
+			for(index_t idx=0; idx<grad.vlen; idx++)
+				grad[idx]=grad_new[idx]-grad_old[idx]+m_average_gradient[idx];
+
+			update_gradient(grad,variable_reference);
+			m_gradient_updater->update_variable(variable_reference,grad,learning_rate);
+
+			do_proximal_operation(variable_reference);
+
+			for(index_t idx=0; idx<grad.vlen; idx++)
+			{
+				m_average_gradient[idx]+=(grad_new[idx]-grad_old[idx])/num_samples;
+				grad_old[idx]=grad_new[idx];
+			}
+		}
+	}
+	float64_t cost=m_fun->get_cost();
+	return cost+get_penalty(variable_reference);
+}
+
+float64_t SAGAMinimizer::minimize_lazily()
+{
+	SGVector<float64_t> variable_reference=m_fun->obtain_variable_reference();
+	FirstOrderSAGCostFunction *fun=dynamic_cast<FirstOrderSAGCostFunction *>(m_fun);
+	float64_t num_samples=fun->get_sample_size();
+	for(;m_cur_passes<m_num_passes;m_cur_passes++)
+	{
+		begin_lazy_update(variable_reference.vlen);
+		fun->begin_sample();
+		while(fun->next_sample())
+		{
+			m_iter_counter++;
+			float64_t learning_rate=1.0;
+			if(m_learning_rate)
+				learning_rate=m_learning_rate->get_learning_rate(m_iter_counter);
+
+			index_t sample_idx=fun->get_sample_index();
+			REQUIRE(sample_idx>=0 && sample_idx<m_sparse_gradients.num_vectors,
+				"Sample index (%d) must be between 0 and %d\n", sample_idx, m_sparse_gradients.num_vectors-1);
+			SGVector<index_t> support=fun->get_gradient_support();
+			for(index_t idx=0; idx<support.vlen; idx++)
+				catch_up_lazy_variable(variable_reference, m_average_gradient, support[idx]);
+			SGSparseVector<float64_t> grad_new=fun->get_sparse_gradient();
+
+			/* the average gradient changes where the kept gradient is non-zero,
+			 * so these variables have to be up to date as well
+			 */
+			SGSparseVector<float64_t> grad_old=m_sparse_gradients[sample_idx];
+			for(index_t idx=0; idx<grad_old.num_feat_entries; idx++)
+				catch_up_lazy_variable(variable_reference, m_average_gradient, grad_old.features[idx].feat_index);
+
+			next_lazy_step(variable_reference, m_average_gradient, learning_rate);
+			for(index_t idx=0; idx<grad_new.num_feat_entries; idx++)
+			{
+				index_t feat_idx=grad_new.features[idx].feat_index;
+				catch_up_lazy_variable(variable_reference, m_average_gradient, feat_idx);
+				variable_reference[feat_idx]-=learning_rate*grad_new.features[idx].entry;
+			}
+			for(index_t idx=0; idx<grad_old.num_feat_entries; idx++)
+			{
+				index_t feat_idx=grad_old.features[idx].feat_index;
+				catch_up_lazy_variable(variable_reference, m_average_gradient, feat_idx);
+				variable_reference[feat_idx]+=learning_rate*grad_old.features[idx].entry;
+			}
+
+			for(index_t idx=0; idx<grad_new.num_feat_entries; idx++)
+				m_average_gradient[grad_new.features[idx].feat_index]+=grad_new.features[idx].entry/num_samples;
+			for(index_t idx=0; idx<grad_old.num_feat_entries; idx++)
+				m_average_gradient[grad_old.features[idx].feat_index]-=grad_old.features[idx].entry/num_samples;
+			m_sparse_gradients[sample_idx]=grad_new;
+		}
+		end_lazy_update(variable_reference, m_average_gradient);
+	}
+	float64_t cost=m_fun->get_cost();
+	return cost+get_penalty(variable_reference);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) The Shogun Machine Learning Toolbox
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the Shogun Development Team.
+ *
+ */
+
+#ifndef SAGAMINIMIZER_H
+#define SAGAMINIMIZER_H
+#include <shogun/optimization/FirstOrderStochasticMinimizer.h>
+#include <shogun/optimization/FirstOrderSAGCostFunction.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGSparseMatrix.h>
+namespace shogun
+{
+
+/** @brief The class implements the SAGA minimizer.
+ *
+ * SAGA keeps the last sample gradient of every sample. A step uses the
+ * sample gradient minus the one kept for the sample plus the average of
+ * the kept gradients, so unlike SVRG no passes through the data are needed
+ * to compute average gradients. The kept gradients start at zero.
+ *
+ * With dense sample gradients, the kept gradients need memory for
+ * get_sample_size() times the number of target variables. If the cost
+ * function provides sparse sample gradients, only their non-zero elements
+ * are kept and steps are lazy (see supports_lazy_update()).
+ *
+ * The cost function must implement
+ * FirstOrderSAGCostFunction::get_sample_index().
+ *
+ * Reference:
+ * Defazio, Aaron, Francis Bach, and Simon Lacoste-Julien.
+ * "SAGA: A fast incremental gradient method with support for non-strongly
+ * convex composite objectives."
+ * Advances in Neural Information Processing Systems. 2014.
+ */
+
+class SAGAMinimizer: public FirstOrderStochasticMinimizer
+{
+public:
+	/** Default constructor */
+	SAGAMinimizer();
+
+	/** Constructor
+	 * @param fun stochastic cost function
+	 */
+	SAGAMinimizer(FirstOrderSAGCostFunction *fun);
+
+	/** Destructor */
+	virtual ~SAGAMinimizer();
+
+	/** Do minimization and get the optimal value 
+	 * 
+	 * @return optimal value
+	 */
+	virtual float64_t minimize();
+
+	/** returns the name of the class
+	 *
+	 * @return name SAGAMinimizer
+	 */
+	virtual const char* get_name() const { return "SAGAMinimizer"; }
+
+protected:
+	/**  init the minimization process */
+	virtual void init_minimization();
+
+	/** Do minimization with lazy updates of the target variables, see
+	 * FirstOrderStochasticMinimizer::supports_lazy_update()
+	 *
+	 * @return optimal value
+	 */
+	virtual float64_t minimize_lazily();
+
+	/**  average of the kept sample gradients */
+	SGVector<float64_t> m_average_gradient;
+
+	/**  kept dense sample gradients, one column per sample */
+	SGMatrix<float64_t> m_gradients;
+
+	/**  kept sparse sample gradients, one vector per sample */
+	SGSparseMatrix<float64_t> m_sparse_gradients;
+private:
+	/** Init */
+	void init();
+};
+
+}
+#endif /* SAGAMINIMIZER_H */
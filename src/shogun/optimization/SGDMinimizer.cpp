@@ -30,7 +30,12 @@
  */
 #include <shogun/optimization/SGDMinimizer.h>
 #include <shogun/optimization/GradientDescendUpdater.h>
+#include <shogun/optimization/L2Penalty.h>
 #include <shogun/lib/config.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/base/Parameter.h>
+#include <shogun/base/Parallel.h>
+#include <shogun/mathematics/Math.h>
 using namespace shogun;
 
 SGDMinimizer::SGDMinimizer()
@@ -56,6 +61,19 @@ float64_t SGDMinimizer::minimize()
 	SGVector<float64_t> variable_reference=m_fun->obtain_variable_reference();
 	FirstOrderStochasticCostFunction *fun=dynamic_cast<FirstOrderStochasticCostFunction *>(m_fun);
 	REQUIRE(fun,"the cost function must be a stochastic cost function\n");
+	int32_t num_threads=parallel->get_num_threads();
+	if(m_parallel_mode!=PSGD_SERIAL && num_threads>1)
+	{
+		if(supports_parallel_minimization())
+			return minimize_in_parallel(num_threads);
+
+		SG_WARNING("The cost function, gradient updater or penalty do not "
+			"support parallel minimization, minimizing serially\n");
+	}
+
+	if(supports_lazy_update())
+		return minimize_lazily();
+
 	for(;m_cur_passes<m_num_passes;m_cur_passes++)
 	{
 		fun->begin_sample();
@@ -76,8 +94,154 @@ float64_t SGDMinimizer::minimize()
 	return cost+get_penalty(variable_reference);
 }
 
+float64_t SGDMinimizer::minimize_lazily()
+{
+	SGVector<float64_t> variable_reference=m_fun->obtain_variable_reference();
+	FirstOrderStochasticCostFunction *fun=dynamic_cast<FirstOrderStochasticCostFunction *>(m_fun);
+	SGVector<float64_t> no_direction;
+	for(;m_cur_passes<m_num_passes;m_cur_passes++)
+	{
+		begin_lazy_update(variable_reference.vlen);
+		fun->begin_sample();
+		while(fun->next_sample())
+		{
+			m_iter_counter++;
+			float64_t learning_rate=1.0;
+			if(m_learning_rate)
+				learning_rate=m_learning_rate->get_learning_rate(m_iter_counter);
+
+			SGVector<index_t> support=fun->get_gradient_support();
+			for(index_t idx=0; idx<support.vlen; idx++)
+				catch_up_lazy_variable(variable_reference, no_direction, support[idx]);
+			SGSparseVector<float64_t> grad=fun->get_sparse_gradient();
+
+			next_lazy_step(variable_reference, no_direction, learning_rate);
+			for(index_t idx=0; idx<grad.num_feat_entries; idx++)
+			{
+				index_t feat_idx=grad.features[idx].feat_index;
+				catch_up_lazy_variable(variable_reference, no_direction, feat_idx);
+				variable_reference[feat_idx]-=learning_rate*grad.features[idx].entry;
+			}
+		}
+		end_lazy_update(variable_reference, no_direction);
+	}
+	float64_t cost=m_fun->get_cost();
+	return cost+get_penalty(variable_reference);
+}
+
+bool SGDMinimizer::supports_parallel_minimization()
+{
+	FirstOrderSAGCostFunction *fun=dynamic_cast<FirstOrderSAGCostFunction *>(m_fun);
+	if(!fun || !fun->supports_sparse_sample_gradient())
+		return false;
+
+	GradientDescendUpdater* updater=dynamic_cast<GradientDescendUpdater*>(m_gradient_updater);
+	if(!updater || updater->enables_descend_correction())
+		return false;
+
+	return !m_penalty_type || dynamic_cast<L2Penalty*>(m_penalty_type);
+}
+
+float64_t SGDMinimizer::minimize_in_parallel(int32_t num_threads)
+{
+	SGVector<float64_t> variable_reference=m_fun->obtain_variable_reference();
+	FirstOrderSAGCostFunction *fun=dynamic_cast<FirstOrderSAGCostFunction *>(m_fun);
+	index_t num_samples=fun->get_sample_size();
+	num_threads=CMath::max(1, CMath::min(num_threads, num_samples));
+
+	// private variables of the threads in PSGD_AVERAGED mode
+	SGMatrix<float64_t> thread_variables;
+	if(m_parallel_mode==PSGD_AVERAGED)
+		thread_variables=SGMatrix<float64_t>(variable_reference.vlen, num_threads);
+
+	for(;m_cur_passes<m_num_passes;m_cur_passes++)
+	{
+		if(m_parallel_mode==PSGD_AVERAGED)
+		{
+			for(int32_t k=0; k<num_threads; k++)
+			{
+				std::copy(variable_reference.vector, variable_reference.vector+variable_reference.vlen,
+					thread_variables.get_column_vector(k));
+			}
+		}
+
+		/* thread k does every num_threads-th step of a serial pass, so all
+		 * steps use the same learning rates as in a serial pass */
+#pragma omp parallel for num_threads(num_threads)
+		for(int32_t k=0; k<num_threads; k++)
+		{
+			index_t first=int64_t(num_samples)*k/num_threads;
+			index_t last=int64_t(num_samples)*(k+1)/num_threads;
+			if(m_parallel_mode==PSGD_AVERAGED)
+			{
+				SGVector<float64_t> variable(thread_variables.get_column_vector(k),
+					variable_reference.vlen, false);
+				minimize_shard(variable, first, last, m_iter_counter+k+1, num_threads);
+			}
+			else
+			{
+				// Hogwild!, the variables are shared without locks
+				minimize_shard(variable_reference, first, last, m_iter_counter+k+1, num_threads);
+			}
+		}
+		m_iter_counter+=num_samples;
+
+		if(m_parallel_mode==PSGD_AVERAGED)
+		{
+			variable_reference.zero();
+			for(int32_t k=0; k<num_threads; k++)
+			{
+				float64_t weight=float64_t(int64_t(num_samples)*(k+1)/num_threads-
+					int64_t(num_samples)*k/num_threads)/num_samples;
+				SGVector<float64_t>::vec1_plus_scalar_times_vec2(variable_reference.vector,
+					weight, thread_variables.get_column_vector(k), variable_reference.vlen);
+			}
+		}
+	}
+	float64_t cost=m_fun->get_cost();
+	return cost+get_penalty(variable_reference);
+}
+
+void SGDMinimizer::minimize_shard(SGVector<float64_t> variable, index_t first,
+	index_t last, int32_t first_step, int32_t step_stride)
+{
+	FirstOrderSAGCostFunction *fun=dynamic_cast<FirstOrderSAGCostFunction *>(m_fun);
+
+	// scaling of the L2 penalty not applied to the variables yet
+	float64_t scale=1.0;
+	index_t num_updated=0;
+	int32_t step=first_step;
+	for(index_t idx=first; idx<last; idx++, step+=step_stride)
+	{
+		float64_t learning_rate=1.0;
+		if(m_learning_rate)
+			learning_rate=m_learning_rate->get_learning_rate(step);
+
+		// the gradient at the true variables scale*variable
+		SGSparseVector<float64_t> grad=fun->get_sparse_sample_gradient(idx, variable, scale);
+		for(index_t k=0; k<grad.num_feat_entries; k++)
+			variable[grad.features[k].feat_index]-=learning_rate*grad.features[k].entry/scale;
+
+		if(m_penalty_type)
+		{
+			scale*=1.0-learning_rate*m_penalty_weight;
+			num_updated+=grad.num_feat_entries;
+			if(num_updated>=variable.vlen || scale<0.5 || idx==last-1)
+			{
+				SGVector<float64_t>::scale_vector(scale, variable.vector, variable.vlen);
+				scale=1.0;
+				num_updated=0;
+			}
+		}
+	}
+}
+
 void SGDMinimizer::init()
 {
+	m_parallel_mode=PSGD_SERIAL;
+
+	SG_ADD((machine_int_t*) &m_parallel_mode, "SGDMinimizer__m_parallel_mode",
+		"parallel_mode in SGDMinimizer", MS_NOT_AVAILABLE);
 }
 
 void SGDMinimizer::init_minimization()
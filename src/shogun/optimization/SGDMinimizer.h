@@ -32,10 +32,37 @@
 #ifndef SGDMINIMIZER_H
 #define SGDMINIMIZER_H
 #include <shogun/optimization/FirstOrderStochasticMinimizer.h>
+#include <shogun/optimization/FirstOrderSAGCostFunction.h>
 
 namespace shogun
 {
 
+/** how threads of parallel stochastic gradient descent share the target
+ * variables
+ */
+enum EParallelSGDMode
+{
+	/** a single thread goes through all samples, deterministic */
+	PSGD_SERIAL=0,
+	/** every thread goes through its own shard of the samples and updates
+	 * the shared variables without locks (Hogwild!). Updates of different
+	 * threads can overwrite each other, which rarely matters when the
+	 * gradients are sparse, and results depend on the timing of the threads.
+	 *
+	 * Reference: Niu, Feng, et al. "Hogwild!: A lock-free approach to
+	 * parallelizing stochastic gradient descent." NIPS 2011.
+	 */
+	PSGD_HOGWILD=1,
+	/** every thread goes through its own shard of the samples with a
+	 * private copy of the variables, and the copies are averaged after each
+	 * pass. Deterministic for a fixed number of threads.
+	 *
+	 * Reference: Zinkevich, Martin, et al. "Parallelized stochastic gradient
+	 * descent." NIPS 2010.
+	 */
+	PSGD_AVERAGED=2
+};
+
 /** @brief The class implements the stochastic gradient descend (SGD) minimizer.
  *
  * A good introduction to SGD can be found at
@@ -69,10 +96,68 @@ public:
 	 */
 	virtual float64_t minimize();
 
+	/** Set how the minimization is parallelized
+	 *
+	 * PSGD_HOGWILD and PSGD_AVERAGED split the samples between
+	 * parallel->get_num_threads() threads. They need a
+	 * FirstOrderSAGCostFunction which supports sparse sample gradients
+	 * (see FirstOrderSAGCostFunction::get_sparse_sample_gradient()), such
+	 * as MarginLossCostFunction with sparse features, a
+	 * GradientDescendUpdater without descend correction and no penalty or
+	 * an L2 penalty; otherwise and with one thread the minimization is
+	 * serial. The threads apply the scaling of the L2 penalty to all
+	 * variables at once, after their sample gradients had as many non-zero
+	 * elements as there are variables or the scaling reached one half, and
+	 * evaluate the sample gradients at the scaled variables meanwhile.
+	 *
+	 * @param mode parallel mode, PSGD_SERIAL by default
+	 */
+	virtual void set_parallel_mode(EParallelSGDMode mode) { m_parallel_mode=mode; }
+
+	/** Get the parallel mode
+	 *
+	 * @return parallel mode
+	 */
+	virtual EParallelSGDMode get_parallel_mode() const { return m_parallel_mode; }
+
 protected:
 	/*  init the minimization process */
 	virtual void init_minimization();
 
+	/** Do minimization with lazy updates of the target variables, see
+	 * FirstOrderStochasticMinimizer::supports_lazy_update()
+	 *
+	 * @return optimal value
+	 */
+	virtual float64_t minimize_lazily();
+
+	/** Can the minimization run in the parallel mode?
+	 *
+	 * @return whether the requirements of set_parallel_mode() are met
+	 */
+	virtual bool supports_parallel_minimization();
+
+	/** Do minimization with several threads, see set_parallel_mode()
+	 *
+	 * @param num_threads number of threads
+	 * @return optimal value
+	 */
+	virtual float64_t minimize_in_parallel(int32_t num_threads);
+
+	/** Do SGD steps on a shard of samples
+	 *
+	 * @param variable target variables to update
+	 * @param first first sample of the shard
+	 * @param last sample after the last one of the shard
+	 * @param first_step iteration counter of the first step
+	 * @param step_stride increment of the iteration counter between steps
+	 */
+	virtual void minimize_shard(SGVector<float64_t> variable, index_t first,
+		index_t last, int32_t first_step, int32_t step_stride);
+
+	/** how the minimization is parallelized */
+	EParallelSGDMode m_parallel_mode;
+
 private:
 	  /* Init */
 	void init();
@@ -93,6 +93,9 @@ float64_t SVRGMinimizer::minimize()
 	SGVector<float64_t> variable_reference=m_fun->obtain_variable_reference();
 	FirstOrderSAGCostFunction *fun=dynamic_cast<FirstOrderSAGCostFunction *>(m_fun);
 	REQUIRE(fun,"the cost function must be a stochastic average gradient cost function\n");
+	if(supports_lazy_update())
+		return minimize_lazily();
+
 	for(;m_cur_passes<(m_num_passes-m_num_sgd_passes);m_cur_passes++)
 	{
 		if(m_cur_passes%m_svrg_interval==0)
@@ -131,3 +134,62 @@ float64_t SVRGMinimizer::minimize()
 	float64_t cost=m_fun->get_cost();
 	return cost+get_penalty(variable_reference);
 }
+
+float64_t SVRGMinimizer::minimize_lazily()
+{
+	SGVector<float64_t> variable_reference=m_fun->obtain_variable_reference();
+	FirstOrderSAGCostFunction *fun=dynamic_cast<FirstOrderSAGCostFunction *>(m_fun);
+	for(;m_cur_passes<(m_num_passes-m_num_sgd_passes);m_cur_passes++)
+	{
+		if(m_cur_passes%m_svrg_interval==0)
+		{
+			if(m_previous_variable.vlen==0)
+				m_previous_variable=SGVector<float64_t>(variable_reference.vlen);
+
+			std::copy(variable_reference.vector, variable_reference.vector+variable_reference.vlen, m_previous_variable.vector);
+			m_average_gradient=fun->get_average_gradient();
+		}
+		begin_lazy_update(variable_reference.vlen);
+		fun->begin_sample();
+		while(fun->next_sample())
+		{
+			m_iter_counter++;
+			float64_t learning_rate=1.0;
+			if(m_learning_rate)
+				learning_rate=m_learning_rate->get_learning_rate(m_iter_counter);
+
+			SGVector<index_t> support=fun->get_gradient_support();
+			for(index_t idx=0; idx<support.vlen; idx++)
+				catch_up_lazy_variable(variable_reference, m_average_gradient, support[idx]);
+			SGSparseVector<float64_t> grad_new=fun->get_sparse_gradient();
+
+			// the sample gradient only depends on the variables in its support
+			SGVector<float64_t> var(support.vlen);
+			for(index_t idx=0; idx<support.vlen; idx++)
+			{
+				var[idx]=variable_reference[support[idx]];
+				variable_reference[support[idx]]=m_previous_variable[support[idx]];
+			}
+			SGSparseVector<float64_t> grad_old=fun->get_sparse_gradient();
+			for(index_t idx=support.vlen-1; idx>=0; idx--)
+				variable_reference[support[idx]]=var[idx];
+
+			next_lazy_step(variable_reference, m_average_gradient, learning_rate);
+			for(index_t idx=0; idx<grad_new.num_feat_entries; idx++)
+			{
+				index_t feat_idx=grad_new.features[idx].feat_index;
+				catch_up_lazy_variable(variable_reference, m_average_gradient, feat_idx);
+				variable_reference[feat_idx]-=learning_rate*grad_new.features[idx].entry;
+			}
+			for(index_t idx=0; idx<grad_old.num_feat_entries; idx++)
+			{
+				index_t feat_idx=grad_old.features[idx].feat_index;
+				catch_up_lazy_variable(variable_reference, m_average_gradient, feat_idx);
+				variable_reference[feat_idx]+=learning_rate*grad_old.features[idx].entry;
+			}
+		}
+		end_lazy_update(variable_reference, m_average_gradient);
+	}
+	float64_t cost=m_fun->get_cost();
+	return cost+get_penalty(variable_reference);
+}
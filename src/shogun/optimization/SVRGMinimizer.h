@@ -116,6 +116,13 @@ protected:
 	/**  init the minimization process */
 	virtual void init_minimization();
 
+	/** Do minimization with lazy updates of the target variables, see
+	 * FirstOrderStochasticMinimizer::supports_lazy_update()
+	 *
+	 * @return optimal value
+	 */
+	virtual float64_t minimize_lazily();
+
 	/** the number to go through data  using SGD before SVRG update */
 	int32_t m_num_sgd_passes;
 
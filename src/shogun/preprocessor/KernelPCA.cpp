@@ -22,8 +22,173 @@
 #include <shogun/preprocessor/DimensionReductionPreprocessor.h>
 #include <shogun/features/Features.h>
 #include <shogun/io/SGIO.h>
+#include <shogun/mathematics/eigen3.h>
 
 using namespace shogun;
+using namespace Eigen;
+
+/** number of kernel matrix rows a thread computes at once */
+#define KPCA_ROW_BLOCK_SIZE 16
+
+/** KPCA_AUTO uses the iterative method from this number of vectors on */
+#define KPCA_ITERATIVE_MIN_VECTORS 2000
+
+namespace
+{
+
+/** Products of the centered kernel matrix HKH, H=I-11'/n, with vectors.
+ * The kernel matrix is computed a block of rows at a time, in parallel, and
+ * is never stored
+ */
+struct CenteredKernelProduct
+{
+	CenteredKernelProduct(CKernel* k) : kernel(k) { }
+
+	index_t rows() const { return kernel->get_num_vec_lhs(); }
+
+	/** Y=K*X for the uncentered kernel matrix */
+	MatrixXd uncentered(const MatrixXd& X) const
+	{
+		index_t n = rows();
+		MatrixXd Y(n, X.cols());
+
+		#pragma omp parallel
+		{
+			MatrixXd K(KPCA_ROW_BLOCK_SIZE, n);
+
+			#pragma omp for schedule(dynamic)
+			for (index_t b=0; b<n; b+=KPCA_ROW_BLOCK_SIZE)
+			{
+				index_t len = CMath::min<index_t>(KPCA_ROW_BLOCK_SIZE, n-b);
+				for (index_t j=0; j<n; j++)
+				{
+					for (index_t i=0; i<len; i++)
+						K(i,j) = kernel->kernel(b+i, j);
+				}
+				Y.middleRows(b, len) = K.topRows(len)*X;
+			}
+		}
+
+		return Y;
+	}
+
+	MatrixXd operator()(const MatrixXd& X) const
+	{
+		MatrixXd Y = uncentered(X.rowwise()-X.colwise().mean());
+		return Y.rowwise()-Y.colwise().mean();
+	}
+
+	CKernel* kernel;
+};
+
+/** Computes the top k eigenpairs of a symmetric operator with thick restart
+ * Lanczos iterations [Wu and Simon, 2000]. The basis is reorthogonalized
+ * fully, it is small as only the top eigenpairs are needed
+ *
+ * @param A product of the operator with a matrix
+ * @param k number of eigenpairs
+ * @param max_restarts maximum number of restarts
+ * @param tolerance eigenpairs are converged when their residuals are below
+ * tolerance times the largest eigenvalue
+ * @param eigenvalues top k eigenvalues, descending
+ * @param eigenvectors corresponding eigenvectors
+ * @return whether the eigenpairs converged
+ */
+template <class Operator>
+bool lanczos_top_eigenpairs(const Operator& A, int32_t k, int32_t max_restarts,
+	float64_t tolerance, SGVector<float64_t>& eigenvalues,
+	SGMatrix<float64_t>& eigenvectors)
+{
+	index_t n = A.rows();
+	index_t m = CMath::min<index_t>(n, CMath::max(2*k+1, k+20));
+
+	MatrixXd V(n, m+1);
+	MatrixXd T = MatrixXd::Zero(m, m);
+	for (index_t i=0; i<n; i++)
+		V(i,0) = CMath::randn_double();
+	V.col(0).normalize();
+
+	SelfAdjointEigenSolver<MatrixXd> eigen_solver;
+	float64_t beta = 0;
+	bool converged = false;
+	index_t start = 0;
+
+	for (int32_t restart=0; restart<=max_restarts; restart++)
+	{
+		for (index_t j=start; j<m; j++)
+		{
+			VectorXd w = A(V.col(j));
+
+			// twice is enough to keep the basis orthogonal [Parlett]
+			VectorXd h = V.leftCols(j+1).transpose()*w;
+			w -= V.leftCols(j+1)*h;
+			VectorXd h2 = V.leftCols(j+1).transpose()*w;
+			w -= V.leftCols(j+1)*h2;
+			h += h2;
+
+			T.col(j).head(j+1) = h;
+			T.row(j).head(j+1) = h.transpose();
+
+			beta = w.norm();
+			if (beta<=CMath::MACHINE_EPSILON*CMath::abs(T(0,0)) && j+1<m)
+			{
+				// invariant subspace found, continue with a random
+				// direction orthogonal to it
+				for (index_t i=0; i<n; i++)
+					w[i] = CMath::randn_double();
+				w -= V.leftCols(j+1)*(V.leftCols(j+1).transpose()*w);
+				w -= V.leftCols(j+1)*(V.leftCols(j+1).transpose()*w);
+				beta = 0;
+				V.col(j+1) = w.normalized();
+			}
+			else
+				V.col(j+1) = w/beta;
+
+			if (j+1<m)
+			{
+				T(j+1,j) = beta;
+				T(j,j+1) = beta;
+			}
+		}
+
+		// Ritz values are in ascending order, the residual of a Ritz pair
+		// is beta times the last entry of its eigenvector of T
+		eigen_solver.compute(T);
+		const VectorXd& theta = eigen_solver.eigenvalues();
+		const MatrixXd& S = eigen_solver.eigenvectors();
+
+		float64_t scale = CMath::max(CMath::abs(theta[m-1]), CMath::abs(theta[0]));
+		converged = true;
+		for (index_t i=m-k; i<m; i++)
+			converged &= CMath::abs(beta*S(m-1,i))<=tolerance*scale;
+
+		if (converged || restart==max_restarts || m==n)
+			break;
+
+		// keep the top Ritz vectors and the last Lanczos vector
+		index_t p = CMath::min(m-1, k+(m-k)/2);
+		V.leftCols(p) = V.leftCols(m)*S.rightCols(p);
+		V.col(p) = V.col(m);
+
+		T.setZero();
+		T.diagonal().head(p) = theta.tail(p);
+		start = p;
+	}
+
+	const VectorXd& theta = eigen_solver.eigenvalues();
+	const MatrixXd& S = eigen_solver.eigenvectors();
+
+	eigenvalues = SGVector<float64_t>(k);
+	eigenvectors = SGMatrix<float64_t>(n, k);
+	Map<VectorXd> values(eigenvalues.vector, k);
+	Map<MatrixXd> vectors(eigenvectors.matrix, n, k);
+	values = theta.tail(k).reverse();
+	vectors = V.leftCols(m)*S.rightCols(k).rowwise().reverse();
+
+	return converged || m==n;
+}
+
+}
 
 CKernelPCA::CKernelPCA() : CDimensionReductionPreprocessor()
 {
@@ -42,11 +207,20 @@ void CKernelPCA::init()
 	m_init_features = NULL;
 	m_transformation_matrix = SGMatrix<float64_t>();
 	m_bias_vector = SGVector<float64_t>();
+	m_method = KPCA_AUTO;
+	m_tolerance = 1e-10;
+	m_max_restarts = 100;
 
 	SG_ADD(&m_transformation_matrix, "transformation_matrix",
 		"matrix used to transform data", MS_NOT_AVAILABLE);
 	SG_ADD(&m_bias_vector, "bias_vector",
 		"bias vector used to transform data", MS_NOT_AVAILABLE);
+	SG_ADD((machine_int_t*) &m_method, "method",
+		"Method used to compute the eigenvectors", MS_NOT_AVAILABLE);
+	SG_ADD(&m_tolerance, "tolerance",
+		"Tolerance of iterative method", MS_NOT_AVAILABLE);
+	SG_ADD(&m_max_restarts, "max_restarts",
+		"Maximum number of restarts of iterative method", MS_NOT_AVAILABLE);
 }
 
 void CKernelPCA::cleanup()
@@ -74,49 +248,92 @@ bool CKernelPCA::init(CFeatures* features)
 		m_init_features = features;
 
 		m_kernel->init(features,features);
-		SGMatrix<float64_t> kernel_matrix = m_kernel->get_kernel_matrix();
-		m_kernel->cleanup();
-		int32_t n = kernel_matrix.num_cols;
-		int32_t m = kernel_matrix.num_rows;
-		ASSERT(n==m)
+		int32_t n = m_kernel->get_num_vec_lhs();
+		REQUIRE(m_target_dim>0 && m_target_dim<=n, "Target dimension (%d) "
+			"must be positive and at most the number of vectors (%d)\n",
+			m_target_dim, n)
 
-		float64_t* bias_tmp = SGMatrix<float64_t>::get_column_sum(kernel_matrix.matrix, n,n);
-		SGVector<float64_t>::scale_vector(-1.0/n, bias_tmp, n);
-		float64_t s = SGVector<float64_t>::sum(bias_tmp, n)/n;
-		SGVector<float64_t>::add_scalar(-s, bias_tmp, n);
+		EKernelPCAMethod method = m_method;
+		if (method==KPCA_AUTO)
+		{
+			method = (n>=KPCA_ITERATIVE_MIN_VECTORS && 10*m_target_dim<n) ?
+				KPCA_ITERATIVE : KPCA_FULL;
+		}
+
+		// column sums of the kernel matrix, bias_tmp=-colsums/n+sum/n^2
+		SGVector<float64_t> bias_tmp;
+		SGVector<float64_t> eigenvalues;
+
+		if (method==KPCA_FULL)
+		{
+			SGMatrix<float64_t> kernel_matrix = m_kernel->get_kernel_matrix();
+			int32_t m = kernel_matrix.num_rows;
+			ASSERT(n==m)
+
+			bias_tmp = SGVector<float64_t>(
+				SGMatrix<float64_t>::get_column_sum(kernel_matrix.matrix, n,n), n);
+
+			SGMatrix<float64_t>::center_matrix(kernel_matrix.matrix, n, m);
 
-		SGMatrix<float64_t>::center_matrix(kernel_matrix.matrix, n, m);
+			float64_t* all_eigenvalues=SGMatrix<float64_t>::compute_eigenvectors(kernel_matrix.matrix, n, n);
 
-		float64_t* eigenvalues=SGMatrix<float64_t>::compute_eigenvectors(kernel_matrix.matrix, n, n);
+			// eigenvalues are in ascending order
+			eigenvalues = SGVector<float64_t>(m_target_dim);
+			m_transformation_matrix = SGMatrix<float64_t>(n, m_target_dim);
+			for (int32_t k=0; k<m_target_dim; k++)
+			{
+				eigenvalues[k] = all_eigenvalues[n-k-1];
+				memcpy(m_transformation_matrix.get_column_vector(k),
+					kernel_matrix.get_column_vector(n-k-1), sizeof(float64_t)*n);
+			}
 
-		for (int32_t i=0; i<n; i++)
+			SG_FREE(all_eigenvalues);
+		}
+		else
+		{
+			CenteredKernelProduct kernel_product(m_kernel);
+
+			bias_tmp = SGVector<float64_t>(n);
+			Map<VectorXd>(bias_tmp.vector, n) =
+				kernel_product.uncentered(VectorXd::Ones(n));
+
+			SG_INFO("Computing %d eigenvectors with Lanczos iterations\n", m_target_dim)
+			if (!lanczos_top_eigenpairs(kernel_product, m_target_dim,
+				m_max_restarts, m_tolerance, eigenvalues, m_transformation_matrix))
+			{
+				SG_WARNING("Eigenvectors did not converge within %d restarts\n",
+					m_max_restarts)
+			}
+		}
+		m_kernel->cleanup();
+
+		SGVector<float64_t>::scale_vector(-1.0/n, bias_tmp.vector, n);
+		float64_t s = SGVector<float64_t>::sum(bias_tmp.vector, n)/n;
+		SGVector<float64_t>::add_scalar(-s, bias_tmp.vector, n);
+
+		for (int32_t i=0; i<m_target_dim; i++)
 		{
 			//normalize and trap divide by zero and negative eigenvalues
 			for (int32_t j=0; j<n; j++)
-				kernel_matrix.matrix[i*n+j]/=CMath::sqrt(CMath::max(1e-16,eigenvalues[i]));
+				m_transformation_matrix.matrix[i*n+j]/=CMath::sqrt(CMath::max(1e-16,eigenvalues[i]));
 		}
 
-		SG_FREE(eigenvalues);
-
-		m_transformation_matrix = SGMatrix<float64_t>(kernel_matrix.matrix,n,n);
-		kernel_matrix.matrix = NULL;
-		m_bias_vector = SGVector<float64_t>(n);
+		m_bias_vector = SGVector<float64_t>(m_target_dim);
 		SGVector<float64_t>::fill_vector(m_bias_vector.vector, m_bias_vector.vlen, 0.0);
 
 		cblas_dgemv(CblasColMajor, CblasTrans,
-				n, n, 1.0, m_transformation_matrix.matrix, n,
-				bias_tmp, 1, 0.0, m_bias_vector.vector, 1);
+				n, m_target_dim, 1.0, m_transformation_matrix.matrix, n,
+				bias_tmp.vector, 1, 0.0, m_bias_vector.vector, 1);
 
-		float64_t* rowsum = SGMatrix<float64_t>::get_row_sum(m_transformation_matrix.matrix, n, n);
-		SGVector<float64_t>::scale_vector(1.0/n, rowsum, n);
+		float64_t* rowsum = SGMatrix<float64_t>::get_row_sum(m_transformation_matrix.matrix, n, m_target_dim);
+		SGVector<float64_t>::scale_vector(1.0/n, rowsum, m_target_dim);
 
-		for (int32_t i=0; i<n; i++)
+		for (int32_t i=0; i<m_target_dim; i++)
 		{
 			for (int32_t j=0; j<n; j++)
 				m_transformation_matrix.matrix[j+n*i] -= rowsum[i];
 		}
 		SG_FREE(rowsum);
-		SG_FREE(bias_tmp);
 
 		m_initialized=true;
 		SG_INFO("Done\n")
@@ -129,11 +346,15 @@ bool CKernelPCA::init(CFeatures* features)
 SGMatrix<float64_t> CKernelPCA::apply_to_feature_matrix(CFeatures* features)
 {
 	ASSERT(m_initialized)
+	REQUIRE(m_target_dim<=m_transformation_matrix.num_cols, "Target dimension "
+		"(%d) must be at most the number of computed components (%d), "
+		"re-initialize after changing it\n", m_target_dim,
+		m_transformation_matrix.num_cols)
 	CDenseFeatures<float64_t>* simple_features = (CDenseFeatures<float64_t>*)features;
 
 	int32_t num_vectors = simple_features->get_num_vectors();
 	int32_t i,j,k;
-	int32_t n = m_transformation_matrix.num_cols;
+	int32_t n = m_transformation_matrix.num_rows;
 
 	m_kernel->init(features,m_init_features);
 
@@ -149,7 +370,7 @@ SGMatrix<float64_t> CKernelPCA::apply_to_feature_matrix(CFeatures* features)
 			float64_t kij = m_kernel->kernel(i,j);
 
 			for (k=0; k<m_target_dim; k++)
-				new_feature_matrix[k+i*m_target_dim] += kij*m_transformation_matrix.matrix[(n-k-1)*n+j];
+				new_feature_matrix[k+i*m_target_dim] += kij*m_transformation_matrix.matrix[k*n+j];
 		}
 	}
 
@@ -161,12 +382,16 @@ SGMatrix<float64_t> CKernelPCA::apply_to_feature_matrix(CFeatures* features)
 SGVector<float64_t> CKernelPCA::apply_to_feature_vector(SGVector<float64_t> vector)
 {
 	ASSERT(m_initialized)
+	REQUIRE(m_target_dim<=m_transformation_matrix.num_cols, "Target dimension "
+		"(%d) must be at most the number of computed components (%d), "
+		"re-initialize after changing it\n", m_target_dim,
+		m_transformation_matrix.num_cols)
 	SGVector<float64_t> result = SGVector<float64_t>(m_target_dim);
 	m_kernel->init(new CDenseFeatures<float64_t>(SGMatrix<float64_t>(vector.vector,vector.vlen,1)),
 	               m_init_features);
 
 	int32_t j,k;
-	int32_t n = m_transformation_matrix.num_cols;
+	int32_t n = m_transformation_matrix.num_rows;
 
 	for (j=0; j<m_target_dim; j++)
 		result.vector[j] = m_bias_vector.vector[j];
@@ -176,7 +401,7 @@ SGVector<float64_t> CKernelPCA::apply_to_feature_vector(SGVector<float64_t> vect
 		float64_t kj = m_kernel->kernel(0,j);
 
 		for (k=0; k<m_target_dim; k++)
-			result.vector[k] += kj*m_transformation_matrix.matrix[(n-k-1)*n+j];
+			result.vector[k] += kj*m_transformation_matrix.matrix[k*n+j];
 	}
 
 	m_kernel->cleanup();
@@ -186,10 +411,14 @@ SGVector<float64_t> CKernelPCA::apply_to_feature_vector(SGVector<float64_t> vect
 CDenseFeatures<float64_t>* CKernelPCA::apply_to_string_features(CFeatures* features)
 {
 	ASSERT(m_initialized)
+	REQUIRE(m_target_dim<=m_transformation_matrix.num_cols, "Target dimension "
+		"(%d) must be at most the number of computed components (%d), "
+		"re-initialize after changing it\n", m_target_dim,
+		m_transformation_matrix.num_cols)
 
 	int32_t num_vectors = features->get_num_vectors();
 	int32_t i,j,k;
-	int32_t n = m_transformation_matrix.num_cols;
+	int32_t n = m_transformation_matrix.num_rows;
 
 	m_kernel->init(features,m_init_features);
 
@@ -205,7 +434,7 @@ CDenseFeatures<float64_t>* CKernelPCA::apply_to_string_features(CFeatures* featu
 			float64_t kij = m_kernel->kernel(i,j);
 
 			for (k=0; k<m_target_dim; k++)
-				new_feature_matrix[k+i*m_target_dim] += kij*m_transformation_matrix.matrix[(n-k-1)*n+j];
+				new_feature_matrix[k+i*m_target_dim] += kij*m_transformation_matrix.matrix[k*n+j];
 		}
 	}
 
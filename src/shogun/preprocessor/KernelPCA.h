@@ -24,6 +24,29 @@ namespace shogun
 class CFeatures;
 class CKernel;
 
+/** method CKernelPCA computes the top eigenvectors of the centered kernel
+ * matrix with
+ */
+enum EKernelPCAMethod
+{
+	/** ITERATIVE if the target dimension is small compared to the number
+	 * of vectors and there are more than a few thousand of them, FULL
+	 * otherwise
+	 */
+	KPCA_AUTO = 10,
+	/** eigendecomposition of the whole kernel matrix, which is stored.
+	 * Time complexity ~n^3, memory n^2 (n-number of vectors)
+	 */
+	KPCA_FULL = 20,
+	/** thick restart Lanczos iterations [Wu and Simon, 2000] on products of
+	 * the kernel matrix with vectors, which are computed a block of rows
+	 * at a time in parallel so that the kernel matrix is never stored.
+	 * Each product costs n^2 kernel evaluations, memory ~n(2k+20)
+	 * (k-target dimension)
+	 */
+	KPCA_ITERATIVE = 30
+};
+
 /** @brief Preprocessor KernelPCA performs kernel principal component analysis
  *
  * Schoelkopf, B., Smola, A. J., & Mueller, K. R. (1999).
@@ -31,6 +54,8 @@ class CKernel;
  * Advances in kernel methods support vector learning, 1327(3), 327-352. MIT Press.
  * Retrieved from http://citeseerx.ist.psu.edu/viewdoc/summary?doi=10.1.1.32.8744
  *
+ * Only the top target dimension eigenvectors of the centered kernel matrix
+ * are kept, see EKernelPCAMethod for how they are computed.
  */
 class CKernelPCA: public CDimensionReductionPreprocessor
 {
@@ -65,8 +90,9 @@ public:
 		 */
 		virtual CDenseFeatures<float64_t>* apply_to_string_features(CFeatures* features);
 
-		/** get transformation matrix, i.e. eigenvectors
-		 *
+		/** get transformation matrix, i.e. the top target dimension
+		 * eigenvectors (in descending order of their eigenvalues), scaled
+		 * and centered
 		 */
 		SGMatrix<float64_t> get_transformation_matrix() const
 		{
@@ -81,6 +107,32 @@ public:
 			return m_bias_vector;
 		}
 
+		/** set method used to compute the eigenvectors
+		 * @param method method, default KPCA_AUTO
+		 */
+		void set_method(EKernelPCAMethod method) { m_method = method; }
+
+		/** @return method used to compute the eigenvectors */
+		EKernelPCAMethod get_method() const { return m_method; }
+
+		/** set tolerance of ITERATIVE method, the eigenpairs are
+		 * converged when their residuals are below tolerance times the
+		 * largest eigenvalue
+		 * @param tolerance tolerance, default 1e-10
+		 */
+		void set_tolerance(float64_t tolerance) { m_tolerance = tolerance; }
+
+		/** @return tolerance of ITERATIVE method */
+		float64_t get_tolerance() const { return m_tolerance; }
+
+		/** set maximum number of restarts of ITERATIVE method
+		 * @param max_restarts maximum number of restarts, default 100
+		 */
+		void set_max_restarts(int32_t max_restarts) { m_max_restarts = max_restarts; }
+
+		/** @return maximum number of restarts of ITERATIVE method */
+		int32_t get_max_restarts() const { return m_max_restarts; }
+
 		/** @return object name */
 		virtual const char* get_name() const { return "KernelPCA"; }
 
@@ -106,6 +158,15 @@ public:
 		/** true when already initialized */
 		bool m_initialized;
 
+		/** method used to compute the eigenvectors */
+		EKernelPCAMethod m_method;
+
+		/** tolerance of ITERATIVE method */
+		float64_t m_tolerance;
+
+		/** maximum number of restarts of ITERATIVE method */
+		int32_t m_max_restarts;
+
 };
 }
 #endif
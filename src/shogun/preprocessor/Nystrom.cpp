@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) The Shogun Machine Learning Toolbox
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the Shogun Development Team.
+ */
+
+#include <limits>
+#include <algorithm>
+#include <vector>
+#include <functional>
+#include <shogun/preprocessor/Nystrom.h>
+#include <shogun/kernel/Kernel.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/distance/EuclideanDistance.h>
+#include <shogun/clustering/KMeans.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/eigen3.h>
+#include <shogun/io/SGIO.h>
+
+using namespace shogun;
+using namespace Eigen;
+
+/* number of vectors whose kernel rows are held in memory at once */
+#define NYSTROM_BLOCK_SIZE 1024
+
+CNystrom::CNystrom() : CDimensionReductionPreprocessor()
+{
+	init();
+}
+
+CNystrom::CNystrom(CKernel* k, int32_t num_landmarks,
+		ENystromLandmarkSelection selection) : CDimensionReductionPreprocessor()
+{
+	init();
+	set_kernel(k);
+	set_target_dim(num_landmarks);
+	m_landmark_selection=selection;
+}
+
+void CNystrom::init()
+{
+	m_landmark_selection=NLS_UNIFORM;
+	m_leverage_regularization=1e-3;
+	m_landmarks=NULL;
+	m_initialized=false;
+
+	SG_ADD((machine_int_t*) &m_landmark_selection, "landmark_selection",
+		"Landmark selection strategy", MS_AVAILABLE);
+	SG_ADD(&m_leverage_regularization, "leverage_regularization",
+		"Ridge regularization for leverage scores", MS_AVAILABLE);
+	SG_ADD((CSGObject**) &m_landmarks, "landmarks", "Landmarks",
+		MS_NOT_AVAILABLE);
+	SG_ADD(&m_transformation_matrix, "transformation_matrix",
+		"Inverse square root of landmark kernel matrix", MS_NOT_AVAILABLE);
+	SG_ADD(&m_initialized, "initialized", "True when initialized",
+		MS_NOT_AVAILABLE);
+}
+
+CNystrom::~CNystrom()
+{
+	SG_UNREF(m_landmarks);
+}
+
+void CNystrom::cleanup()
+{
+	SG_UNREF(m_landmarks);
+	m_landmarks=NULL;
+	m_transformation_matrix=SGMatrix<float64_t>();
+	m_initialized=false;
+}
+
+bool CNystrom::init(CFeatures* features)
+{
+	REQUIRE(features, "No features provided\n");
+	REQUIRE(m_kernel, "Kernel is not set\n");
+
+	int32_t n=features->get_num_vectors();
+	REQUIRE(m_target_dim<=n, "Number of landmarks (%d) must not exceed the \
+number of vectors (%d)\n", m_target_dim, n);
+
+	cleanup();
+
+	CFeatures* kernel_lhs=m_kernel->get_lhs();
+	CFeatures* kernel_rhs=m_kernel->get_rhs();
+
+	switch (m_landmark_selection)
+	{
+		case NLS_UNIFORM:
+			m_landmarks=features->copy_subset(sample_uniform(n));
+			break;
+		case NLS_LEVERAGE_SCORES:
+			m_landmarks=features->copy_subset(sample_leverage_scores(features));
+			break;
+		case NLS_KMEANS:
+			m_landmarks=cluster_landmarks(features);
+			break;
+		default:
+			SG_ERROR("Unknown landmark selection strategy (%d)\n",
+					m_landmark_selection);
+	}
+	SG_REF(m_landmarks);
+
+	int32_t m=m_landmarks->get_num_vectors();
+	m_kernel->init(m_landmarks, m_landmarks);
+	SGMatrix<float64_t> K_mm=m_kernel->get_kernel_matrix();
+	restore_kernel(kernel_lhs, kernel_rhs);
+
+	SelfAdjointEigenSolver<MatrixXd> solver(Map<MatrixXd>(K_mm.matrix, m, m));
+	if (solver.info()!=Success)
+	{
+		SG_WARNING("Eigendecomposition of landmark kernel matrix failed.\n")
+		SG_UNREF(m_landmarks);
+		m_landmarks=NULL;
+		return false;
+	}
+
+	/* pseudo inverse square root, the dimensions belonging to numerically
+	 * zero eigenvalues are mapped to zero */
+	VectorXd D=solver.eigenvalues();
+	const float64_t tolerance=
+		m*std::numeric_limits<float64_t>::epsilon()*D.maxCoeff();
+	for (index_t i=0; i<m; ++i)
+		D[i]=D[i]<tolerance ? 0 : 1.0/CMath::sqrt(D[i]);
+
+	m_transformation_matrix=SGMatrix<float64_t>(m, m);
+	Map<MatrixXd> W(m_transformation_matrix.matrix, m, m);
+	W=D.asDiagonal()*solver.eigenvectors().transpose();
+
+	m_initialized=true;
+	return true;
+}
+
+void CNystrom::restore_kernel(CFeatures* lhs, CFeatures* rhs)
+{
+	if (lhs && rhs)
+		m_kernel->init(lhs, rhs);
+	else
+		m_kernel->cleanup();
+
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
+}
+
+SGVector<index_t> CNystrom::sample_uniform(int32_t num_vectors) const
+{
+	SGVector<index_t> perm(num_vectors);
+	perm.range_fill();
+	CMath::permute(perm);
+
+	SGVector<index_t> idx(m_target_dim);
+	for (index_t i=0; i<m_target_dim; ++i)
+		idx[i]=perm[i];
+	CMath::qsort(idx.vector, m_target_dim);
+
+	return idx;
+}
+
+SGVector<index_t> CNystrom::sample_leverage_scores(CFeatures* features)
+{
+	REQUIRE(m_leverage_regularization>0, "Leverage score regularization \
+(%f) must be positive\n", m_leverage_regularization);
+
+	int32_t n=features->get_num_vectors();
+	int32_t s=CMath::min(n, 2*m_target_dim);
+
+	/* uniform pilot set the leverage scores are estimated against */
+	SGVector<index_t> perm(n);
+	perm.range_fill();
+	CMath::permute(perm);
+	SGVector<index_t> pilot_idx(s);
+	for (index_t i=0; i<s; ++i)
+		pilot_idx[i]=perm[i];
+	CFeatures* pilot=features->copy_subset(pilot_idx);
+	SG_REF(pilot);
+
+	SGVector<float64_t> diag(n);
+	m_kernel->init(features, features);
+#pragma omp parallel for
+	for (index_t i=0; i<n; ++i)
+		diag[i]=m_kernel->kernel(i, i);
+	m_kernel->cleanup();
+
+	m_kernel->init(pilot, pilot);
+	SGMatrix<float64_t> K_ss=m_kernel->get_kernel_matrix();
+	m_kernel->cleanup();
+
+	Map<MatrixXd> K_ss_eig(K_ss.matrix, s, s);
+	K_ss_eig.diagonal().array()+=m_leverage_regularization*s;
+	LLT<MatrixXd> llt(K_ss_eig);
+	REQUIRE(llt.info()==Success, "Cholesky decomposition of regularized \
+pilot kernel matrix failed\n");
+
+	/* leverage scores up to the constant factor 1/(lambda s):
+	 * l_i = k(x_i,x_i) - k_i^T (K_ss + lambda s I)^{-1} k_i */
+	SGVector<float64_t> scores(n);
+	m_kernel->init(pilot, features);
+	for (index_t start=0; start<n; start+=NYSTROM_BLOCK_SIZE)
+	{
+		int32_t len=CMath::min(NYSTROM_BLOCK_SIZE, n-start);
+		MatrixXd K_block(s, len);
+
+#pragma omp parallel for
+		for (index_t j=0; j<len; ++j)
+		{
+			for (index_t i=0; i<s; ++i)
+				K_block(i, j)=m_kernel->kernel(i, start+j);
+		}
+
+		llt.matrixL().solveInPlace(K_block);
+		VectorXd residual=K_block.colwise().squaredNorm();
+
+		for (index_t j=0; j<len; ++j)
+		{
+			scores[start+j]=CMath::max(diag[start+j]-residual[j],
+					std::numeric_limits<float64_t>::epsilon());
+		}
+	}
+	m_kernel->cleanup();
+	SG_UNREF(pilot);
+
+	/* weighted sampling without replacement: keep the m largest keys
+	 * u_i^(1/l_i), compared in log space */
+	std::vector<std::pair<float64_t, index_t> > keys(n);
+	for (index_t i=0; i<n; ++i)
+	{
+		float64_t u=CMath::random(std::numeric_limits<float64_t>::min(), 1.0);
+		keys[i]=std::make_pair(CMath::log(u)/scores[i], i);
+	}
+	std::partial_sort(keys.begin(), keys.begin()+m_target_dim, keys.end(),
+			std::greater<std::pair<float64_t, index_t> >());
+
+	SGVector<index_t> idx(m_target_dim);
+	for (index_t i=0; i<m_target_dim; ++i)
+		idx[i]=keys[i].second;
+	CMath::qsort(idx.vector, m_target_dim);
+
+	return idx;
+}
+
+CFeatures* CNystrom::cluster_landmarks(CFeatures* features)
+{
+	REQUIRE(features->get_feature_class()==C_DENSE &&
+			features->get_feature_type()==F_DREAL,
+			"KMeans landmark selection requires dense real-valued features\n");
+
+	CDenseFeatures<float64_t>* dense=(CDenseFeatures<float64_t>*) features;
+	CEuclideanDistance* distance=new CEuclideanDistance(dense, dense);
+	CKMeans* kmeans=new CKMeans(m_target_dim, distance, true);
+	SG_REF(kmeans);
+	kmeans->train();
+	SGMatrix<float64_t> centers=kmeans->get_cluster_centers();
+	SG_UNREF(kmeans);
+
+	return new CDenseFeatures<float64_t>(centers);
+}
+
+SGMatrix<float64_t> CNystrom::compute_feature_map(CFeatures* features)
+{
+	REQUIRE(m_initialized, "Nystrom preprocessor is not initialized\n");
+
+	int32_t n=features->get_num_vectors();
+	int32_t m=m_landmarks->get_num_vectors();
+
+	SGMatrix<float64_t> result(m, n);
+	Map<MatrixXd> result_eig(result.matrix, m, n);
+	Map<MatrixXd> W(m_transformation_matrix.matrix, m, m);
+
+	CFeatures* kernel_lhs=m_kernel->get_lhs();
+	CFeatures* kernel_rhs=m_kernel->get_rhs();
+	m_kernel->init(m_landmarks, features);
+	MatrixXd K_block(m, NYSTROM_BLOCK_SIZE);
+	for (index_t start=0; start<n; start+=NYSTROM_BLOCK_SIZE)
+	{
+		int32_t len=CMath::min(NYSTROM_BLOCK_SIZE, n-start);
+
+#pragma omp parallel for
+		for (index_t j=0; j<len; ++j)
+		{
+			for (index_t i=0; i<m; ++i)
+				K_block(i, j)=m_kernel->kernel(i, start+j);
+		}
+
+		result_eig.middleCols(start, len).noalias()=W*K_block.leftCols(len);
+	}
+	restore_kernel(kernel_lhs, kernel_rhs);
+
+	return result;
+}
+
+SGMatrix<float64_t> CNystrom::apply_to_feature_matrix(CFeatures* features)
+{
+	REQUIRE(features, "No features provided\n");
+	REQUIRE(features->get_feature_class()==C_DENSE &&
+			features->get_feature_type()==F_DREAL,
+			"%s::apply_to_feature_matrix() requires dense real-valued features, \
+use apply_to_features() for others\n", get_name());
+
+	SGMatrix<float64_t> result=compute_feature_map(features);
+	((CDenseFeatures<float64_t>*) features)->set_feature_matrix(result);
+	return result;
+}
+
+SGVector<float64_t> CNystrom::apply_to_feature_vector(SGVector<float64_t> vector)
+{
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(
+			SGMatrix<float64_t>(vector.vector, vector.vlen, 1, false));
+	SG_REF(features);
+	SGMatrix<float64_t> result=compute_feature_map(features);
+	SG_UNREF(features);
+
+	SGVector<float64_t> mapped(result.num_rows);
+	memcpy(mapped.vector, result.matrix, sizeof(float64_t)*result.num_rows);
+	return mapped;
+}
+
+CDenseFeatures<float64_t>* CNystrom::apply_to_features(CFeatures* features)
+{
+	return new CDenseFeatures<float64_t>(compute_feature_map(features));
+}
+
+ENystromLandmarkSelection CNystrom::get_landmark_selection() const
+{
+	return m_landmark_selection;
+}
+
+void CNystrom::set_landmark_selection(ENystromLandmarkSelection selection)
+{
+	m_landmark_selection=selection;
+}
+
+float64_t CNystrom::get_leverage_regularization() const
+{
+	return m_leverage_regularization;
+}
+
+void CNystrom::set_leverage_regularization(float64_t lambda)
+{
+	REQUIRE(lambda>0, "Regularization (%f) must be positive\n", lambda);
+	m_leverage_regularization=lambda;
+}
+
+CFeatures* CNystrom::get_landmarks() const
+{
+	SG_REF(m_landmarks);
+	return m_landmarks;
+}
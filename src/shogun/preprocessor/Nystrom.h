@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) The Shogun Machine Learning Toolbox
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of the Shogun Development Team.
+ */
+
+#ifndef NYSTROM_H_
+#define NYSTROM_H_
+
+#include <shogun/lib/config.h>
+
+#include <shogun/preprocessor/DimensionReductionPreprocessor.h>
+#include <shogun/features/Features.h>
+#include <shogun/lib/common.h>
+
+namespace shogun
+{
+
+class CFeatures;
+class CKernel;
+
+/** Strategy used by CNystrom to choose the landmark points */
+enum ENystromLandmarkSelection
+{
+	/** landmarks are sampled uniformly without replacement */
+	NLS_UNIFORM = 10,
+	/** landmarks are the cluster centers found by KMeans++ initialized
+	 * KMeans (dense real-valued features only)
+	 */
+	NLS_KMEANS = 20,
+	/** landmarks are sampled without replacement proportionally to their
+	 * approximate ridge leverage scores
+	 */
+	NLS_LEVERAGE_SCORES = 30
+};
+
+/** @brief Preprocessor Nystrom computes an explicit finite-dimensional
+ * feature map approximating an arbitrary kernel.
+ *
+ * Given \f$m\f$ landmarks \f$z_1,\dots,z_m\f$ the approximate feature map is
+ *
+ * \f[
+ * \phi(x) = K_{m,m}^{-1/2} [k(z_1,x),\dots,k(z_m,x)]^T
+ * \f]
+ *
+ * where \f$K_{m,m}^{-1/2}\f$ is computed from the eigendecomposition of the
+ * kernel matrix of the landmarks (eigenvalues below numerical precision are
+ * discarded, i.e. the pseudo-inverse is used). Inner products of the
+ * resulting features satisfy \f$\phi(x)^T\phi(y)=K_{x,m}K_{m,m}^+K_{m,y}\f$,
+ * the Nyström approximation of \f$k(x,y)\f$.
+ *
+ * Since the output is a CDenseFeatures object, any linear machine (e.g.
+ * CLibLinear, CSVMOcas or CLinearRidgeRegression) trained on it approximates
+ * the corresponding kernel machine at a cost of \f$O(nm)\f$ kernel
+ * evaluations instead of \f$O(n^2)\f$.
+ *
+ * The number of landmarks is the target dimension of the preprocessor and
+ * is set through set_target_dim(). Landmarks are selected in init() by one of
+ * the strategies in ENystromLandmarkSelection. The kernel may be defined on
+ * any feature type; for non-dense features use apply_to_features().
+ * The kernel is initialized on the landmarks while the preprocessor uses it
+ * and is initialized with its previous features again afterwards.
+ *
+ * Williams, C., & Seeger, M. (2001).
+ * Using the Nyström Method to Speed Up Kernel Machines.
+ * Advances in Neural Information Processing Systems 13, 682-688.
+ *
+ * Alaoui, A. E., & Mahoney, M. W. (2015).
+ * Fast Randomized Kernel Ridge Regression with Statistical Guarantees.
+ * Advances in Neural Information Processing Systems 28, 775-783.
+ */
+class CNystrom: public CDimensionReductionPreprocessor
+{
+public:
+	/** default constructor */
+	CNystrom();
+
+	/** constructor
+	 *
+	 * @param k kernel to approximate
+	 * @param num_landmarks number of landmarks (target dimension)
+	 * @param selection landmark selection strategy
+	 */
+	CNystrom(CKernel* k, int32_t num_landmarks,
+			ENystromLandmarkSelection selection=NLS_UNIFORM);
+
+	/** destructor */
+	virtual ~CNystrom();
+
+	/** select landmarks from features and compute the transformation
+	 *
+	 * @param features training features the landmarks are taken from
+	 * @return whether initialization was successful
+	 */
+	virtual bool init(CFeatures* features);
+
+	/** cleanup */
+	virtual void cleanup();
+
+	/** apply preprocessor to dense feature matrix, the matrix of the
+	 * given features is replaced by the mapped one
+	 *
+	 * @param features dense real-valued features
+	 * @return mapped feature matrix
+	 */
+	virtual SGMatrix<float64_t> apply_to_feature_matrix(CFeatures* features);
+
+	/** apply preprocessor to a single dense feature vector
+	 *
+	 * @param vector feature vector
+	 * @return mapped feature vector
+	 */
+	virtual SGVector<float64_t> apply_to_feature_vector(SGVector<float64_t> vector);
+
+	/** apply preprocessor to features of any type the kernel accepts
+	 *
+	 * @param features features to map
+	 * @return new dense features holding the mapped vectors
+	 */
+	virtual CDenseFeatures<float64_t>* apply_to_features(CFeatures* features);
+
+	/** @return landmark selection strategy */
+	ENystromLandmarkSelection get_landmark_selection() const;
+
+	/** set landmark selection strategy
+	 *
+	 * @param selection strategy
+	 */
+	void set_landmark_selection(ENystromLandmarkSelection selection);
+
+	/** @return ridge regularization used to estimate leverage scores */
+	float64_t get_leverage_regularization() const;
+
+	/** set ridge regularization used to estimate leverage scores
+	 *
+	 * @param lambda regularization (positive)
+	 */
+	void set_leverage_regularization(float64_t lambda);
+
+	/** @return selected landmarks */
+	CFeatures* get_landmarks() const;
+
+	/** @return transformation matrix \f$K_{m,m}^{-1/2}\f$ */
+	SGMatrix<float64_t> get_transformation_matrix() const
+	{
+		return m_transformation_matrix;
+	}
+
+	/** @return object name */
+	virtual const char* get_name() const { return "Nystrom"; }
+
+	/** @return the type of preprocessor */
+	virtual EPreprocessorType get_type() const { return P_NYSTROM; }
+
+protected:
+	/** sample landmark indices uniformly
+	 *
+	 * @param num_vectors number of vectors to sample from
+	 * @return sorted indices
+	 */
+	SGVector<index_t> sample_uniform(int32_t num_vectors) const;
+
+	/** sample landmark indices proportionally to approximate ridge
+	 * leverage scores, which are estimated against a uniformly sampled
+	 * pilot set of twice the number of landmarks
+	 *
+	 * @param features features to sample from
+	 * @return sorted indices
+	 */
+	SGVector<index_t> sample_leverage_scores(CFeatures* features);
+
+	/** cluster features with KMeans and use the centers as landmarks
+	 *
+	 * @param features dense real-valued features
+	 * @return landmark features
+	 */
+	CFeatures* cluster_landmarks(CFeatures* features);
+
+	/** compute the mapped feature matrix of features, kernel rows are
+	 * computed in blocks so that only the output is materialized
+	 *
+	 * @param features features to map
+	 * @return mapped matrix (target dim rows, one column per vector)
+	 */
+	SGMatrix<float64_t> compute_feature_map(CFeatures* features);
+
+	/** initialize the kernel again with the features it was initialized
+	 * with before the preprocessor used it, or clean it up if it was not
+	 * initialized
+	 *
+	 * @param lhs previous left hand side features of the kernel (unref'ed)
+	 * @param rhs previous right hand side features of the kernel (unref'ed)
+	 */
+	void restore_kernel(CFeatures* lhs, CFeatures* rhs);
+
+private:
+	void init();
+
+protected:
+	/** landmark selection strategy */
+	ENystromLandmarkSelection m_landmark_selection;
+
+	/** ridge regularization for leverage score estimation */
+	float64_t m_leverage_regularization;
+
+	/** landmarks */
+	CFeatures* m_landmarks;
+
+	/** transformation matrix */
+	SGMatrix<float64_t> m_transformation_matrix;
+
+	/** true when already initialized */
+	bool m_initialized;
+};
+}
+#endif /* NYSTROM_H_ */
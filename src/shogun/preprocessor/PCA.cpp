@@ -16,12 +16,94 @@
 #include <shogun/mathematics/Math.h>
 #include <shogun/preprocessor/DensePreprocessor.h>
 #include <shogun/features/Features.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
 #include <shogun/io/SGIO.h>
 #include <shogun/mathematics/eigen3.h>
 
 using namespace shogun;
 using namespace Eigen;
 
+namespace
+{
+
+/** product of the covariance matrix of centered data with a matrix, without
+ * forming the covariance matrix */
+struct DataCovarianceProduct
+{
+	DataCovarianceProduct(const Map<MatrixXd>& centered_data)
+		: X(centered_data) { }
+
+	index_t rows() const { return X.rows(); }
+
+	MatrixXd operator()(const MatrixXd& M) const
+	{
+		MatrixXd XtM = X.transpose()*M;
+		return X*XtM/(X.cols()-1);
+	}
+
+	const Map<MatrixXd>& X;
+};
+
+/** product of a given covariance matrix with a matrix */
+struct CovarianceMatrixProduct
+{
+	CovarianceMatrixProduct(const MatrixXd& cov_mat) : C(cov_mat) { }
+
+	index_t rows() const { return C.rows(); }
+
+	MatrixXd operator()(const MatrixXd& M) const
+	{
+		return C.selfadjointView<Lower>()*M;
+	}
+
+	const MatrixXd& C;
+};
+
+/** Computes the top k eigenpairs of a covariance matrix with the randomized
+ * range finder with power iterations and the Rayleigh-Ritz projection of
+ * [Halko, Martinsson and Tropp, 2011] (Algorithms 4.4 and 5.3). The range is
+ * orthonormalized after every product so that the directions of smaller
+ * eigenvalues are not lost to rounding
+ *
+ * @param cov product of the covariance matrix with a matrix
+ * @param k number of eigenpairs
+ * @param oversampling number of additional random vectors
+ * @param num_power_iterations number of power iterations
+ * @param eigenvalues top k eigenvalues, ascending like the ones of EVD
+ * @param eigenvectors corresponding eigenvectors
+ */
+template <class Product>
+void randomized_eigensolver(const Product& cov, int32_t k,
+	int32_t oversampling, int32_t num_power_iterations,
+	SGVector<float64_t>& eigenvalues, SGMatrix<float64_t>& eigenvectors)
+{
+	index_t dim = cov.rows();
+	index_t num_samples = CMath::min<index_t>(k+oversampling, dim);
+
+	MatrixXd Q(dim, num_samples);
+	for (index_t i=0; i<Q.size(); i++)
+		Q.data()[i] = CMath::randn_double();
+
+	for (int32_t i=0; i<=num_power_iterations; i++)
+	{
+		HouseholderQR<MatrixXd> qr(cov(Q));
+		Q = qr.householderQ()*MatrixXd::Identity(dim, num_samples);
+	}
+
+	MatrixXd T = Q.transpose()*cov(Q);
+	SelfAdjointEigenSolver<MatrixXd> eigen_solver(T);
+
+	// eigenvalues are in ascending order
+	eigenvalues = SGVector<float64_t>(k);
+	eigenvectors = SGMatrix<float64_t>(dim, k);
+	Map<VectorXd> values(eigenvalues.vector, k);
+	Map<MatrixXd> vectors(eigenvectors.matrix, dim, k);
+	values = eigen_solver.eigenvalues().tail(k);
+	vectors = Q*eigen_solver.eigenvectors().rightCols(k);
+}
+
+}
+
 CPCA::CPCA(bool do_whitening, EPCAMode mode, float64_t thresh, EPCAMethod method, EPCAMemoryMode mem_mode)
 : CDimensionReductionPreprocessor()
 {
@@ -55,6 +137,9 @@ void CPCA::init()
 	m_mem_mode = MEM_REALLOCATE;
 	m_method = AUTO;
 	m_eigenvalue_zero_tolerance=1e-15;
+	m_oversampling = 10;
+	m_num_power_iterations = 2;
+	m_streaming_block_size = 1024;
 
 	SG_ADD(&m_transformation_matrix, "transformation_matrix",
 	    "Transformation matrix (Eigenvectors of covariance matrix).",
@@ -74,6 +159,12 @@ void CPCA::init()
 		"Method used for PCA calculation", MS_NOT_AVAILABLE);
 	SG_ADD(&m_eigenvalue_zero_tolerance, "eigenvalue_zero_tolerance", "zero tolerance"
 	" for determining zero eigenvalues during whitening to avoid numerical issues", MS_NOT_AVAILABLE);
+	SG_ADD(&m_oversampling, "oversampling",
+		"Number of additional random vectors of randomized method", MS_NOT_AVAILABLE);
+	SG_ADD(&m_num_power_iterations, "num_power_iterations",
+		"Number of power iterations of randomized method", MS_NOT_AVAILABLE);
+	SG_ADD(&m_streaming_block_size, "streaming_block_size",
+		"Number of vectors read at once from streaming features", MS_NOT_AVAILABLE);
 }
 
 CPCA::~CPCA()
@@ -84,8 +175,19 @@ bool CPCA::init(CFeatures* features)
 {
 	if (!m_initialized)
 	{
-		REQUIRE(features->get_feature_class()==C_DENSE, "PCA only works with dense features")
 		REQUIRE(features->get_feature_type()==F_DREAL, "PCA only works with real features")
+		REQUIRE(m_method!=RANDOMIZED || m_mode==FIXED_NUMBER,
+			"Randomized PCA only computes the target dimension's components, "
+			"it requires FIXED_NUMBER mode\n")
+
+		if (features->get_feature_class()==C_STREAMING_DENSE)
+		{
+			init_streaming((CStreamingDenseFeatures<float64_t>*)features);
+			m_initialized = true;
+			return true;
+		}
+
+		REQUIRE(features->get_feature_class()==C_DENSE, "PCA only works with dense features")
 
 		SGMatrix<float64_t> feature_matrix = ((CDenseFeatures<float64_t>*)features)
 									->get_feature_matrix();
@@ -107,95 +209,34 @@ bool CPCA::init(CFeatures* features)
  		data_mean = fmatrix.rowwise().sum()/(float64_t) num_vectors;
 		fmatrix = fmatrix.colwise()-data_mean;
 
-		m_eigenvalues_vector = SGVector<float64_t>(max_dim_allowed);
-		Map<VectorXd> eigenValues(m_eigenvalues_vector.vector, max_dim_allowed);
-
 		if (m_method == AUTO)
 			m_method = (num_vectors>num_features) ? EVD : SVD;
 
-		if (m_method == EVD)
+		if (m_method == RANDOMIZED)
+		{
+			SGVector<float64_t> eigenvalues;
+			SGMatrix<float64_t> eigenvectors;
+			randomized_eigensolver(DataCovarianceProduct(fmatrix), m_target_dim,
+				m_oversampling, m_num_power_iterations, eigenvalues, eigenvectors);
+			init_top_eigenvectors(eigenvalues, eigenvectors, num_vectors);
+		}
+		else if (m_method == EVD)
 		{
 			// covariance matrix
-			MatrixXd cov_mat(num_features, num_features);
-			cov_mat = fmatrix*fmatrix.transpose();
-			cov_mat /= (num_vectors-1);
-
-			SG_INFO("Computing Eigenvalues ... ")
-			// eigen value computed
-			SelfAdjointEigenSolver<MatrixXd> eigenSolve =
-					SelfAdjointEigenSolver<MatrixXd>(cov_mat);
-			eigenValues = eigenSolve.eigenvalues().tail(max_dim_allowed);
-
-			// target dimension
-			switch (m_mode)
-			{
-				case FIXED_NUMBER :
-					num_dim = m_target_dim;
-					break;
-
-				case VARIANCE_EXPLAINED :
-					{
-						float64_t eig_sum = eigenValues.sum();
-						float64_t com_sum = 0;
-						for (int32_t i=num_features-1; i<-1; i++)
-						{
-							num_dim++;
-							com_sum += m_eigenvalues_vector.vector[i];
-							if (com_sum/eig_sum>=m_thresh)
-								break;
-						}
-					}
-					break;
-
-				case THRESHOLD :
-					for (int32_t i=num_features-1; i<-1; i++)
-					{
-						if (m_eigenvalues_vector.vector[i]>m_thresh)
-							num_dim++;
-						else
-							break;
-					}
-					break;
-			};
-			SG_INFO("Done\nReducing from %i to %i features..", num_features, num_dim)
-
-			m_transformation_matrix = SGMatrix<float64_t>(num_features,num_dim);
-			Map<MatrixXd> transformMatrix(m_transformation_matrix.matrix,
-								 num_features, num_dim);
-			num_old_dim = num_features;
-
-			// eigenvector matrix
-			transformMatrix = eigenSolve.eigenvectors().block(0,
-						num_features-num_dim, num_features,num_dim);
-			if (m_whitening)
-			{
-				for (int32_t i=0; i<num_dim; i++)
-				{
-					if (CMath::fequals_abs<float64_t>(0.0, eigenValues[i+max_dim_allowed-num_dim],
-											m_eigenvalue_zero_tolerance))
-					{
-						SG_WARNING("Covariance matrix has almost zero Eigenvalue (ie "
-							"Eigenvalue within a tolerance of %E around 0) at "
-							"dimension %d. Consider reducing its dimension.",
-							m_eigenvalue_zero_tolerance, i+max_dim_allowed-num_dim+1)
-
-						transformMatrix.col(i) = MatrixXd::Zero(num_features,1);
-						continue;
-					}
+			SGMatrix<float64_t> cov_mat(num_features, num_features);
+			Map<MatrixXd> cov(cov_mat.matrix, num_features, num_features);
+			cov = fmatrix*fmatrix.transpose();
+			cov /= (num_vectors-1);
 
-					transformMatrix.col(i) /=
-					CMath::sqrt(eigenValues[i+max_dim_allowed-num_dim]*(num_vectors-1));
-				}
-			}
+			init_evd(cov_mat, num_vectors);
 		}
-
 		else
 		{
 			// compute SVD of data matrix
 			JacobiSVD<MatrixXd> svd(fmatrix.transpose(), ComputeThinU | ComputeThinV);
 
 			// compute non-negative eigen values from singular values
-			eigenValues = svd.singularValues();
+			VectorXd eigenValues = svd.singularValues();
 			eigenValues = eigenValues.cwiseProduct(eigenValues)/(num_vectors-1);
 
 			// target dimension
@@ -209,10 +250,10 @@ bool CPCA::init(CFeatures* features)
 					{
 						float64_t eig_sum = eigenValues.sum();
 						float64_t com_sum = 0;
-						for (int32_t i=0; i<num_features; i++)
+						for (int32_t i=0; i<max_dim_allowed; i++)
 						{
 							num_dim++;
-							com_sum += m_eigenvalues_vector.vector[i];
+							com_sum += eigenValues[i];
 							if (com_sum/eig_sum>=m_thresh)
 								break;
 						}
@@ -220,17 +261,21 @@ bool CPCA::init(CFeatures* features)
 					break;
 
 				case THRESHOLD :
-					for (int32_t i=0; i<num_features; i++)
+					for (int32_t i=0; i<max_dim_allowed; i++)
 					{
-						if (m_eigenvalues_vector.vector[i]>m_thresh)
+						if (eigenValues[i]>m_thresh)
 							num_dim++;
 						else
 							break;
 					}
 					break;
 			};
+
 			SG_INFO("Done\nReducing from %i to %i features..", num_features, num_dim)
 
+			m_eigenvalues_vector = SGVector<float64_t>(max_dim_allowed);
+			Map<VectorXd>(m_eigenvalues_vector.vector, max_dim_allowed) = eigenValues;
+
 			// right singular vectors form eigenvectors
 			m_transformation_matrix = SGMatrix<float64_t>(num_features,num_dim);
 			Map<MatrixXd> transformMatrix(m_transformation_matrix.matrix, num_features, num_dim);
@@ -266,6 +311,194 @@ bool CPCA::init(CFeatures* features)
 	return false;
 }
 
+void CPCA::init_evd(SGMatrix<float64_t> cov_mat, int64_t num_vectors)
+{
+	int32_t num_features = cov_mat.num_rows;
+	int32_t max_dim_allowed = CMath::min<int64_t>(num_vectors, num_features);
+
+	m_eigenvalues_vector = SGVector<float64_t>(max_dim_allowed);
+	Map<VectorXd> eigenValues(m_eigenvalues_vector.vector, max_dim_allowed);
+	Map<MatrixXd> cov(cov_mat.matrix, num_features, num_features);
+
+	SG_INFO("Computing Eigenvalues ... ")
+	// eigen value computed
+	SelfAdjointEigenSolver<MatrixXd> eigenSolve =
+			SelfAdjointEigenSolver<MatrixXd>(cov);
+	eigenValues = eigenSolve.eigenvalues().tail(max_dim_allowed);
+
+	// target dimension
+	switch (m_mode)
+	{
+		case FIXED_NUMBER :
+			num_dim = m_target_dim;
+			break;
+
+		case VARIANCE_EXPLAINED :
+			{
+				float64_t eig_sum = eigenValues.sum();
+				float64_t com_sum = 0;
+				for (int32_t i=num_features-1; i<-1; i++)
+				{
+					num_dim++;
+					com_sum += m_eigenvalues_vector.vector[i];
+					if (com_sum/eig_sum>=m_thresh)
+						break;
+				}
+			}
+			break;
+
+		case THRESHOLD :
+			for (int32_t i=num_features-1; i<-1; i++)
+			{
+				if (m_eigenvalues_vector.vector[i]>m_thresh)
+					num_dim++;
+				else
+					break;
+			}
+			break;
+	};
+
+	// eigenvector matrix
+	SGMatrix<float64_t> eigenvectors(num_features, num_dim);
+	Map<MatrixXd>(eigenvectors.matrix, num_features, num_dim) =
+		eigenSolve.eigenvectors().block(0, num_features-num_dim,
+			num_features, num_dim);
+	init_top_eigenvectors(m_eigenvalues_vector, eigenvectors, num_vectors);
+}
+
+void CPCA::init_top_eigenvectors(SGVector<float64_t> eigenvalues,
+		SGMatrix<float64_t> eigenvectors, int64_t num_vectors)
+{
+	int32_t num_features = eigenvectors.num_rows;
+	num_dim = eigenvectors.num_cols;
+	num_old_dim = num_features;
+	m_eigenvalues_vector = eigenvalues;
+	m_transformation_matrix = eigenvectors;
+
+	SG_INFO("Done\nReducing from %i to %i features..", num_features, num_dim)
+
+	if (m_whitening)
+	{
+		Map<MatrixXd> transformMatrix(m_transformation_matrix.matrix,
+			num_features, num_dim);
+
+		// the eigenvectors belong to the largest eigenvalues
+		int32_t offset = eigenvalues.vlen-num_dim;
+		for (int32_t i=0; i<num_dim; i++)
+		{
+			if (CMath::fequals_abs<float64_t>(0.0, eigenvalues[i+offset],
+						m_eigenvalue_zero_tolerance))
+			{
+				SG_WARNING("Covariance matrix has almost zero Eigenvalue (ie "
+					"Eigenvalue within a tolerance of %E around 0) at "
+					"dimension %d. Consider reducing its dimension.",
+					m_eigenvalue_zero_tolerance, i+offset+1)
+
+				transformMatrix.col(i) = MatrixXd::Zero(num_features,1);
+				continue;
+			}
+
+			transformMatrix.col(i) /=
+				CMath::sqrt(eigenvalues[i+offset]*(num_vectors-1));
+		}
+	}
+}
+
+void CPCA::init_streaming(CStreamingDenseFeatures<float64_t>* features)
+{
+	REQUIRE(m_streaming_block_size>0, "Streaming block size (%d) must be "
+		"positive\n", m_streaming_block_size)
+
+	int32_t num_features = 0;
+	int64_t num_vectors = 0;
+	VectorXd mean;
+	MatrixXd scatter;
+
+	SGMatrix<float64_t> block;
+	int32_t block_len = 0;
+
+	SG_INFO("Accumulating covariance matrix of streaming features\n")
+	features->start_parser();
+	while (true)
+	{
+		bool has_example = features->get_next_example();
+		if (has_example)
+		{
+			SGVector<float64_t> vec = features->get_vector();
+			if (!block.matrix)
+			{
+				num_features = vec.vlen;
+				block = SGMatrix<float64_t>(num_features, m_streaming_block_size);
+				mean = VectorXd::Zero(num_features);
+				scatter = MatrixXd::Zero(num_features, num_features);
+			}
+			REQUIRE(vec.vlen==num_features, "All vectors must have the same "
+				"dimension (%d), got %d\n", num_features, vec.vlen)
+
+			memcpy(block.get_column_vector(block_len), vec.vector,
+				sizeof(float64_t)*num_features);
+			block_len++;
+			features->release_example();
+		}
+
+		// merge the block's mean and scatter matrix with the ones so far
+		// [Chan, Golub and LeVeque, 1979], which does not lose the
+		// variance to cancellation as sums of squares would
+		if (block_len==m_streaming_block_size || (!has_example && block_len>0))
+		{
+			Map<MatrixXd> X(block.matrix, num_features, block_len);
+			VectorXd block_mean = X.rowwise().mean();
+			MatrixXd centered = X.colwise()-block_mean;
+			VectorXd delta = block_mean-mean;
+			int64_t n = num_vectors+block_len;
+
+			scatter.selfadjointView<Lower>().rankUpdate(centered);
+			scatter.selfadjointView<Lower>().rankUpdate(delta,
+				float64_t(num_vectors)*block_len/n);
+			mean += delta*(float64_t(block_len)/n);
+
+			num_vectors = n;
+			block_len = 0;
+		}
+
+		if (!has_example)
+			break;
+	}
+	features->end_parser();
+
+	REQUIRE(num_vectors>1, "At least two vectors are needed, got %ld\n",
+		num_vectors)
+	SG_INFO("num_examples: %ld num_features: %ld \n", num_vectors, num_features)
+
+	int32_t max_dim_allowed = CMath::min<int64_t>(num_vectors, num_features);
+	num_dim=0;
+
+	REQUIRE(m_target_dim<=max_dim_allowed,
+		 "target dimension should be less or equal to than minimum of N and D")
+
+	m_mean_vector = SGVector<float64_t>(num_features);
+	Map<VectorXd>(m_mean_vector.vector, num_features) = mean;
+	scatter /= (num_vectors-1);
+
+	if (m_method == RANDOMIZED)
+	{
+		SGVector<float64_t> eigenvalues;
+		SGMatrix<float64_t> eigenvectors;
+		randomized_eigensolver(CovarianceMatrixProduct(scatter), m_target_dim,
+			m_oversampling, m_num_power_iterations, eigenvalues, eigenvectors);
+		init_top_eigenvectors(eigenvalues, eigenvectors, num_vectors);
+	}
+	else
+	{
+		// the data is gone, so SVD is not possible
+		m_method = EVD;
+		SGMatrix<float64_t> cov_mat(num_features, num_features);
+		Map<MatrixXd>(cov_mat.matrix, num_features, num_features) =
+			scatter.selfadjointView<Lower>();
+		init_evd(cov_mat, num_vectors);
+	}
+}
+
 void CPCA::cleanup()
 {
 	m_transformation_matrix=SGMatrix<float64_t>();
@@ -381,3 +614,39 @@ float64_t CPCA::get_eigenvalue_zero_tolerance() const
 	return m_eigenvalue_zero_tolerance;
 }
 
+
+void CPCA::set_oversampling(int32_t oversampling)
+{
+	REQUIRE(oversampling>=0, "Oversampling (%d) must be non-negative\n",
+		oversampling)
+	m_oversampling = oversampling;
+}
+
+int32_t CPCA::get_oversampling() const
+{
+	return m_oversampling;
+}
+
+void CPCA::set_num_power_iterations(int32_t num_power_iterations)
+{
+	REQUIRE(num_power_iterations>=0, "Number of power iterations (%d) must "
+		"be non-negative\n", num_power_iterations)
+	m_num_power_iterations = num_power_iterations;
+}
+
+int32_t CPCA::get_num_power_iterations() const
+{
+	return m_num_power_iterations;
+}
+
+void CPCA::set_streaming_block_size(int32_t block_size)
+{
+	REQUIRE(block_size>0, "Streaming block size (%d) must be positive\n",
+		block_size)
+	m_streaming_block_size = block_size;
+}
+
+int32_t CPCA::get_streaming_block_size() const
+{
+	return m_streaming_block_size;
+}
@@ -22,6 +22,8 @@
 
 namespace shogun
 {
+template <class T> class CStreamingDenseFeatures;
+
 /** Matrix decomposition method for PCA */
 enum EPCAMethod
 {
@@ -34,7 +36,13 @@ enum EPCAMethod
 	/** Eigenvalue decomposition of covariance matrix.
 	 * Time complexity ~10d^3 (d-dimensions n-number of vectors)
 	 */
-	EVD = 30
+	EVD = 30,
+	/** Randomized eigendecomposition of the covariance matrix, computes
+	 * only the top target dimension components (FIXED_NUMBER mode).
+	 * Time complexity ~2(q+2)dnk (k-target dimensions q-number of power
+	 * iterations)
+	 */
+	RANDOMIZED = 40
 };
 
 /** mode of pca */
@@ -88,9 +96,23 @@ enum EPCAMemoryMode
  * using the formula \f$e_i = \frac{\sqrt{d_i}}{N-1}\f$.
  * The time complexity of this method is \f$~14DN^2\f$ and should be used when N < D.
  *
+ * <em>RANDOMIZED</em> : Only the top T eigenvectors of the covariance matrix are
+ * computed by the randomized range finder of [Halko, Martinsson and Tropp, 2011]:
+ * the covariance matrix is applied to T+oversampling random vectors, followed
+ * by a few power iterations, and the eigenvectors are computed within the
+ * span of the results. The time complexity is \f$~2(q+2)DNT\f$ for q power
+ * iterations, neither the covariance matrix nor its full decomposition are
+ * needed. Only available in FIXED_NUMBER mode. The eigenvalues and components
+ * are stored in ascending order, like the ones of EVD.
  * <em>AUTO</em> : This mode automagically chooses one of the above modes for the user
  * based on whether N > D (chooses EVD) or N < D (chooses SVD).
  *
+ * PCA can also be initialized from CStreamingDenseFeatures, which are then read
+ * once, a block of vectors at a time, to accumulate the mean and covariance
+ * matrix. The components are computed from the covariance matrix with
+ * RANDOMIZED or with EVD (any other method), so only the \f$D \times D\f$
+ * covariance matrix and a block of vectors are kept in memory.
+ *
  * This class provides 3 modes to determine the value of T :
  *
  * <em>FIXED_NUMBER</em> : T is supplied by user directly using set_target_dims method
@@ -161,6 +183,11 @@ class CPCA: public CDimensionReductionPreprocessor
 		SGMatrix<float64_t> get_transformation_matrix();
 
 		/** get eigenvalues of PCA
+		 *
+		 * SVD stores them in descending order, and the columns of the
+		 * transformation matrix belong to the first ones. EVD, RANDOMIZED
+		 * and streaming features store them in ascending order, and the
+		 * columns belong to the last ones
 		 */
 		SGVector<float64_t> get_eigenvalues();
 
@@ -192,10 +219,62 @@ class CPCA: public CDimensionReductionPreprocessor
 		 */
 		float64_t get_eigenvalue_zero_tolerance() const;
 
+		/** set number of vectors added to the target dimension when
+		 * sampling the range of the covariance matrix in RANDOMIZED
+		 * method
+		 * @param oversampling oversampling, default 10
+		 */
+		void set_oversampling(int32_t oversampling);
+
+		/** @return oversampling of RANDOMIZED method */
+		int32_t get_oversampling() const;
+
+		/** set number of power iterations of RANDOMIZED method. More
+		 * iterations make the components more accurate if the eigenvalues
+		 * decay slowly
+		 * @param num_power_iterations number of power iterations, default 2
+		 */
+		void set_num_power_iterations(int32_t num_power_iterations);
+
+		/** @return number of power iterations of RANDOMIZED method */
+		int32_t get_num_power_iterations() const;
+
+		/** set number of vectors read at once from streaming features
+		 * @param block_size block size, default 1024
+		 */
+		void set_streaming_block_size(int32_t block_size);
+
+		/** @return number of vectors read at once from streaming features */
+		int32_t get_streaming_block_size() const;
+
 	protected:
 
 		void init();
 
+		/** computes mean and covariance matrix of streaming features and
+		 * the components from them
+		 * @param features streaming features
+		 */
+		void init_streaming(CStreamingDenseFeatures<float64_t>* features);
+
+		/** computes the components from the eigendecomposition of the
+		 * covariance matrix
+		 * @param cov_mat covariance matrix
+		 * @param num_vectors number of vectors it was computed from
+		 */
+		void init_evd(SGMatrix<float64_t> cov_mat, int64_t num_vectors);
+
+		/** sets the eigenvalues and the transformation matrix from the top
+		 * eigenvectors of the covariance matrix, whitened if requested
+		 * @param eigenvalues eigenvalues in ascending order
+		 * @param eigenvectors eigenvectors of the largest eigenvalues, in
+		 * the same order
+		 * @param num_vectors number of vectors the covariance matrix was
+		 * computed from
+		 */
+		void init_top_eigenvectors(SGVector<float64_t> eigenvalues,
+				SGMatrix<float64_t> eigenvectors, int64_t num_vectors);
+
 	protected:
 
 		/** transformation matrix */
@@ -225,6 +304,12 @@ class CPCA: public CDimensionReductionPreprocessor
 		 * whitening to tackle numerical issues
 		 */
 		float64_t m_eigenvalue_zero_tolerance;
+		/** oversampling of RANDOMIZED method */
+		int32_t m_oversampling;
+		/** number of power iterations of RANDOMIZED method */
+		int32_t m_num_power_iterations;
+		/** number of vectors read at once from streaming features */
+		int32_t m_streaming_block_size;
 };
 }
 #endif // PCA_H_
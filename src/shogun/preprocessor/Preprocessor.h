@@ -53,7 +53,8 @@ enum EPreprocessorType
 	P_PNORM = 190,
 	P_RESCALEFEATURES = 200,
 	P_FISHERLDA = 210,
-	P_BAHSIC = 220
+	P_BAHSIC = 220,
+	P_NYSTROM = 230
 };
 
 /** @brief Class Preprocessor defines a preprocessor interface.
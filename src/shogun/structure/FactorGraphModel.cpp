@@ -399,6 +399,15 @@ float64_t CFactorGraphModel::delta_loss(CStructuredData* y1, CStructuredData* y2
 	return loss;
 }
 
+bool CFactorGraphModel::init_parallel_argmax(SGVector<float64_t> w)
+{
+	if (m_verbose)
+		return false;
+
+	w_to_fparams(w);
+	return true;
+}
+
 void CFactorGraphModel::init_training()
 {
 }
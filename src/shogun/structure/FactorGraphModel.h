@@ -122,6 +122,15 @@ public:
 	 */
 	virtual CResultSet* argmax(SGVector< float64_t > w, int32_t feat_idx, bool const training = true);
 
+	/** prepares concurrent argmax calls by setting the factor parameters
+	 * from w once, argmax then only modifies the factor graph of its
+	 * example. Not supported in verbose mode.
+	 *
+	 * @param w weight vector
+	 * @return whether argmax can be called concurrently
+	 */
+	virtual bool init_parallel_argmax(SGVector<float64_t> w);
+
 	/** computes \f$ \Delta(y_{1}, y_{2}) \f$
 	 *
 	 * @param y1 an instance of structured data
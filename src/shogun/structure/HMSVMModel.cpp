@@ -65,7 +65,8 @@ SGVector< float64_t > CHMSVMModel::get_joint_feature_vector(
 		int32_t feat_idx,
 		CStructuredData* y)
 {
-	// Shorthand for the number of features of the feature vector
+	// Shorthands for the number of states, the matrix features and their dimension
+	int32_t S = m_state_model->get_num_states();
 	CMatrixFeatures< float64_t >* mf = (CMatrixFeatures< float64_t >*) m_features;
 	int32_t D = mf->get_num_features();
 
@@ -78,16 +79,20 @@ SGVector< float64_t > CHMSVMModel::get_joint_feature_vector(
 
 	// Translate from labels sequence to state sequence
 	SGVector< int32_t > state_seq = m_state_model->labels_to_states(label_seq);
-	m_transmission_weights.zero();
+	// Local weights, argmax may be called concurrently for different examples
+	SGMatrix< float64_t > transmission_weights(S,S);
+	transmission_weights.zero();
 
 	for ( int32_t i = 0 ; i < state_seq.vlen-1 ; ++i )
-		m_transmission_weights(state_seq[i],state_seq[i+1]) += 1;
+		transmission_weights(state_seq[i],state_seq[i+1]) += 1;
 
 	SGMatrix< float64_t > obs = mf->get_feature_vector(feat_idx);
 	REQUIRE(obs.num_rows == D && obs.num_cols == state_seq.vlen,
 		"obs.num_rows (%d) != D (%d) OR obs.num_cols (%d) != state_seq.vlen (%d)\n",
 		obs.num_rows, D, obs.num_cols, state_seq.vlen)
-	m_emission_weights.zero();
+	SGVector< float64_t > emission_weights(
+			S*D*(m_use_plifs ? m_num_plif_nodes : m_num_obs));
+	emission_weights.zero();
 	index_t aux_idx, weight_idx;
 
 	if ( !m_use_plifs )	// Do not use PLiFs
@@ -99,17 +104,15 @@ SGVector< float64_t > CHMSVMModel::get_joint_feature_vector(
 			for ( int32_t j = 0 ; j < state_seq.vlen ; ++j )
 			{
 				weight_idx = aux_idx + state_seq[j]*D*m_num_obs + obs(f,j);
-				m_emission_weights[weight_idx] += 1;
+				emission_weights[weight_idx] += 1;
 			}
 		}
 
-		m_state_model->weights_to_vector(psi, m_transmission_weights, m_emission_weights,
+		m_state_model->weights_to_vector(psi, transmission_weights, emission_weights,
 				D, m_num_obs);
 	}
 	else	// Use PLiFs
 	{
-		int32_t S = m_state_model->get_num_states();
-
 		for ( int32_t f = 0 ; f < D ; ++f )
 		{
 			aux_idx = f*m_num_plif_nodes;
@@ -134,15 +137,15 @@ SGVector< float64_t > CHMSVMModel::get_joint_feature_vector(
 				weight_idx = aux_idx + state_seq[j]*D*m_num_plif_nodes;
 
 				if ( count == 0 )
-					m_emission_weights[weight_idx] += 1;
+					emission_weights[weight_idx] += 1;
 				else if ( count == m_num_plif_nodes )
-					m_emission_weights[weight_idx + m_num_plif_nodes-1] += 1;
+					emission_weights[weight_idx + m_num_plif_nodes-1] += 1;
 				else
 				{
-					m_emission_weights[weight_idx + count] +=
+					emission_weights[weight_idx + count] +=
 						(value-limits[count-1]) / (limits[count]-limits[count-1]);
 
-					m_emission_weights[weight_idx + count-1] +=
+					emission_weights[weight_idx + count-1] +=
 						(limits[count]-value) / (limits[count]-limits[count-1]);
 				}
 
@@ -150,7 +153,7 @@ SGVector< float64_t > CHMSVMModel::get_joint_feature_vector(
 			}
 		}
 
-		m_state_model->weights_to_vector(psi, m_transmission_weights, m_emission_weights,
+		m_state_model->weights_to_vector(psi, transmission_weights, emission_weights,
 				D, m_num_plif_nodes);
 	}
 
@@ -196,7 +199,8 @@ CResultSet* CHMSVMModel::argmax(
 	if ( !m_use_plifs )	// Do not use PLiFs
 	{
 		index_t em_idx;
-		m_state_model->reshape_emission_params(m_emission_weights, w, D, m_num_obs);
+		SGVector< float64_t > emission_weights(S*D*m_num_obs);
+		m_state_model->reshape_emission_params(emission_weights, w, D, m_num_obs);
 
 		for ( int32_t i = 0 ; i < T ; ++i )
 		{
@@ -206,7 +210,7 @@ CResultSet* CHMSVMModel::argmax(
 				em_idx = j*m_num_obs + (index_t)CMath::round(x(j,i));
 
 				for ( int32_t s = 0 ; s < S ; ++s )
-					E(s,i) += m_emission_weights[s*D*m_num_obs + em_idx];
+					E(s,i) += emission_weights[s*D*m_num_obs + em_idx];
 			}
 		}
 	}
@@ -253,7 +257,8 @@ CResultSet* CHMSVMModel::argmax(
 	// Initialize the dynamic programming table and the traceback matrix
 	SGMatrix< float64_t >  dp(T, S);
 	SGMatrix< float64_t > trb(T, S);
-	m_state_model->reshape_transmission_params(m_transmission_weights, w);
+	SGMatrix< float64_t > transmission_weights(S, S);
+	m_state_model->reshape_transmission_params(transmission_weights, w);
 
 	for ( int32_t s = 0 ; s < S ; ++s )
 	{
@@ -286,8 +291,8 @@ CResultSet* CHMSVMModel::argmax(
 
 			for ( int32_t prev = 0 ; prev < S ; ++prev )
 			{
-				// aij = m_transmission_weights(prev, cur)
-				a = m_transmission_weights[cur*S + prev];
+				// aij = transmission_weights(prev, cur)
+				a = transmission_weights[cur*S + prev];
 
 				if ( a > -CMath::INFTY )
 				{
@@ -354,6 +359,12 @@ float64_t CHMSVMModel::delta_loss(CStructuredData* y1, CStructuredData* y2)
 	return m_state_model->loss(seq1, seq2);
 }
 
+bool CHMSVMModel::init_parallel_argmax(SGVector< float64_t > w)
+{
+	// Setting up the PLiFs from w modifies them, Viterbi only reads the rest
+	return !m_use_plifs;
+}
+
 void CHMSVMModel::init_primal_opt(
 		float64_t regularization,
 		SGMatrix< float64_t > & A,
@@ -489,10 +500,6 @@ bool CHMSVMModel::check_training_setup() const
 void CHMSVMModel::init()
 {
 	SG_ADD((CSGObject**) &m_state_model, "m_state_model", "The state model", MS_NOT_AVAILABLE);
-	SG_ADD(&m_transmission_weights, "m_transmission_weights",
-			"Transmission weights used in Viterbi", MS_NOT_AVAILABLE);
-	SG_ADD(&m_emission_weights, "m_emission_weights",
-			"Emission weights used in Viterbi", MS_NOT_AVAILABLE);
 	SG_ADD(&m_num_plif_nodes, "m_num_plif_nodes", "The number of points per PLiF",
 			MS_NOT_AVAILABLE); // FIXME It would actually make sense to do MS for this parameter
 	SG_ADD(&m_use_plifs, "m_use_plifs", "Whether to use plifs", MS_NOT_AVAILABLE);
@@ -527,13 +534,6 @@ void CHMSVMModel::init_training()
 	CMatrixFeatures< float64_t >* mf = (CMatrixFeatures< float64_t >*) m_features;
 	int32_t D = mf->get_num_features();
 
-	// Transmission and emission weights allocation
-	m_transmission_weights = SGMatrix< float64_t >(S,S);
-	if ( m_use_plifs )
-		m_emission_weights = SGVector< float64_t >(S*D*m_num_plif_nodes);
-	else
-		m_emission_weights = SGVector< float64_t >(S*D*m_num_obs);
-
 	// Auxiliary variables
 
 	// Shorthand for the number of free states
@@ -596,16 +596,6 @@ void CHMSVMModel::init_training()
 	}
 }
 
-SGMatrix< float64_t > CHMSVMModel::get_transmission_weights() const
-{
-	return m_transmission_weights;
-}
-
-SGVector< float64_t > CHMSVMModel::get_emission_weights() const
-{
-	return m_emission_weights;
-}
-
 CStateModel* CHMSVMModel::get_state_model() const
 {
 	SG_REF(m_state_model);
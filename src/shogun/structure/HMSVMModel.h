@@ -82,6 +82,14 @@ class CHMSVMModel : public CStructuredModel
 		 */
 		virtual CResultSet* argmax(SGVector< float64_t > w, int32_t feat_idx, bool const training = true);
 
+		/** prepares concurrent argmax calls, supported unless PLiFs are
+		 * used since these are set from the weight vector in argmax
+		 *
+		 * @param w weight vector
+		 * @return whether argmax can be called concurrently
+		 */
+		virtual bool init_parallel_argmax(SGVector< float64_t > w);
+
 		/** computes \f$ \Delta(y_{1}, y_{2}) \f$
 		 *
 		 * @param y1 an instance of structured data
@@ -142,24 +150,12 @@ class CHMSVMModel : public CStructuredModel
 		void set_use_plifs(bool use_plifs);
 
 		/**
-		 * initializes the emission and transmission vectors of weights used in Viterbi
-		 * decoding. In case PLiFs are used, it also initializes the matrix of PLiFs and
-		 * automatically selects the supporting points based on the feature values
+		 * initializes the number of auxiliary variables. In case PLiFs are used, it
+		 * also initializes the matrix of PLiFs and automatically selects the
+		 * supporting points based on the feature values
 		 */
 		virtual void init_training();
 
-		/** get transmission weights
-		 *
-		 * @return vector with the transmission weights
-		 */
-		SGMatrix< float64_t > get_transmission_weights() const;
-
-		/** get emission weights
-		 *
-		 * @return vector with the emission weights
-		 */
-		SGVector< float64_t > get_emission_weights() const;
-
 		/** get state model
 		 *
 		 * @return model with the description of the states
@@ -186,12 +182,6 @@ class CHMSVMModel : public CStructuredModel
 		/** the state model */
 		CStateModel* m_state_model;
 
-		/** transition weights used in Viterbi */
-		SGMatrix< float64_t > m_transmission_weights;
-
-		/** emission weights used in Viterbi */
-		SGVector< float64_t > m_emission_weights;
-
 		/** number of supporting points for each PLiF */
 		int32_t m_num_plif_nodes;
 
@@ -125,6 +125,12 @@ CResultSet* CMulticlassModel::argmax(
 	return ret;
 }
 
+bool CMulticlassModel::init_parallel_argmax(SGVector< float64_t > w)
+{
+	m_num_classes = ((CMulticlassSOLabels*) m_labels)->get_num_classes();
+	return true;
+}
+
 float64_t CMulticlassModel::delta_loss(CStructuredData* y1, CStructuredData* y2)
 {
 	CRealNumber* rn1 = CRealNumber::obtain_from_generic(y1);
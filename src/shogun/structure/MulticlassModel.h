@@ -79,6 +79,14 @@ class CMulticlassModel : public CStructuredModel
 		 */
 		virtual CResultSet* argmax(SGVector< float64_t > w, int32_t feat_idx, bool const training = true);
 
+		/** prepares concurrent argmax calls, argmax of this model only
+		 * reads the features, labels and weights
+		 *
+		 * @param w weight vector
+		 * @return true
+		 */
+		virtual bool init_parallel_argmax(SGVector< float64_t > w);
+
 		/** computes \f$ \Delta(y_{1}, y_{2}) \f$
 		 *
 		 * @param y1 an instance of structured data
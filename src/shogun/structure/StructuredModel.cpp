@@ -180,6 +180,11 @@ void CStructuredModel::init_training()
 	// Nothing to do here
 }
 
+bool CStructuredModel::init_parallel_argmax(SGVector< float64_t > w)
+{
+	return false;
+}
+
 bool CStructuredModel::check_training_setup() const
 {
 	// Nothing to do here
@@ -265,6 +265,19 @@ class CStructuredModel : public CSGObject
 		 */
 		virtual void init_training();
 
+		/** prepares the model to compute the argmax of several examples
+		 * concurrently with the given weight vector. Called before the
+		 * loss-augmented argmax of all the examples is evaluated, e.g. in
+		 * CStructuredOutputMachine::risk. In this class it does nothing and
+		 * returns false; re-implement it for models whose argmax only reads
+		 * shared state once prepared.
+		 *
+		 * @param w weight vector
+		 * @return whether argmax can be called concurrently for different
+		 * examples
+		 */
+		virtual bool init_parallel_argmax(SGVector< float64_t > w);
+
 		/**
 		 * method to be called from a SO machine before training
 		 * to ensure that the training data is valid (e.g. check that
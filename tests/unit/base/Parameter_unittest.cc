@@ -1589,7 +1589,6 @@ TEST(TParameter,copy_SPARSE_SCALAR_target_empty)
 
 	SGSparseVector<float64_t> vec1=s1->get_sparse_feature_vector(0);
 	SGSparseVector<float64_t> vec2=s2->get_sparse_feature_vector(0);
-	void* temp=vec2.features;
 	vec2.features=NULL;
 	vec2.num_feat_entries=0;
 
@@ -1608,7 +1607,6 @@ TEST(TParameter,copy_SPARSE_SCALAR_target_empty)
 
 	delete param1;
 	delete param2;
-	SG_FREE(temp);
 	s1->free_sparse_feature_vector(0);
 	s2->free_sparse_feature_vector(0);
 	SG_UNREF(s1);
@@ -1628,8 +1626,6 @@ TEST(TParameter,copy_SPARSE_SCALAR_source_and_target_empty)
 
 	SGSparseVector<float64_t> vec1=s1->get_sparse_feature_vector(0);
 	SGSparseVector<float64_t> vec2=s2->get_sparse_feature_vector(0);
-	void* temp1=vec1.features;
-	void* temp2=vec2.features;
 	vec2.features=NULL;
 	vec1.features=NULL;
 	vec1.num_feat_entries=0;
@@ -1646,8 +1642,6 @@ TEST(TParameter,copy_SPARSE_SCALAR_source_and_target_empty)
 
 	delete param1;
 	delete param2;
-	SG_FREE(temp1);
-	SG_FREE(temp2);
 	s1->free_sparse_feature_vector(0);
 	s2->free_sparse_feature_vector(0);
 	SG_UNREF(s1);
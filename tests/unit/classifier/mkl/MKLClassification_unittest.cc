@@ -0,0 +1,85 @@
+#include <shogun/classifier/mkl/MKLClassification.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/kernel/CombinedKernel.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/features/CombinedFeatures.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/mathematics/Math.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+TEST(MKLClassificationTest,subkernel_quadratic_forms_used)
+{
+	const index_t num_vectors=40;
+	const index_t dim=2;
+	SGMatrix<float64_t> data(dim, num_vectors);
+	SGVector<float64_t> lab(num_vectors);
+	for (index_t i=0; i<num_vectors; i++)
+	{
+		lab[i]=i%2 ? 1 : -1;
+		for (index_t j=0; j<dim; j++)
+			data(j,i)=lab[i]+CMath::sin(dim*i+j+1.0);
+	}
+
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	CBinaryLabels* labels=new CBinaryLabels(lab);
+	CCombinedKernel* combined=new CCombinedKernel();
+	combined->append_kernel(new CGaussianKernel(10, 0.5));
+	combined->append_kernel(new CGaussianKernel(10, 3));
+	combined->append_kernel(new CLinearKernel());
+	combined->init(feats, feats);
+
+	/* init() wraps the features separately for each side, only the
+	 * subkernels see the same features on both sides */
+	EXPECT_TRUE(combined->has_symmetric_subkernels());
+
+	CMKLClassification* mkl=new CMKLClassification(new CLibSVM());
+	SG_REF(mkl);
+	mkl->set_mkl_norm(2);
+	mkl->set_interleaved_optimization_enabled(false);
+	mkl->set_kernel(combined);
+	mkl->set_labels(labels);
+	EXPECT_TRUE(mkl->use_subkernel_quadratic_forms());
+	mkl->train();
+
+	/* the dual objective from the quadratic forms matches the naive sum */
+	index_t nsv=mkl->get_num_support_vectors();
+	float64_t expected=0;
+	for (index_t k_idx=0; k_idx<combined->get_num_kernels(); k_idx++)
+	{
+		CKernel* k=combined->get_kernel(k_idx);
+		float64_t sum=0;
+		for (index_t i=0; i<nsv; i++)
+		{
+			for (index_t j=0; j<nsv; j++)
+			{
+				sum+=mkl->get_alpha(i)*mkl->get_alpha(j)*
+					k->kernel(mkl->get_support_vector(i),
+							mkl->get_support_vector(j));
+			}
+		}
+		expected+=CMath::pow(sum, 2.0);
+		SG_UNREF(k);
+	}
+	expected=0.5*CMath::sqrt(expected)-mkl->compute_sum_alpha();
+
+	EXPECT_NEAR(mkl->compute_mkl_dual_objective(), expected, 1e-8);
+
+	/* different features on both sides of a subkernel disable the fast
+	 * path */
+	CCombinedFeatures* lhs=new CCombinedFeatures();
+	CCombinedFeatures* rhs=new CCombinedFeatures();
+	for (index_t k_idx=0; k_idx<combined->get_num_kernels(); k_idx++)
+	{
+		lhs->append_feature_obj(feats);
+		rhs->append_feature_obj(new CDenseFeatures<float64_t>(data));
+	}
+	combined->init(lhs, rhs);
+	EXPECT_FALSE(combined->has_symmetric_subkernels());
+	EXPECT_FALSE(mkl->use_subkernel_quadratic_forms());
+
+	SG_UNREF(mkl);
+}
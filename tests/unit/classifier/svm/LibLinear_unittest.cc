@@ -1294,4 +1294,92 @@ TEST(LibLinear,simple_set_train_L2R_LR_DUAL_BIAS)
 	SG_UNREF(eval);
 	SG_UNREF(pred);
 }
+
+//Train on noisy linearly separable data with as many samples (or features
+//for the L1 regularized solvers) that the coordinate descent sweeps use
+//several threads
+SGVector<float64_t> train_parallel_coordinate_descent(
+		LIBLINEAR_SOLVER_TYPE liblinear_solver_type, bool parallel_cd)
+{
+	index_t num_features = 64;
+	index_t num_samples = 4096;
+	CMath::init_random(17);
+
+	SGMatrix<float64_t> data(num_features, num_samples);
+	SGVector<float64_t> labels(num_samples);
+	for (index_t i = 0; i < num_samples; ++i)
+	{
+		float64_t margin = 0.5*CMath::randn_double();
+		for (index_t j = 0; j < num_features; ++j)
+		{
+			data(j, i) = CMath::randn_double();
+			if (j % 8 == 0)
+				margin += data(j, i);
+		}
+		labels[i] = margin > 0 ? 1.0 : -1.0;
+	}
+
+	bool is_l1 = liblinear_solver_type == L1R_L2LOSS_SVC ||
+			liblinear_solver_type == L1R_LR;
+	if (is_l1)
+	{
+		SGMatrix<float64_t>::transpose_matrix(data.matrix,
+				data.num_rows, data.num_cols);
+	}
+
+	CDenseFeatures<float64_t>* train_feats = new CDenseFeatures<float64_t>(data);
+	CBinaryLabels* ground_truth = new CBinaryLabels(labels);
+
+	CLibLinear* ll = new CLibLinear(liblinear_solver_type);
+	ll->set_bias_enabled(true);
+	ll->set_features(train_feats);
+	ll->set_labels(ground_truth);
+	ll->set_parallel_coordinate_descent(parallel_cd);
+	ll->parallel->set_num_threads(4);
+	ll->train();
+
+	SGVector<float64_t> w = ll->get_w().clone();
+	w.resize_vector(w.vlen+1);
+	w[w.vlen-1] = ll->get_bias();
+
+	SG_UNREF(ll);
+	return w;
+}
+
+void check_parallel_coordinate_descent(
+		LIBLINEAR_SOLVER_TYPE liblinear_solver_type)
+{
+	SGVector<float64_t> serial_w =
+		train_parallel_coordinate_descent(liblinear_solver_type, false);
+	SGVector<float64_t> parallel_w =
+		train_parallel_coordinate_descent(liblinear_solver_type, true);
+
+	float64_t scale = 0;
+	for (index_t i = 0; i < serial_w.vlen; ++i)
+		scale = CMath::max(scale, CMath::abs(serial_w[i]));
+
+	EXPECT_EQ(parallel_w.vlen, serial_w.vlen);
+	for (index_t i = 0; i < serial_w.vlen; ++i)
+		EXPECT_NEAR(parallel_w[i], serial_w[i], 1e-2*scale);
+}
+
+TEST(LibLinear,parallel_L2R_L2LOSS_SVC_DUAL)
+{
+	check_parallel_coordinate_descent(L2R_L2LOSS_SVC_DUAL);
+}
+
+TEST(LibLinear,parallel_L2R_L1LOSS_SVC_DUAL)
+{
+	check_parallel_coordinate_descent(L2R_L1LOSS_SVC_DUAL);
+}
+
+TEST(LibLinear,parallel_L1R_L2LOSS_SVC)
+{
+	check_parallel_coordinate_descent(L1R_L2LOSS_SVC);
+}
+
+TEST(LibLinear,parallel_L1R_LR)
+{
+	check_parallel_coordinate_descent(L1R_LR);
+}
 #endif //HAVE_LAPACK
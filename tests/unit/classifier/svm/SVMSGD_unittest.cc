@@ -0,0 +1,63 @@
+#include <shogun/classifier/svm/SVMSGD.h>
+#include <shogun/features/DataGenerator.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+#ifdef HAVE_LAPACK
+static float64_t train_svmsgd(EParallelSGDMode mode, SGVector<float64_t>& w)
+{
+	index_t num_samples=500;
+	CMath::init_random(7);
+	SGMatrix<float64_t> gaussians=CDataGenerator::generate_gaussians(num_samples, 2, 2);
+
+	// alternate the classes and center the data between the means
+	SGMatrix<float64_t> data(2, 2*num_samples);
+	SGVector<float64_t> labels(2*num_samples);
+	for (index_t i=0; i<data.num_cols; i++)
+	{
+		index_t j=i%2==0 ? i/2 : num_samples+i/2;
+		data(0,i)=gaussians(0,j)+7.5;
+		data(1,i)=gaussians(1,j)-7.5;
+		labels[i]=i%2==0 ? 1.0 : -1.0;
+	}
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(data);
+	CBinaryLabels* ground_truth=new CBinaryLabels(labels);
+
+	CSVMSGD* svm=new CSVMSGD(1.0, features, ground_truth);
+	svm->set_parallel_mode(mode);
+	svm->parallel->set_num_threads(4);
+	svm->train();
+	w=svm->get_w().clone();
+
+	CBinaryLabels* pred=svm->apply_binary(features);
+	float64_t accuracy=0;
+	for (index_t i=0; i<labels.vlen; i++)
+		accuracy+=pred->get_label(i)==labels[i];
+
+	SG_UNREF(pred);
+	SG_UNREF(svm);
+	return accuracy/labels.vlen;
+}
+
+TEST(SVMSGD,parallel_modes)
+{
+	SGVector<float64_t> w_serial;
+	float64_t accuracy=train_svmsgd(PSGD_SERIAL, w_serial);
+	EXPECT_GT(accuracy, 0.95);
+
+	SGVector<float64_t> w_hogwild;
+	EXPECT_NEAR(train_svmsgd(PSGD_HOGWILD, w_hogwild), accuracy, 0.02);
+
+	SGVector<float64_t> w_averaged;
+	EXPECT_NEAR(train_svmsgd(PSGD_AVERAGED, w_averaged), accuracy, 0.02);
+
+	// averaging is deterministic for a fixed number of threads
+	SGVector<float64_t> w_averaged_again;
+	train_svmsgd(PSGD_AVERAGED, w_averaged_again);
+	for (index_t i=0; i<w_averaged.vlen; i++)
+		EXPECT_EQ(w_averaged[i], w_averaged_again[i]);
+}
+#endif // HAVE_LAPACK
@@ -0,0 +1,65 @@
+#include <shogun/lib/config.h>
+#include <shogun/clustering/GMM.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/mathematics/Math.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+#ifdef HAVE_LAPACK
+
+TEST(GMM, train_em_log_likelihood)
+{
+	const int32_t num_vectors=600;
+	const int32_t dim=3;
+	ECovType cov_types[]={FULL, DIAG, SPHERICAL};
+
+	sg_rand->set_seed(7);
+	SGMatrix<float64_t> data(dim, num_vectors);
+	for (int32_t i=0; i<num_vectors; i++)
+	{
+		float64_t offset=i<num_vectors/3 ? -8 : 8;
+		for (int32_t j=0; j<dim; j++)
+			data(j, i)=CMath::randn_double()*(j+1)+offset;
+	}
+
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	SG_REF(feats);
+
+	for (int32_t t=0; t<3; t++)
+	{
+		CGMM* gmm=new CGMM(2, cov_types[t]);
+		SG_REF(gmm);
+		gmm->train(feats);
+		float64_t log_likelihood=gmm->train_em(1e-9, 1000, 1e-9);
+
+		/* batched E-step has to agree with the per vector densities */
+		float64_t expected=0;
+		for (int32_t i=0; i<num_vectors; i++)
+		{
+			SGVector<float64_t> v=feats->get_feature_vector(i);
+			SGVector<float64_t> answer=gmm->cluster(v);
+			expected+=answer[2];
+		}
+		EXPECT_NEAR(log_likelihood, expected, 1e-8*CMath::abs(expected));
+
+		SGVector<float64_t> coef=gmm->get_coef();
+		int32_t small=coef[0]<coef[1] ? 0 : 1;
+		EXPECT_NEAR(coef[small], 1.0/3, 1e-6);
+		EXPECT_NEAR(coef[1-small], 2.0/3, 1e-6);
+
+		SGVector<float64_t> mean_small=gmm->get_nth_mean(small);
+		SGVector<float64_t> mean_large=gmm->get_nth_mean(1-small);
+		for (int32_t j=0; j<dim; j++)
+		{
+			EXPECT_NEAR(mean_small[j], -8, 0.5);
+			EXPECT_NEAR(mean_large[j], 8, 0.5);
+		}
+
+		SG_UNREF(gmm);
+	}
+
+	SG_UNREF(feats);
+}
+
+#endif /* HAVE_LAPACK */
@@ -11,8 +11,11 @@
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/clustering/KMeans.h>
 #include <shogun/clustering/KMeansMiniBatch.h>
+#include <shogun/clustering/StreamingKMeansMiniBatch.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
 #include <shogun/distance/EuclideanDistance.h>
 #include <gtest/gtest.h>
+#include <unistd.h>
 
 using namespace shogun;
 
@@ -281,3 +284,209 @@ TEST(KMeans, random_centers_assign)
 	SG_UNREF(learnt_centers);
 }
 
+
+TEST(KMeans, accelerated_methods_match_lloyd)
+{
+	/* bound based iterations have to reproduce the Lloyd clustering */
+	const int32_t dim=3;
+	const int32_t num_vectors=300;
+	const int32_t num_centers=25;
+	CMath::init_random(42);
+
+	SGMatrix<float64_t> data(dim, num_vectors);
+	for (index_t i=0; i<num_vectors; i++)
+	{
+		float64_t offset=10.0*(i%5);
+		for (index_t j=0; j<dim; j++)
+			data(j,i)=offset+CMath::normal_random(0.0, 2.0);
+	}
+
+	SGMatrix<float64_t> initial_centers(dim, num_centers);
+	for (index_t c=0; c<num_centers; c++)
+	{
+		for (index_t j=0; j<dim; j++)
+			initial_centers(j,c)=data(j,c*7);
+	}
+
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(data);
+	SG_REF(features);
+
+	EKMeansMethod methods[]={KMM_LLOYD, KMM_HAMERLY, KMM_ELKAN, KMM_AUTO};
+	SGMatrix<float64_t> reference;
+
+	for (index_t m=0; m<4; m++)
+	{
+		CEuclideanDistance* distance=new CEuclideanDistance(features, features);
+		CKMeans* clustering=new CKMeans(num_centers, distance, initial_centers);
+		clustering->set_train_method(methods[m]);
+		clustering->train(features);
+
+		SGMatrix<float64_t> c=clustering->get_cluster_centers();
+		if (m==0)
+			reference=c;
+		else
+		{
+			for (index_t i=0; i<dim*num_centers; i++)
+				EXPECT_NEAR(reference.matrix[i], c.matrix[i], 1E-10);
+		}
+
+		SG_UNREF(clustering);
+	}
+
+	SG_UNREF(features);
+}
+
+TEST(KMeans, KMeans_parallel_center_initialization_test)
+{
+	/* four well separated blobs, KMeans|| should seed one center in each */
+	const int32_t num_per_blob=50;
+	CMath::init_random(7);
+
+	SGMatrix<float64_t> data(2, 4*num_per_blob);
+	for (index_t i=0; i<4*num_per_blob; i++)
+	{
+		data(0,i)=100.0*(i%2)+CMath::normal_random(0.0, 1.0);
+		data(1,i)=100.0*((i/2)%2)+CMath::normal_random(0.0, 1.0);
+	}
+
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(data);
+	SG_REF(features);
+	CEuclideanDistance* distance=new CEuclideanDistance(features, features);
+	CKMeans* clustering=new CKMeans(4, distance);
+	clustering->set_use_kmeans_parallel(true);
+	clustering->set_kmeans_parallel_params(2.0, 3);
+	EXPECT_TRUE(clustering->get_use_kmeans_parallel());
+
+	for (int32_t loop=0; loop<5; loop++)
+	{
+		clustering->train(features);
+		SGMatrix<float64_t> c=clustering->get_cluster_centers();
+
+		SGVector<int32_t> count(4);
+		count.zero();
+		for (index_t j=0; j<4; j++)
+		{
+			int32_t blob=(c(0,j)>50 ? 1 : 0)+(c(1,j)>50 ? 2 : 0);
+			count[blob]++;
+		}
+
+		for (index_t b=0; b<4; b++)
+			EXPECT_EQ(1, count[b]);
+	}
+
+	SG_UNREF(clustering);
+	SG_UNREF(features);
+}
+
+TEST(KMeans, streaming_minibatch_training_test)
+{
+	/* two blobs around (0,0) and (100,100), streamed in batches */
+	const int32_t num_vectors=1000;
+	CMath::init_random(3);
+
+	SGMatrix<float64_t> data(2, num_vectors);
+	for (index_t i=0; i<num_vectors; i++)
+	{
+		data(0,i)=100.0*(i%2)+CMath::normal_random(0.0, 1.0);
+		data(1,i)=100.0*(i%2)+CMath::normal_random(0.0, 1.0);
+	}
+
+	SGMatrix<float64_t> initial_centers(2,2);
+	initial_centers(0,0)=10;
+	initial_centers(1,0)=10;
+	initial_centers(0,1)=90;
+	initial_centers(1,1)=90;
+
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(data);
+	CStreamingDenseFeatures<float64_t>* stream=
+		new CStreamingDenseFeatures<float64_t>(features);
+	SG_REF(stream);
+
+	CEuclideanDistance* distance=new CEuclideanDistance();
+	CStreamingKMeansMiniBatch* clustering=
+		new CStreamingKMeansMiniBatch(2, distance, initial_centers);
+	clustering->set_batch_size(64);
+	clustering->train(stream);
+
+	SGMatrix<float64_t> c=clustering->get_cluster_centers();
+	EXPECT_NEAR(0, c(0,0), 0.2);
+	EXPECT_NEAR(0, c(1,0), 0.2);
+	EXPECT_NEAR(100, c(0,1), 0.2);
+	EXPECT_NEAR(100, c(1,1), 0.2);
+
+	/* initial centers are not modified */
+	EXPECT_EQ(10, initial_centers(0,0));
+
+	/* every streamed vector is counted once */
+	SGVector<float64_t> counts=clustering->get_center_counts();
+	EXPECT_EQ(num_vectors/2, counts[0]);
+	EXPECT_EQ(num_vectors/2, counts[1]);
+
+	SG_UNREF(clustering);
+	SG_UNREF(stream);
+}
+
+TEST(KMeans, streaming_minibatch_resume_from_checkpoint)
+{
+	/* two blobs around (0,0) and (100,100), streamed in batches */
+	const int32_t num_vectors=1000;
+	const int32_t num_first=640;
+	const char* filename="StreamingKMeansMiniBatch_checkpoint.txt";
+	CMath::init_random(3);
+
+	SGMatrix<float64_t> data(2, num_vectors);
+	for (index_t i=0; i<num_vectors; i++)
+	{
+		data(0,i)=100.0*(i%2)+CMath::normal_random(0.0, 1.0);
+		data(1,i)=100.0*(i%2)+CMath::normal_random(0.0, 1.0);
+	}
+
+	SGMatrix<float64_t> initial_centers(2,2);
+	initial_centers(0,0)=10;
+	initial_centers(1,0)=10;
+	initial_centers(0,1)=90;
+	initial_centers(1,1)=90;
+
+	/* uninterrupted training on the whole stream */
+	CStreamingDenseFeatures<float64_t>* stream=new CStreamingDenseFeatures<float64_t>(
+		new CDenseFeatures<float64_t>(data));
+	CStreamingKMeansMiniBatch* clustering=new CStreamingKMeansMiniBatch(2,
+		new CEuclideanDistance(), initial_centers);
+	clustering->set_batch_size(64);
+	clustering->train(stream);
+	SGMatrix<float64_t> centers=clustering->get_cluster_centers();
+	SGVector<float64_t> counts=clustering->get_center_counts();
+	SG_UNREF(clustering);
+
+	/* the first 10 batches, which end with a checkpoint */
+	SGMatrix<float64_t> first(2, num_first);
+	SGMatrix<float64_t> rest(2, num_vectors-num_first);
+	memcpy(first.matrix, data.matrix, sizeof(float64_t)*2*num_first);
+	memcpy(rest.matrix, data.get_column_vector(num_first),
+		sizeof(float64_t)*2*(num_vectors-num_first));
+
+	stream=new CStreamingDenseFeatures<float64_t>(new CDenseFeatures<float64_t>(first));
+	clustering=new CStreamingKMeansMiniBatch(2, new CEuclideanDistance(), initial_centers);
+	clustering->set_batch_size(64);
+	clustering->set_checkpoint(10, filename);
+	clustering->train(stream);
+	SG_UNREF(clustering);
+
+	/* resumed on the rest of the stream */
+	stream=new CStreamingDenseFeatures<float64_t>(new CDenseFeatures<float64_t>(rest));
+	clustering=new CStreamingKMeansMiniBatch(2, new CEuclideanDistance());
+	clustering->set_batch_size(64);
+	clustering->load_checkpoint(filename);
+	clustering->train(stream);
+	SGMatrix<float64_t> resumed_centers=clustering->get_cluster_centers();
+	SGVector<float64_t> resumed_counts=clustering->get_center_counts();
+	SG_UNREF(clustering);
+	unlink(filename);
+
+	for (index_t j=0; j<2; j++)
+	{
+		EXPECT_EQ(counts[j], resumed_counts[j]);
+		for (index_t i=0; i<2; i++)
+			EXPECT_NEAR(centers(i,j), resumed_centers(i,j), 1e-10);
+	}
+}
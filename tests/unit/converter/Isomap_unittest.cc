@@ -1,6 +1,7 @@
 #include <vector>
 #include <set>
 #include <queue>
+#include <algorithm>
 
 #include <shogun/converter/Isomap.h>
 #include <shogun/distance/EuclideanDistance.h>
@@ -8,6 +9,9 @@
 #include <shogun/features/DataGenerator.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/lib/SGMatrix.h>
+#define TAPKEE_EIGEN_INCLUDE_FILE <shogun/mathematics/eigen3.h>
+#include <shogun/lib/tapkee/defines.hpp>
+#include <shogun/lib/tapkee/routines/isomap.hpp>
 #include <gtest/gtest.h>
 
 using namespace shogun;
@@ -58,8 +62,133 @@ TEST(IsomapTest,DISABLED_distance_preserving_max_k)
 	SG_UNREF(euclidean_distance);
 	SG_UNREF(euclidean_distance_for_embedding);
 }
+
+/* With every vector as a landmark, landmark Isomap has to give the
+ * embedding of Isomap up to the signs of its coordinates, so the distances
+ * between the embedded vectors have to be the same
+ */
+TEST(IsomapTest,landmark_equals_full_with_all_landmarks)
+{
+	const index_t n_samples = 30;
+	const index_t n_target_dimensions = 2;
+	SGMatrix<float64_t> data(3, n_samples);
+	/* vectors on a noisy arc */
+	CMath::init_random(17);
+	for (index_t i=0; i<n_samples; i++)
+	{
+		float64_t angle = 0.1*i;
+		data(0,i) = CMath::cos(angle);
+		data(1,i) = CMath::sin(angle);
+		data(2,i) = 0.01*CMath::randn_double();
+	}
+	CDenseFeatures<float64_t>* features = new CDenseFeatures<float64_t>(data);
+	SG_REF(features);
+
+	CDenseFeatures<float64_t>* embeddings[2];
+	for (index_t landmark=0; landmark<2; landmark++)
+	{
+		CIsomap* isomap = new CIsomap();
+		isomap->set_k(4);
+		isomap->set_target_dim(n_target_dimensions);
+		isomap->set_landmark(landmark==1);
+		isomap->set_landmark_number(n_samples);
+		embeddings[landmark] = isomap->embed(features);
+		EXPECT_EQ(n_target_dimensions, embeddings[landmark]->get_dim_feature_space());
+		EXPECT_EQ(n_samples, embeddings[landmark]->get_num_vectors());
+		SG_UNREF(isomap);
+	}
+
+	CEuclideanDistance* full_distance =
+		new CEuclideanDistance(embeddings[0], embeddings[0]);
+	CEuclideanDistance* landmark_distance =
+		new CEuclideanDistance(embeddings[1], embeddings[1]);
+	SGMatrix<float64_t> full_distances = full_distance->get_distance_matrix();
+	SGMatrix<float64_t> landmark_distances = landmark_distance->get_distance_matrix();
+	for (index_t i=0; i<n_samples*n_samples; i++)
+		EXPECT_NEAR(full_distances[i], landmark_distances[i], 1e-6);
+
+	SG_UNREF(full_distance);
+	SG_UNREF(landmark_distance);
+	SG_UNREF(features);
+}
 #endif // HAVE_LAPACK
 
+struct isomap_test_distance_callback
+{
+	isomap_test_distance_callback(const SGMatrix<float64_t>& m) : data(m)
+	{
+	}
+	tapkee::ScalarType distance(tapkee::IndexType a, tapkee::IndexType b) const
+	{
+		float64_t d = 0.0;
+		for (index_t i=0; i<data.num_rows; i++)
+			d += CMath::sq(data(i,a)-data(i,b));
+		return CMath::sqrt(d);
+	}
+	SGMatrix<float64_t> data;
+};
+
+/* The neighbors of a vector are not neighbored by it in general, so the
+ * neighborhood graph has to be made undirected for the shortest distances
+ * to be symmetric. Shortest distances from landmarks have to be the rows of
+ * the full matrix.
+ */
+TEST(IsomapTest,geodesic_distances_symmetric)
+{
+	const index_t n_samples = 40;
+	const index_t n_neighbors = 3;
+	CMath::init_random(17);
+	SGMatrix<float64_t> data = CDataGenerator::generate_gaussians(n_samples, 1, 2);
+	isomap_test_distance_callback callback(data);
+
+	std::vector<tapkee::IndexType> indices;
+	for (index_t i=0; i<n_samples; i++)
+		indices.push_back(i);
+
+	tapkee::tapkee_internal::Neighbors neighbors(n_samples);
+	for (index_t i=0; i<n_samples; i++)
+	{
+		std::vector<std::pair<float64_t,tapkee::IndexType> > distances;
+		for (index_t j=0; j<n_samples; j++)
+		{
+			if (j!=i)
+				distances.push_back(std::make_pair(callback.distance(i,j),j));
+		}
+		std::sort(distances.begin(), distances.end());
+		for (index_t k=0; k<n_neighbors; k++)
+			neighbors[i].push_back(distances[k].second);
+	}
+
+	tapkee::DenseSymmetricMatrix geodesic =
+		tapkee::tapkee_internal::compute_shortest_distances_matrix(
+			indices.begin(), indices.end(), neighbors, callback);
+	ASSERT_EQ(n_samples, geodesic.rows());
+	ASSERT_EQ(n_samples, geodesic.cols());
+	for (index_t i=0; i<n_samples; i++)
+	{
+		EXPECT_EQ(0.0, geodesic(i,i));
+		for (index_t j=0; j<n_samples; j++)
+		{
+			EXPECT_NEAR(geodesic(i,j), geodesic(j,i), 1e-12);
+			EXPECT_GE(geodesic(i,j), callback.distance(i,j)-1e-12);
+		}
+	}
+
+	tapkee::tapkee_internal::Landmarks landmarks;
+	for (index_t i=0; i<n_samples; i+=7)
+		landmarks.push_back(i);
+	tapkee::DenseMatrix landmark_geodesic =
+		tapkee::tapkee_internal::compute_shortest_distances_matrix(
+			indices.begin(), indices.end(), landmarks, neighbors, callback);
+	ASSERT_EQ(index_t(landmarks.size()), landmark_geodesic.rows());
+	ASSERT_EQ(n_samples, landmark_geodesic.cols());
+	for (index_t l=0; l<index_t(landmarks.size()); l++)
+	{
+		for (index_t j=0; j<n_samples; j++)
+			EXPECT_NEAR(geodesic(landmarks[l],j), landmark_geodesic(l,j), 1e-12);
+	}
+}
+
 struct index_and_distance_struct
 {
 	float64_t distance;
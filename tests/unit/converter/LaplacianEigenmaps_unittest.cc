@@ -0,0 +1,102 @@
+#include <shogun/converter/LaplacianEigenmaps.h>
+#include <shogun/distance/EuclideanDistance.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGVector.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <algorithm>
+
+using namespace shogun;
+
+TEST(LaplacianEigenmapsTest,generalized_eigenvectors)
+{
+	const index_t n_vectors=150;
+	const index_t n_neighbors=8;
+	const index_t n_target_dimensions=2;
+	const float64_t tau=0.5;
+
+	CMath::init_random(17);
+	SGMatrix<float64_t> data(2, n_vectors);
+	for (index_t i=0; i<2*n_vectors; i++)
+		data.matrix[i]=CMath::random(0.0, 1.0);
+
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(data);
+	CEuclideanDistance* distance=new CEuclideanDistance(features, features);
+	SG_REF(distance);
+
+	CLaplacianEigenmaps* embedder=new CLaplacianEigenmaps();
+	SG_REF(embedder);
+	embedder->set_k(n_neighbors);
+	embedder->set_tau(tau);
+	embedder->set_target_dim(n_target_dimensions);
+	CDenseFeatures<float64_t>* embedding=embedder->embed_distance(distance);
+	SGMatrix<float64_t> vectors=embedding->get_feature_matrix();
+	EXPECT_EQ(n_target_dimensions, vectors.num_rows);
+	EXPECT_EQ(n_vectors, vectors.num_cols);
+
+	// laplacian L=D-W of the heat kernel on the symmetrized neighbor graph
+	SGMatrix<float64_t> W(n_vectors, n_vectors);
+	W.zero();
+	for (index_t i=0; i<n_vectors; i++)
+	{
+		std::vector<std::pair<float64_t,index_t> > dists;
+		for (index_t j=0; j<n_vectors; j++)
+		{
+			if (j!=i)
+				dists.push_back(std::make_pair(distance->distance(i,j), j));
+		}
+		std::sort(dists.begin(), dists.end());
+		for (index_t j=0; j<n_neighbors; j++)
+		{
+			float64_t heat=CMath::exp(-CMath::sq(dists[j].first)/tau);
+			W(i,dists[j].second)+=heat;
+			W(dists[j].second,i)+=heat;
+		}
+	}
+	SGVector<float64_t> D(n_vectors);
+	D.zero();
+	for (index_t i=0; i<n_vectors; i++)
+	{
+		for (index_t j=0; j<n_vectors; j++)
+			D[i]+=W(i,j);
+	}
+
+	// rows are solutions of L v = lambda D v with v^T D v = 1, which are
+	// D-orthogonal to the skipped constant one, smallest eigenvalues first
+	float64_t last_eigenvalue=0.0;
+	for (index_t r=0; r<n_target_dimensions; r++)
+	{
+		SGVector<float64_t> v(n_vectors);
+		for (index_t i=0; i<n_vectors; i++)
+			v[i]=vectors(r,i);
+
+		SGVector<float64_t> Lv(n_vectors);
+		float64_t vDv=0.0, vLv=0.0, constant_product=0.0;
+		for (index_t i=0; i<n_vectors; i++)
+		{
+			Lv[i]=D[i]*v[i];
+			for (index_t j=0; j<n_vectors; j++)
+				Lv[i]-=W(i,j)*v[j];
+			vDv+=v[i]*D[i]*v[i];
+			vLv+=v[i]*Lv[i];
+			constant_product+=D[i]*v[i];
+		}
+		EXPECT_NEAR(1.0, vDv, 1E-6);
+		EXPECT_NEAR(0.0, constant_product, 1E-6);
+
+		float64_t eigenvalue=vLv;
+		for (index_t i=0; i<n_vectors; i++)
+			EXPECT_NEAR(eigenvalue*D[i]*v[i], Lv[i], 1E-6);
+
+		EXPECT_GT(eigenvalue, 1E-10);
+		EXPECT_GE(eigenvalue, last_eigenvalue);
+		last_eigenvalue=eigenvalue;
+	}
+
+	SG_UNREF(embedding);
+	SG_UNREF(embedder);
+	SG_UNREF(distance);
+}
@@ -1,6 +1,12 @@
 #include <shogun/converter/TDistributedStochasticNeighborEmbedding.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/features/DataGenerator.h>
+#include <shogun/base/init.h>
+#include <shogun/base/Parallel.h>
+#include <shogun/mathematics/Math.h>
+#define TAPKEE_EIGEN_INCLUDE_FILE <shogun/mathematics/eigen3.h>
+#include <shogun/lib/tapkee/defines.hpp>
+#include <shogun/lib/tapkee/external/barnes_hut_sne/tsne.hpp>
 #include <gtest/gtest.h>
 
 using namespace shogun;
@@ -36,5 +42,71 @@ TEST(TDistributedStochasticNeighborEmbeddingTest,basic)
 	SG_UNREF(high_dimensional_features);
 	SG_UNREF(low_dimensional_features);
 }
+
+/* The exact (theta=0) variant is computed in parallel over points and has to
+ * give the same embedding with any number of threads */
+TEST(TDistributedStochasticNeighborEmbeddingTest,exact_parallel_equals_serial)
+{
+	const index_t n_samples = 30;
+	const index_t n_target_dimensions = 2;
+	SGMatrix<float64_t> data = CDataGenerator::generate_gaussians(n_samples/2, 2, 3);
+	int32_t num_threads = get_global_parallel()->get_num_threads();
+
+	SGMatrix<float64_t> embeddings[2];
+	int32_t threads[2] = {1, 4};
+	for (index_t t=0; t<2; t++)
+	{
+		get_global_parallel()->set_num_threads(threads[t]);
+		CDenseFeatures<float64_t>* features =
+			new CDenseFeatures<float64_t>(data.clone());
+		CTDistributedStochasticNeighborEmbedding* embedder =
+			new CTDistributedStochasticNeighborEmbedding();
+		embedder->set_target_dim(n_target_dimensions);
+		embedder->set_perplexity(n_samples / 5.0);
+		embedder->set_theta(0.0);
+
+		CMath::init_random(17);
+		CDenseFeatures<float64_t>* embedding = embedder->embed(features);
+		embeddings[t] = embedding->get_feature_matrix();
+
+		SG_UNREF(embedding);
+		SG_UNREF(embedder);
+		SG_UNREF(features);
+	}
+	get_global_parallel()->set_num_threads(num_threads);
+
+	EXPECT_EQ(n_target_dimensions, embeddings[0].num_rows);
+	EXPECT_EQ(n_samples, embeddings[0].num_cols);
+	for (index_t i=0; i<embeddings[0].num_rows*embeddings[0].num_cols; i++)
+	{
+		EXPECT_FALSE(CMath::is_nan(embeddings[0].matrix[i]));
+		EXPECT_NEAR(embeddings[0].matrix[i], embeddings[1].matrix[i], 1E-10);
+	}
+}
 #endif // HAVE_LAPACK
 
+TEST(TDistributedStochasticNeighborEmbeddingTest,squared_euclidean_distance)
+{
+	const index_t N = 20;
+	const index_t D = 3;
+	CMath::init_random(17);
+	SGMatrix<float64_t> X(D, N);
+	for (index_t i=0; i<N*D; i++)
+		X.matrix[i] = CMath::random(-1.0, 1.0);
+
+	SGMatrix<float64_t> DD(N, N);
+	tsne::TSNE tsne;
+	tsne.computeSquaredEuclideanDistance(X.matrix, N, D, DD.matrix);
+
+	for (index_t n=0; n<N; n++)
+	{
+		for (index_t m=0; m<N; m++)
+		{
+			float64_t dist = 0.0;
+			for (index_t d=0; d<D; d++)
+				dist += CMath::sq(X(d,n)-X(d,m));
+
+			EXPECT_NEAR(dist, DD(n,m), 1E-12);
+		}
+	}
+}
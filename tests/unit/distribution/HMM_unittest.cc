@@ -0,0 +1,104 @@
+#include <shogun/distributions/HMM.h>
+#include <shogun/features/StringFeatures.h>
+#include <shogun/lib/SGStringList.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/base/init.h>
+#include <shogun/base/Parallel.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+/* log probability of a sequence with the plain forward recursion */
+static float64_t naive_forward(CHMM* hmm, SGVector<uint16_t> obs)
+{
+	int32_t N=hmm->get_N();
+	SGVector<float64_t> alpha(N);
+	SGVector<float64_t> alpha_new(N);
+
+	for (int32_t i=0; i<N; i++)
+		alpha[i]=hmm->get_p(i)+hmm->get_b(i, obs[0]);
+
+	for (int32_t t=1; t<obs.vlen; t++)
+	{
+		for (int32_t j=0; j<N; j++)
+		{
+			float64_t sum=-CMath::INFTY;
+			for (int32_t i=0; i<N; i++)
+				sum=CMath::logarithmic_sum(sum, alpha[i]+hmm->get_a(i,j));
+			alpha_new[j]=sum+hmm->get_b(j, obs[t]);
+		}
+		for (int32_t j=0; j<N; j++)
+			alpha[j]=alpha_new[j];
+	}
+
+	float64_t prob=-CMath::INFTY;
+	for (int32_t i=0; i<N; i++)
+		prob=CMath::logarithmic_sum(prob, alpha[i]+hmm->get_q(i));
+
+	return prob;
+}
+
+TEST(HMM,parallel_equals_serial)
+{
+	const int32_t num_vectors=23;
+	const int32_t N=3;
+	const int32_t M=4;
+	const int32_t num_threads[]={1, 4};
+
+	CMath::init_random(7);
+	const char acgt[]="ACGT";
+	SGStringList<char> strings(num_vectors, 15);
+	for (int32_t i=0; i<num_vectors; i++)
+	{
+		SGString<char> current(CMath::random(5, 15));
+		for (int32_t t=0; t<current.slen; t++)
+			current.string[t]=acgt[CMath::random(0, M-1)];
+		strings.strings[i]=current;
+	}
+	CStringFeatures<char>* chars=new CStringFeatures<char>(strings, DNA);
+	CStringFeatures<uint16_t>* obs=new CStringFeatures<uint16_t>(DNA);
+	obs->obtain_from_char(chars, 0, 1, 0, false);
+	SG_UNREF(chars);
+	SG_REF(obs);
+
+	int32_t orig_num_threads=get_global_parallel()->get_num_threads();
+	CHMM* hmms[2];
+	for (int32_t k=0; k<2; k++)
+	{
+		/* the number of cache slots is fixed at construction */
+		get_global_parallel()->set_num_threads(num_threads[k]);
+		CMath::init_random(17);
+		hmms[k]=new CHMM(obs, N, M, 1e-10);
+		SG_REF(hmms[k]);
+
+		float64_t sum=0;
+		for (int32_t i=0; i<num_vectors; i++)
+		{
+			float64_t expected=naive_forward(hmms[k], obs->get_feature_vector(i));
+			EXPECT_NEAR(hmms[k]->model_probability(i), expected, 1e-10);
+			sum+=expected;
+		}
+		EXPECT_NEAR(hmms[k]->model_probability(), sum/num_vectors, 1e-10);
+
+		hmms[k]->set_iterations(5);
+		hmms[k]->set_epsilon(0);
+		hmms[k]->train();
+	}
+	get_global_parallel()->set_num_threads(orig_num_threads);
+
+	/* Baum-Welch with several workers estimates the same model as with one */
+	for (int32_t i=0; i<N; i++)
+	{
+		EXPECT_NEAR(hmms[0]->get_p(i), hmms[1]->get_p(i), 1e-8);
+		EXPECT_NEAR(hmms[0]->get_q(i), hmms[1]->get_q(i), 1e-8);
+		for (int32_t j=0; j<N; j++)
+			EXPECT_NEAR(hmms[0]->get_a(i,j), hmms[1]->get_a(i,j), 1e-8);
+		for (int32_t j=0; j<M; j++)
+			EXPECT_NEAR(hmms[0]->get_b(i,j), hmms[1]->get_b(i,j), 1e-8);
+	}
+	EXPECT_NEAR(hmms[0]->model_probability(), hmms[1]->model_probability(), 1e-8);
+
+	SG_UNREF(hmms[0]);
+	SG_UNREF(hmms[1]);
+	SG_UNREF(obs);
+}
@@ -100,4 +100,63 @@ TEST(MixtureModel,gaussian_mixture_model)
 	SG_UNREF(mix)
 }
 
+TEST(MixtureModel,batched_log_likelihood)
+{
+	sg_rand->set_seed(3);
+	const int32_t dim=3;
+	const int32_t num_vectors=2500;
+	SGMatrix<float64_t> data(dim,num_vectors);
+	for (int32_t i=0;i<dim*num_vectors;i++)
+		data.matrix[i]=CMath::randn_double()*2;
+
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	SG_REF(feats);
+
+	/* covariance with correlated dimensions */
+	SGMatrix<float64_t> cov(dim,dim);
+	for (int32_t i=0;i<dim;i++)
+	{
+		for (int32_t j=0;j<dim;j++)
+			cov(i,j)=i==j ? 2.0+i : 0.5;
+	}
+
+	ECovType cov_types[]={FULL, DIAG, SPHERICAL};
+	CDynamicObjectArray* comps=new CDynamicObjectArray();
+	SGVector<float64_t> weights(3);
+	for (int32_t k=0;k<3;k++)
+	{
+		SGVector<float64_t> mean(dim);
+		for (int32_t i=0;i<dim;i++)
+			mean[i]=k-i;
+
+		CGaussian* g=new CGaussian(mean,cov.clone(),cov_types[k]);
+		g->set_features(feats);
+		comps->push_back(g);
+		weights[k]=(k+1)/6.0;
+
+		SGVector<float64_t> log_pdf=g->compute_log_PDF(data);
+		SGVector<float64_t> log_likelihood=g->get_log_likelihood_examples(10,30);
+		ASSERT_EQ(log_pdf.vlen,num_vectors);
+		ASSERT_EQ(log_likelihood.vlen,20);
+		for (int32_t i=0;i<num_vectors;i++)
+		{
+			SGVector<float64_t> v(data.get_column_vector(i),dim,false);
+			EXPECT_NEAR(log_pdf[i],g->compute_log_PDF(v),1e-10);
+		}
+		for (int32_t i=0;i<20;i++)
+			EXPECT_NEAR(log_likelihood[i],g->get_log_likelihood_example(i+10),1e-10);
+	}
+
+	CMixtureModel* mix=new CMixtureModel(comps,weights);
+	mix->set_features(feats);
+
+	SGVector<float64_t> log_likelihood=mix->get_log_likelihood();
+	ASSERT_EQ(log_likelihood.vlen,num_vectors);
+	for (int32_t i=0;i<num_vectors;i++)
+		EXPECT_NEAR(log_likelihood[i],mix->get_log_likelihood_example(i),1e-10);
+
+	SG_UNREF(mix);
+	SG_UNREF(feats);
+}
+
 #endif /* HAVE_LAPACK */
\ No newline at end of file
@@ -10,6 +10,9 @@
 
 #include <shogun/labels/BinaryLabels.h>
 #include <shogun/evaluation/ROCEvaluation.h>
+#include <shogun/evaluation/PRCEvaluation.h>
+#include <shogun/evaluation/ScoreHistogram.h>
+#include <shogun/mathematics/Math.h>
 #include <gtest/gtest.h>
 
 using namespace shogun;
@@ -33,3 +36,143 @@ TEST(ROCEvaluation,one)
 	SG_UNREF(roc);
 	SG_UNREF(gt);
 }
+
+TEST(ROCEvaluation,exact_matches_pairwise_auc)
+{
+	index_t num_labels=20000;
+	SGVector<float64_t> scores(num_labels);
+	SGVector<float64_t> labels(num_labels);
+	for (index_t i=0; i<num_labels; i++)
+	{
+		labels[i]=CMath::random(0.0, 1.0)<0.3 ? 1 : -1;
+		// rounded scores to have ties
+		scores[i]=CMath::round(10*(CMath::normal_random(0.0, 1.0)+labels[i]));
+	}
+
+	CBinaryLabels* gt=new CBinaryLabels(labels);
+	CBinaryLabels* predicted=new CBinaryLabels(scores);
+	CROCEvaluation* roc=new CROCEvaluation();
+	roc->parallel->set_num_threads(4);
+	float64_t auc=roc->evaluate(predicted, gt);
+
+	// fraction of correctly ordered positive/negative pairs, ties count half
+	SGVector<float64_t> pos_scores(num_labels);
+	SGVector<float64_t> neg_scores(num_labels);
+	index_t num_pos=0;
+	index_t num_neg=0;
+	for (index_t i=0; i<num_labels; i++)
+	{
+		if (labels[i]>0)
+			pos_scores[num_pos++]=scores[i];
+		else
+			neg_scores[num_neg++]=scores[i];
+	}
+	float64_t pairs=0;
+	for (index_t i=0; i<num_pos; i++)
+	{
+		for (index_t j=0; j<num_neg; j++)
+		{
+			if (pos_scores[i]>neg_scores[j])
+				pairs+=1;
+			else if (pos_scores[i]==neg_scores[j])
+				pairs+=0.5;
+		}
+	}
+	EXPECT_NEAR(auc, pairs/num_pos/num_neg, 1E-10);
+
+	SGMatrix<float64_t> graph=roc->get_ROC();
+	EXPECT_EQ(graph(0,0), 0);
+	EXPECT_EQ(graph(1,0), 0);
+	EXPECT_EQ(graph(0,graph.num_cols-1), 1);
+	EXPECT_EQ(graph(1,graph.num_cols-1), 1);
+
+	SGVector<float64_t> thresholds=roc->get_thresholds();
+	for (index_t i=1; i<thresholds.vlen; i++)
+		EXPECT_GE(thresholds[i-1], thresholds[i]);
+
+	SG_UNREF(roc);
+	SG_UNREF(predicted);
+	SG_UNREF(gt);
+}
+
+TEST(ROCEvaluation,histogram)
+{
+	index_t num_labels=50000;
+	SGVector<float64_t> scores(num_labels);
+	SGVector<float64_t> labels(num_labels);
+	for (index_t i=0; i<num_labels; i++)
+	{
+		labels[i]=CMath::random(0.0, 1.0)<0.5 ? 1 : -1;
+		scores[i]=CMath::normal_random(0.0, 1.0)+labels[i];
+	}
+
+	CBinaryLabels* gt=new CBinaryLabels(labels);
+	CBinaryLabels* predicted=new CBinaryLabels(scores);
+	CROCEvaluation* roc=new CROCEvaluation();
+	float64_t exact=roc->evaluate(predicted, gt);
+
+	roc->set_method(CM_HISTOGRAM);
+	roc->parallel->set_num_threads(3);
+	float64_t approximate=roc->evaluate(predicted, gt);
+	EXPECT_NEAR(approximate, exact, 1E-4);
+	EXPECT_LE(roc->get_ROC().num_cols, roc->get_num_bins()+1);
+
+	// histograms of two shards merged are the histogram of all scores
+	CScoreHistogram* all=new CScoreHistogram(1000, -5, 5);
+	CScoreHistogram* first=new CScoreHistogram(1000, -5, 5);
+	CScoreHistogram* second=new CScoreHistogram(1000, -5, 5);
+	all->add(scores, labels);
+	first->add(SGVector<float64_t>(scores.vector, num_labels/3, false),
+			SGVector<float64_t>(labels.vector, num_labels/3, false));
+	second->add(SGVector<float64_t>(scores.vector+num_labels/3,
+			num_labels-num_labels/3, false),
+			SGVector<float64_t>(labels.vector+num_labels/3,
+			num_labels-num_labels/3, false));
+	first->merge(second);
+
+	SGVector<int64_t> positives=all->get_positive_counts();
+	SGVector<int64_t> negatives=all->get_negative_counts();
+	for (index_t i=0; i<1000; i++)
+	{
+		EXPECT_EQ(first->get_positive_counts()[i], positives[i]);
+		EXPECT_EQ(first->get_negative_counts()[i], negatives[i]);
+	}
+	EXPECT_EQ(roc->evaluate_histogram(first), all->get_auROC());
+	EXPECT_NEAR(roc->get_auROC(), exact, 1E-3);
+
+	// both curves have their points at the lower edges of the bins, the
+	// scores at or above which are predicted positive
+	SGVector<float64_t> roc_thresholds=all->get_ROC_thresholds();
+	SGVector<float64_t> prc_thresholds=all->get_PRC_thresholds();
+	SGMatrix<float64_t> roc_graph=all->get_ROC();
+	ASSERT_EQ(roc_thresholds.vlen, prc_thresholds.vlen);
+	for (index_t k=0; k<roc_thresholds.vlen; k++)
+	{
+		EXPECT_EQ(roc_thresholds[k], prc_thresholds[k]);
+
+		// scores below the range are counted in the first bin
+		if (roc_thresholds[k]==all->get_min_score())
+			continue;
+
+		int64_t tp=0;
+		for (index_t i=0; i<num_labels; i++)
+		{
+			if (labels[i]>0 && scores[i]>=roc_thresholds[k])
+				tp++;
+		}
+		EXPECT_NEAR(float64_t(tp)/all->get_num_positives(),
+				roc_graph(1,k+1), 1E-12);
+	}
+
+	CPRCEvaluation* prc=new CPRCEvaluation();
+	float64_t exact_prc=prc->evaluate(predicted, gt);
+	EXPECT_NEAR(prc->evaluate_histogram(first), exact_prc, 1E-3);
+
+	SG_UNREF(prc);
+	SG_UNREF(all);
+	SG_UNREF(first);
+	SG_UNREF(second);
+	SG_UNREF(roc);
+	SG_UNREF(predicted);
+	SG_UNREF(gt);
+}
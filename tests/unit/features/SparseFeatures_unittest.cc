@@ -392,3 +392,193 @@ TEST(SparseFeaturesTest,subset_get_full_feature_vector_smaller)
 
 	SG_UNREF(features);
 }
+
+TEST(SparseFeaturesTest,get_transposed_cached)
+{
+	SGMatrix<int32_t> data(2, 3);
+
+	data(0, 0)=0;
+	data(0, 1)=1;
+	data(0, 2)=2;
+	data(1, 0)=3;
+	data(1, 1)=0;
+	data(1, 2)=5;
+
+	CSparseFeatures<int32_t>* features=new CSparseFeatures<int32_t>(data);
+	SG_REF(features);
+
+	CSparseFeatures<int32_t>* transposed=features->get_transposed();
+	SG_REF(transposed);
+
+	EXPECT_EQ(transposed->get_num_features(), data.num_cols);
+	EXPECT_EQ(transposed->get_num_vectors(), data.num_rows);
+
+	SGMatrix<int32_t> data_transposed=transposed->get_full_feature_matrix();
+	for (index_t i=0; i<data.num_rows; ++i)
+	{
+		for (index_t j=0; j<data.num_cols; ++j)
+			EXPECT_EQ(data_transposed(j,i), data(i,j));
+	}
+
+	/* the cached transposed matrix is computed once, the transposed
+	 * features own their matrix */
+	SGSparseMatrix<int32_t> cached=
+		features->get_transposed_sparse_feature_matrix();
+	EXPECT_EQ(features->get_transposed_sparse_feature_matrix().sparse_matrix,
+			cached.sparse_matrix);
+	EXPECT_NE(transposed->get_sparse_feature_matrix().sparse_matrix,
+			cached.sparse_matrix);
+	transposed->get_sparse_feature_matrix()(2,0)=11;
+	EXPECT_EQ(cached(2,0), 2);
+
+	/* in place changes are seen after freeing the cache */
+	features->get_sparse_feature_matrix()(0,2)=13;
+	features->free_transposed_sparse_feature_matrix();
+	EXPECT_EQ(features->get_transposed_sparse_feature_matrix()(2,0), 13);
+
+	/* a new feature matrix invalidates the cache */
+	SGMatrix<int32_t> data2(4, 1);
+	data2.set_const(7);
+	features->set_full_feature_matrix(data2);
+	SGSparseMatrix<int32_t> transposed2=
+		features->get_transposed_sparse_feature_matrix();
+	EXPECT_EQ(transposed2.num_vectors, 4);
+	EXPECT_EQ(transposed2.num_features, 1);
+	for (index_t i=0; i<4; ++i)
+		EXPECT_EQ(transposed2(0,i), 7);
+
+	SG_UNREF(transposed);
+	SG_UNREF(features);
+}
+
+TEST(SparseFeaturesTest,copy_subset)
+{
+	SGMatrix<int32_t> data(2, 4);
+	for (index_t i=0; i<data.num_rows*data.num_cols; ++i)
+		data.matrix[i]=i%3;
+
+	CSparseFeatures<int32_t>* features=new CSparseFeatures<int32_t>(data);
+	SG_REF(features);
+
+	SGVector<index_t> subset_idx(3);
+	subset_idx[0]=3;
+	subset_idx[1]=1;
+	subset_idx[2]=2;
+	features->add_subset(subset_idx);
+
+	SGVector<index_t> copy_idx(2);
+	copy_idx[0]=0;
+	copy_idx[1]=2;
+	CSparseFeatures<int32_t>* copy=
+		(CSparseFeatures<int32_t>*)features->copy_subset(copy_idx);
+	SG_REF(copy);
+	SG_UNREF(features);
+
+	EXPECT_EQ(copy->get_num_vectors(), copy_idx.vlen);
+	SGMatrix<int32_t> data_copy=copy->get_full_feature_matrix();
+	for (index_t i=0; i<copy_idx.vlen; ++i)
+	{
+		for (index_t j=0; j<data.num_rows; ++j)
+			EXPECT_EQ(data_copy(j,i), data(j,subset_idx[copy_idx[i]]));
+	}
+
+	SG_UNREF(copy);
+}
+
+TEST(SparseFeaturesTest,dot_subset)
+{
+	SGMatrix<float64_t> data(4, 5);
+	data.zero();
+	data(0, 0)=1;
+	data(2, 0)=-2;
+	data(1, 1)=3;
+	data(2, 1)=4;
+	data(3, 2)=0.5;
+	data(0, 4)=2;
+	data(3, 4)=-1;
+
+	CSparseFeatures<float64_t>* features=new CSparseFeatures<float64_t>(data);
+	SG_REF(features);
+
+	int32_t idx[]={4, 0, 3, 1, 0};
+	float64_t result[5];
+	for (index_t i=0; i<data.num_cols; ++i)
+	{
+		features->dot_subset(i, features, idx, 5, result);
+		for (index_t j=0; j<5; ++j)
+			EXPECT_NEAR(result[j], features->dot(i, features, idx[j]), 1E-15);
+	}
+
+	/* pairs are merged if a dense vector does not pay off */
+	features->set_num_features(1000);
+	for (index_t i=0; i<data.num_cols; ++i)
+	{
+		features->dot_subset(i, features, idx, 5, result);
+		for (index_t j=0; j<5; ++j)
+			EXPECT_NEAR(result[j], features->dot(i, features, idx[j]), 1E-15);
+	}
+
+	SG_UNREF(features);
+}
+
+TEST(SparseFeaturesTest,compute_dot_matrix)
+{
+	SGMatrix<float64_t> data(4, 3);
+	data.zero();
+	data(0, 0)=1;
+	data(2, 0)=-2;
+	data(1, 1)=3;
+	data(2, 1)=4;
+	data(3, 2)=0.5;
+
+	SGMatrix<float64_t> data2(4, 2);
+	data2.zero();
+	data2(2, 0)=1;
+	data2(3, 0)=2;
+	data2(0, 1)=-1;
+
+	CSparseFeatures<float64_t>* features=new CSparseFeatures<float64_t>(data);
+	CSparseFeatures<float64_t>* features2=new CSparseFeatures<float64_t>(data2);
+	SG_REF(features);
+	SG_REF(features2);
+
+	/* also with a subset of the right hand side */
+	SGVector<index_t> subset(3);
+	subset[0]=1;
+	subset[1]=0;
+	subset[2]=1;
+	features2->add_subset(subset);
+
+	SGMatrix<float64_t> dots(3, 3);
+	features->compute_dot_matrix(features2, dots);
+	for (index_t i=0; i<3; ++i)
+	{
+		for (index_t j=0; j<3; ++j)
+			EXPECT_NEAR(dots(i,j), features->dot(i, features2, j), 1E-15);
+	}
+
+	SG_UNREF(features2);
+	SG_UNREF(features);
+}
+
+TEST(SparseFeaturesTest,sparse_feature_vector_outlives_features)
+{
+	SGMatrix<int32_t> data(2, 3);
+	data(0, 0)=0;
+	data(0, 1)=1;
+	data(0, 2)=2;
+	data(1, 0)=3;
+	data(1, 1)=0;
+	data(1, 2)=5;
+
+	/* the matrix converted from dense data stores its vectors contiguously */
+	CSparseFeatures<int32_t>* features=new CSparseFeatures<int32_t>(data);
+	SG_REF(features);
+	SGSparseVector<int32_t> vec=features->get_sparse_feature_vector(2);
+	features->free_sparse_feature_vector(2);
+	SG_UNREF(features);
+
+	EXPECT_EQ(vec.num_feat_entries, 2);
+	EXPECT_EQ(vec.get_feature(0), 2);
+	EXPECT_EQ(vec.get_feature(1), 5);
+}
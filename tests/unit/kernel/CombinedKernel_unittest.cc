@@ -1,5 +1,8 @@
 #include <shogun/kernel/CombinedKernel.h>
 #include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/mathematics/Math.h>
 #include <shogun/io/SerializableAsciiFile.h>
 #include <gtest/gtest.h>
 
@@ -217,3 +220,66 @@ TEST(CombinedKernelTest,combination)
 	SG_UNREF(combined_list);
 	SG_UNREF(kernel_list);
 }
+
+TEST(CombinedKernelTest,subkernel_quadratic_forms)
+{
+	const index_t num_vectors=40;
+	const index_t dim=3;
+	SGMatrix<float64_t> data(dim, num_vectors);
+	for (index_t i=0; i<dim*num_vectors; i++)
+		data.matrix[i]=CMath::sin(i+1.0);
+
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	CCombinedKernel* combined=new CCombinedKernel();
+	combined->append_kernel(new CGaussianKernel(10, 0.5));
+	combined->append_kernel(new CGaussianKernel(10, 3));
+	combined->append_kernel(new CLinearKernel());
+	combined->init(feats, feats);
+
+	SGVector<int32_t> idx(15);
+	SGVector<float64_t> weights(15);
+	for (index_t i=0; i<idx.vlen; i++)
+	{
+		idx[i]=2*i+1;
+		weights[i]=CMath::cos(i+1.0);
+	}
+
+	SGMatrix<float64_t> expected(combined->get_num_kernels(), 2);
+	expected.zero();
+	for (index_t k_idx=0; k_idx<combined->get_num_kernels(); k_idx++)
+	{
+		CKernel* k=combined->get_kernel(k_idx);
+		for (index_t i=0; i<idx.vlen; i++)
+		{
+			for (index_t j=0; j<idx.vlen; j++)
+			{
+				expected(k_idx, 0)+=weights[i]*weights[j]*k->kernel(idx[i], idx[j]);
+				expected(k_idx, 1)+=weights[i]*weights[j]*k->kernel(idx[i]+2, idx[j]+2);
+			}
+		}
+		SG_UNREF(k);
+	}
+
+	SGVector<float64_t> q=combined->compute_subkernel_quadratic_forms(idx, weights);
+	for (index_t k_idx=0; k_idx<q.vlen; k_idx++)
+		EXPECT_NEAR(q[k_idx], expected(k_idx, 0), 1e-10);
+
+	/* cached values have to be the same, also after the vectors changed in
+	 * part */
+	combined->set_subkernel_cache_size(1);
+	for (index_t run=0; run<2; run++)
+	{
+		q=combined->compute_subkernel_quadratic_forms(idx, weights);
+		for (index_t k_idx=0; k_idx<q.vlen; k_idx++)
+			EXPECT_NEAR(q[k_idx], expected(k_idx, 0), 1e-10);
+	}
+
+	SGVector<int32_t> shifted(idx.vlen);
+	for (index_t i=0; i<idx.vlen; i++)
+		shifted[i]=idx[i]+2;
+	q=combined->compute_subkernel_quadratic_forms(shifted, weights);
+	for (index_t k_idx=0; k_idx<q.vlen; k_idx++)
+		EXPECT_NEAR(q[k_idx], expected(k_idx, 1), 1e-10);
+
+	SG_UNREF(combined);
+}
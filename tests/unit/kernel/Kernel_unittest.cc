@@ -32,7 +32,10 @@
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
 #include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/kernel/PolyKernel.h>
 #include <gtest/gtest.h>
 
 using namespace shogun;
@@ -456,4 +459,87 @@ TEST(Kernel, gaussian_kernel_width_constructor)
 	EXPECT_EQ(kernel->get_cache_size(), 10);
 	EXPECT_EQ(kernel->get_width(), width);
 	SG_UNREF(kernel);
-}
\ No newline at end of file
+}
+
+/* kernel matrices and rows on sparse features, which are computed at once,
+ * have to match the ones on the same dense features */
+static void check_sparse_kernel(CKernel* kernel)
+{
+	const index_t num_feats=20;
+	const index_t num_feats_rhs=7;
+	const index_t dim=50;
+
+	CMath::init_random(100);
+	SGMatrix<float64_t> data(dim, num_feats);
+	SGMatrix<float64_t> data_rhs(dim, num_feats_rhs);
+	data.zero();
+	data_rhs.zero();
+	for (index_t i=0; i<5*num_feats; ++i)
+		data(CMath::random(0, dim-1), i%num_feats)=CMath::randn_double();
+	for (index_t i=0; i<5*num_feats_rhs; ++i)
+		data_rhs(CMath::random(0, dim-1), i%num_feats_rhs)=CMath::randn_double();
+
+	CDenseFeatures<float64_t>* dense=new CDenseFeatures<float64_t>(data);
+	CDenseFeatures<float64_t>* dense_rhs=new CDenseFeatures<float64_t>(data_rhs);
+	CSparseFeatures<float64_t>* sparse=new CSparseFeatures<float64_t>(data);
+	CSparseFeatures<float64_t>* sparse_rhs=new CSparseFeatures<float64_t>(data_rhs);
+	SG_REF(dense);
+	SG_REF(dense_rhs);
+	SG_REF(sparse);
+	SG_REF(sparse_rhs);
+
+	kernel->init(dense, dense);
+	SGMatrix<float64_t> km=kernel->get_kernel_matrix();
+	SGVector<float64_t> row=kernel->get_kernel_row(3);
+	kernel->init(sparse, sparse);
+	SGMatrix<float64_t> km_sparse=kernel->get_kernel_matrix();
+	SGVector<float64_t> row_sparse=kernel->get_kernel_row(3);
+
+	for (index_t i=0; i<num_feats; ++i)
+	{
+		EXPECT_NEAR(row_sparse[i], row[i], 1E-10);
+		for (index_t j=0; j<num_feats; ++j)
+			EXPECT_NEAR(km_sparse(i,j), km(i,j), 1E-10);
+	}
+
+	kernel->init(dense, dense_rhs);
+	km=kernel->get_kernel_matrix();
+	kernel->init(sparse, sparse_rhs);
+	km_sparse=kernel->get_kernel_matrix();
+
+	for (index_t i=0; i<num_feats; ++i)
+	{
+		for (index_t j=0; j<num_feats_rhs; ++j)
+			EXPECT_NEAR(km_sparse(i,j), km(i,j), 1E-10);
+	}
+
+	kernel->cleanup();
+	SG_UNREF(sparse_rhs);
+	SG_UNREF(sparse);
+	SG_UNREF(dense_rhs);
+	SG_UNREF(dense);
+}
+
+TEST(Kernel, sparse_linear_kernel)
+{
+	CLinearKernel* kernel=new CLinearKernel();
+	SG_REF(kernel);
+	check_sparse_kernel(kernel);
+	SG_UNREF(kernel);
+}
+
+TEST(Kernel, sparse_poly_kernel)
+{
+	CPolyKernel* kernel=new CPolyKernel(10, 3, true);
+	SG_REF(kernel);
+	check_sparse_kernel(kernel);
+	SG_UNREF(kernel);
+}
+
+TEST(Kernel, sparse_gaussian_kernel)
+{
+	CGaussianKernel* kernel=new CGaussianKernel(10, 2);
+	SG_REF(kernel);
+	check_sparse_kernel(kernel);
+	SG_UNREF(kernel);
+}
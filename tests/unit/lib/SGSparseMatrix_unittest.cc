@@ -14,6 +14,7 @@
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGSparseVector.h>
 #include <shogun/lib/SGSparseMatrix.h>
+#include <shogun/lib/SGSparseMatrixBuilder.h>
 #include <shogun/io/LibSVMFile.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/mathematics/Random.h>
@@ -265,3 +266,107 @@ TEST(SGSparseMatrix, from_dense)
 		for (index_t vecIndex=0; vecIndex<numberOfVectors; ++vecIndex)
 			EXPECT_EQ(sparseMatrix(featIndex,vecIndex), denseMatrix(featIndex,vecIndex));
 }
+
+TEST(SGSparseMatrix, builder)
+{
+	SGSparseMatrixBuilder<float64_t> builder(3);
+
+	builder.add_entry(0, 1.0);
+	builder.add_entry(4, 2.0);
+	builder.finish_vector();
+	builder.finish_vector();
+	builder.add_entry(2, 3.0);
+	builder.finish_vector();
+
+	EXPECT_EQ(builder.get_num_vectors(), 3);
+	EXPECT_EQ(builder.get_num_entries(), 3);
+
+	SGSparseMatrix<float64_t> m=builder.get_matrix();
+	EXPECT_EQ(builder.get_num_vectors(), 0);
+	EXPECT_EQ(builder.get_num_entries(), 0);
+
+	EXPECT_EQ(m.num_vectors, 3);
+	EXPECT_EQ(m.num_features, 5);
+	EXPECT_EQ(m[0].num_feat_entries, 2);
+	EXPECT_EQ(m[1].num_feat_entries, 0);
+	EXPECT_EQ(m[2].num_feat_entries, 1);
+
+	// all vectors point into one block
+	EXPECT_EQ(m[0].features, m.entries);
+	EXPECT_EQ(m[2].features, m.entries+2);
+
+	EXPECT_EQ(m(0,0), 1.0);
+	EXPECT_EQ(m(4,0), 2.0);
+	EXPECT_EQ(m(2,2), 3.0);
+	EXPECT_EQ(m(1,2), 0.0);
+}
+
+TEST(SGSparseMatrix, builder_many_vectors)
+{
+	const index_t num_vectors=5000;
+	SGSparseMatrixBuilder<int32_t> builder;
+
+	for (index_t i=0; i<num_vectors; ++i)
+	{
+		SGSparseVector<int32_t> vec(2);
+		vec.features[0].feat_index=i%7;
+		vec.features[0].entry=i;
+		vec.features[1].feat_index=7+i%3;
+		vec.features[1].entry=-i;
+		builder.add_vector(vec);
+	}
+
+	SGSparseMatrix<int32_t> m=builder.get_matrix();
+	EXPECT_EQ(m.num_vectors, num_vectors);
+	EXPECT_EQ(m.num_features, 10);
+
+	for (index_t i=0; i<num_vectors; ++i)
+	{
+		EXPECT_EQ(m[i].features, m.entries+2*i);
+		EXPECT_EQ(m(i%7,i), i);
+		EXPECT_EQ(m(7+i%3,i), -i);
+	}
+}
+
+TEST(SGSparseMatrix, insert_into_contiguous)
+{
+	SGMatrix<float64_t> dense(3, 2);
+	dense.zero();
+	dense(0,0)=1.0;
+	dense(2,1)=2.0;
+
+	SGSparseMatrix<float64_t> m(dense);
+	EXPECT_EQ(m[1].features, m[0].features+1);
+
+	// the new entry must not touch the block
+	m(1,0)=3.0;
+	m.sort_features();
+
+	EXPECT_EQ(m[0].num_feat_entries, 2);
+	EXPECT_EQ(m(0,0), 1.0);
+	EXPECT_EQ(m(1,0), 3.0);
+	EXPECT_EQ(m(2,1), 2.0);
+	EXPECT_EQ(m.entries[0].entry, 1.0);
+	EXPECT_EQ(m.entries[1].entry, 2.0);
+}
+
+TEST(SGSparseMatrix, contiguous_vectors_outlive_matrix)
+{
+	SGMatrix<float64_t> dense(3, 2);
+	dense.zero();
+	dense(0,0)=1.0;
+	dense(1,1)=2.0;
+	dense(2,1)=3.0;
+
+	SGSparseMatrix<float64_t> m(dense);
+	SGSparseVector<float64_t> v=m[1];
+	EXPECT_EQ(v.features, m.entries+1);
+
+	// the vector keeps the block of entries alive
+	m=SGSparseMatrix<float64_t>();
+	EXPECT_EQ(v.num_feat_entries, 2);
+	EXPECT_EQ(v.features[0].feat_index, 1);
+	EXPECT_EQ(v.features[0].entry, 2.0);
+	EXPECT_EQ(v.features[1].feat_index, 2);
+	EXPECT_EQ(v.features[1].entry, 3.0);
+}
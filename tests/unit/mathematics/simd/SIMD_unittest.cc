@@ -0,0 +1,139 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/lib/common.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/simd/SIMD.h>
+#include <gtest/gtest.h>
+
+#include <math.h>
+
+using namespace shogun;
+
+namespace
+{
+
+/* odd length so that every kernel also runs its remainder loop */
+SGVector<float64_t> simd_test_input()
+{
+	const index_t n=1001;
+	SGVector<float64_t> x(n+6);
+	for (index_t i=0; i<n; i++)
+		x[i]=-745.0+1500.0*i/(n-1);
+	x[n]=0;
+	x[n+1]=-708.3;
+	x[n+2]=708.9;
+	x[n+3]=1e-310;
+	x[n+4]=CMath::INFTY;
+	x[n+5]=-CMath::INFTY;
+	return x;
+}
+
+void expect_relative_near(float64_t expected, float64_t actual, float64_t tol)
+{
+	if (CMath::is_nan(expected))
+		EXPECT_TRUE(CMath::is_nan(actual));
+	else if (CMath::is_infinity(expected) || expected==0)
+		EXPECT_EQ(expected, actual);
+	else
+		EXPECT_NEAR(expected, actual, tol*CMath::abs(expected));
+}
+
+}
+
+TEST(SIMD, elementwise)
+{
+	ESIMDInstructionSet default_set=simd::get_instruction_set();
+	EXPECT_TRUE(simd::is_supported(SIMD_SCALAR));
+	EXPECT_TRUE(simd::is_supported(default_set));
+
+	SGVector<float64_t> x=simd_test_input();
+	SGVector<float64_t> positive(x.vlen);
+	for (index_t i=0; i<x.vlen; i++)
+		positive[i]=::exp(x[i]/2);
+	positive[0]=0;
+	positive[1]=-1;
+
+	ESIMDInstructionSet sets[]={SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2, SIMD_AVX512};
+	for (int32_t s=0; s<4; s++)
+	{
+		if (!simd::is_supported(sets[s]))
+			continue;
+		simd::set_instruction_set(sets[s]);
+		EXPECT_EQ(sets[s], simd::get_instruction_set());
+
+		SGVector<float64_t> y(x.vlen);
+		simd::exp(x.vector, y.vector, x.vlen);
+		for (index_t i=0; i<x.vlen; i++)
+			expect_relative_near(::exp(x[i]), y[i], 1e-15);
+
+		simd::sigmoid(x.vector, y.vector, x.vlen);
+		for (index_t i=0; i<x.vlen; i++)
+			expect_relative_near(1.0/(1.0+::exp(-x[i])), y[i], 1e-15);
+
+		simd::log(positive.vector, y.vector, positive.vlen);
+		for (index_t i=0; i<positive.vlen; i++)
+			expect_relative_near(::log(positive[i]), y[i], 1e-15);
+
+		/* in place */
+		y=x.clone();
+		simd::exp(y.vector, y.vector, y.vlen);
+		for (index_t i=0; i<x.vlen; i++)
+			expect_relative_near(::exp(x[i]), y[i], 1e-15);
+	}
+
+	simd::set_instruction_set(default_set);
+}
+
+TEST(SIMD, reductions)
+{
+	ESIMDInstructionSet default_set=simd::get_instruction_set();
+
+	const index_t n=1003;
+	SGVector<float64_t> a(n);
+	SGVector<float64_t> b(n);
+	for (index_t i=0; i<n; i++)
+	{
+		a[i]=CMath::sin(i*0.1)*(i%7);
+		b[i]=CMath::cos(i*0.3)-0.2;
+	}
+	a[500]=-42;
+	b[17]=13;
+
+	float64_t dot=0;
+	float64_t sqdist=0;
+	for (index_t i=0; i<n; i++)
+	{
+		dot+=a[i]*b[i];
+		sqdist+=(a[i]-b[i])*(a[i]-b[i]);
+	}
+
+	ESIMDInstructionSet sets[]={SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2, SIMD_AVX512};
+	for (int32_t s=0; s<4; s++)
+	{
+		if (!simd::is_supported(sets[s]))
+			continue;
+		simd::set_instruction_set(sets[s]);
+
+		EXPECT_NEAR(dot, simd::dot(a.vector, b.vector, n), 1e-12*n);
+		EXPECT_NEAR(sqdist, simd::squared_distance(a.vector, b.vector, n), 1e-12*n);
+		EXPECT_EQ(0, simd::dot(a.vector, b.vector, 0));
+
+		SGVector<float64_t> y=b.clone();
+		simd::axpy(-0.5, a.vector, y.vector, n);
+		for (index_t i=0; i<n; i++)
+			EXPECT_NEAR(b[i]-0.5*a[i], y[i], 1e-15);
+
+		EXPECT_EQ(-42, simd::min(a.vector, n));
+		EXPECT_EQ(13, simd::max(b.vector, n));
+		EXPECT_EQ(a[0], simd::min(a.vector, 1));
+		EXPECT_EQ(CMath::max(CMath::max(b[0], b[1]), b[2]), simd::max(b.vector, 3));
+	}
+
+	simd::set_instruction_set(default_set);
+}
@@ -10,6 +10,7 @@
 #include <shogun/metric/LMNNImpl.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/labels/MulticlassLabels.h>
+#include <shogun/mathematics/Math.h>
 #include <gtest/gtest.h>
 
 using namespace shogun;
@@ -188,3 +189,46 @@ TEST(LMNNImpl,find_impostors_exact)
 	SG_UNREF(features)
 	SG_UNREF(labels)
 }
+
+TEST(LMNNImpl,find_impostors_ball_tree)
+{
+	// enough examples for several blocks in the exact search
+	int32_t d=3;
+	int32_t n=600;
+	SGMatrix<float64_t> feat_mat(d,n);
+	SGVector<float64_t> lab_vec(n);
+	sg_rand->set_seed(17);
+	for (int32_t i=0; i<n; i++)
+	{
+		lab_vec[i]=i%3;
+		for (int32_t j=0; j<d; j++)
+			feat_mat(j,i)=CMath::randn_double()+lab_vec[i];
+	}
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(feat_mat);
+	CMulticlassLabels* labels=new CMulticlassLabels(lab_vec);
+
+	int32_t k=3;
+	SGMatrix<index_t> target_nn=CLMNNImpl::find_target_nn(features,labels,k);
+
+	Eigen::MatrixXd L=Eigen::MatrixXd::Identity(d,d);
+	L(0,1)=0.5;
+	ImpostorsSetType blocked=CLMNNImpl::find_impostors(features,labels,L,target_nn,0,1,false);
+	ImpostorsSetType tree=CLMNNImpl::find_impostors(features,labels,L,target_nn,0,1,true);
+
+	// both searches are exact, the sets have to be the same
+	EXPECT_GT(blocked.size(), 0u);
+	ASSERT_EQ(blocked.size(), tree.size());
+	for (size_t i=0; i<blocked.size(); i++)
+	{
+		EXPECT_EQ(blocked[i].example, tree[i].example);
+		EXPECT_EQ(blocked[i].target, tree[i].target);
+		EXPECT_EQ(blocked[i].impostor, tree[i].impostor);
+	}
+
+	// sorted and free of duplicates
+	for (size_t i=1; i<blocked.size(); i++)
+		EXPECT_TRUE(blocked[i-1]<blocked[i]);
+
+	SG_UNREF(features)
+	SG_UNREF(labels)
+}
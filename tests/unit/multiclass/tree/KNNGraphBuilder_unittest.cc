@@ -0,0 +1,224 @@
+#include <shogun/multiclass/tree/KNNGraphBuilder.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/distance/EuclideanDistance.h>
+#include <shogun/distance/ManhattanMetric.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/mathematics/Math.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+static CDenseFeatures<float64_t>* random_features(int32_t dim, int32_t n)
+{
+	SGMatrix<float64_t> data(dim, n);
+	for (int64_t i=0; i<int64_t(dim)*n; i++)
+		data.matrix[i]=CMath::randn_double();
+
+	return new CDenseFeatures<float64_t>(data);
+}
+
+static SGMatrix<index_t> find_neighbors(CDistance* distance, int32_t k,
+	EKNNGraphMethod method, SGMatrix<float64_t>* dists=NULL)
+{
+	CKNNGraphBuilder* builder=new CKNNGraphBuilder(k, method);
+	SG_REF(builder);
+	builder->set_leaf_size(5);
+	builder->build(distance);
+	SGMatrix<index_t> neighbors=builder->get_neighbors();
+	if (dists)
+		*dists=builder->get_distances();
+	SG_UNREF(builder);
+
+	return neighbors;
+}
+
+TEST(KNNGraphBuilder,trees_equal_brute)
+{
+	CMath::init_random(17);
+	CDenseFeatures<float64_t>* feats=random_features(3, 200);
+	CEuclideanDistance* distance=new CEuclideanDistance(feats, feats);
+	SG_REF(distance);
+
+	SGMatrix<float64_t> brute_dists;
+	SGMatrix<index_t> brute=find_neighbors(distance, 5, KNNG_BRUTE, &brute_dists);
+	EXPECT_EQ(5, brute.num_rows);
+	EXPECT_EQ(200, brute.num_cols);
+
+	EKNNGraphMethod methods[]={KNNG_KD_TREE, KNNG_BALL_TREE};
+	for (int32_t m=0; m<2; m++)
+	{
+		SGMatrix<float64_t> dists;
+		SGMatrix<index_t> neighbors=find_neighbors(distance, 5, methods[m], &dists);
+		for (index_t i=0; i<brute.num_cols; i++)
+		{
+			for (index_t j=0; j<brute.num_rows; j++)
+			{
+				EXPECT_EQ(brute(j,i), neighbors(j,i));
+				EXPECT_NEAR(brute_dists(j,i), dists(j,i), 1E-10);
+				EXPECT_NE(i, neighbors(j,i));
+				EXPECT_NEAR(distance->distance(neighbors(j,i), i), dists(j,i), 1E-10);
+			}
+		}
+	}
+
+	SG_UNREF(distance);
+}
+
+TEST(KNNGraphBuilder,manhattan_queries)
+{
+	CMath::init_random(17);
+	CDenseFeatures<float64_t>* train=random_features(4, 150);
+	CDenseFeatures<float64_t>* test=random_features(4, 30);
+	CManhattanMetric* distance=new CManhattanMetric(train, test);
+	SG_REF(distance);
+
+	SGMatrix<index_t> brute=find_neighbors(distance, 7, KNNG_BRUTE);
+	SGMatrix<index_t> tree=find_neighbors(distance, 7, KNNG_BALL_TREE);
+	EXPECT_EQ(30, tree.num_cols);
+	for (index_t i=0; i<brute.num_cols; i++)
+	{
+		for (index_t j=0; j<brute.num_rows; j++)
+			EXPECT_EQ(brute(j,i), tree(j,i));
+	}
+
+	SG_UNREF(distance);
+}
+
+TEST(KNNGraphBuilder,include_self)
+{
+	CMath::init_random(17);
+	CDenseFeatures<float64_t>* feats=random_features(2, 50);
+	CEuclideanDistance* distance=new CEuclideanDistance(feats, feats);
+	SG_REF(distance);
+
+	CKNNGraphBuilder* builder=new CKNNGraphBuilder(3, KNNG_KD_TREE);
+	SG_REF(builder);
+	builder->set_exclude_self(false);
+	builder->build(distance);
+	SGMatrix<index_t> neighbors=builder->get_neighbors();
+	SGMatrix<float64_t> dists=builder->get_distances();
+	for (index_t i=0; i<neighbors.num_cols; i++)
+	{
+		EXPECT_EQ(i, neighbors(0,i));
+		EXPECT_EQ(0, dists(0,i));
+	}
+
+	SG_UNREF(builder);
+	SG_UNREF(distance);
+}
+
+TEST(KNNGraphBuilder,kernel_distance)
+{
+	CMath::init_random(17);
+	CDenseFeatures<float64_t>* feats=random_features(3, 100);
+	CEuclideanDistance* distance=new CEuclideanDistance(feats, feats);
+	CLinearKernel* linear=new CLinearKernel(feats, feats);
+	CGaussianKernel* gaussian=new CGaussianKernel(feats, feats, 2.0);
+	SG_REF(distance);
+	SG_REF(linear);
+	SG_REF(gaussian);
+
+	SGMatrix<float64_t> expected_dists;
+	SGMatrix<index_t> expected=find_neighbors(distance, 6, KNNG_BRUTE, &expected_dists);
+
+	// the linear kernel induces the Euclidean distance and is searched in a
+	// tree, the Gaussian one a distance monotonic in it and is searched brute force
+	EXPECT_TRUE(CKNNGraphBuilder::is_tree_supported(distance));
+	EXPECT_TRUE(CKNNGraphBuilder::is_tree_supported(linear));
+	EXPECT_FALSE(CKNNGraphBuilder::is_tree_supported(gaussian));
+
+	CKNNGraphBuilder* builder=new CKNNGraphBuilder(6, KNNG_BALL_TREE);
+	SG_REF(builder);
+	builder->build(linear);
+	SGMatrix<index_t> linear_neighbors=builder->get_neighbors();
+	SGMatrix<float64_t> linear_dists=builder->get_distances();
+	builder->build(gaussian);
+	SGMatrix<index_t> gaussian_neighbors=builder->get_neighbors();
+
+	for (index_t i=0; i<expected.num_cols; i++)
+	{
+		for (index_t j=0; j<expected.num_rows; j++)
+		{
+			EXPECT_EQ(expected(j,i), linear_neighbors(j,i));
+			EXPECT_NEAR(expected_dists(j,i), linear_dists(j,i), 1E-10);
+			EXPECT_EQ(expected(j,i), gaussian_neighbors(j,i));
+		}
+	}
+
+	SG_UNREF(builder);
+	SG_UNREF(gaussian);
+	SG_UNREF(linear);
+	SG_UNREF(distance);
+}
+
+TEST(KNNGraphBuilder,nn_descent_recall)
+{
+	CMath::init_random(17);
+	int32_t k=10;
+	CDenseFeatures<float64_t>* feats=random_features(5, 1000);
+	CEuclideanDistance* distance=new CEuclideanDistance(feats, feats);
+	SG_REF(distance);
+
+	SGMatrix<index_t> exact=find_neighbors(distance, k, KNNG_BALL_TREE);
+	SGMatrix<float64_t> dists;
+	SGMatrix<index_t> approximate=find_neighbors(distance, k, KNNG_NN_DESCENT, &dists);
+
+	int32_t num_found=0;
+	for (index_t i=0; i<exact.num_cols; i++)
+	{
+		for (index_t j=0; j<k; j++)
+		{
+			EXPECT_NE(i, approximate(j,i));
+			if (j>0)
+				EXPECT_LE(dists(j-1,i), dists(j,i));
+
+			for (index_t l=0; l<k; l++)
+			{
+				if (exact(l,i)==approximate(j,i))
+					num_found++;
+			}
+		}
+	}
+
+	EXPECT_GT(float64_t(num_found)/(k*exact.num_cols), 0.9);
+
+	SG_UNREF(distance);
+}
+
+TEST(KNNGraphBuilder,get_graph)
+{
+	CMath::init_random(17);
+	CDenseFeatures<float64_t>* feats=random_features(2, 40);
+	CEuclideanDistance* distance=new CEuclideanDistance(feats, feats);
+	SG_REF(distance);
+
+	CKNNGraphBuilder* builder=new CKNNGraphBuilder(4, KNNG_BRUTE);
+	SG_REF(builder);
+	builder->build(distance);
+	SGMatrix<index_t> neighbors=builder->get_neighbors();
+	SGSparseMatrix<float64_t> graph=builder->get_graph();
+
+	EXPECT_EQ(40, graph.num_vectors);
+	EXPECT_EQ(40, graph.num_features);
+	for (index_t i=0; i<graph.num_vectors; i++)
+	{
+		SGSparseVector<float64_t> row=graph[i];
+		EXPECT_EQ(4, row.num_feat_entries);
+		for (index_t j=0; j<row.num_feat_entries; j++)
+		{
+			if (j>0)
+				EXPECT_LT(row.features[j-1].feat_index, row.features[j].feat_index);
+
+			EXPECT_NEAR(distance->distance(row.features[j].feat_index, i),
+				row.features[j].entry, 1E-10);
+			bool found=false;
+			for (index_t l=0; l<neighbors.num_rows; l++)
+				found|=neighbors(l,i)==row.features[j].feat_index;
+			EXPECT_TRUE(found);
+		}
+	}
+
+	SG_UNREF(builder);
+	SG_UNREF(distance);
+}
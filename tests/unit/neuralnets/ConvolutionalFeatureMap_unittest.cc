@@ -732,6 +732,149 @@ TEST(ConvolutionalFeatureMap, compute_input_gradients)
 	SG_UNREF(layers);
 }
 
+TEST(ConvolutionalFeatureMap, compute_gradients_logistic_with_stride)
+{
+	const int32_t w = 12;
+	const int32_t h = 10;
+	const int32_t rx = 1;
+	const int32_t ry = 2;
+	const int32_t b = 2;
+	const int32_t map_index = 1;
+	const int32_t num_maps = 3;
+
+	int32_t stride_x = 3;
+	int32_t stride_y = 2;
+	int32_t w_out = w/stride_x;
+	int32_t h_out = h/stride_y;
+
+	CMath::init_random(100);
+
+	CNeuralLinearLayer* input1 = new CNeuralLinearLayer (w*h);
+	input1->set_batch_size(b);
+
+	// two channels
+	CNeuralLinearLayer* input2 = new CNeuralLinearLayer (2*w*h);
+	input2->set_batch_size(b);
+
+	for (int32_t i=0; i<input1->get_num_neurons()*b; i++)
+		input1->get_activations()[i] = CMath::random(-10.0,10.0);
+
+	for (int32_t i=0; i<input2->get_num_neurons()*b; i++)
+		input2->get_activations()[i] = CMath::random(-10.0,10.0);
+
+	CDynamicObjectArray* layers = new CDynamicObjectArray();
+	layers->append_element(input1);
+	layers->append_element(input2);
+
+	SGVector<int32_t> input_indices(2);
+	input_indices[0] = 0;
+	input_indices[1] = 1;
+
+	CConvolutionalFeatureMap map(w,h,rx,ry,stride_x,stride_y,map_index,
+		CMAF_LOGISTIC);
+	SGVector<float64_t> params(1+(2*rx+1)*(2*ry+1)*3);
+	for (int32_t i=0; i<params.vlen; i++)
+		params[i] = CMath::normal_random(0.0,0.1);
+
+	SGMatrix<float64_t> A(num_maps*w_out*h_out,b);
+	A.zero();
+
+	map.compute_activations(params, layers, input_indices, A);
+
+	// compute activation gradients with respect to some function
+	// assuming the function is 0.5*sum(c[i]*A[i]^2), so that the
+	// activation gradients differ from the activations
+	SGVector<float64_t> c(A.num_rows*A.num_cols);
+	for (int32_t i=0; i<c.vlen; i++)
+		c[i] = CMath::random(-2.0,2.0);
+
+	SGMatrix<float64_t> AG(num_maps*w_out*h_out,b);
+	for (int32_t i=0; i<AG.num_rows*AG.num_cols; i++)
+		AG[i] = c[i]*A[i];
+
+	// compute gradients
+	input1->get_activation_gradients().zero();
+	input2->get_activation_gradients().zero();
+	SGVector<float64_t> PG(params.vlen);
+	map.compute_gradients(params, A, AG, layers, input_indices, PG);
+
+	// approximate parameter gradients
+	float64_t epsilon = 1e-9;
+
+	SGVector<float64_t> PG_numerical(params.vlen);
+	for (int32_t i=0; i<params.vlen; i++)
+	{
+		params[i] += epsilon;
+		map.compute_activations(params, layers, input_indices, A);
+		float64_t error_plus = 0;
+		for (int32_t k=0; k<A.num_rows*A.num_cols; k++)
+			error_plus += 0.5*c[k]*A[k]*A[k];
+
+		params[i] -= 2*epsilon;
+		map.compute_activations(params, layers, input_indices, A);
+		float64_t error_minus = 0;
+		for (int32_t k=0; k<A.num_rows*A.num_cols; k++)
+			error_minus += 0.5*c[k]*A[k]*A[k];
+
+		params[i] += epsilon;
+
+		PG_numerical[i] = (error_plus-error_minus)/(2*epsilon);
+	}
+
+	// approximate input gradients
+	SGMatrix<float64_t> IG1(input1->get_num_neurons(), b);
+	for (int32_t i=0; i<IG1.num_rows*IG1.num_cols; i++)
+	{
+		input1->get_activations()[i] += epsilon;
+		map.compute_activations(params, layers, input_indices, A);
+		float64_t error_plus = 0;
+		for (int32_t k=0; k<A.num_rows*A.num_cols; k++)
+			error_plus += 0.5*c[k]*A[k]*A[k];
+
+		input1->get_activations()[i] -= 2*epsilon;
+		map.compute_activations(params, layers, input_indices, A);
+		float64_t error_minus = 0;
+		for (int32_t k=0; k<A.num_rows*A.num_cols; k++)
+			error_minus += 0.5*c[k]*A[k]*A[k];
+
+		input1->get_activations()[i] += epsilon;
+
+		IG1[i] = (error_plus-error_minus)/(2*epsilon);
+	}
+
+	SGMatrix<float64_t> IG2(input2->get_num_neurons(), b);
+	for (int32_t i=0; i<IG2.num_rows*IG2.num_cols; i++)
+	{
+		input2->get_activations()[i] += epsilon;
+		map.compute_activations(params, layers, input_indices, A);
+		float64_t error_plus = 0;
+		for (int32_t k=0; k<A.num_rows*A.num_cols; k++)
+			error_plus += 0.5*c[k]*A[k]*A[k];
+
+		input2->get_activations()[i] -= 2*epsilon;
+		map.compute_activations(params, layers, input_indices, A);
+		float64_t error_minus = 0;
+		for (int32_t k=0; k<A.num_rows*A.num_cols; k++)
+			error_minus += 0.5*c[k]*A[k]*A[k];
+
+		input2->get_activations()[i] += epsilon;
+
+		IG2[i] = (error_plus-error_minus)/(2*epsilon);
+	}
+
+	// compare
+	for (int32_t i=0; i<PG.vlen; i++)
+		EXPECT_NEAR(PG_numerical[i], PG[i], 1e-5);
+
+	for (int32_t i=0; i<IG1.num_rows*IG1.num_cols; i++)
+		EXPECT_NEAR(IG1[i], input1->get_activation_gradients()[i], 1e-5);
+
+	for (int32_t i=0; i<IG2.num_rows*IG2.num_cols; i++)
+		EXPECT_NEAR(IG2[i], input2->get_activation_gradients()[i], 1e-5);
+
+	SG_UNREF(layers);
+}
+
 TEST(ConvolutionalFeatureMap, pool_activations)
 {
 	const int32_t w = 6;
@@ -768,3 +911,93 @@ TEST(ConvolutionalFeatureMap, pool_activations)
 	for (int32_t i=0; i<max_indices.num_rows*max_indices.num_cols; i++)
 		EXPECT_EQ(ref_max_indices[i], max_indices[i]);
 }
+
+TEST(ConvolutionalFeatureMap, multiple_maps_with_pooling)
+{
+	const int32_t w = 8;
+	const int32_t h = 6;
+	const int32_t rx = 2;
+	const int32_t ry = 1;
+	const int32_t stride_x = 2;
+	const int32_t stride_y = 1;
+	const int32_t pw = 2;
+	const int32_t ph = 3;
+	const int32_t b = 5;
+	const int32_t num_maps = 3;
+	const int32_t w_out = w/stride_x;
+	const int32_t h_out = h/stride_y;
+
+	CMath::init_random(17);
+
+	CNeuralLinearLayer* input1 = new CNeuralLinearLayer (2*w*h);
+	input1->set_batch_size(b);
+	for (int32_t i=0; i<input1->get_num_neurons()*b; i++)
+		input1->get_activations()[i] = CMath::random(-1.0,1.0);
+
+	CDynamicObjectArray* layers = new CDynamicObjectArray();
+	layers->append_element(input1);
+
+	SGVector<int32_t> input_indices(1);
+	input_indices[0] = 0;
+
+	const int32_t num_parameters_per_map = 1+(2*rx+1)*(2*ry+1)*2;
+	SGVector<float64_t> params(num_maps*num_parameters_per_map);
+	for (int32_t i=0; i<params.vlen; i++)
+		params[i] = CMath::normal_random(0.0,0.1);
+
+	// all maps at once with pooling
+	SGMatrix<float64_t> A(num_maps*w_out*h_out,b);
+	SGMatrix<float64_t> pooled(num_maps*w_out*h_out/(pw*ph),b);
+	SGMatrix<float64_t> max_indices(pooled.num_rows,b);
+	CConvolutionalFeatureMap maps(w,h,rx,ry,stride_x,stride_y,0,
+		CMAF_LOGISTIC, NLAP_NONE, num_maps);
+	maps.compute_activations(params, layers, input_indices, A, pw, ph,
+		pooled, max_indices);
+
+	SGMatrix<float64_t> AG(A.num_rows,b);
+	for (int32_t i=0; i<AG.num_rows*AG.num_cols; i++)
+		AG[i] = CMath::random(-1.0,1.0);
+	SGMatrix<float64_t> AG_single = AG.clone();
+
+	input1->get_activation_gradients().zero();
+	SGVector<float64_t> PG(params.vlen);
+	maps.compute_gradients(params, A, AG, layers, input_indices, PG);
+	SGMatrix<float64_t> IG = input1->get_activation_gradients().clone();
+
+	// one map at a time
+	SGMatrix<float64_t> A_single(A.num_rows,b);
+	SGMatrix<float64_t> pooled_single(pooled.num_rows,b);
+	SGMatrix<float64_t> max_indices_single(pooled.num_rows,b);
+	SGVector<float64_t> PG_single(params.vlen);
+	input1->get_activation_gradients().zero();
+	for (int32_t m=0; m<num_maps; m++)
+	{
+		SGVector<float64_t> map_params(params.vector+m*num_parameters_per_map,
+			num_parameters_per_map, false);
+		SGVector<float64_t> map_gradients(PG_single.vector+m*num_parameters_per_map,
+			num_parameters_per_map, false);
+
+		CConvolutionalFeatureMap map(w,h,rx,ry,stride_x,stride_y,m,CMAF_LOGISTIC);
+		map.compute_activations(map_params, layers, input_indices, A_single);
+		map.pool_activations(A_single, pw, ph, pooled_single, max_indices_single);
+		map.compute_gradients(map_params, A_single, AG_single, layers,
+			input_indices, map_gradients);
+	}
+
+	for (int32_t i=0; i<A.num_rows*A.num_cols; i++)
+		EXPECT_NEAR(A_single[i], A[i], 1e-12);
+
+	for (int32_t i=0; i<pooled.num_rows*pooled.num_cols; i++)
+	{
+		EXPECT_NEAR(pooled_single[i], pooled[i], 1e-12);
+		EXPECT_EQ(max_indices_single[i], max_indices[i]);
+	}
+
+	for (int32_t i=0; i<PG.vlen; i++)
+		EXPECT_NEAR(PG_single[i], PG[i], 1e-12);
+
+	for (int32_t i=0; i<IG.num_rows*IG.num_cols; i++)
+		EXPECT_NEAR(input1->get_activation_gradients()[i], IG[i], 1e-12);
+
+	SG_UNREF(layers);
+}
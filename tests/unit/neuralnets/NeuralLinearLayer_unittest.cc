@@ -409,3 +409,40 @@ TEST(NeuralLinearLayer, compute_parameter_gradients_hidden)
 
 	SG_UNREF(layers);
 }
+
+/** Checks that the layer's buffers keep their memory while the batch size
+ * shrinks moderately and that inference only mode releases the gradients
+ */
+TEST(NeuralLinearLayer, set_batch_size)
+{
+	CNeuralLinearLayer layer(5);
+
+	layer.set_batch_size(10);
+	float64_t* activations = layer.get_activations().matrix;
+	float64_t* local_gradients = layer.get_local_gradients().matrix;
+
+	layer.set_batch_size(7);
+	EXPECT_EQ(activations, layer.get_activations().matrix);
+	EXPECT_EQ(local_gradients, layer.get_local_gradients().matrix);
+	EXPECT_EQ(5, layer.get_activations().num_rows);
+	EXPECT_EQ(7, layer.get_activations().num_cols);
+	EXPECT_EQ(7, layer.get_activation_gradients().num_cols);
+
+	layer.set_batch_size(8, true);
+	EXPECT_EQ(activations, layer.get_activations().matrix);
+	EXPECT_EQ(8, layer.get_activations().num_cols);
+	EXPECT_TRUE(layer.get_activation_gradients().matrix==NULL);
+	EXPECT_TRUE(layer.get_local_gradients().matrix==NULL);
+
+	layer.set_batch_size(9);
+	EXPECT_EQ(activations, layer.get_activations().matrix);
+	EXPECT_EQ(9, layer.get_local_gradients().num_cols);
+
+	layer.set_batch_size(20);
+	EXPECT_EQ(20, layer.get_activations().num_cols);
+	EXPECT_EQ(20, layer.get_local_gradients().num_cols);
+
+	layer.set_batch_size(2);
+	EXPECT_EQ(2, layer.get_activations().num_cols);
+	EXPECT_EQ(2, layer.get_local_gradients().num_cols);
+}
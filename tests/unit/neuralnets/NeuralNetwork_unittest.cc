@@ -465,3 +465,62 @@ TEST(NeuralNetwork, gradient_descent)
 	SG_UNREF(features);
 	SG_UNREF(predictions);
 }
+
+/** tests that splitting the mini-batches between several threads during
+ * gradient descent training gives the same parameters as serial training
+ */
+TEST(NeuralNetwork, gradient_descent_multithreaded)
+{
+	int32_t N = 200;
+	SGMatrix<float64_t> inputs_matrix(3,N);
+	SGVector<float64_t> targets_vector(N);
+
+	CMath::init_random(100);
+	for (int32_t i=0; i<N; i++)
+	{
+		for (int32_t j=0; j<3; j++)
+			inputs_matrix(j,i) = CMath::random(-1.0,1.0);
+		targets_vector[i] = inputs_matrix(0,i)*inputs_matrix(1,i)
+			-inputs_matrix(2,i);
+	}
+
+	CDenseFeatures<float64_t>* features =
+		new CDenseFeatures<float64_t>(inputs_matrix);
+	CRegressionLabels* labels = new CRegressionLabels(targets_vector);
+	SG_REF(labels);
+
+	int32_t num_threads[] = {1, 4};
+	SGVector<float64_t> params[2];
+	for (int32_t t=0; t<2; t++)
+	{
+		CDynamicObjectArray* layers = new CDynamicObjectArray();
+		layers->append_element(new CNeuralInputLayer(3));
+		layers->append_element(new CNeuralLogisticLayer(10));
+		layers->append_element(new CNeuralLinearLayer(1));
+
+		CMath::init_random(10);
+		CNeuralNetwork* network = new CNeuralNetwork(layers);
+		network->quick_connect();
+		network->initialize_neural_network(0.1);
+
+		network->set_optimization_method(NNOM_GRADIENT_DESCENT);
+		network->set_gd_mini_batch_size(70);
+		network->set_l2_coefficient(0.01);
+		network->set_max_norm(2.0);
+		network->set_epsilon(0.0);
+		network->set_max_num_epochs(20);
+
+		network->parallel->set_num_threads(num_threads[t]);
+		network->set_labels(labels);
+		network->train(features);
+
+		params[t] = network->get_parameters().clone();
+		SG_UNREF(network);
+	}
+
+	for (int32_t i=0; i<params[0].vlen; i++)
+		EXPECT_NEAR(params[0][i], params[1][i], 1e-10);
+
+	SG_UNREF(features);
+	SG_UNREF(labels);
+}
@@ -37,6 +37,12 @@
 #include <shogun/optimization/ConstLearningRate.h>
 #include <shogun/mathematics/eigen3.h>
 #include <shogun/optimization/SVRGMinimizer.h>
+#include <shogun/optimization/SAGAMinimizer.h>
+#include <shogun/optimization/MarginLossCostFunction.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/loss/LogLoss.h>
 #include <shogun/base/Parameter.h>
 #include <gtest/gtest.h>
 #include <shogun/lib/Map.h>
@@ -362,6 +368,150 @@ bool ClassificationForTestCostFunction2::next_sample()
 	return true;
 }
 
+SparseClassificationForTestCostFunction::SparseClassificationForTestCostFunction(bool sparse_gradient)
+{
+	m_sparse_gradient=sparse_gradient;
+	m_sample_idx=-1;
+}
+
+void SparseClassificationForTestCostFunction::set_data(SGSparseMatrix<float64_t> features, SGVector<float64_t> labels)
+{
+	REQUIRE(labels.vlen==features.num_vectors,"");
+	m_labels=labels;
+	m_features=features;
+	m_weight=SGVector<float64_t>(features.num_features);
+	m_weight.zero();
+}
+
+float64_t SparseClassificationForTestCostFunction::get_cost()
+{
+	float64_t cost=0.0;
+	for(index_t idx=0; idx<m_labels.vlen; idx++)
+	{
+		float64_t margin=m_labels[idx]*m_features[idx].dense_dot(1.0, m_weight.vector, m_weight.vlen, 0.0);
+		cost+=log(1.0+exp(-margin));
+	}
+	return cost;
+}
+
+SGVector<float64_t> SparseClassificationForTestCostFunction::obtain_variable_reference()
+{
+	return m_weight;
+}
+
+float64_t SparseClassificationForTestCostFunction::get_derivative(index_t idx)
+{
+	float64_t margin=m_labels[idx]*m_features[idx].dense_dot(1.0, m_weight.vector, m_weight.vlen, 0.0);
+	return -m_labels[idx]/(1.0+exp(margin));
+}
+
+SGVector<float64_t> SparseClassificationForTestCostFunction::get_gradient()
+{
+	SGVector<float64_t> grad(m_weight.vlen);
+	grad.zero();
+	SGSparseVector<float64_t> x=m_features[m_sample_idx];
+	float64_t derivative=get_derivative(m_sample_idx);
+	for(index_t k=0; k<x.num_feat_entries; k++)
+		grad[x.features[k].feat_index]+=derivative*x.features[k].entry;
+	return grad;
+}
+
+SGVector<float64_t> SparseClassificationForTestCostFunction::get_average_gradient()
+{
+	SGVector<float64_t> grad(m_weight.vlen);
+	grad.zero();
+	for(index_t idx=0; idx<m_labels.vlen; idx++)
+	{
+		SGSparseVector<float64_t> x=m_features[idx];
+		float64_t derivative=get_derivative(idx)/m_labels.vlen;
+		for(index_t k=0; k<x.num_feat_entries; k++)
+			grad[x.features[k].feat_index]+=derivative*x.features[k].entry;
+	}
+	return grad;
+}
+
+int32_t SparseClassificationForTestCostFunction::get_sample_size()
+{
+	return m_labels.vlen;
+}
+
+void SparseClassificationForTestCostFunction::begin_sample()
+{
+	m_sample_idx=-1;
+}
+
+bool SparseClassificationForTestCostFunction::next_sample()
+{
+	m_sample_idx++;
+	return m_sample_idx<m_labels.vlen;
+}
+
+SGVector<index_t> SparseClassificationForTestCostFunction::get_gradient_support()
+{
+	SGSparseVector<float64_t> x=m_features[m_sample_idx];
+	SGVector<index_t> support(x.num_feat_entries);
+	for(index_t k=0; k<x.num_feat_entries; k++)
+		support[k]=x.features[k].feat_index;
+	return support;
+}
+
+SGSparseVector<float64_t> SparseClassificationForTestCostFunction::get_sparse_gradient()
+{
+	SGSparseVector<float64_t> x=m_features[m_sample_idx];
+	SGSparseVector<float64_t> grad(x.num_feat_entries);
+	float64_t derivative=get_derivative(m_sample_idx);
+	for(index_t k=0; k<x.num_feat_entries; k++)
+	{
+		grad.features[k].feat_index=x.features[k].feat_index;
+		grad.features[k].entry=derivative*x.features[k].entry;
+	}
+	return grad;
+}
+
+SGSparseVector<float64_t> SparseClassificationForTestCostFunction::get_sparse_sample_gradient(
+	index_t sample_idx, SGVector<float64_t> variable, float64_t scale)
+{
+	SGSparseVector<float64_t> x=m_features[sample_idx];
+	SGSparseVector<float64_t> grad(x.num_feat_entries);
+	float64_t margin=m_labels[sample_idx]*x.dense_dot(scale, variable.vector, variable.vlen, 0.0);
+	float64_t derivative=-m_labels[sample_idx]/(1.0+exp(margin));
+	for(index_t k=0; k<x.num_feat_entries; k++)
+	{
+		grad.features[k].feat_index=x.features[k].feat_index;
+		grad.features[k].entry=derivative*x.features[k].entry;
+	}
+	return grad;
+}
+
+struct SparseClassificationFixture
+{
+	SparseClassificationFixture() {init();}
+	SGVector<float64_t> y;
+	SGSparseMatrix<float64_t> x;
+	void init();
+};
+
+void SparseClassificationFixture::init()
+{
+	//100 samples with 4 out of 1000 features each
+	index_t num_features=1000;
+	index_t num_samples=100;
+	y=SGVector<float64_t>(num_samples);
+	x=SGSparseMatrix<float64_t>(num_features, num_samples);
+	for(index_t i=0; i<num_samples; i++)
+	{
+		y[i]=i%2==0 ? 1 : -1;
+		SGSparseVector<float64_t> v(4);
+		for(index_t k=0; k<4; k++)
+		{
+			//the first feature of a sample is informative
+			v.features[k].feat_index=k==0 ? i%10 : (i*37+k*211)%num_features;
+			v.features[k].entry=k==0 ? y[i] : 0.1*(k+i%7)-0.3;
+		}
+		x[i]=v;
+	}
+}
+
 struct ClassificationFixture
 {
 	ClassificationFixture(){init();}
@@ -1086,3 +1236,248 @@ TEST(SMIDASMinimizer, test1)
 
 	delete opt;
 }
+
+template <class T>
+static SGVector<float64_t> minimize_sparse_classification(bool sparse_gradient, int32_t num_passes)
+{
+	SparseClassificationFixture data;
+	SparseClassificationForTestCostFunction* fun=new SparseClassificationForTestCostFunction(sparse_gradient);
+	fun->set_data(data.x, data.y);
+
+	T* opt=new T(fun);
+	opt->set_penalty_weight(0.01);
+	L2Penalty* penalty_type=new L2Penalty();
+	opt->set_penalty_type(penalty_type);
+	ConstLearningRate* rate=new ConstLearningRate();
+	rate->set_const_learning_rate(0.5);
+	opt->set_learning_rate(rate);
+	GradientDescendUpdater* updater=new GradientDescendUpdater();
+	opt->set_gradient_updater(updater);
+	opt->set_number_passes(num_passes);
+	opt->minimize();
+
+	SGVector<float64_t> w=fun->obtain_variable_reference();
+	delete opt;
+	return w;
+}
+
+TEST(SGDMinimizer,lazy_update)
+{
+	SGVector<float64_t> dense=minimize_sparse_classification<SGDMinimizer>(false, 10);
+	SGVector<float64_t> lazy=minimize_sparse_classification<SGDMinimizer>(true, 10);
+	for(index_t i=0; i<dense.vlen; i++)
+		EXPECT_NEAR(lazy[i], dense[i], 1e-12);
+}
+
+static SGVector<float64_t> minimize_sparse_classification_in_parallel(EParallelSGDMode mode)
+{
+	SparseClassificationFixture data;
+	SparseClassificationForTestCostFunction* fun=new SparseClassificationForTestCostFunction(true);
+	fun->set_data(data.x, data.y);
+
+	SGDMinimizer* opt=new SGDMinimizer(fun);
+	opt->set_penalty_weight(0.01);
+	L2Penalty* penalty_type=new L2Penalty();
+	opt->set_penalty_type(penalty_type);
+	ConstLearningRate* rate=new ConstLearningRate();
+	rate->set_const_learning_rate(0.5);
+	opt->set_learning_rate(rate);
+	GradientDescendUpdater* updater=new GradientDescendUpdater();
+	opt->set_gradient_updater(updater);
+	opt->set_number_passes(20);
+	opt->set_parallel_mode(mode);
+	opt->parallel->set_num_threads(4);
+	opt->minimize();
+
+	SGVector<float64_t> w=fun->obtain_variable_reference();
+	delete opt;
+	return w;
+}
+
+TEST(SGDMinimizer,parallel_modes)
+{
+	SGVector<float64_t> serial=minimize_sparse_classification<SGDMinimizer>(true, 20);
+	SGVector<float64_t> hogwild=minimize_sparse_classification_in_parallel(PSGD_HOGWILD);
+	SGVector<float64_t> averaged=minimize_sparse_classification_in_parallel(PSGD_AVERAGED);
+	SGVector<float64_t> averaged2=minimize_sparse_classification_in_parallel(PSGD_AVERAGED);
+
+	for(index_t i=0; i<serial.vlen; i++)
+	{
+		EXPECT_EQ(averaged[i], averaged2[i]);
+		EXPECT_NEAR(hogwild[i], serial[i], 0.1);
+		EXPECT_NEAR(averaged[i], serial[i], 0.1);
+	}
+}
+
+static SGVector<float64_t> minimize_margin_loss_in_parallel(EParallelSGDMode mode)
+{
+	SparseClassificationFixture data;
+	CSparseFeatures<float64_t>* features=new CSparseFeatures<float64_t>(data.x);
+	CBinaryLabels* labels=new CBinaryLabels(data.y);
+	MarginLossCostFunction* fun=new MarginLossCostFunction(features, labels, new CLogLoss());
+	EXPECT_TRUE(fun->supports_sparse_sample_gradient());
+
+	SGDMinimizer* opt=new SGDMinimizer(fun);
+	opt->set_penalty_weight(0.01);
+	L2Penalty* penalty_type=new L2Penalty();
+	opt->set_penalty_type(penalty_type);
+	ConstLearningRate* rate=new ConstLearningRate();
+	rate->set_const_learning_rate(0.5);
+	opt->set_learning_rate(rate);
+	GradientDescendUpdater* updater=new GradientDescendUpdater();
+	opt->set_gradient_updater(updater);
+	opt->set_number_passes(20);
+	opt->set_parallel_mode(mode);
+	opt->parallel->set_num_threads(4);
+	opt->minimize();
+
+	SGVector<float64_t> w=fun->obtain_variable_reference();
+	delete opt;
+	return w;
+}
+
+TEST(MarginLossCostFunction,sgd_parallel_modes)
+{
+	//the log loss of the margin is the cost of the test cost function
+	SGVector<float64_t> expected=minimize_sparse_classification<SGDMinimizer>(true, 20);
+	SGVector<float64_t> serial=minimize_margin_loss_in_parallel(PSGD_SERIAL);
+	SGVector<float64_t> hogwild=minimize_margin_loss_in_parallel(PSGD_HOGWILD);
+	SGVector<float64_t> averaged=minimize_margin_loss_in_parallel(PSGD_AVERAGED);
+	for(index_t i=0; i<serial.vlen; i++)
+	{
+		EXPECT_NEAR(serial[i], expected[i], 1e-10);
+		EXPECT_NEAR(hogwild[i], serial[i], 0.1);
+		EXPECT_NEAR(averaged[i], serial[i], 0.1);
+	}
+}
+
+TEST(SAGAMinimizer,lazy_update)
+{
+	SGVector<float64_t> dense=minimize_sparse_classification<SAGAMinimizer>(false, 10);
+	SGVector<float64_t> lazy=minimize_sparse_classification<SAGAMinimizer>(true, 10);
+	for(index_t i=0; i<dense.vlen; i++)
+		EXPECT_NEAR(lazy[i], dense[i], 1e-12);
+}
+
+TEST(SAGAMinimizer,converges_to_optimum)
+{
+	SGVector<float64_t> w=minimize_sparse_classification<SAGAMinimizer>(true, 200);
+
+	//the gradient of the penalized cost vanishes at the optimum
+	SparseClassificationFixture data;
+	SparseClassificationForTestCostFunction* fun=new SparseClassificationForTestCostFunction(true);
+	SG_REF(fun);
+	fun->set_data(data.x, data.y);
+	SGVector<float64_t> var=fun->obtain_variable_reference();
+	std::copy(w.vector, w.vector+w.vlen, var.vector);
+	SGVector<float64_t> grad=fun->get_average_gradient();
+	for(index_t i=0; i<w.vlen; i++)
+		EXPECT_NEAR(grad[i]+0.01*w[i], 0, 1e-8);
+
+	SG_UNREF(fun);
+}
+
+TEST(SVRGMinimizer,lazy_update)
+{
+	SparseClassificationFixture data;
+	SGVector<float64_t> results[2];
+	for(index_t sparse=0; sparse<2; sparse++)
+	{
+		SparseClassificationForTestCostFunction* fun=new SparseClassificationForTestCostFunction(sparse);
+		fun->set_data(data.x, data.y);
+
+		SVRGMinimizer* opt=new SVRGMinimizer(fun);
+		opt->set_penalty_weight(0.01);
+		L2Penalty* penalty_type=new L2Penalty();
+		opt->set_penalty_type(penalty_type);
+		ConstLearningRate* rate=new ConstLearningRate();
+		rate->set_const_learning_rate(0.5);
+		opt->set_learning_rate(rate);
+		GradientDescendUpdater* updater=new GradientDescendUpdater();
+		opt->set_gradient_updater(updater);
+		opt->set_number_passes(10);
+		opt->set_sgd_number_passes(2);
+		opt->set_average_update_interval(2);
+		opt->minimize();
+
+		results[sparse]=fun->obtain_variable_reference();
+		delete opt;
+	}
+
+	for(index_t i=0; i<results[0].vlen; i++)
+		EXPECT_NEAR(results[1][i], results[0][i], 1e-12);
+}
+
+template <class T>
+static void set_margin_loss_passes(T* opt)
+{
+	opt->set_number_passes(10);
+}
+
+static void set_margin_loss_passes(SVRGMinimizer* opt)
+{
+	opt->set_number_passes(10);
+	opt->set_sgd_number_passes(2);
+	opt->set_average_update_interval(2);
+}
+
+template <class T>
+static SGVector<float64_t> minimize_margin_loss(bool sparse_features)
+{
+	SparseClassificationFixture data;
+	CSparseFeatures<float64_t>* sparse=new CSparseFeatures<float64_t>(data.x);
+	CDotFeatures* features=sparse;
+	if (!sparse_features)
+		features=new CDenseFeatures<float64_t>(sparse->get_full_feature_matrix());
+	SG_REF(sparse);
+	CBinaryLabels* labels=new CBinaryLabels(data.y);
+	MarginLossCostFunction* fun=new MarginLossCostFunction(features, labels, new CLogLoss());
+	EXPECT_EQ(fun->supports_sparse_gradient(), sparse_features);
+
+	T* opt=new T(fun);
+	opt->set_penalty_weight(0.01);
+	L2Penalty* penalty_type=new L2Penalty();
+	opt->set_penalty_type(penalty_type);
+	ConstLearningRate* rate=new ConstLearningRate();
+	rate->set_const_learning_rate(0.5);
+	opt->set_learning_rate(rate);
+	GradientDescendUpdater* updater=new GradientDescendUpdater();
+	opt->set_gradient_updater(updater);
+	set_margin_loss_passes(opt);
+	opt->minimize();
+
+	SGVector<float64_t> w=fun->obtain_variable_reference();
+	delete opt;
+	SG_UNREF(sparse);
+	return w;
+}
+
+template <class T>
+static void check_margin_loss_lazy_update()
+{
+	SGVector<float64_t> dense=minimize_margin_loss<T>(false);
+	SGVector<float64_t> lazy=minimize_margin_loss<T>(true);
+	for(index_t i=0; i<dense.vlen; i++)
+		EXPECT_NEAR(lazy[i], dense[i], 1e-12);
+}
+
+TEST(MarginLossCostFunction,sgd_lazy_update)
+{
+	check_margin_loss_lazy_update<SGDMinimizer>();
+
+	//the log loss of the margin is the cost of the test cost function
+	SGVector<float64_t> expected=minimize_sparse_classification<SGDMinimizer>(true, 10);
+	SGVector<float64_t> w=minimize_margin_loss<SGDMinimizer>(true);
+	for(index_t i=0; i<w.vlen; i++)
+		EXPECT_NEAR(w[i], expected[i], 1e-10);
+}
+
+TEST(MarginLossCostFunction,saga_lazy_update)
+{
+	check_margin_loss_lazy_update<SAGAMinimizer>();
+}
+
+TEST(MarginLossCostFunction,svrg_lazy_update)
+{
+	check_margin_loss_lazy_update<SVRGMinimizer>();
+}
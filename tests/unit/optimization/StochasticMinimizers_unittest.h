@@ -35,6 +35,7 @@
 #include <shogun/optimization/FirstOrderSAGCostFunction.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/lib/SGVector.h>
+#include <shogun/lib/SGSparseMatrix.h>
 #include <shogun/base/SGObject.h>
 using namespace shogun;
 
@@ -51,6 +52,7 @@ public:
 	virtual SGVector<float64_t> get_gradient();
 	virtual SGVector<float64_t> get_average_gradient();
 	virtual int32_t get_sample_size();
+	virtual index_t get_sample_index() { return m_idx; }
 	virtual void begin_sample();
 	virtual bool next_sample();
 	virtual const char* get_name() const { return "RegressionForTestCostFunction"; }
@@ -73,6 +75,7 @@ public:
 	virtual void begin_sample();
 	virtual bool next_sample();
 	virtual int32_t get_sample_size();
+	virtual index_t get_sample_index() { return m_sample_idx; }
 	virtual SGVector<float64_t> get_average_gradient();
 	virtual const char* get_name() const { return "ClassificationForTestCostFunction"; }
 protected:
@@ -98,6 +101,36 @@ public:
 	virtual const char* get_name() const { return "ClassificationForTestCostFunction2"; }
 };
 
+class SparseClassificationForTestCostFunction: public FirstOrderSAGCostFunction
+{
+public:
+	SparseClassificationForTestCostFunction(bool sparse_gradient);
+	virtual ~SparseClassificationForTestCostFunction(){}
+	void set_data(SGSparseMatrix<float64_t> features, SGVector<float64_t> labels);
+	virtual float64_t get_cost();
+	virtual SGVector<float64_t> obtain_variable_reference();
+	virtual SGVector<float64_t> get_gradient();
+	virtual SGVector<float64_t> get_average_gradient();
+	virtual int32_t get_sample_size();
+	virtual index_t get_sample_index() { return m_sample_idx; }
+	virtual void begin_sample();
+	virtual bool next_sample();
+	virtual bool supports_sparse_gradient() { return m_sparse_gradient; }
+	virtual SGVector<index_t> get_gradient_support();
+	virtual SGSparseVector<float64_t> get_sparse_gradient();
+	virtual bool supports_sparse_sample_gradient() { return m_sparse_gradient; }
+	virtual SGSparseVector<float64_t> get_sparse_sample_gradient(index_t sample_idx,
+		SGVector<float64_t> variable, float64_t scale=1.0);
+	virtual const char* get_name() const { return "SparseClassificationForTestCostFunction"; }
+protected:
+	float64_t get_derivative(index_t idx);
+	bool m_sparse_gradient;
+	index_t m_sample_idx;
+	SGSparseMatrix<float64_t> m_features;
+	SGVector<float64_t> m_labels;
+	SGVector<float64_t> m_weight;
+};
+
 class CRegressionExample: public CSGObject
 {
 friend class RegressionForTestCostFunction;
@@ -1,25 +1,28 @@
 #include <shogun/preprocessor/KernelPCA.h>
 #include <shogun/kernel/GaussianKernel.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/mathematics/eigen3.h>
 
 #include <gtest/gtest.h>
 
 using ::testing::Test;
 using namespace shogun;
+using namespace Eigen;
 
 #ifdef HAVE_LAPACK
-TEST(KernelPCA, DISABLED_apply_to_feature_matrix_input)
+TEST(KernelPCA, apply_to_feature_matrix_input)
 {
 	float64_t data[] = {1, 1, 1,
                       1, 2, 3,
                       5, 6, 1,
                       2, 2, 2,
                       1, 1, 1};
-	float64_t resdata[] = {-1.526879008202007e-02,  6.902776989923266e-01,
-                         -4.032822763552926e-01, -5.151523890814317e-01,
-                         8.444041004961732e-01, -4.318711485273607e-01,
-                         -4.105842439768400e-01, -4.335318603758601e-01,
-                         -1.526879008202015e-02, 6.902776989923268e-01
+	// components with the largest eigenvalue first
+	float64_t resdata[] = {6.902776989923266e-01, -1.526879008202007e-02,
+                         -5.151523890814317e-01, -4.032822763552926e-01,
+                         -4.318711485273607e-01, 8.444041004961732e-01,
+                         -4.335318603758601e-01, -4.105842439768400e-01,
+                         6.902776989923268e-01, -1.526879008202015e-02
 	                        };// column-wise
 	int32_t num_vectors = 5;
 	int32_t num_features = 3;
@@ -33,11 +36,81 @@ TEST(KernelPCA, DISABLED_apply_to_feature_matrix_input)
 	kpca.init(feats);
 	SGMatrix<float64_t> embedding = kpca.apply_to_feature_matrix(feats);
 
-	float64_t s;
+	EXPECT_EQ(2, embedding.num_rows);
+	EXPECT_EQ(num_vectors, embedding.num_cols);
+
 	// allow embedding with opposite sign
-	if ( embedding.matrix[0] > 0)
-		s = -1;
+	for (index_t k = 0; k < 2; ++k)
+	{
+		float64_t s = CMath::sign(embedding(k,0)*resdata[k]);
+		for (index_t i = 0; i < num_vectors; ++i)
+			EXPECT_NEAR(embedding(k,i), s * resdata[2*i+k], 1E-6);
+	}
+}
+
+TEST(KernelPCA, iterative_equals_full)
+{
+	CMath::init_random(17);
+
+	int32_t num_vectors = 150;
+	int32_t num_features = 4;
+	SGMatrix<float64_t> data(num_features, num_vectors);
 	for (index_t i = 0; i < num_features * num_vectors; ++i)
-		EXPECT_LE(CMath::abs(embedding.matrix[i] - s * resdata[i]), 1E-6);
+		data.matrix[i] = CMath::randn_double();
+
+	SGMatrix<float64_t> embeddings[2];
+	EKernelPCAMethod methods[] = {KPCA_FULL, KPCA_ITERATIVE};
+	for (int32_t m = 0; m < 2; ++m)
+	{
+		CDenseFeatures<float64_t>* feats = new CDenseFeatures<float64_t>(data.clone());
+		SG_REF(feats);
+		CGaussianKernel* kernel = new CGaussianKernel();
+		kernel->set_width(4);
+		CKernelPCA* kpca = new CKernelPCA(kernel);
+		kpca->set_method(methods[m]);
+		kpca->set_target_dim(3);
+		kpca->init(feats);
+
+		EXPECT_EQ(num_vectors, kpca->get_transformation_matrix().num_rows);
+		EXPECT_EQ(3, kpca->get_transformation_matrix().num_cols);
+		EXPECT_EQ(3, kpca->get_bias_vector().vlen);
+
+		embeddings[m] = kpca->apply_to_feature_matrix(feats);
+		SG_UNREF(kpca);
+		SG_UNREF(feats);
+	}
+
+	// reference: the centered kernel matrix Kc=HKH has eigenpairs
+	// (lambda_k, v_k), the training vectors embed as sqrt(lambda_k)*v_k
+	MatrixXd K(num_vectors, num_vectors);
+	for (index_t i = 0; i < num_vectors; ++i)
+	{
+		for (index_t j = 0; j < num_vectors; ++j)
+		{
+			float64_t sq_dist = 0;
+			for (index_t d = 0; d < num_features; ++d)
+				sq_dist += CMath::sq(data(d,i)-data(d,j));
+			K(i,j) = CMath::exp(-sq_dist/4);
+		}
+	}
+	MatrixXd H = MatrixXd::Identity(num_vectors, num_vectors) -
+		MatrixXd::Constant(num_vectors, num_vectors, 1.0/num_vectors);
+	SelfAdjointEigenSolver<MatrixXd> solver(H*K*H);
+
+	// allow embedding with opposite sign
+	for (index_t k = 0; k < 3; ++k)
+	{
+		index_t col = num_vectors-k-1;
+		float64_t scale = CMath::sqrt(solver.eigenvalues()[col]);
+		for (int32_t m = 0; m < 2; ++m)
+		{
+			float64_t s = CMath::sign(embeddings[m](k,0)*solver.eigenvectors()(0,col));
+			for (index_t i = 0; i < num_vectors; ++i)
+			{
+				EXPECT_NEAR(embeddings[m](k,i),
+					s * scale * solver.eigenvectors()(i,col), 1E-6);
+			}
+		}
+	}
 }
 #endif // HAVE_LAPACK
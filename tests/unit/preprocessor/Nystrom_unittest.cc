@@ -0,0 +1,188 @@
+#include <shogun/preprocessor/Nystrom.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/mathematics/Math.h>
+
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+static SGMatrix<float64_t> nystrom_test_data(int32_t dim, int32_t num_vectors)
+{
+	SGMatrix<float64_t> data(dim, num_vectors);
+	for (index_t i=0; i<dim*num_vectors; ++i)
+		data.matrix[i]=CMath::normal_random(0.0, 1.0);
+	return data;
+}
+
+TEST(Nystrom, all_landmarks_reproduce_kernel_matrix)
+{
+	const int32_t dim=3;
+	const int32_t num_vectors=20;
+	CMath::init_random(17);
+
+	SGMatrix<float64_t> data=nystrom_test_data(dim, num_vectors);
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data.clone());
+	SG_REF(feats);
+
+	CGaussianKernel* kernel=new CGaussianKernel(10, 2.0);
+	kernel->init(feats, feats);
+	SGMatrix<float64_t> K=kernel->get_kernel_matrix();
+	kernel->cleanup();
+
+	CNystrom* nystrom=new CNystrom(kernel, num_vectors);
+	SG_REF(nystrom);
+	nystrom->init(feats);
+	CDenseFeatures<float64_t>* mapped=nystrom->apply_to_features(feats);
+	SGMatrix<float64_t> phi=mapped->get_feature_matrix();
+	EXPECT_EQ(phi.num_rows, num_vectors);
+	EXPECT_EQ(phi.num_cols, num_vectors);
+
+	for (index_t i=0; i<num_vectors; ++i)
+	{
+		for (index_t j=0; j<num_vectors; ++j)
+		{
+			float64_t dot=0;
+			for (index_t l=0; l<phi.num_rows; ++l)
+				dot+=phi(l, i)*phi(l, j);
+			EXPECT_NEAR(dot, K(i, j), 1E-8);
+		}
+	}
+
+	SG_UNREF(mapped);
+	SG_UNREF(nystrom);
+	SG_UNREF(feats);
+}
+
+TEST(Nystrom, apply_to_feature_vector_matches_matrix)
+{
+	const int32_t dim=2;
+	const int32_t num_vectors=30;
+	const int32_t num_landmarks=8;
+	CMath::init_random(17);
+
+	SGMatrix<float64_t> data=nystrom_test_data(dim, num_vectors);
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data.clone());
+	SG_REF(feats);
+
+	CNystrom* nystrom=new CNystrom(new CGaussianKernel(10, 1.0), num_landmarks);
+	SG_REF(nystrom);
+	nystrom->init(feats);
+
+	SGVector<float64_t> vec(data.get_column_vector(3), dim, false);
+	SGVector<float64_t> mapped_vec=nystrom->apply_to_feature_vector(vec);
+	SGMatrix<float64_t> mapped=nystrom->apply_to_feature_matrix(feats);
+
+	ASSERT_EQ(mapped_vec.vlen, num_landmarks);
+	EXPECT_EQ(mapped.num_rows, num_landmarks);
+	EXPECT_EQ(mapped.num_cols, num_vectors);
+	for (index_t i=0; i<num_landmarks; ++i)
+		EXPECT_NEAR(mapped_vec[i], mapped(i, 3), 1E-12);
+
+	SG_UNREF(nystrom);
+	SG_UNREF(feats);
+}
+
+TEST(Nystrom, landmark_selection)
+{
+	const int32_t dim=2;
+	const int32_t num_vectors=100;
+	const int32_t num_landmarks=10;
+	CMath::init_random(17);
+
+	SGMatrix<float64_t> data=nystrom_test_data(dim, num_vectors);
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	SG_REF(feats);
+
+	ENystromLandmarkSelection selections[]={NLS_UNIFORM, NLS_KMEANS,
+		NLS_LEVERAGE_SCORES};
+
+	for (index_t s=0; s<3; ++s)
+	{
+		CNystrom* nystrom=new CNystrom(new CGaussianKernel(10, 2.0),
+				num_landmarks, selections[s]);
+		SG_REF(nystrom);
+		EXPECT_TRUE(nystrom->init(feats));
+
+		CFeatures* landmarks=nystrom->get_landmarks();
+		EXPECT_EQ(landmarks->get_num_vectors(), num_landmarks);
+		SG_UNREF(landmarks);
+
+		/* approximation is exact on the landmarks themselves, so the
+		 * diagonal of the approximate kernel can not exceed one */
+		CDenseFeatures<float64_t>* mapped=nystrom->apply_to_features(feats);
+		SGMatrix<float64_t> phi=mapped->get_feature_matrix();
+		for (index_t i=0; i<num_vectors; ++i)
+		{
+			float64_t sq_norm=0;
+			for (index_t l=0; l<phi.num_rows; ++l)
+				sq_norm+=CMath::sq(phi(l, i));
+			EXPECT_LE(sq_norm, 1.0+1E-8);
+		}
+
+		SG_UNREF(mapped);
+		SG_UNREF(nystrom);
+	}
+
+	SG_UNREF(feats);
+}
+
+TEST(Nystrom, kernel_features_restored)
+{
+	const int32_t dim=2;
+	const int32_t num_vectors=30;
+	const int32_t num_landmarks=5;
+	CMath::init_random(17);
+
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(
+			nystrom_test_data(dim, num_vectors));
+	CDenseFeatures<float64_t>* other=new CDenseFeatures<float64_t>(
+			nystrom_test_data(dim, 7));
+	SG_REF(feats);
+	SG_REF(other);
+
+	CGaussianKernel* kernel=new CGaussianKernel(10, 2.0);
+	kernel->init(feats, other);
+	CNystrom* nystrom=new CNystrom(kernel, num_landmarks, NLS_LEVERAGE_SCORES);
+	SG_REF(nystrom);
+	EXPECT_TRUE(nystrom->init(feats));
+	CDenseFeatures<float64_t>* mapped=nystrom->apply_to_features(feats);
+
+	CFeatures* lhs=kernel->get_lhs();
+	CFeatures* rhs=kernel->get_rhs();
+	EXPECT_EQ(lhs, feats);
+	EXPECT_EQ(rhs, other);
+	EXPECT_EQ(kernel->get_num_vec_lhs(), num_vectors);
+	EXPECT_EQ(kernel->get_num_vec_rhs(), 7);
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
+
+	SG_UNREF(mapped);
+	SG_UNREF(nystrom);
+	SG_UNREF(other);
+	SG_UNREF(feats);
+}
+
+TEST(Nystrom, apply_to_feature_matrix_requires_dense_features)
+{
+	const int32_t dim=2;
+	const int32_t num_vectors=10;
+	CMath::init_random(17);
+
+	SGMatrix<float64_t> data=nystrom_test_data(dim, num_vectors);
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+	CSparseFeatures<float64_t>* sparse=new CSparseFeatures<float64_t>(data);
+	SG_REF(feats);
+	SG_REF(sparse);
+
+	CNystrom* nystrom=new CNystrom(new CGaussianKernel(10, 2.0), 3);
+	SG_REF(nystrom);
+	EXPECT_TRUE(nystrom->init(feats));
+	EXPECT_THROW(nystrom->apply_to_feature_matrix(sparse), ShogunException);
+
+	SG_UNREF(nystrom);
+	SG_UNREF(sparse);
+	SG_UNREF(feats);
+}
@@ -31,6 +31,7 @@
 #include <gtest/gtest.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/features/DenseFeatures.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/lib/SGVector.h>
 
@@ -607,3 +608,117 @@ TEST(PCA, PCA_WHITEN_EVD)
 	SG_UNREF(pca);
 	SG_UNREF(features);
 }
+
+TEST(PCA, PCA_RANDOMIZED)
+{
+	CMath::init_random(17);
+
+	// data with a decaying spectrum
+	int32_t num_features=20, num_vectors=200;
+	SGMatrix<float64_t> data(num_features,num_vectors);
+	for (int32_t j=0; j<num_vectors; j++)
+	{
+		for (int32_t i=0; i<num_features; i++)
+			data(i,j)=CMath::randn_double()/(i+1)+1.0;
+	}
+
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(data);
+	CPCA* pca_svd=new CPCA(SVD);
+	pca_svd->set_target_dim(3);
+	pca_svd->init(features);
+
+	// the error of the range shrinks by lambda_14/lambda_3~0.05 with every
+	// power iteration
+	CPCA* pca=new CPCA(RANDOMIZED);
+	pca->set_target_dim(3);
+	pca->set_num_power_iterations(6);
+	pca->init(features);
+
+	SGMatrix<float64_t> transmat_svd=pca_svd->get_transformation_matrix();
+	SGMatrix<float64_t> transmat=pca->get_transformation_matrix();
+	SGVector<float64_t> eigvec_svd=pca_svd->get_eigenvalues();
+	SGVector<float64_t> eigvec=pca->get_eigenvalues();
+
+	EXPECT_EQ(3, eigvec.vlen);
+	EXPECT_EQ(num_features, transmat.num_rows);
+	EXPECT_EQ(3, transmat.num_cols);
+
+	float64_t epsilon = 1e-8;
+	// SVD stores the eigenpairs in descending order, RANDOMIZED in
+	// ascending order
+	for (int32_t j=0; j<3; j++)
+	{
+		int32_t j_svd=2-j;
+		EXPECT_NEAR(eigvec_svd[j_svd], eigvec[j], epsilon);
+
+		// eigenvectors are unique up to their sign
+		float64_t sign=CMath::sign(transmat(0,j)*transmat_svd(0,j_svd));
+		for (int32_t i=0; i<num_features; i++)
+			EXPECT_NEAR(transmat_svd(i,j_svd), sign*transmat(i,j), epsilon);
+	}
+
+	SG_UNREF(pca);
+	SG_UNREF(pca_svd);
+	SG_UNREF(features);
+}
+
+TEST(PCA, PCA_streaming)
+{
+	CMath::init_random(17);
+
+	int32_t num_features=6, num_vectors=100;
+	SGMatrix<float64_t> data(num_features,num_vectors);
+	for (int32_t j=0; j<num_vectors; j++)
+	{
+		for (int32_t i=0; i<num_features; i++)
+			data(i,j)=CMath::randn_double()*(i+1)+100.0;
+	}
+
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(data);
+	SG_REF(features);
+	CPCA* pca_evd=new CPCA(EVD);
+	pca_evd->set_target_dim(2);
+	pca_evd->init(features);
+
+	SGMatrix<float64_t> transmat_evd=pca_evd->get_transformation_matrix();
+	SGVector<float64_t> eigvec_evd=pca_evd->get_eigenvalues();
+	SGVector<float64_t> mean_evd=pca_evd->get_mean();
+
+	EPCAMethod methods[]={EVD, RANDOMIZED};
+	for (int32_t m=0; m<2; m++)
+	{
+		CStreamingDenseFeatures<float64_t>* streaming_features=
+			new CStreamingDenseFeatures<float64_t>(features);
+
+		CPCA* pca=new CPCA(methods[m]);
+		pca->set_target_dim(2);
+		// blocks do not divide the number of vectors
+		pca->set_streaming_block_size(7);
+		pca->init(streaming_features);
+
+		SGMatrix<float64_t> transmat=pca->get_transformation_matrix();
+		SGVector<float64_t> eigvec=pca->get_eigenvalues();
+		SGVector<float64_t> mean=pca->get_mean();
+
+		float64_t epsilon = 1e-8;
+		for (int32_t i=0; i<num_features; i++)
+			EXPECT_NEAR(mean_evd[i], mean[i], epsilon);
+
+		// both methods store the eigenvalues in ascending order, EVD all of
+		// them and RANDOMIZED only the top ones
+		for (int32_t j=0; j<2; j++)
+		{
+			EXPECT_NEAR(eigvec_evd[num_features-1-j], eigvec[eigvec.vlen-1-j], epsilon);
+
+			float64_t sign=CMath::sign(transmat(0,j)*transmat_evd(0,j));
+			for (int32_t i=0; i<num_features; i++)
+				EXPECT_NEAR(transmat_evd(i,j), sign*transmat(i,j), epsilon);
+		}
+
+		SG_UNREF(pca);
+		SG_UNREF(streaming_features);
+	}
+
+	SG_UNREF(pca_evd);
+	SG_UNREF(features);
+}
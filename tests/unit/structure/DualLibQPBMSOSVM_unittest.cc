@@ -21,6 +21,8 @@
 
 #include <shogun/structure/MulticlassModel.h>
 #include <shogun/structure/DualLibQPBMSOSVM.h>
+#include <shogun/base/Parallel.h>
+#include <shogun/mathematics/Math.h>
 
 using namespace shogun;
 
@@ -137,6 +139,54 @@ TEST_P(DualLibQPBMSOSVMTestLoopSolvers,train_small_problem_and_predict)
 	SG_UNREF(out);
 }
 
+TEST(DualLibQPBMSOSVM,parallel_risk_matches_serial)
+{
+	int32_t N        = 100;
+	int32_t feat_dim = 5;
+	int32_t num_feat = 4;
+
+	SGVector<float64_t> labs = create_test_labels(N);
+	CMulticlassSOLabels* labels = new CMulticlassSOLabels(labs);
+	SGSparseMatrix<float64_t> feats = create_test_features(N, feat_dim, num_feat);
+	CSparseFeatures< float64_t >* features = new CSparseFeatures< float64_t >(feats);
+
+	CMulticlassModel* model = new CMulticlassModel(features, labels);
+	CDualLibQPBMSOSVM* sosvm = new CDualLibQPBMSOSVM(model, labels, 1e3);
+	SG_REF(sosvm);
+
+	int32_t dim = model->get_dim();
+	SGVector<float64_t> w(dim);
+	for (int32_t i=0; i<dim; i++)
+		w[i] = CMath::sin(i+1.0);
+
+	// risk and subgradient computed example by example
+	SGVector<float64_t> expected_subgrad(dim);
+	expected_subgrad.zero();
+	float64_t expected_risk = 0;
+	for (int32_t i=0; i<N; i++)
+	{
+		CResultSet* result = model->argmax(w, i, true);
+		for (int32_t j=0; j<dim; j++)
+			expected_subgrad[j] += result->psi_pred[j]-result->psi_truth[j];
+		expected_risk += result->score;
+		SG_UNREF(result);
+	}
+
+	int32_t num_threads[] = {1, 3, 4};
+	for (int32_t t=0; t<3; t++)
+	{
+		sosvm->parallel->set_num_threads(num_threads[t]);
+		SGVector<float64_t> subgrad(dim);
+		float64_t risk = sosvm->risk(subgrad.vector, w.vector);
+
+		EXPECT_NEAR(risk, expected_risk, 1e-9);
+		for (int32_t j=0; j<dim; j++)
+			EXPECT_NEAR(subgrad[j], expected_subgrad[j], 1e-9);
+	}
+
+	SG_UNREF(sosvm);
+}
+
 INSTANTIATE_TEST_CASE_P(IterateAllBMSOSolvers,
                         DualLibQPBMSOSVMTestLoopSolvers,
                         ::testing::Values(BMRM, PPBMRM, P3BMRM, NCBM));